@@ -24,13 +24,19 @@
 #include <cstring>       // for memcpy, strlen, strchr, strerror_r, strncmp
 #include <ctime>         // for tm, localtime_r, mktime, strptime, time_t
 #include <filesystem>    // for path, operator/, operator==, directory_iterator
+#include <fstream>       // for ifstream
 #include <iostream>      // for basic_istream, basic_ostream, operator<<, fpos
 #include <iterator>      // for distance
 #include <limits>        // for numeric_limits
+#include <map>           // for map
 #include <memory>        // for unique_ptr
 #include <ranges>        // for reverse_view, ref_view
+#include <sstream>       // for ostringstream
 #include <system_error>  // for error_code
+#include <sys/stat.h>    // for fstat
 #include <type_traits>   // for is_integral_v, is_same_v, is_floating_point_v
+#include <unordered_map> // for unordered_map
+#include <unistd.h>      // for close, unlink
 #include <utility>       // for move
 
 namespace fs = std::filesystem;
@@ -251,6 +257,7 @@ FILE* OpenDBFile( const char* name, const TDatime& date, const char* here,
     ::Error(here, "Cannot open database file db_%s%sdat", name,
             (name[strlen(name) - 1] == '.' ? "" : "."));
   }
+  DBFingerprint::Record(name, openpath);
   return fi;
 }
 
@@ -604,6 +611,490 @@ Bool_t DBDatesDiffer( const TDatime& a, const TDatime& b )
   return a != b;
 }
 
+namespace {
+
+//_____________________________________________________________________________
+bool SplitDBkey( const string& line, string& key, string& value )
+{
+  // If 'line' has the form "key = value", as recognized by IsDBkey, split
+  // it into 'key' and 'value' and return true. 'key' may be empty.
+
+  string dummy;
+  if( IsDBkey(line, "", dummy) == 0 )
+    return false;
+  auto eq = line.find('=');
+  auto b = line.find_first_not_of(" \t");
+  if( b < eq )
+    key = line.substr(b, line.find_last_not_of(" \t", eq - 1) - b + 1);
+  else
+    key.clear();
+  if( auto v = line.find_first_not_of(" \t", eq + 1); v != string::npos )
+    value = line.substr(v);
+  else
+    value.clear();
+  return true;
+}
+
+//_____________________________________________________________________________
+Int_t read_error( const char* here )
+{
+  // Set errtxt to the message for the current errno. Returns -1.
+
+  constexpr Int_t bufsiz = 256;
+  char buf[bufsiz];
+#ifdef GNU_STRERROR_R
+  const char* ret = strerror_r(errno, buf, bufsiz);
+  errtxt = string(here) + ": " + (ret ? ret : "unknown error " + to_string(errno));
+#else
+  strerror_r(errno, buf, bufsiz);
+  errtxt = string(here) + ": " + buf;
+#endif
+  return -1;
+}
+
+//_____________________________________________________________________________
+// Key/value lookup state of LoadDBvalue while scanning a database file
+class DBKeyScan {
+public:
+  DBKeyScan( const TDatime& datime, const char* key, string& value )
+    : fKey(key), fValue(value), fKeyDate(0), fPrevDate(0), fFound(false),
+      fIgnore(false)
+  {
+    WithDefaultTZ(fDate = datime.Convert());
+  }
+  // Process a database line after text variable substitution
+  void Process( const string& line )
+  {
+    if( Int_t status; !fIgnore && (status = IsDBkey(line, fKey, fValue)) != 0 ) {
+      if( status > 0 )
+        Found();
+    } else if( Long64_t date = 0; IsDBdate(line, date) != 0 )
+      SetDate(date);
+  }
+  // Process a raw database line, substituting text variables, if any
+  void ProcessRaw( const string& dbline )
+  {
+    vector<string> lines(1, dbline);
+    if( gHaTextvars )
+      gHaTextvars->Substitute(lines);
+    for( const auto& line: lines )
+      Process(line);
+  }
+  // Found a matching key for a newer date than before. We do not set
+  // fIgnore here so that the _last_, not the first, of multiple identical
+  // keys is evaluated.
+  void Found()
+  {
+    fFound = true;
+    fPrevDate = fKeyDate;
+  }
+  void Found( const string& value )
+  {
+    fValue = value;
+    Found();
+  }
+  // Entering a section with time stamp 'date'
+  void SetDate( Long64_t date )
+  {
+    fKeyDate = date;
+    fIgnore = (fKeyDate > fDate || fKeyDate < fPrevDate);
+  }
+  const char* GetKey()   const { return fKey; }
+  Bool_t      IsFound()  const { return fFound; }
+  Bool_t      IsIgnore() const { return fIgnore; }
+
+private:
+  const char* fKey;
+  string&     fValue;
+  Long64_t    fDate;      // Requested date
+  Long64_t    fKeyDate;   // Time stamp of current section
+  Long64_t    fPrevDate;  // Time stamp of section of last match
+  Bool_t      fFound;
+  Bool_t      fIgnore;    // Current section is outside of date range
+};
+
+//_____________________________________________________________________________
+// Directory for on-disk database file indexes, see SetDBIndexCacheDir
+string gDBIndexCacheDir;
+Bool_t gDBIndexCacheDirSet = false;
+
+const string& GetDBIndexCacheDir()
+{
+  if( !gDBIndexCacheDirSet ) {
+    if( const char* env = gSystem->Getenv("DB_INDEX_CACHE") )
+      gDBIndexCacheDir = env;
+    gDBIndexCacheDirSet = true;
+  }
+  return gDBIndexCacheDir;
+}
+
+//_____________________________________________________________________________
+// In-memory index of the keys and time stamps in a database file. Each file
+// is parsed only once (per modification). Subsequent LoadDBvalue calls then
+// look up the key in a hash table instead of re-reading the entire file.
+// If a cache directory is set, the index is also saved there, so that other
+// jobs reading the same, unmodified file can load it instead of parsing
+// the file.
+class DBFileIndex {
+public:
+  // Get the index of 'file', building it if necessary. Returns nullptr if
+  // the file cannot be indexed (e.g. not a regular file). Sets 'err' to -1
+  // on read errors.
+  static const DBFileIndex* Get( FILE* file, Int_t& err );
+
+  // Look up key, see LoadDBvalue. Returns true if found
+  Bool_t Find( DBKeyScan& scan ) const;
+
+private:
+  enum ELineType { kDate, kKey, kText };
+  struct Line_t {
+    ELineType type;
+    Long64_t  date;       // kDate: time stamp. kKey: time stamp in value, if any
+    Bool_t    has_date;
+    string    key;        // kKey: key. kText: raw line
+    string    value;      // kKey: value
+  };
+  struct Stat_t {
+    dev_t    dev;
+    ino_t    ino;
+    Long64_t mtime;
+    off_t    size;
+    TString  tz;          // Time zone for dates w/o offset at build time
+    bool operator==( const Stat_t& rhs ) const {
+      return dev == rhs.dev && ino == rhs.ino && mtime == rhs.mtime &&
+             size == rhs.size && tz == rhs.tz;
+    }
+  };
+
+  Stat_t                 fStat;
+  vector<Line_t>         fLines;   // Relevant lines, in file order
+  unordered_map<string, vector<UInt_t>> fKeys;  // Key -> indices in fLines
+  // Lines that may change the scan state regardless of key: time stamps,
+  // keys with time stamps in the value, and lines with text variables
+  vector<UInt_t>         fEvents;
+  Bool_t                 fHaveText; // Any lines with text variables
+
+  Int_t  Build( FILE* file );
+  void   Reindex();
+  void   Process( UInt_t i, DBKeyScan& scan ) const;
+
+  // On-disk copy of the index
+  static string CachePath( const Stat_t& st );
+  Bool_t Load( const string& path, const Stat_t& st );
+  void   Save( const string& path ) const;
+};
+
+//_____________________________________________________________________________
+const DBFileIndex* DBFileIndex::Get( FILE* file, Int_t& err )
+{
+  err = 0;
+  struct stat st{};
+  if( fstat(fileno(file), &st) != 0 || !S_ISREG(st.st_mode) )
+    return nullptr;
+#ifdef __APPLE__
+  const auto& mtim = st.st_mtimespec;
+#else
+  const auto& mtim = st.st_mtim;
+#endif
+  Stat_t fst{st.st_dev, st.st_ino,
+             static_cast<Long64_t>(mtim.tv_sec) * 1000000000 + mtim.tv_nsec,
+             st.st_size, gNeedTZCorrection ? gDefaultTZ : TString()};
+
+  // Indexes in memory are checked first, then those on disk
+  static thread_local map<pair<dev_t, ino_t>, DBFileIndex> indexes;
+  auto& idx = indexes[{fst.dev, fst.ino}];
+  if( !(idx.fStat == fst) ) {
+    string cache = CachePath(fst);
+    if( cache.empty() || !idx.Load(cache, fst) ) {
+      if( (err = idx.Build(file)) != 0 ) {
+        indexes.erase({fst.dev, fst.ino});
+        return nullptr;
+      }
+      idx.fStat = fst;
+      if( !cache.empty() )
+        idx.Save(cache);
+    }
+  }
+  return &idx;
+}
+
+//_____________________________________________________________________________
+Int_t DBFileIndex::Build( FILE* file )
+{
+  // Parse the database file and record all keys and time stamps.
+  // The lines are read exactly as LoadDBvalue does.
+
+  fLines.clear();
+  fKeys.clear();
+  fEvents.clear();
+  fHaveText = false;
+  fStat = {};
+
+  constexpr Int_t bufsiz = 256;
+  unique_ptr<char[]> buf{new char[bufsiz]};
+  string line;
+
+  errno = 0;
+  rewind(file);
+  if( errno )
+    return read_error("LoadDBvalue");
+  while( ReadDBline(file, buf.get(), bufsiz, line) != EOF ) {
+    if( line.empty() ) continue;
+    Line_t ln{kKey, 0, false, {}, {}};
+    if( line.find("${") != string::npos ) {
+      // Text variables can change, so these lines are evaluated on each
+      // lookup
+      ln.type = kText;
+      ln.key = line;
+    } else if( SplitDBkey(line, ln.key, ln.value) ) {
+      // A time stamp in a "key = value" line takes effect if the line is in
+      // an ignored section, see DBKeyScan::Process
+      if( line.find('[') != string::npos &&
+          IsDBdate(line, ln.date, false) != 0 )
+        ln.has_date = true;
+      // Lines with an empty key never match
+      if( ln.key.empty() && !ln.has_date )
+        continue;
+    } else if( IsDBdate(line, ln.date) != 0 ) {
+      ln.type = kDate;
+      ln.has_date = true;
+    } else
+      continue;
+    fLines.push_back(std::move(ln));
+  }
+  if( errno )
+    return read_error("LoadDBvalue");
+  Reindex();
+  return 0;
+}
+
+//_____________________________________________________________________________
+void DBFileIndex::Reindex()
+{
+  // Build the lookup tables from fLines
+
+  fKeys.clear();
+  fEvents.clear();
+  fHaveText = false;
+  for( UInt_t i = 0; i < fLines.size(); ++i ) {
+    const auto& ln = fLines[i];
+    switch( ln.type ) {
+      case kText:
+        fHaveText = true;
+        fEvents.push_back(i);
+        break;
+      case kKey:
+        if( ln.has_date )
+          fEvents.push_back(i);
+        if( !ln.key.empty() )
+          fKeys[ln.key].push_back(i);
+        break;
+      case kDate:
+        fEvents.push_back(i);
+        break;
+    }
+  }
+}
+
+//_____________________________________________________________________________
+// File format of on-disk indexes. The byte order mark rejects files written
+// on machines with different endianness.
+constexpr char     kDBIndexMagic[8] = { 'P','o','d','d','D','B','I','x' };
+constexpr UInt_t   kDBIndexVersion  = 1;
+constexpr UInt_t   kDBIndexBOM      = 0x01020304;
+
+//_____________________________________________________________________________
+string DBFileIndex::CachePath( const Stat_t& st )
+{
+  // Path of the on-disk index for the file with 'st', or empty if on-disk
+  // indexes are disabled. Dates without time zone offset are converted
+  // with the default time zone; without it, they depend on the local time
+  // zone, and the index is not saved.
+
+  const string& dir = GetDBIndexCacheDir();
+  if( dir.empty() || st.tz.IsNull() )
+    return {};
+  ostringstream ostr;
+  ostr << dir << "/dbindex_" << hex << static_cast<ULong64_t>(st.dev)
+       << "_" << static_cast<ULong64_t>(st.ino) << ".bin";
+  return ostr.str();
+}
+
+//_____________________________________________________________________________
+template<typename T>
+inline bool WriteBin( FILE* fo, const T& x )
+{
+  static_assert(is_trivially_copyable_v<T>);
+  return fwrite(&x, sizeof(x), 1, fo) == 1;
+}
+inline bool WriteBin( FILE* fo, const string& s )
+{
+  auto n = static_cast<UInt_t>(s.size());
+  return WriteBin(fo, n) && (n == 0 || fwrite(s.data(), n, 1, fo) == 1);
+}
+template<typename T>
+inline bool ReadBin( FILE* fi, T& x )
+{
+  static_assert(is_trivially_copyable_v<T>);
+  return fread(&x, sizeof(x), 1, fi) == 1;
+}
+inline bool ReadBin( FILE* fi, string& s )
+{
+  UInt_t n = 0;
+  if( !ReadBin(fi, n) || n > (1U<<24) )
+    return false;
+  s.resize(n);
+  return n == 0 || fread(s.data(), n, 1, fi) == 1;
+}
+
+//_____________________________________________________________________________
+Bool_t DBFileIndex::Load( const string& path, const Stat_t& st )
+{
+  // Load the index from 'path'. Succeeds only if it was saved for a file
+  // with the same device, inode, modification time and size, and for the
+  // same default time zone, as 'st'.
+
+  unique_ptr<FILE, int(*)(FILE*)> fi{fopen(path.c_str(), "rb"), fclose};
+  if( !fi )
+    return false;
+  char magic[sizeof(kDBIndexMagic)];
+  UInt_t version = 0, bom = 0;
+  ULong64_t dev = 0, ino = 0, nlines = 0;
+  Long64_t mtime = 0, size = 0;
+  string tz;
+  if( fread(magic, sizeof(magic), 1, fi.get()) != 1 ||
+      memcmp(magic, kDBIndexMagic, sizeof(magic)) != 0 ||
+      !ReadBin(fi.get(), version) || version != kDBIndexVersion ||
+      !ReadBin(fi.get(), bom) || bom != kDBIndexBOM ||
+      !ReadBin(fi.get(), dev) || !ReadBin(fi.get(), ino) ||
+      !ReadBin(fi.get(), mtime) || !ReadBin(fi.get(), size) ||
+      !ReadBin(fi.get(), tz) || !ReadBin(fi.get(), nlines) )
+    return false;
+  if( dev != static_cast<ULong64_t>(st.dev) ||
+      ino != static_cast<ULong64_t>(st.ino) ||
+      mtime != st.mtime || size != static_cast<Long64_t>(st.size) ||
+      tz != st.tz.Data() ||
+      nlines > static_cast<ULong64_t>(st.size) )
+    return false;
+
+  vector<Line_t> lines(nlines);
+  for( auto& ln: lines ) {
+    UChar_t type = 0, has_date = 0;
+    if( !ReadBin(fi.get(), type) || type > kText ||
+        !ReadBin(fi.get(), has_date) || !ReadBin(fi.get(), ln.date) ||
+        !ReadBin(fi.get(), ln.key) || !ReadBin(fi.get(), ln.value) )
+      return false;
+    ln.type = static_cast<ELineType>(type);
+    ln.has_date = has_date;
+  }
+  fLines = std::move(lines);
+  Reindex();
+  fStat = st;
+  return true;
+}
+
+//_____________________________________________________________________________
+void DBFileIndex::Save( const string& path ) const
+{
+  // Save the index to 'path'. The index is written to a temporary file
+  // that is then renamed, so readers see either a complete index or none.
+  // Errors are ignored; the index is then simply rebuilt next time.
+
+  string tmp = path + ".XXXXXX";
+  int fd = mkstemp(tmp.data());
+  if( fd < 0 )
+    return;
+  fchmod(fd, 0644);  // Readable by other jobs, like the database itself
+  FILE* fo = fdopen(fd, "wb");
+  if( !fo ) {
+    close(fd);
+    unlink(tmp.c_str());
+    return;
+  }
+  bool ok =
+    fwrite(kDBIndexMagic, sizeof(kDBIndexMagic), 1, fo) == 1 &&
+    WriteBin(fo, kDBIndexVersion) && WriteBin(fo, kDBIndexBOM) &&
+    WriteBin(fo, static_cast<ULong64_t>(fStat.dev)) &&
+    WriteBin(fo, static_cast<ULong64_t>(fStat.ino)) &&
+    WriteBin(fo, fStat.mtime) &&
+    WriteBin(fo, static_cast<Long64_t>(fStat.size)) &&
+    WriteBin(fo, string(fStat.tz.Data())) &&
+    WriteBin(fo, static_cast<ULong64_t>(fLines.size()));
+  for( auto it = fLines.begin(); ok && it != fLines.end(); ++it ) {
+    ok = WriteBin(fo, static_cast<UChar_t>(it->type)) &&
+         WriteBin(fo, static_cast<UChar_t>(it->has_date)) &&
+         WriteBin(fo, it->date) &&
+         WriteBin(fo, it->key) && WriteBin(fo, it->value);
+  }
+  ok = (fclose(fo) == 0) && ok;
+  if( !ok || rename(tmp.c_str(), path.c_str()) != 0 )
+    unlink(tmp.c_str());
+}
+
+//_____________________________________________________________________________
+void DBFileIndex::Process( UInt_t i, DBKeyScan& scan ) const
+{
+  const auto& ln = fLines[i];
+  switch( ln.type ) {
+    case kDate:
+      scan.SetDate(ln.date);
+      break;
+    case kKey:
+      if( !scan.IsIgnore() ) {
+        if( ln.key == scan.GetKey() )
+          scan.Found(ln.value);
+      } else if( ln.has_date )
+        scan.SetDate(ln.date);
+      break;
+    case kText:
+      scan.ProcessRaw(ln.key);
+      break;
+  }
+}
+
+//_____________________________________________________________________________
+Bool_t DBFileIndex::Find( DBKeyScan& scan ) const
+{
+  // Replay the lines of the file that are relevant for the requested key,
+  // i.e. the lines with this key and all lines that may change the date
+  // state of the scan. Other lines have no effect on the result.
+
+  static const vector<UInt_t> none;
+  auto it = fKeys.find(scan.GetKey());
+  if( it == fKeys.end() && !fHaveText )
+    return false;
+  const auto& keylines = (it != fKeys.end()) ? it->second : none;
+
+  auto k = keylines.begin(), e = fEvents.begin();
+  while( k != keylines.end() || e != fEvents.end() ) {
+    UInt_t i;
+    if( e == fEvents.end() || (k != keylines.end() && *k < *e) )
+      i = *k++;
+    else {
+      if( k != keylines.end() && *k == *e )
+        ++k;
+      i = *e++;
+    }
+    Process(i, scan);
+  }
+  return scan.IsFound();
+}
+
+} // namespace
+
+//_____________________________________________________________________________
+void SetDBIndexCacheDir( const char* dir )
+{
+  // Save indexes of database files in directory 'dir', from where other
+  // jobs can load them instead of parsing unchanged files again. Indexes
+  // are validated by device, inode, modification time and size of the file.
+  // nullptr or "" disables the on-disk indexes. If this function is not
+  // called, the environment variable DB_INDEX_CACHE sets the directory.
+
+  gDBIndexCacheDir = dir ? dir : "";
+  gDBIndexCacheDirSet = true;
+}
+
 //_____________________________________________________________________________
 Int_t LoadDBvalue( FILE* file, const TDatime& datime, const char* key,
                    string& value )
@@ -615,6 +1106,9 @@ Int_t LoadDBvalue( FILE* file, const TDatime& datime, const char* key,
   // Values with time stamps later than 'date' are ignored.
   // This allows incremental organization of the database where
   // only changes are recorded with time stamps.
+  // The keys of regular files are indexed in memory when the file is first
+  // read, so that repeated lookups do not re-read the file. Indexes may also
+  // be kept on disk for other jobs, see SetDBIndexCacheDir.
   // Return values:
   //    0: success
   //    1: key not found
@@ -623,57 +1117,39 @@ Int_t LoadDBvalue( FILE* file, const TDatime& datime, const char* key,
 
   if( !file || !key ) return -255;
 
-  static const string here("LoadDBvalue");
+  errtxt.clear();
+  DBKeyScan scan(datime, key, value);
+
+  Int_t err = 0;
+  if( const auto* idx = DBFileIndex::Get(file, err) ) {
+    bool found = idx->Find(scan);
+    // Leave the file at EOF, as a full scan would
+    fseeko(file, 0, SEEK_END);
+    return found ? 0 : 1;
+  }
+  if( err )
+    return err;
+
+  // Not indexable. Scan the file.
   constexpr Int_t bufsiz = 256;
   unique_ptr<char[]> buf{new char[bufsiz]};
-  char* const bufp = buf.get();
-
-  WithDefaultTZ(Long64_t date = datime.Convert());
-  Long64_t keydate = 0, prevdate = 0;
-
-  bool found = false, do_ignore = false;
   string dbline;
-  vector<string> lines;
 
   errno = 0;
-  errtxt.clear();
   rewind(file);
   if( errno )
-    goto err;
+    return read_error("LoadDBvalue");
 
-  while( ReadDBline(file, bufp, bufsiz, dbline) != EOF ) {
+  while( ReadDBline(file, buf.get(), bufsiz, dbline) != EOF ) {
     if( dbline.empty() ) continue;
     // Replace text variables in this database line, if any. Multi-valued
     // variables are supported here, although they are only sensible on the LHS
-    lines.assign(1, dbline);
-    if( gHaTextvars )
-      gHaTextvars->Substitute(lines);
-    for( auto& line : lines ) {
-      if( Int_t status; !do_ignore && (status = IsDBkey(line, key, value)) != 0 ) {
-        if( status > 0 ) {
-          // Found a matching key for a newer date than before
-          found = true;
-          prevdate = keydate;
-          // we do not set do_ignore to true here so that the _last_, not the
-          // first, of multiple identical keys is evaluated.
-        }
-      } else if( IsDBdate(line, keydate) != 0 )
-        do_ignore = (keydate > date || keydate < prevdate);
-    }
+    scan.ProcessRaw(dbline);
   }
+  if( errno )
+    return read_error("LoadDBvalue");
 
-  if( errno ) {
-err:
-#ifdef GNU_STRERROR_R
-    const char* ret = strerror_r(errno, bufp, bufsiz);
-    errtxt = here + ": " + (ret ? ret : "unknown error " + to_string(errno));
-#else
-    strerror_r(errno, bufp, bufsiz);
-    errtxt = here + ": " + bufp;
-#endif
-    return -1;
-  }
-  return found ? 0 : 1;
+  return scan.IsFound() ? 0 : 1;
 }
 
 namespace {
@@ -1311,6 +1787,172 @@ Bool_t IsDBtimestamp( const string& line, Long64_t& ldate )
   return IsDBdate(line, ldate, true);
 }
 
+//_____________________________________________________________________________
+namespace {
+
+// Recorder currently active in this thread
+thread_local DBFingerprint* current_fingerprint = nullptr;
+
+struct DBFileStat_t {
+  Long64_t mtime;
+  Long64_t size;
+};
+
+//_____________________________________________________________________________
+bool GetDBFileStat( const string& path, DBFileStat_t& st )
+{
+  std::error_code ec;
+  auto mtime = fs::last_write_time(path, ec);
+  if( ec ) return false;
+  auto size = fs::file_size(path, ec);
+  if( ec ) return false;
+  st.mtime = mtime.time_since_epoch().count();
+  st.size = static_cast<Long64_t>(size);
+  return true;
+}
+
+//_____________________________________________________________________________
+const vector<Long64_t>& GetDBFileTimestamps( const string& path,
+                                             const DBFileStat_t& st )
+{
+  // Sorted list of all time stamps in the database file at 'path'.
+  // Files are scanned only once per modification.
+
+  struct Timestamps_t {
+    DBFileStat_t     stat;
+    vector<Long64_t> dates;
+  };
+  static thread_local map<string, Timestamps_t> cache;
+
+  auto& entry = cache[path];
+  if( entry.stat.mtime == st.mtime && entry.stat.size == st.size &&
+      !entry.dates.empty() )
+    return entry.dates;
+
+  entry.stat = st;
+  entry.dates.clear();
+  ifstream ifs(path);
+  string line;
+  Long64_t date = 0;
+  while( getline(ifs, line) ) {
+    // Commented-out time stamps are included. This can only narrow the
+    // validity window.
+    if( line.find('[') != string::npos && IsDBdate(line, date, false) )
+      entry.dates.push_back(date);
+  }
+  ranges::sort(entry.dates);
+  // Mark file as scanned even if it has no time stamps
+  entry.dates.insert(entry.dates.begin(), numeric_limits<Long64_t>::min());
+  return entry.dates;
+}
+
+//_____________________________________________________________________________
+string FindDBFile( const char* name, const TDatime& date )
+{
+  // Absolute path of the file that OpenDBFile would open for 'name' and
+  // 'date', or empty if none
+
+  for( fs::path fpath: GetDBFileList(name, date, "DBFingerprint") ) {
+    if( !gSystem->AccessPathName(fpath.c_str(), kReadPermission) ) //sic
+      return fpath.is_absolute() ? fpath : fs::current_path() / fpath;
+  }
+  return {};
+}
+
+} // anonymous namespace
+
+//_____________________________________________________________________________
+DBFingerprint::Recorder::Recorder( DBFingerprint& fp, const TDatime& date )
+  : fFP(fp), fPrev(current_fingerprint)
+{
+  fFP.Clear();
+  WithDefaultTZ(fFP.fDate = date.Convert());
+  current_fingerprint = &fFP;
+}
+
+//_____________________________________________________________________________
+DBFingerprint::Recorder::~Recorder()
+{
+  current_fingerprint = fPrev;
+}
+
+//_____________________________________________________________________________
+void DBFingerprint::Clear()
+{
+  fFiles.clear();
+  fDate = 0;
+  fComplete = false;
+}
+
+//_____________________________________________________________________________
+void DBFingerprint::Record( const char* name, const string& path )
+{
+  // Add database file 'name', opened at 'path', to the active fingerprint.
+  // Determine the time interval around the recording date during which the
+  // file's contents are the same.
+
+  DBFingerprint* fp = current_fingerprint;
+  if( !fp || !name )
+    return;
+  for( const auto& file: fp->fFiles ) {
+    if( file.name == name && file.path == path )
+      return;
+  }
+  File_t file{name, path, 0, 0, numeric_limits<Long64_t>::min(),
+              numeric_limits<Long64_t>::max()};
+  if( !path.empty() ) {
+    DBFileStat_t st{};
+    if( !GetDBFileStat(path, st) ) {
+      // Should not happen since the file was just opened. Make sure the
+      // fingerprint is never valid.
+      fp->fComplete = false;
+      file.begin = file.end = fp->fDate;
+    } else {
+      file.mtime = st.mtime;
+      file.size = st.size;
+      const auto& dates = GetDBFileTimestamps(path, st);
+      auto it = ranges::upper_bound(dates, fp->fDate);
+      file.begin = *std::prev(it);
+      if( it != dates.end() )
+        file.end = *it;
+    }
+  }
+  fp->fFiles.push_back(std::move(file));
+}
+
+//_____________________________________________________________________________
+Bool_t DBFingerprint::IsValidFor( const TDatime& date ) const
+{
+  // Return true if reading the recorded database files for 'date' would give
+  // the same results as for the recorded date. This is the case if
+  //  - each file name resolves to the same file (the search path depends on
+  //    the date, see GetDBFileList), and
+  //  - the files have not been modified, and
+  //  - 'date' falls into the same interval between time stamps in each file.
+
+  if( !fComplete )
+    return false;
+  WithDefaultTZ(Long64_t ldate = date.Convert());
+  try {
+    for( const auto& file: fFiles ) {
+      if( ldate < file.begin || ldate >= file.end )
+        return false;
+      if( FindDBFile(file.name.c_str(), date) != file.path )
+        return false;
+      if( file.path.empty() )
+        continue;
+      DBFileStat_t st{};
+      if( !GetDBFileStat(file.path, st) ||
+          st.mtime != file.mtime || st.size != file.size )
+        return false;
+    }
+  }
+  catch( const fs::filesystem_error& ) {
+    return false;
+  }
+  return true;
+}
+
 //_____________________________________________________________________________
 // Timezone handling
 const char* const gDefaultTZString = "US/Eastern";
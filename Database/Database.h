@@ -46,6 +46,8 @@ template<class T> // instantiations available for all supported types (see VarTy
 Int_t    LoadDBvalue( FILE* file, const TDatime& date, const char* key, T& value );
 Int_t    LoadDBvalue( FILE* file, const TDatime& date, const char* key, std::string& value );
 Int_t    LoadDBvalue( FILE* file, const TDatime& date, const char* key, TString& value );
+// Directory for on-disk indexes of database files (default: none)
+void     SetDBIndexCacheDir( const char* dir );
 template <class T>
 Int_t    LoadDBarray( FILE* file, const TDatime& date, const char* key, std::vector<T>& values );
 template <class T>
@@ -61,6 +63,51 @@ Int_t    SeekDBdate( std::istream& istr, const TDatime& date, Bool_t end_on_tag
 Bool_t   IsDBtimestamp( const std::string& line, TDatime& keydate );
 Bool_t   IsDBtimestamp( const std::string& line, Long64_t& keydate );
 
+// Record of the database files read for a given date. Used to decide whether
+// reading the database for another date would give the same results.
+class DBFingerprint {
+public:
+  DBFingerprint() : fDate(0), fComplete(false) {}
+
+  // While a Recorder exists, the database files opened by the current thread
+  // via OpenDBFile are recorded in 'fp', which is cleared first. Recorders
+  // may be nested; files are recorded only by the innermost one.
+  class Recorder {
+  public:
+    Recorder( DBFingerprint& fp, const TDatime& date );
+    ~Recorder();
+    Recorder( const Recorder& ) = delete;
+    Recorder& operator=( const Recorder& ) = delete;
+    // Declare that all inputs for this date were recorded
+    void Commit() { fFP.fComplete = true; }
+  private:
+    DBFingerprint& fFP;
+    DBFingerprint* fPrev;
+  };
+
+  void     Clear();
+  UInt_t   GetNFiles() const { return static_cast<UInt_t>(fFiles.size()); }
+  // True if the recorded files are unchanged and, for 'date', resolve to the
+  // same paths and the same time-stamped sections as for the recorded date
+  Bool_t   IsValidFor( const TDatime& date ) const;
+
+  // Called by OpenDBFile. 'path' is empty if the file was not found.
+  static void Record( const char* name, const std::string& path );
+
+private:
+  struct File_t {
+    std::string name;    // Name requested from OpenDBFile
+    std::string path;    // Absolute path of file opened, or empty
+    Long64_t    mtime;   // Modification time of file
+    Long64_t    size;    // Size of file
+    Long64_t    begin;   // Validity window of the file's contents
+    Long64_t    end;     //  as determined by its time stamps
+  };
+  std::vector<File_t> fFiles;
+  Long64_t fDate;      // Date of recording (Unix time)
+  Bool_t   fComplete;  // All inputs recorded, see Recorder::Commit()
+};
+
 // Time zone to assume for legacy database time stamps without time zone offsets.
 // The default is "US/Eastern".
 void     SetDefaultTZ( const char* tz = nullptr );
@@ -8,6 +8,7 @@
 #include "THaDetectorBase.h"
 #include "Fadc250Module.h"
 #include "Decoder.h"
+#include <span>
 #include <stdexcept>
 
 using namespace std;
@@ -98,18 +99,12 @@ Int_t FADCData::ReadConfig( FILE* file, const TDatime& date, const char* prefix
 
 //_____________________________________________________________________________
 static inline
-OptUInt_t GetFADCValue( EModuleType type, const DigitizerHitInfo_t& hitinfo,
-                        Fadc250Module* fadc ) {
-  // Get item "type" from FADC module pointed to by fFADC
+OptUInt_t GetFADCValue( span<const uint32_t> data, UInt_t hit ) {
+  // Get element 'hit' of FADC data 'data', if present
 
-  assert(fadc);
   OptUInt_t val;
-  if( fadc->HasCapability(type) &&
-      hitinfo.hit < fadc->GetNumEvents(type, hitinfo.chan) ) {
-    val = fadc->GetData(type, hitinfo.chan, hitinfo.hit);
-    if( val == kMaxUInt ) // error return code
-      val = nullopt;
-  }
+  if( hit < data.size() )
+    val = data[hit];
   return val;
 }
 
@@ -123,7 +118,8 @@ OptUInt_t FADCData::LoadFADCData( const DigitizerHitInfo_t& hitinfo )
     throw logic_error("Bad module type (expected Fadc250Module). "
                       "Should never happen. Call expert.");
 
-  return GetFADCValue( kPulseIntegral, hitinfo, fadc );
+  return GetFADCValue(fadc->GetPulseData(kPulseIntegral, hitinfo.chan),
+                      hitinfo.hit);
 }
 
 //_____________________________________________________________________________
@@ -144,11 +140,18 @@ Int_t FADCData::StoreHit( const DigitizerHitInfo_t& hitinfo, UInt_t data )
   auto* fadc = dynamic_cast<Fadc250Module*>(hitinfo.module);
   assert(fadc);  // should have been caught in LoadData
 
+  const UInt_t chan = hitinfo.chan, hit = hitinfo.hit;
+  // Firmware versions < 2 report a single pedestal for all pulses
+  const UInt_t iped = (fadc->GetFirmware() >= 2) ? hit : 0;
+
   auto& FDAT = fFADCData[k];
   FDAT.fIntegral  = data;
-  FDAT.fOverflow  = fadc->GetOverflowBit(hitinfo.chan, hitinfo.hit);
-  FDAT.fUnderflow = fadc->GetUnderflowBit(hitinfo.chan, hitinfo.hit);
-  FDAT.fPedq      = fadc->GetPedestalQuality(hitinfo.chan, hitinfo.hit);
+  FDAT.fOverflow  =
+    GetFADCValue(fadc->GetOverflowBits(chan), hit).value_or(kMaxUInt);
+  FDAT.fUnderflow =
+    GetFADCValue(fadc->GetUnderflowBits(chan), hit).value_or(kMaxUInt);
+  FDAT.fPedq      =
+    GetFADCValue(fadc->GetPedestalQualities(chan), iped).value_or(kMaxUInt);
 
   class TypeItem { public: EModuleType type; const string name; };
   static const vector<TypeItem> items = {
@@ -158,7 +161,8 @@ Int_t FADCData::StoreHit( const DigitizerHitInfo_t& hitinfo, UInt_t data )
   };
 
   for( const auto& item : items ) {
-    OptUInt_t val = GetFADCValue(item.type, hitinfo, fadc);
+    OptUInt_t val = GetFADCValue(fadc->GetPulseData(item.type, chan),
+                                 item.type == kPulsePedestal ? iped : hit);
     if( !val ) {
       string s("Error retrieving FADC item type ");
       s += item.name; s += ". Decoder bug. Call expert.";
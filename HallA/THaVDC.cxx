@@ -27,7 +27,10 @@
 #include "TROOT.h"
 #include "THaString.h"
 #include "TimeCorrectionModule.h"
+#include "Helper.h"
 #include <map>
+#include <algorithm>
+#include <vector>
 #include <cstdio>
 #include <cstdlib>
 #include <cassert>
@@ -475,7 +478,6 @@ Int_t THaVDC::ConstructTracks( TClonesArray* tracks, Int_t mode )
   // them to 'tracks'
 
   // TODO:
-  //   Only make combos whose projections are close
   //   do a real 3D fit, not just compute 3D chi2?
 
 #ifdef WITH_DEBUG
@@ -517,11 +519,53 @@ Int_t THaVDC::ConstructTracks( TClonesArray* tracks, Int_t mode )
 
   Int_t nPairs  = 0;  // Number of point pairs to consider
 
+  // The matching error of a pair is the sum of the squared distances between
+  // each point's projection into the other plane and the other point. Every
+  // component of these distances must therefore be smaller than
+  // sqrt(fErrorCutoff). Index the upper points by x so that, for each lower
+  // point, only upper points near its projection are tried. Points with
+  // undefined coordinates are always tried, as before.
+  Double_t maxdist = TMath::Sqrt(fErrorCutoff) * (1.0 + 1e-9);
+  vector<pair<Double_t, Int_t>> upperByX;   // (x, index) of upper points
+  vector<Int_t> upperAlways, candidates;
+  upperByX.reserve(nUpper);
+  for( int j = 0; j < nUpper; j++ ) {
+    THaVDCPoint* upperPoint = fUpper->GetPoint(j);
+    Double_t x = upperPoint->GetX();
+    if( TMath::Finite(x) && TMath::Finite(upperPoint->GetY()) &&
+        TMath::Finite(upperPoint->GetTheta()) &&
+        TMath::Finite(upperPoint->GetPhi()) )
+      upperByX.emplace_back(x, j);
+    else
+      upperAlways.push_back(j);
+  }
+  sort(ALL(upperByX));
+
   for( int i = 0; i < nLower; i++ ) {
     THaVDCPoint* lowerPoint = fLower->GetPoint(i);
     assert(lowerPoint);
 
-    for( int j = 0; j < nUpper; j++ ) {
+    // Upper points within maxdist of the lower point's projection,
+    // in the original order so that the pairs are created in the same order
+    Double_t px = lowerPoint->GetX() + fSpacing * lowerPoint->GetTheta();
+    Double_t py = lowerPoint->GetY() + fSpacing * lowerPoint->GetPhi();
+    candidates.clear();
+    if( TMath::Finite(px) && TMath::Finite(py) ) {
+      auto it = lower_bound(ALL(upperByX),
+                            make_pair(px - maxdist, -1));
+      for( ; it != upperByX.end() && it->first <= px + maxdist; ++it ) {
+        Double_t y = fUpper->GetPoint(it->second)->GetY();
+        if( TMath::Abs(y - py) <= maxdist )
+          candidates.push_back(it->second);
+      }
+      candidates.insert(candidates.end(), ALL(upperAlways));
+      sort(ALL(candidates));
+    } else {
+      for( int j = 0; j < nUpper; j++ )
+        candidates.push_back(j);
+    }
+
+    for( auto j: candidates ) {
       THaVDCPoint* upperPoint = fUpper->GetPoint(j);
       assert(upperPoint);
 
@@ -19,6 +19,7 @@
 #include "THaVDCPlane.h"
 #include "THaVDCPoint.h"
 #include "THaVDCCluster.h"
+#include "MethodThunk.h"
 #include "TMath.h"
 
 //_____________________________________________________________________________
@@ -107,6 +108,14 @@ Int_t THaVDCChamber::DefineVariables( EMode mode )
   if( ret )
     return ret;
 
+  // Direct calls of the per-point member functions below
+  using Podd::MethodThunk;
+  [[maybe_unused]] static const Bool_t methods_registered =
+    MethodThunk::Register<&THaCluster::X>("X") &&
+    MethodThunk::Register<&THaCluster::Y>("Y") &&
+    MethodThunk::Register<&THaCluster::Z>("Z") &&
+    MethodThunk::Register<&THaVDCPoint::HasPartner>("HasPartner");
+
   RVarDef vars[] = {
     { "npt",       "Number of space points", "GetNPoints()" },
     { "pt.x",      "Point center x (m)",     "fPoints.THaVDCPoint.X()" },
@@ -27,9 +27,11 @@
 #include "TClass.h"
 #include "TMath.h"
 #include "VarDef.h"
+#include "MethodThunk.h"
 #include "THaApparatus.h"
 #include "Helper.h"
 
+#include <algorithm>
 #include <cstring>
 #include <vector>
 #include <iostream>
@@ -447,6 +449,14 @@ Int_t THaVDCPlane::DefineVariables( EMode mode )
 
   // Register variables in global list
 
+  // Direct calls of the per-hit and per-cluster member functions below
+  using Podd::MethodThunk;
+  [[maybe_unused]] static const Bool_t methods_registered =
+    MethodThunk::Register<&THaVDCHit::GetWireNum>("GetWireNum") &&
+    MethodThunk::Register<&THaVDCCluster::GetSize>("GetSize") &&
+    MethodThunk::Register<&THaVDCCluster::GetPivotWireNum>("GetPivotWireNum") &&
+    MethodThunk::Register<&THaVDCCluster::GetTrackIndex>("GetTrackIndex");
+
   RVarDef vars[] = {
     { "nhit",   "Number of hits",             "GetNHits()" },
     { "wire",   "Active wire numbers",        "fHits.THaVDCHit.GetWireNum()" },
@@ -714,14 +724,28 @@ Int_t THaVDCPlane::FindClusters()
 
   TimeCut timecut(fVDC, this);
 
-  Int_t nHits = GetNHits();   // Number of hits in the plane
   Int_t nUsed = 0;                // Number of wires used in clustering
   Int_t nLastUsed = -1;
   Int_t nextClust = 0;            // Current cluster number
   assert(GetNClusters() == 0);
 
+  // Hits within the time cut, in wire order. Each pass only looks at these.
+  // Hits that a pass assigns to a cluster candidate (cluster number -2 or
+  // >= 0) are removed after the pass since later passes ignore them.
+  vector<THaVDCHit*> hits;
+  hits.reserve(GetNHits());
+  for( Int_t i = 0; i < GetNHits(); ++i ) {
+    THaVDCHit* hit = GetHit(i);
+    assert(hit);
+    if( timecut(hit) )
+      hits.push_back(hit);
+  }
+  auto is_spent = []( const THaVDCHit* hit ) {
+    return hit->GetClsNum() != -1 && hit->GetClsNum() != -3;
+  };
+
   vector<THaVDCHit*> clushits;
-  clushits.reserve(nHits);
+  clushits.reserve(hits.size());
 
   fNpass = 0;
 
@@ -729,18 +753,14 @@ Int_t THaVDCPlane::FindClusters()
   while( nLastUsed != nUsed ) {
     fNpass++;
     nLastUsed = nUsed;
+    Int_t nHits = static_cast<Int_t>(hits.size());
     //Loop through all TDC hits
     for( Int_t i = 0; i < nHits; ) {
       clushits.clear();
       Bool_t falling = true;
 
-      THaVDCHit* hit = GetHit(i);
-      assert(hit);
+      THaVDCHit* hit = hits[i];
 
-      if( !timecut(hit) ) {
-        ++i;
-        continue;
-      }
       if( hit->GetClsNum() != -1 ) {
         ++i;
         continue;
@@ -758,10 +778,7 @@ Int_t THaVDCPlane::FindClusters()
       Int_t nwires = 1;
       while( ++i < nHits ) {
 
-        THaVDCHit* nextHit = GetHit(i);
-        assert(nextHit);    // should never happen, else bug in Decode
-        if( !timecut(nextHit))
-          continue;
+        THaVDCHit* nextHit = hits[i];
         if( nextHit->GetClsNum() != -1  && // -1 is virgin
             nextHit->GetClsNum() != -3 )   // -3 was considered to start a cluster but is not in cluster
           continue;
@@ -846,6 +863,16 @@ Int_t THaVDCPlane::FindClusters()
 
     } //end loop over hits
 
+    if( nUsed != nLastUsed ) {
+      hits.erase(remove_if(ALL(hits), is_spent), hits.end());
+      // Without unused hits, another pass cannot start any new cluster.
+      // Count it as done.
+      if( none_of(ALL(hits), []( const THaVDCHit* hit ) {
+            return hit->GetClsNum() == -1; }) ) {
+        fNpass++;
+        break;
+      }
+    }
   } // end passes over hits
 
   assert(GetNClusters() == nextClust);
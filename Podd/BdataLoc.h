@@ -64,6 +64,7 @@ public:
   virtual UInt_t  NumHits() const               { return DidLoad() ? 1 : 0; }
   virtual UInt_t  Get( UInt_t i = 0 ) const     { assert(DidLoad() && i == 0); return data; }
   virtual void    Print( Option_t* opt="" ) const;
+  UInt_t          GetCrate() const              { return crate; }
   //TODO: Needed?
   Bool_t operator==( const char* aname ) const  { return fName == aname; }
   // operator== and != compare the hardware definitions of two BdataLoc's
@@ -169,6 +170,11 @@ public:
   virtual const char* GetTypeKey() const  { return fgThisType->fDBkey; };
   virtual void    Print( Option_t* opt="" ) const;
 
+  UInt_t  GetHeader()  const { return header; }
+  UInt_t  GetNtoskip() const { return ntoskip; }
+  // Set data found by an external search for the header, see DecData
+  void    SetData( UInt_t word ) { data = word; }
+
   // virtual Bool_t operator==( const BdataLoc& rhs ) const
   // { return (crate == rhs.crate &&
   // 	    header == rhs.header && ntoskip == rhs.ntoskip); }
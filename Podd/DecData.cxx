@@ -82,6 +82,7 @@
 #include <cstdio>
 #include <cassert>
 #include <memory>
+#include <algorithm>
 
 using namespace std;
 
@@ -130,6 +131,8 @@ void DecData::Reset( Option_t* opt )
   // Reset the class. Removes all data channel definitions
 
   Clear(opt);
+  fWordSearch.clear();
+  fOtherLocs.clear();
   fBdataLoc.Clear();
 }
 
@@ -318,6 +321,8 @@ Int_t DecData::ReadDatabase( const TDatime& date )
   Bool_t re_init = fIsInit;
   fIsInit = false;
   if( !re_init ) {
+    fWordSearch.clear();
+    fOtherLocs.clear();
     fBdataLoc.Clear();
   }
 
@@ -372,7 +377,120 @@ THaAnalysisObject::EStatus DecData::Init( const TDatime& run_time )
 
   // Standard analysis object init, calls MakePrefix(), ReadDatabase()
   // and DefineVariables(), and Clear("I")
-  return THaAnalysisObject::Init( run_time ); // NOLINT(*-parent-virtual-call)
+  EStatus status = THaAnalysisObject::Init( run_time ); // NOLINT(*-parent-virtual-call)
+  if( status == kOK )
+    BuildWordSearch();
+  return status;
+}
+
+//_____________________________________________________________________________
+void DecData::BuildWordSearch()
+{
+  // Group the WordLoc channels by crate, so that Decode() can find all
+  // their header words in a single pass over each crate buffer. All other
+  // channels, including ones of classes derived from WordLoc, which may
+  // implement their own Load(), are loaded individually.
+
+  fWordSearch.clear();
+  fOtherLocs.clear();
+  TIter next( &fBdataLoc );
+  while( auto* dataloc = static_cast<BdataLoc*>(next()) ) {
+    if( dataloc->IsA() != WordLoc::Class() ) {
+      fOtherLocs.push_back(dataloc);
+      continue;
+    }
+    auto* loc = static_cast<WordLoc*>(dataloc);
+    auto it = find_if( fWordSearch.begin(), fWordSearch.end(),
+                       [loc]( const WordSearch& ws ) {
+                         return ws.GetCrate() == loc->GetCrate();
+                       });
+    if( it == fWordSearch.end() ) {
+      fWordSearch.emplace_back(loc->GetCrate());
+      it = prev(fWordSearch.end());
+    }
+    it->Add(loc);
+  }
+  for( auto& ws : fWordSearch )
+    ws.Build();
+}
+
+//_____________________________________________________________________________
+static inline UInt_t HashWord( UInt_t word, UInt_t shift )
+{
+  // Multiplicative (Fibonacci) hash, giving 32-shift bits
+  return (word * 2654435769U) >> shift;
+}
+
+//_____________________________________________________________________________
+void DecData::WordSearch::Build()
+{
+  // Set up the hash table of header words. The table is kept at most 1/4
+  // full, so nearly all words in the crate buffer that are not header words
+  // are rejected by the first probe.
+
+  stable_sort( fLocs.begin(), fLocs.end(),
+               []( const WordLoc* a, const WordLoc* b ) {
+                 return a->GetHeader() < b->GetHeader();
+               });
+  fDone.assign(fLocs.size(), 0);
+  size_t nslots = 16;
+  UInt_t bits = 4;
+  while( nslots < 4 * fLocs.size() ) {
+    nslots *= 2;
+    ++bits;
+  }
+  fShift = 32 - bits;
+  fSlots.assign(nslots, Slot_t{0, kMaxUInt, kMaxUInt});
+  fMinSkip = kMaxUInt;
+  const auto mask = static_cast<UInt_t>(nslots - 1);
+  for( UInt_t i = 0, j = 0; i < fLocs.size(); i = j ) {
+    UInt_t header = fLocs[i]->GetHeader();
+    for( ; j < fLocs.size() && fLocs[j]->GetHeader() == header; ++j )
+      fMinSkip = min(fMinSkip, fLocs[j]->GetNtoskip());
+    UInt_t k = HashWord(header, fShift);
+    while( fSlots[k].first != kMaxUInt )
+      k = (k + 1) & mask;
+    fSlots[k] = {header, i, j};
+  }
+}
+
+//_____________________________________________________________________________
+void DecData::WordSearch::Load( const THaEvData& evdata )
+{
+  // Load the data of all WordLocs of this crate with one pass over the
+  // crate buffer. The result is the same as that of WordLoc::Load for
+  // each of them: the first occurrence of the header word, starting at
+  // word 2 of the buffer, determines the data word, provided the latter
+  // lies within the buffer.
+
+  UInt_t roclen = evdata.GetRocLength(fCrate);
+  if( fLocs.empty() || roclen < fMinSkip+1 )
+    return;
+  const UInt_t* cratebuf = evdata.GetRawDataBuffer(fCrate);
+  assert(cratebuf);  // Must exist if roclen > 0
+
+  fill( fDone.begin(), fDone.end(), 0 );
+  size_t nleft = fLocs.size();
+  const auto mask = static_cast<UInt_t>(fSlots.size() - 1);
+  const UInt_t iend = roclen - fMinSkip;  // Last possible header position
+  for( UInt_t i = 2; i <= iend && nleft > 0; ++i ) {
+    const UInt_t word = cratebuf[i];
+    UInt_t k = HashWord(word, fShift);
+    while( fSlots[k].first != kMaxUInt && fSlots[k].header != word )
+      k = (k + 1) & mask;
+    const Slot_t& slot = fSlots[k];
+    if( slot.first == kMaxUInt )
+      continue;
+    for( UInt_t j = slot.first; j < slot.last; ++j ) {
+      if( fDone[j] )
+        continue;
+      fDone[j] = 1;
+      --nleft;
+      UInt_t ntoskip = fLocs[j]->GetNtoskip();
+      if( ntoskip <= roclen - i )
+        fLocs[j]->SetData(cratebuf[i + ntoskip]);
+    }
+  }
 }
 
 //_____________________________________________________________________________
@@ -387,17 +505,14 @@ Int_t DecData::Decode(const THaEvData& evdata)
 
   evtype = evdata.GetEvType();   // CODA event type
 
-  // For each raw data source registered in fBdataLoc, get the data
-
-  //TODO: accelerate search for multiple header words in same crate
-  //- group WordLoc objects by crate
-  //- for each crate with >1 WordLoc defs, make a MultiWordLoc
-  //- MultiWordLoc uses faster search algo to scan crate buffer
+  // For each raw data source registered in fBdataLoc, get the data.
+  // The header words of WordLoc channels are searched for per crate,
+  // all at once (see BuildWordSearch).
 
-  TIter next( &fBdataLoc );
-  while( auto* dataloc = static_cast<BdataLoc*>(next()) ) {
+  for( auto* dataloc : fOtherLocs )
     dataloc->Load( evdata );
-  }
+  for( auto& ws : fWordSearch )
+    ws.Load( evdata );
 
   if( fDebug>1 )
     Print();
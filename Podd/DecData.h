@@ -10,6 +10,7 @@
 #include "THaApparatus.h"
 #include "THashList.h"
 #include "BdataLoc.h"
+#include <vector>
 
 class TString;
 
@@ -43,6 +44,33 @@ protected:
   Int_t           DefineLocType( const BdataLoc::BdataLocType& loctype,
 				 const TString& configstr, bool re_init );
 
+  // Search for the header words of all WordLoc channels of one crate in
+  // a single pass over the crate's data buffer
+  class WordSearch {
+  public:
+    explicit WordSearch( UInt_t crate ) : fCrate(crate), fShift(0), fMinSkip(kMaxUInt) {}
+    UInt_t GetCrate() const { return fCrate; }
+    void   Add( WordLoc* loc ) { fLocs.push_back(loc); }
+    void   Build();
+    void   Load( const THaEvData& evdata );
+  private:
+    struct Slot_t {
+      UInt_t header;  // Header word
+      UInt_t first;   // Range of WordLocs with this header in fLocs,
+      UInt_t last;    //  first = kMaxUInt if slot is empty
+    };
+    UInt_t fCrate;
+    UInt_t fShift;                  // 32 - log2(fSlots.size())
+    UInt_t fMinSkip;                // Smallest offset of any WordLoc
+    std::vector<WordLoc*> fLocs;    // WordLocs, sorted by header
+    std::vector<Slot_t>   fSlots;   // Hash table of header words
+    std::vector<char>     fDone;    // fLocs[i] loaded in current event
+  };
+  std::vector<WordSearch> fWordSearch; //! WordLoc channels by crate
+  std::vector<BdataLoc*>  fOtherLocs;  //! Channels that load themselves
+
+  void            BuildWordSearch();
+
   // Expansion hooks for ReadDatabase
   virtual Int_t   SetupDBVersion( FILE* file, Int_t db_version );
   virtual Int_t   GetConfigstr( FILE* file, const TDatime& date,
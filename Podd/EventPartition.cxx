@@ -0,0 +1,176 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// Podd::EventPartition
+//
+// In an event-parallel replay, every worker reads and decodes all events
+// of the run, but only analyzes its own share of the physics events.
+// Physics events are grouped into blocks of consecutive events, and the
+// blocks are assigned to the workers in turn. A worker fills the output
+// tree only for its own blocks and records the number of tree entries at
+// the end of each of them. From these numbers, the parent process can
+// copy the workers' tree entries in the original event order.
+//
+// WorkerReport is the small binary file in which a worker hands these
+// numbers, its statistics counters, and its cut statistics to the parent.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "EventPartition.h"
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+using namespace std;
+
+namespace Podd {
+
+//_____________________________________________________________________________
+EventPartition::EventPartition( UInt_t nworkers, UInt_t worker,
+                                ULong64_t blocksize )
+  : fNWorkers(nworkers > 0 ? nworkers : 1)
+  , fWorker(worker)
+  , fBlockSize(blocksize > 0 ? blocksize : kDefaultBlockSize)
+  , fCurBlock(-1)
+  , fStop(nullptr)
+{
+  assert(fWorker < fNWorkers);
+}
+
+//_____________________________________________________________________________
+void EventPartition::Next( ULong64_t iphys, Long64_t nentries )
+{
+  auto block = static_cast<Long64_t>(Block(iphys));
+  if( block == fCurBlock )
+    return;
+  // Close the previous block, if it was ours
+  if( fCurBlock >= 0 && fCurBlock % fNWorkers == fWorker )
+    fEnds.push_back(nentries);
+  fCurBlock = block;
+}
+
+//_____________________________________________________________________________
+void EventPartition::Finish( Long64_t nentries )
+{
+  if( fCurBlock >= 0 && fCurBlock % fNWorkers == fWorker )
+    fEnds.push_back(nentries);
+  fCurBlock = -1;
+}
+
+//_____________________________________________________________________________
+void EventPartition::Stop()
+{
+  if( !fStop || fCurBlock < 0 )
+    return;
+  Long64_t last = fStop->load();
+  while( fCurBlock < last && !fStop->compare_exchange_weak(last, fCurBlock) )
+    ;
+}
+
+//_____________________________________________________________________________
+vector<EventPartition::Range_t>
+EventPartition::MergeOrder( const vector<vector<Long64_t>>& ends,
+                            Long64_t lastblock )
+{
+  vector<Range_t> ranges;
+  auto nworkers = static_cast<UInt_t>(ends.size());
+  if( nworkers == 0 )
+    return ranges;
+  for( ULong64_t block = 0;
+       lastblock < 0 || block <= static_cast<ULong64_t>(lastblock); ++block ) {
+    UInt_t worker = block % nworkers;
+    ULong64_t j = block / nworkers;
+    const auto& e = ends[worker];
+    // Blocks are consecutive, so the first missing one ends the replay
+    if( j >= e.size() )
+      break;
+    Long64_t first = j > 0 ? e[j-1] : 0;
+    if( e[j] > first )
+      ranges.push_back({worker, first, e[j]});
+  }
+  return ranges;
+}
+
+namespace {
+
+const char     kReportMagic[8] = { 'P','o','d','d','W','R','e','p' };
+const UInt_t   kReportVersion = 1;
+
+//_____________________________________________________________________________
+template<typename T>
+inline bool WriteBin( FILE* fo, const T& x )
+{
+  static_assert(is_trivially_copyable_v<T>);
+  return fwrite(&x, sizeof(x), 1, fo) == 1;
+}
+template<typename T>
+inline bool WriteBin( FILE* fo, const vector<T>& v )
+{
+  auto n = static_cast<ULong64_t>(v.size());
+  return WriteBin(fo, n) &&
+         (n == 0 || fwrite(v.data(), sizeof(T), n, fo) == n);
+}
+template<typename T>
+inline bool ReadBin( FILE* fi, T& x )
+{
+  static_assert(is_trivially_copyable_v<T>);
+  return fread(&x, sizeof(x), 1, fi) == 1;
+}
+template<typename T>
+inline bool ReadBin( FILE* fi, vector<T>& v )
+{
+  ULong64_t n = 0;
+  if( !ReadBin(fi, n) || n > (1ULL<<32) )
+    return false;
+  v.resize(n);
+  return n == 0 || fread(v.data(), sizeof(T), n, fi) == n;
+}
+
+} // namespace
+
+//_____________________________________________________________________________
+Bool_t WorkerReport::Write( const string& path ) const
+{
+  // Write this report to 'path'. Returns true on success.
+
+  FILE* fo = fopen(path.c_str(), "wb");
+  if( !fo )
+    return false;
+  bool ok =
+    fwrite(kReportMagic, sizeof(kReportMagic), 1, fo) == 1 &&
+    WriteBin(fo, kReportVersion) &&
+    WriteBin(fo, counters) && WriteBin(fo, ncalled) &&
+    WriteBin(fo, npassed) && WriteBin(fo, blockends) &&
+    WriteBin(fo, nev) && WriteBin(fo, nanalyzed) &&
+    WriteBin(fo, status) &&
+    WriteBin(fo, terminate) && WriteBin(fo, fatal);
+  return (fclose(fo) == 0) && ok;
+}
+
+//_____________________________________________________________________________
+Bool_t WorkerReport::Read( const string& path )
+{
+  // Read a report written by Write(). Returns true on success.
+
+  unique_ptr<FILE, int(*)(FILE*)> fi{fopen(path.c_str(), "rb"), fclose};
+  if( !fi )
+    return false;
+  char magic[sizeof(kReportMagic)];
+  UInt_t version = 0;
+  WorkerReport rep;
+  if( fread(magic, sizeof(magic), 1, fi.get()) != 1 ||
+      memcmp(magic, kReportMagic, sizeof(magic)) != 0 ||
+      !ReadBin(fi.get(), version) || version != kReportVersion ||
+      !ReadBin(fi.get(), rep.counters) || !ReadBin(fi.get(), rep.ncalled) ||
+      !ReadBin(fi.get(), rep.npassed) || !ReadBin(fi.get(), rep.blockends) ||
+      !ReadBin(fi.get(), rep.nev) || !ReadBin(fi.get(), rep.nanalyzed) ||
+      !ReadBin(fi.get(), rep.status) ||
+      !ReadBin(fi.get(), rep.terminate) || !ReadBin(fi.get(), rep.fatal) ||
+      rep.ncalled.size() != rep.npassed.size() )
+    return false;
+  *this = std::move(rep);
+  return true;
+}
+
+} // namespace Podd
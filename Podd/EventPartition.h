@@ -0,0 +1,104 @@
+#ifndef Podd_EventPartition_h_
+#define Podd_EventPartition_h_
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Podd::EventPartition
+//
+// Assignment of physics events to the workers of an event-parallel
+// replay (see THaAnalyzer::SetNumWorkers), and the order in which the
+// workers' output is merged.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "Rtypes.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace Podd {
+
+class EventPartition {
+
+public:
+  // Physics events per block if not specified
+  static constexpr ULong64_t kDefaultBlockSize = 100;
+
+  EventPartition( UInt_t nworkers, UInt_t worker,
+                  ULong64_t blocksize = kDefaultBlockSize );
+
+  UInt_t    GetNWorkers()  const { return fNWorkers; }
+  UInt_t    GetWorker()    const { return fWorker; }
+  ULong64_t GetBlockSize() const { return fBlockSize; }
+
+  // Block and worker of physics event 'iphys', counting from 0
+  ULong64_t Block( ULong64_t iphys ) const { return iphys / fBlockSize; }
+  UInt_t    Owner( ULong64_t iphys ) const { return Block(iphys) % fNWorkers; }
+  Bool_t    IsMine( ULong64_t iphys ) const { return Owner(iphys) == fWorker; }
+
+  // Call for each physics event before it is analyzed. 'nentries' is the
+  // number of entries in this worker's output tree so far.
+  void      Next( ULong64_t iphys, Long64_t nentries );
+  // Call once all events have been analyzed
+  void      Finish( Long64_t nentries );
+  // Block currently being analyzed, -1 if none yet
+  Long64_t  GetCurrentBlock() const { return fCurBlock; }
+
+  // Stopping early. 'stop' is shared by all workers and holds the last
+  // block to be analyzed. Stop() makes the current block the last one
+  // unless an earlier one has been set. IsStopped() is true once this
+  // worker has moved past the last block.
+  void      SetStopFlag( std::atomic<Long64_t>* stop ) { fStop = stop; }
+  void      Stop();
+  Bool_t    IsStopped() const
+  { return fStop && fCurBlock > fStop->load(std::memory_order_relaxed); }
+
+  // Number of output tree entries at the end of each of this worker's
+  // blocks, in the order analyzed
+  const std::vector<Long64_t>& GetBlockEnds() const { return fEnds; }
+
+  // Range of entries [first,last) of the output tree of 'worker'
+  struct Range_t {
+    UInt_t   worker;
+    Long64_t first, last;
+  };
+  // Ranges of the workers' output trees in event order, given the block
+  // ends reported by each worker. Stops after 'lastblock' if >= 0.
+  static std::vector<Range_t>
+  MergeOrder( const std::vector<std::vector<Long64_t>>& ends,
+              Long64_t lastblock = -1 );
+
+private:
+  UInt_t    fNWorkers;   // Number of workers
+  UInt_t    fWorker;     // This worker
+  ULong64_t fBlockSize;  // Physics events per block
+  Long64_t  fCurBlock;   // Block of the last event passed to Next()
+  std::atomic<Long64_t>* fStop;  // Last block to analyze, shared by workers
+  std::vector<Long64_t> fEnds;
+};
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Results of one worker that the parent process needs for merging, other
+// than the contents of the worker's output file
+//
+//////////////////////////////////////////////////////////////////////////
+
+struct WorkerReport {
+  std::vector<ULong64_t> counters;   // Analyzer statistics counters
+  std::vector<UInt_t>    ncalled;    // Cut statistics, in the order of gHaCuts
+  std::vector<UInt_t>    npassed;
+  std::vector<Long64_t>  blockends;  // See EventPartition::GetBlockEnds()
+  ULong64_t nev{0};          // Event count at end of replay
+  ULong64_t nanalyzed{0};    // Physics events analyzed for the run
+  Int_t     status{0};       // Last read status
+  Bool_t    terminate{false};
+  Bool_t    fatal{false};
+
+  Bool_t Write( const std::string& path ) const;
+  Bool_t Read( const std::string& path );
+};
+
+} // namespace Podd
+
+#endif
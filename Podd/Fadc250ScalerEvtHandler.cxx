@@ -112,18 +112,31 @@ Int_t Fadc250ScalerEvtHandler::Analyze(THaEvData *evdata)
     fScalerTree = new TTree(sname2,sname3);
     fScalerTree->SetAutoSave(200000000);
 
-    TString name = "evnum";
-    TString tinfo = name + "/l";
-    fScalerTree->Branch(name, &fEvNum, tinfo, 4000);
-
-    name = "evcount";
-    tinfo = name + "/l";
-    fScalerTree->Branch(name, &fEvCount, tinfo, 4000);
-
-    for( size_t i = 0; i < scalerloc.size(); i++) {
-      name = scalerloc[i]->name;
-      tinfo = name + "/D";
-      fScalerTree->Branch(name, &dvars[i], tinfo, 4000);
+    if( Podd::ScalerTreeBuffer::TypedBranchesEnabled() ) {
+      // One branch "scalers" with leaves "evnum" and "evcount" (ULong64_t)
+      // and one leaf per variable: counts as UInt_t, rates as Double_t
+      fTreeBuf.Clear();
+      fTreeBuf.Add("evnum", Podd::ScalerTreeBuffer::kULong64);
+      fTreeBuf.Add("evcount", Podd::ScalerTreeBuffer::kULong64);
+      for( const auto* loc: scalerloc )
+        fTreeBuf.Add(loc->name.Data(), loc->ikind == ICOUNT
+                     ? Podd::ScalerTreeBuffer::kUInt
+                     : Podd::ScalerTreeBuffer::kDouble);
+      fTreeBuf.Branch(fScalerTree, "scalers", kScalerBasketSize);
+    } else {
+      TString name = "evnum";
+      TString tinfo = name + "/l";
+      fScalerTree->Branch(name, &fEvNum, tinfo, kScalerBasketSize);
+
+      name = "evcount";
+      tinfo = name + "/l";
+      fScalerTree->Branch(name, &fEvCount, tinfo, kScalerBasketSize);
+
+      for( size_t i = 0; i < scalerloc.size(); i++) {
+        name = scalerloc[i]->name;
+        tinfo = name + "/D";
+        fScalerTree->Branch(name, &dvars[i], tinfo, kScalerBasketSize);
+      }
     }
   }  // if (!fScalerTree)
 
@@ -153,13 +166,22 @@ Int_t Fadc250ScalerEvtHandler::Analyze(THaEvData *evdata)
     return -1;
   }
 
-  // Pointer to start of bank data buffer (length = data.len_)
+  // Walk the blocks in the bank data buffer (length = data.len_) once,
+  // looking up each block header in the table of scaler headers
+  for( auto* s: scalers )
+    s->Clear();
   Bool_t ifound = false;
-  for( auto& scaler: scalers ) {
-    scaler->LoadSlot(nullptr, evdata->GetRawDataBuffer(),
-                     data.pos_, data.len_ );
-    if( scaler->IsDecoded() )
+  const UInt_t* p = evdata->GetRawDataBuffer() + data.pos_;
+  const UInt_t* pstop = p + data.len_;
+  while( p < pstop && !scalers.empty() ) {
+    UInt_t j = 0;
+    UInt_t nskip = fDispatch.Decode(p, pstop, j);
+    if( nskip > 0 )
       ifound = true;
+    else
+      // Not one of our scalers. Skip to the next block header.
+      nskip = 1 + scalers.front()->GetHeaderNumChan(*p);
+    p += nskip;
   }
 
   if( !ifound )
@@ -185,6 +207,13 @@ Int_t Fadc250ScalerEvtHandler::Analyze(THaEvData *evdata)
   fEvCount++;
   fEvNum = evdata->GetEvNum();
 
+  if( fTreeBuf.HasBranch() ) {
+    fTreeBuf.Set(0, fEvNum);
+    fTreeBuf.Set(1, fEvCount);
+    for( size_t i = 0; i < scalerloc.size(); i++ )
+      fTreeBuf.Set(static_cast<Int_t>(i + 2), dvars[i]);
+  }
+
   for( auto* s: scalers )
     s->Clear();
 
@@ -343,6 +372,9 @@ THaAnalysisObject::EStatus Fadc250ScalerEvtHandler::Init(const TDatime& date)
   // Identify indices of scalers[] vector to variables.
   SetIndices();
 
+  // Header word lookup table for Analyze()
+  fDispatch.Build(scalers);
+
   return kOK;
 }
 
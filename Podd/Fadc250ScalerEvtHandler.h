@@ -11,6 +11,8 @@
 
 #include "THaEvtTypeHandler.h"  // for THaEvtTypeHandler
 #include "TString.h"            // for TString, Rtypes, ClassDefOverride
+#include "ScalerDispatch.h"     // for ScalerDispatch
+#include "ScalerTreeBuffer.h"   // for ScalerTreeBuffer
 #include <string>               // for string
 #include <utility>              // for move
 #include <vector>               // for vector
@@ -47,12 +49,14 @@ protected:
    Int_t  imodel = 0;
    UInt_t icrate = 0;
    std::vector<Decoder::GenScaler*> scalers;
+   Decoder::ScalerDispatch fDispatch;  //! Header word lookup for scalers
    std::vector<FadcScalerLoc*> scalerloc;
    ULong64_t fEvCount;
    ULong64_t fEvNum;  // last seen physics event number
    UInt_t fNormIdx, fNormSlot;
    Double_t *dvars;
    TTree *fScalerTree;
+   Podd::ScalerTreeBuffer fTreeBuf;  //! Typed scaler tree branch, if enabled
 
    ClassDefOverride(Fadc250ScalerEvtHandler,0)  // Fadc250 scaler Event handler
 };
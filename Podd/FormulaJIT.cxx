@@ -0,0 +1,169 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// Podd::FormulaJIT
+//
+// A list of formulas and cuts compiled to a single native function.
+//
+// Each formula is translated from its bytecode (see THaFormula) to a
+// block of C++ statements. Variables are read directly from their fixed
+// addresses, and results of cuts evaluated earlier in the same function
+// are used directly. Results and counters of other cuts are read before
+// the function is called. The function is compiled with the ROOT
+// interpreter's JIT (Cling) when Compile() is called.
+//
+// Formulas that cannot be translated are rejected by Add(). The caller
+// is expected to evaluate them with the interpreter. Generated code
+// depends on the addresses of the variables, so it must be regenerated
+// whenever formulas are recompiled.
+//
+// Compilation adds noticeably to the initialization time and is disabled
+// by default. Enable it with FormulaJIT::SetEnabled() before initializing
+// the analyzer.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "FormulaJIT.h"
+#include "THaFormula.h"
+#include "THaCut.h"
+#include "TInterpreter.h"
+#include "TList.h"
+#include "TError.h"
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+
+using namespace std;
+
+namespace Podd {
+
+Bool_t FormulaJIT::fgEnabled = false;
+
+//_____________________________________________________________________________
+FormulaJIT::FormulaJIT( const char* name )
+  : fFunc(nullptr)
+{
+  // Constructor. 'name' is used to identify the generated function.
+
+  static UInt_t count = 0;
+  fName = "Podd_JIT_";
+  for( const char* c = name; c && *c; ++c )
+    fName += isalnum(static_cast<unsigned char>(*c)) ? *c : '_';
+  fName += "_" + to_string(count++);
+}
+
+//_____________________________________________________________________________
+Int_t FormulaJIT::Add( THaFormula* formula )
+{
+  // Translate 'formula' and append it to the function.
+  // Returns the index of its result, or -1 if it cannot be translated.
+
+  if( !formula || fFunc )
+    return -1;
+
+  auto idx = static_cast<Int_t>(fForm.size());
+  auto* cut = dynamic_cast<THaCut*>(formula);
+  auto next = fExt.size();
+  CutRef_t cutref = [this]( const THaCut* c, ECutValue what ) -> string {
+    if( !c )
+      return {};
+    auto it = find(fCut.begin(), fCut.end(), c);
+    if( it != fCut.end() ) {
+      // Counters of cuts in this function change while it runs
+      if( what != kResult )
+        return {};
+      return "res[" + to_string(it - fCut.begin()) + "]";
+    }
+    fExt.push_back({c, what});
+    return "ext[" + to_string(fExt.size() - 1) + "]";
+  };
+  const string res = "res[" + to_string(idx) + "]";
+  ostringstream code;
+  if( !formula->GenerateCode(code, res, "L" + to_string(idx) + "_", cutref) ) {
+    fExt.resize(next);
+    return -1;
+  }
+  fBody << "  // " << formula->GetName() << "\n" << code.str();
+  if( cut )
+    fBody << "  " << res << " = (TMath::Nint(" << res << ") != 0);\n";
+  fForm.push_back(formula);
+  fCut.push_back(cut);
+  return idx;
+}
+
+//_____________________________________________________________________________
+Bool_t FormulaJIT::AddBlock( const TList* plist )
+{
+  // Add all cuts in 'plist', in order. Objects that are not cuts are
+  // ignored, like in THaCutList::EvalBlock. Returns false if any cut
+  // cannot be translated, in which case the block should be evaluated
+  // by the interpreter.
+
+  if( !plist )
+    return false;
+  TIter next(plist);
+  while( TObject* obj = next() ) {
+    auto* cut = dynamic_cast<THaCut*>(obj);
+    if( !cut )
+      continue;
+    if( Add(cut) < 0 )
+      return false;
+  }
+  return !fForm.empty();
+}
+
+//_____________________________________________________________________________
+Bool_t FormulaJIT::Compile()
+{
+  // Compile the generated code. Returns true on success.
+
+  static const char* const here = "FormulaJIT::Compile";
+
+  if( fFunc )
+    return true;
+  if( fForm.empty() || !gInterpreter )
+    return false;
+
+  ostringstream src;
+  src << "#include \"TMath.h\"\n"
+      << "void " << fName << "( const Double_t* ext, Double_t* res )\n{\n"
+      << "  (void)ext;\n"
+      << fBody.str() << "}\n";
+  fSource = src.str();
+  if( !gInterpreter->Declare(fSource.c_str()) ) {
+    ::Error(here, "Failed to compile generated function %s", fName.c_str());
+    return false;
+  }
+  TInterpreter::EErrorCode err = TInterpreter::kNoError;
+  auto addr = gInterpreter->Calc(("(Long_t)&" + fName).c_str(), &err);
+  if( err != TInterpreter::kNoError || addr == 0 ) {
+    ::Error(here, "Cannot find generated function %s", fName.c_str());
+    return false;
+  }
+  fFunc = reinterpret_cast<Func_t>(addr);
+  fExtVal.assign(fExt.size(), 0.0);
+  fResult.assign(fForm.size(), 0.0);
+  return true;
+}
+
+//_____________________________________________________________________________
+void FormulaJIT::Eval()
+{
+  // Evaluate all formulas. Results of cuts are recorded in the cuts.
+
+  assert(fFunc);
+  for( size_t i = 0; i < fExt.size(); ++i ) {
+    const THaCut* cut = fExt[i].cut;
+    switch( fExt[i].what ) {
+    case kResult:  fExtVal[i] = cut->GetResult();  break;
+    case kNPassed: fExtVal[i] = cut->GetNPassed(); break;
+    case kNCalled: fExtVal[i] = cut->GetNCalled(); break;
+    }
+  }
+  fFunc(fExtVal.data(), fResult.data());
+  for( size_t i = 0; i < fCut.size(); ++i ) {
+    if( fCut[i] )
+      fCut[i]->SetResult(fResult[i] != 0);
+  }
+}
+
+} // namespace Podd
@@ -0,0 +1,80 @@
+#ifndef Podd_FormulaJIT_h_
+#define Podd_FormulaJIT_h_
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Podd::FormulaJIT
+//
+// A list of formulas compiled to one native function with the ROOT
+// interpreter (Cling). C++ code is generated from the bytecode of each
+// formula, see THaFormula::GenerateCode.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "Rtypes.h"
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+class THaFormula;
+class THaCut;
+class TList;
+
+namespace Podd {
+
+class FormulaJIT {
+
+public:
+  // Quantities of cuts that formulas may refer to
+  enum ECutValue { kResult, kNPassed, kNCalled };
+  // Returns the C++ expression for the given quantity of a cut, or an
+  // empty string if the generated code cannot refer to it
+  using CutRef_t = std::function<std::string( const THaCut*, ECutValue )>;
+
+  explicit FormulaJIT( const char* name );
+  FormulaJIT( const FormulaJIT& ) = delete;
+  FormulaJIT& operator=( const FormulaJIT& ) = delete;
+  ~FormulaJIT() = default;  // Compiled code remains with the interpreter
+
+  // Add a formula. Returns its index, or -1 if it cannot be translated.
+  // Results of cuts are recorded in the THaCut objects, as by EvalCut().
+  Int_t      Add( THaFormula* formula );
+  // Add all cuts of a block. Fails unless every cut can be translated.
+  Bool_t     AddBlock( const TList* plist );
+  Bool_t     Compile();
+  Bool_t     IsCompiled() const { return fFunc != nullptr; }
+  void       Eval();
+
+  Double_t   GetResult( Int_t i ) const { return fResult[i]; }
+  UInt_t     GetSize()            const { return fForm.size(); }
+  const std::string& GetCode()    const { return fSource; }
+
+  // Compile cuts and output formulas at initialization (default false)
+  static void   SetEnabled( Bool_t enable = true ) { fgEnabled = enable; }
+  static Bool_t IsEnabled() { return fgEnabled; }
+
+private:
+  using Func_t = void (*)( const Double_t* ext, Double_t* res );
+
+  struct Ext_t {       // Cut quantity read before calling the function
+    const THaCut* cut;
+    ECutValue     what;
+  };
+
+  std::string              fName;    // Name of generated function
+  std::ostringstream       fBody;    // Generated statements
+  std::string              fSource;  // Complete generated source
+  std::vector<THaFormula*> fForm;    // Formulas, in order of evaluation
+  std::vector<THaCut*>     fCut;     // Cut for each formula, or nullptr
+  std::vector<Ext_t>       fExt;     // External operands
+  std::vector<Double_t>    fExtVal;  // Values of external operands
+  std::vector<Double_t>    fResult;  // Results
+  Func_t                   fFunc;    // Compiled function
+
+  static Bool_t fgEnabled;
+};
+
+} // namespace Podd
+
+#endif
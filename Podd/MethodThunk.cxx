@@ -0,0 +1,89 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// Podd::MethodThunk
+//
+// Compiled member function calls for method variables.
+//
+// Global variables defined via a member function, e.g. "GetLabPx()" in
+// an RVarDef list, are normally evaluated with TMethodCall, which goes
+// through the interpreter for every call. For variables defined over
+// collections of objects, like per-track quantities, this tends to
+// dominate the time spent on output.
+//
+// Classes can instead register their member functions, or equivalent
+// callables, with MethodThunk::Register(). THaVarList::DefineByRTTI
+// then builds the variable with a direct call of the registered
+// function. TMethodCall remains the fallback for everything else,
+// including classes defined in interpreted scripts.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "MethodThunk.h"
+#include "TClass.h"
+#include "TBaseClass.h"
+#include "TMethod.h"
+#include "TList.h"
+#include <map>
+#include <string>
+#include <typeindex>
+
+using namespace std;
+
+namespace Podd {
+
+//_____________________________________________________________________________
+static map<pair<type_index, string>, MethodThunk>& Registry()
+{
+  static map<pair<type_index, string>, MethodThunk> registry;
+  return registry;
+}
+
+//_____________________________________________________________________________
+Bool_t MethodThunk::Add( const type_info& cl, const char* method,
+                         MethodThunk thunk )
+{
+  // Add thunk for 'method' of class 'cl' to the registry. An existing
+  // entry is replaced.
+
+  if( !method || !*method || !thunk )
+    return false;
+  Registry()[{type_index(cl), method}] = std::move(thunk);
+  return true;
+}
+
+//_____________________________________________________________________________
+MethodThunk MethodThunk::Find( TClass* cl, const char* method )
+{
+  // Find the thunk for 'method' of class 'cl'. If none is registered for
+  // 'cl' itself, search its base classes, unless 'cl' itself declares a
+  // non-virtual 'method', which hides the base class function.
+
+  if( !cl || !method || !*method || Registry().empty() )
+    return {};
+
+  if( const type_info* ti = cl->GetTypeInfo() ) {
+    auto it = Registry().find({type_index(*ti), method});
+    if( it != Registry().end() )
+      return it->second;
+  }
+  // GetMethodAny() would also find inherited functions
+  if( auto* m = static_cast<TMethod*>(cl->GetListOfMethods()->FindObject(method)) ) {
+    if( !(m->Property() & kIsVirtual) )
+      return {};
+  }
+  TIter next(cl->GetListOfBases());
+  while( auto* base = static_cast<TBaseClass*>(next()) ) {
+    TClass* bcl = base->GetClassPointer();
+    MethodThunk thunk = Find(bcl, method);
+    if( !thunk )
+      continue;
+    Int_t delta = cl->GetBaseClassOffset(bcl);
+    if( delta < 0 )   // virtual base
+      continue;
+    thunk.fOffset += delta;
+    return thunk;
+  }
+  return {};
+}
+
+} // namespace Podd
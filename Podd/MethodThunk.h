@@ -0,0 +1,141 @@
+#ifndef Podd_MethodThunk_h_
+#define Podd_MethodThunk_h_
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Podd::MethodThunk
+//
+// Compiled call of a member function that returns a basic type. Used by
+// method variables (see MethodVar) instead of TMethodCall for member
+// functions that have been registered with Register().
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "Rtypes.h"
+#include "VarType.h"
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+class TClass;
+
+namespace Podd {
+
+class MethodThunk {
+
+public:
+  // Calls the function on the object and stores the result at the given
+  // address, converted to the variable type (see GetType())
+  using Func_t = std::function<void( const void* obj, void* result )>;
+
+  MethodThunk() : fType(kVarTypeEnd), fOffset(0) {}
+  MethodThunk( VarType type, Func_t func )
+    : fType(type), fOffset(0), fFunc(std::move(func)) {}
+
+  explicit operator bool() const { return static_cast<bool>(fFunc); }
+  VarType  GetType()       const { return fType; }
+
+  // Call the member function on the object at 'obj'. Stores the result,
+  // which takes at most 8 bytes, at 'result'.
+  void Call( const void* obj, void* result ) const
+  {
+    fFunc(static_cast<const char*>(obj) + fOffset, result);
+  }
+
+  // Register member function M under 'method' for use by method
+  // variables of M's class and classes derived from it, e.g.
+  //   MethodThunk::Register<&THaTrack::GetLabPx>("GetLabPx");
+  template<auto M> static Bool_t Register( const char* method );
+  // Register a callable taking 'const C&' under 'method' for method
+  // variables of class C, e.g.
+  //   MethodThunk::Register<THaVDCPoint>("X",
+  //      []( const THaVDCPoint& pt ) { return pt.X(); });
+  template<typename C, typename F>
+  static Bool_t Register( const char* method, F func );
+
+  // Find the thunk registered for member function 'method' of class 'cl'
+  // or one of its base classes. Returns an invalid thunk if none exists.
+  static MethodThunk Find( TClass* cl, const char* method );
+
+  // Variable type for results of type T, or kVarTypeEnd if unsupported
+  template<typename T> static constexpr VarType TypeOf();
+
+private:
+  VarType  fType;    // Type of result
+  Long_t   fOffset;  // Offset of base class subobject in object
+  Func_t   fFunc;    // Call of the member function
+
+  template<typename C, typename F> static MethodThunk Make( F func );
+  static Bool_t Add( const std::type_info& cl, const char* method,
+                     MethodThunk thunk );
+
+  template<typename T> struct MemFn;
+  template<typename C, typename R> struct MemFn<R (C::*)() const> {
+    using Class_t = C;
+  };
+  template<typename C, typename R> struct MemFn<R (C::*)()> {
+    using Class_t = C;
+  };
+};
+
+//_____________________________________________________________________________
+template<typename T>
+constexpr VarType MethodThunk::TypeOf()
+{
+  if constexpr( std::is_same_v<T, bool> )
+    return kChar;
+  else if constexpr( std::is_same_v<T, double> )
+    return kDouble;
+  else if constexpr( std::is_same_v<T, float> )
+    return kFloat;
+  else if constexpr( std::is_integral_v<T> ) {
+    constexpr bool s = std::is_signed_v<T>;
+    switch( sizeof(T) ) {
+      case 8:  return s ? kLong  : kULong;
+      case 4:  return s ? kInt   : kUInt;
+      case 2:  return s ? kShort : kUShort;
+      case 1:  return s ? kChar  : kUChar;
+      default: return kVarTypeEnd;
+    }
+  } else
+    return kVarTypeEnd;
+}
+
+//_____________________________________________________________________________
+template<typename C, typename F>
+MethodThunk MethodThunk::Make( F func )
+{
+  using R = std::decay_t<std::invoke_result_t<F, const C&>>;
+  static_assert( TypeOf<R>() != kVarTypeEnd,
+                 "Member function must return a basic type" );
+  return { TypeOf<R>(), [func]( const void* obj, void* result ) {
+    // bool is stored as Char_t, see THaVarList::DefineByRTTI
+    using S = std::conditional_t<std::is_same_v<R, bool>, Char_t, R>;
+    S x = func(*static_cast<const C*>(obj));
+    std::memcpy(result, &x, sizeof(x));
+  } };
+}
+
+//_____________________________________________________________________________
+template<auto M>
+Bool_t MethodThunk::Register( const char* method )
+{
+  using C = typename MemFn<decltype(M)>::Class_t;
+  return Add(typeid(C), method, Make<C>([]( const C& obj ) {
+    // TMethodCall, too, calls non-const member functions of const objects
+    return (const_cast<C&>(obj).*M)();
+  }));
+}
+
+//_____________________________________________________________________________
+template<typename C, typename F>
+Bool_t MethodThunk::Register( const char* method, F func )
+{
+  return Add(typeid(C), method, Make<C>(std::move(func)));
+}
+
+} // namespace Podd
+
+#endif
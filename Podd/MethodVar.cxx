@@ -23,11 +23,14 @@ namespace Podd {
 
 //_____________________________________________________________________________
 MethodVar::MethodVar( THaVar* pvar, const void* addr,
-		      VarType type, MethodPtr_t method )
-  : Variable(pvar,addr,type), fMethod(std::move(method)), fData(0)
+		      VarType type, MethodPtr_t method, MethodThunk thunk )
+  : Variable(pvar,addr,type), fMethod(std::move(method)),
+    fThunk(std::move(thunk)), fData(0)
 {
-  // Constructor
-  assert( fMethod );
+  // Constructor. If 'thunk' is valid, it is used instead of 'method',
+  // which may then be null.
+  assert( fMethod || fThunk );
+  assert( !fThunk || fThunk.GetType() == type );
 
   if( !VerifyNonArrayName(GetName()) ) {
     fValueP = nullptr;
@@ -38,8 +41,13 @@ MethodVar::MethodVar( THaVar* pvar, const void* addr,
 //_____________________________________________________________________________
 Variable::VarPtr_t MethodVar::clone( THaVar* pvar ) const
 {
-  return make_unique<MethodVar>(pvar, fValueP, fType,
-                                make_unique<TMethodCall>(*fMethod));
+  return make_unique<MethodVar>(pvar, fValueP, fType, CloneMethod(), fThunk);
+}
+
+//_____________________________________________________________________________
+MethodVar::MethodPtr_t MethodVar::CloneMethod() const
+{
+  return fMethod ? make_unique<TMethodCall>(*fMethod) : nullptr;
 }
 
 //_____________________________________________________________________________
@@ -51,7 +59,6 @@ const void* MethodVar::GetDataPointer( Int_t i ) const
   const char* const here = "GetDataPointer()";
 
   assert( fValueP );
-  assert( fMethod );
 
   if( i != 0 ) {
     fSelf->Error( here, "Index out of range, variable %s, index %d", GetName(), i );
@@ -66,6 +73,11 @@ const void* MethodVar::GetDataPointer( const void* obj ) const
 {
   // Make the method call on the object pointed to by 'obj'
 
+  if( fThunk ) {
+    fThunk.Call(obj, &fData);
+    return &fData;
+  }
+
   void* pobj = const_cast<void*>(obj);  // TMethodCall wants a non-const object...
 
   if( IsFloat() ) {
@@ -10,6 +10,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "Variable.h"
+#include "MethodThunk.h"
 #include "TMethodCall.h"
 
 namespace Podd {
@@ -19,7 +20,7 @@ namespace Podd {
     using MethodPtr_t = std::unique_ptr<TMethodCall>;
   public:
     MethodVar( THaVar* pvar, const void* addr, VarType type,
-	       MethodPtr_t method );
+	       MethodPtr_t method, MethodThunk thunk = {} );
 
     virtual VarPtr_t     clone( THaVar* pvar ) const;
 
@@ -28,10 +29,12 @@ namespace Podd {
 
   protected:
     MethodPtr_t          fMethod;   //Member function to access data in object
+    MethodThunk          fThunk;    //Compiled call of the function, used if valid
     // Data cache, filled in GetDataPointer()
     mutable Double_t     fData;     //Function call result (interpretation depends on fType!)
 
     const void*  GetDataPointer( const void* obj ) const;
+    MethodPtr_t  CloneMethod() const;
   };
 
 }// namespace Podd
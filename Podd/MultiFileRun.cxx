@@ -8,8 +8,10 @@
 
 #include "MultiFileRun.h"
 #include "THaCodaFile.h"
+#include "CodaMmapFile.h"
 #include "THaPrintOption.h"
 #include "CodaDecoder.h"
+#include "EvtBufferRing.h"
 #include "TRegexp.h"
 #include "TSystem.h"
 #include "Helper.h"
@@ -26,6 +28,14 @@ using namespace Decoder;
 
 namespace Podd {
 
+//__________________________________________________________________________
+static unique_ptr<THaCodaData> MakeCodaData( bool mapped )
+{
+  if( mapped )
+    return make_unique<Decoder::CodaMmapFile>();
+  return MKCODAFILE;
+}
+
 //__________________________________________________________________________
 static TString GetDirName(const char *pathname)
 {
@@ -149,6 +159,7 @@ MultiFileRun::MultiFileRun( const MultiFileRun& rhs )
   , fMaxSegments{rhs.fMaxSegments}
   , fMaxStreams{rhs.fMaxStreams}
   , fFlags{rhs.fFlags}
+  , fMappedIO{rhs.fMappedIO}
   , fNameIsRegexp{rhs.fNameIsRegexp}
   , fLastUsedStream{-1}
   , fNActive{0}
@@ -179,6 +190,7 @@ MultiFileRun& MultiFileRun::operator=(const THaRunBase& rhs)
       fMaxSegments     = mfr.fMaxSegments;
       fMaxStreams      = mfr.fMaxStreams;
       fFlags           = mfr.fFlags;
+      fMappedIO        = mfr.fMappedIO;
       fNameIsRegexp    = mfr.fNameIsRegexp;
     }
     catch( const std::bad_cast& ) {
@@ -188,6 +200,7 @@ MultiFileRun& MultiFileRun::operator=(const THaRunBase& rhs)
       fFirstSegment = fFirstStream = 0;
       fMaxSegments = fMaxStreams = 0;
       fFlags = 0;
+      fMappedIO.clear();
       fNameIsRegexp = false;
     }
   }
@@ -225,6 +238,7 @@ Int_t MultiFileRun::Close()
   fOpened = false;
   fNActive = 0;
   fNevRead = 0;
+  fStreamQueue.clear();
 
   Int_t err = CODA_OK;
   for( auto& stream: fStreams ) {
@@ -795,8 +809,11 @@ Int_t MultiFileRun::Open()
 
   // Now actually open the file(s). Streams will be read in parallel,
   // and so one file of each stream is opened simultaneously.
+  size_t stream_bytes = GetStreamReadAheadBytes(fReadAheadBytes);
   for( auto& stream: fStreams ) {
     stream.fVersion = fDataVersion;
+    stream.SetMappedIO(IsMappedIO(stream.fID));
+    stream.fCodaData->setReadAhead(fReadAheadDepth, stream_bytes);
 #ifndef NDEBUG
     Int_t ret =
 #endif
@@ -807,6 +824,11 @@ Int_t MultiFileRun::Open()
   FindSegmentNumber();
   fFilename = fStreams[fLastUsedStream].GetFilename();
   fNActive = static_cast<Int_t>(fStreams.size());
+  fStreamQueue.clear();
+  fStreamQueue.reserve(fStreams.size());
+  for( Int_t i = 0; i < fNActive; ++i )
+    fStreamQueue.emplace_back(fStreams[i].fEvNum, i);
+  make_heap(ALL(fStreamQueue), greater<>());
   fOpened = true;
   return READ_OK;
 }
@@ -837,6 +859,21 @@ Int_t MultiFileRun::ReadEvent() // NOLINT(misc-no-recursion)
   assert(success);
   fFilename = fStreams[fLastUsedStream].GetFilename();
 
+  // Take the stream out of the queue while its event number changes
+  assert(!fStreamQueue.empty());
+  if( fStreamQueue.front().second == fLastUsedStream ) {
+    pop_heap(ALL(fStreamQueue), greater<>());
+    fStreamQueue.pop_back();
+  } else {
+    // FindNextStream was overridden and picked some other stream
+    auto it = find_if(ALL(fStreamQueue), [this]( const auto& elem ) {
+      return elem.second == fLastUsedStream;
+    });
+    assert(it != fStreamQueue.end());
+    fStreamQueue.erase(it);
+    make_heap(ALL(fStreamQueue), greater<>());
+  }
+
   auto& curstr = fStreams[fLastUsedStream];
   Int_t st = curstr.Read();
   if( st == CODA_EOF ) {     // no more data
@@ -844,6 +881,9 @@ Int_t MultiFileRun::ReadEvent() // NOLINT(misc-no-recursion)
     if( --fNActive > 0 )
       return ReadEvent();    // advance to next active stream
     assert(fNActive == 0);
+  } else {
+    fStreamQueue.emplace_back(curstr.fEvNum, fLastUsedStream);
+    push_heap(ALL(fStreamQueue), greater<>());
   }
   if( st != CODA_OK )
     return ReturnCode(st);
@@ -859,39 +899,10 @@ Int_t MultiFileRun::ReadEvent() // NOLINT(misc-no-recursion)
 Int_t MultiFileRun::FindNextStream() const
 {
   assert(fNActive >= 1);
-  Int_t ret = fLastUsedStream;
-  auto sz = SSIZE(fStreams);
-  if( fNActive > 1 ) {
-    Int_t minidx = -1;
-    ULong64_t minev = kMaxULong64;
-    for( Int_t i = 0; i < sz; ++i ) {
-      const auto& stream = fStreams[i];
-      if( stream.fActive && stream.fEvNum < minev ) {
-        minidx = i;
-        minev = stream.fEvNum;
-      }
-    }
-    assert(minidx != -1);
-    ret = minidx;
-  } else {
-#ifndef NDEBUG
-    bool found = false;
-#endif
-    for( int i = 0; i < sz; ++i ) {
-      if( fStreams[i].fActive ) {
-        ret = i;
-#ifndef NDEBUG
-        assert(!found);   // else fNActive incorrect
-        found = true;
-#else
-        break;
-#endif
-      }
-    }
-#ifndef NDEBUG
-    assert(found);        // else fNActive incorrect
-#endif
-  }
+  assert(SSIZE(fStreamQueue) == fNActive);  // else fNActive incorrect
+  // The stream queue is a min-heap, so the answer is at the top
+  Int_t ret = fStreamQueue.front().second;
+  assert(fStreams[ret].fActive);
   return ret;
 }
 
@@ -1093,6 +1104,65 @@ void MultiFileRun::ClearStreams()
   fIsInit = false;
 }
 
+//_____________________________________________________________________________
+void MultiFileRun::SetMappedIO( Bool_t enable, Int_t stream )
+{
+  // Read the files of the given stream via a memory mapping
+  // (Decoder::CodaMmapFile) if 'enable' is true, or via the EVIO library
+  // otherwise. stream = -1 (default) sets the default for all streams
+  // without an explicit setting. Takes effect at the next Open().
+
+  if( stream < 0 )
+    stream = -1;
+  fMappedIO[stream] = enable;
+}
+
+//_____________________________________________________________________________
+Bool_t MultiFileRun::IsMappedIO( Int_t stream ) const
+{
+  // True if files of the given stream are to be read via a memory mapping
+
+  auto it = fMappedIO.find(stream);
+  if( it == fMappedIO.end() )
+    it = fMappedIO.find(-1);
+  return (it != fMappedIO.end() && it->second);
+}
+
+//_____________________________________________________________________________
+size_t MultiFileRun::GetStreamReadAheadBytes( size_t max_bytes ) const
+{
+  // Memory limit for read-ahead per stream, given a total limit of
+  // 'max_bytes' (0 = default) for all streams
+
+  if( max_bytes == 0 )
+    max_bytes = Decoder::EvtBufferRing::kDefaultMaxBytes;
+  return max_bytes / std::max<size_t>(fStreams.size(), 1);
+}
+
+//_____________________________________________________________________________
+Int_t MultiFileRun::SetReadAhead( UInt_t depth, size_t max_bytes )
+{
+  // Read ahead on each stream on a separate thread, so that streams are read
+  // in parallel. The memory limit 'max_bytes' (0 = default) applies to all
+  // streams together. See THaCodaRun::SetReadAhead.
+  // The setting stays in effect when a stream moves on to its next segment.
+  // If any stream rejects the new setting, the streams already changed are
+  // restored to the current one, so that all streams remain consistent.
+
+  size_t stream_bytes = GetStreamReadAheadBytes(max_bytes);
+  for( auto it = fStreams.begin(); it != fStreams.end(); ++it ) {
+    assert(it->fCodaData);
+    Int_t st = ReturnCode(it->fCodaData->setReadAhead(depth, stream_bytes));
+    if( st != READ_OK ) {
+      size_t old_bytes = GetStreamReadAheadBytes(fReadAheadBytes);
+      for( auto jt = fStreams.begin(); jt != it; ++jt )
+        jt->fCodaData->setReadAhead(fReadAheadDepth, old_bytes);
+      return st;
+    }
+  }
+  return THaCodaRun::SetReadAhead(depth, max_bytes);
+}
+
 //_____________________________________________________________________________
 Int_t MultiFileRun::SetFilename( const char* name )
 {
@@ -1348,6 +1418,7 @@ MultiFileRun::StreamInfo::StreamInfo()
   , fFileIndex{0}
   , fEvNum{0}
   , fActive{false}
+  , fMapped{false}
 {}
 
 //_____________________________________________________________________________
@@ -1358,17 +1429,19 @@ MultiFileRun::StreamInfo::StreamInfo( Int_t id )
   , fFileIndex{0}
   , fEvNum{0}
   , fActive{false}
+  , fMapped{false}
 {}
 
 //_____________________________________________________________________________
 MultiFileRun::StreamInfo::StreamInfo( const StreamInfo& rhs )
-  : fCodaData{MKCODAFILE}
+  : fCodaData{MakeCodaData(rhs.fMapped)}
   , fFiles{rhs.fFiles}
   , fID{rhs.fID}
   , fVersion{rhs.fVersion}
   , fFileIndex{rhs.fFileIndex}
   , fEvNum{rhs.fEvNum}
   , fActive{rhs.fActive}
+  , fMapped{rhs.fMapped}
 {}
 
 //_____________________________________________________________________________
@@ -1376,17 +1449,31 @@ MultiFileRun::StreamInfo&
 MultiFileRun::StreamInfo::operator=( const StreamInfo& rhs )
 {
   if( this != &rhs ) {
-    fCodaData = MKCODAFILE;
+    fCodaData = MakeCodaData(rhs.fMapped);
     fFiles = rhs.fFiles;
     fID = rhs.fID;
     fVersion = rhs.fVersion;
     fFileIndex = rhs.fFileIndex;
     fEvNum = rhs.fEvNum;
     fActive = rhs.fActive;
+    fMapped = rhs.fMapped;
   }
   return *this;
 }
 
+//_____________________________________________________________________________
+void MultiFileRun::StreamInfo::SetMappedIO( Bool_t mapped )
+{
+  // Select the reader for this stream's files: memory-mapped (true) or
+  // EVIO library (false). The stream must not be open.
+
+  assert(!fCodaData || !fCodaData->isOpen());
+  if( fCodaData && mapped == fMapped )
+    return;
+  fCodaData = MakeCodaData(mapped);
+  fMapped = mapped;
+}
+
 //_____________________________________________________________________________
 Int_t MultiFileRun::StreamInfo::Open()
 {
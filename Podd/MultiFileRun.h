@@ -51,7 +51,9 @@
 // where data from the stream with the lowest current physics event number
 // will be presented first. With the usual CODA round-robin write strategy,
 // this will normally yield consecutive event numbers on consecutive calls
-// to ReadEvent().
+// to ReadEvent(). If read-ahead is enabled (see SetReadAhead), each stream
+// reads ahead on its own I/O thread, and the memory limit for read-ahead
+// is shared among the streams.
 //
 // Special events (e.g. slow controls, scalers) may not be delivered in the
 // exact order in which they were written. This behavior may be fine-tuned
@@ -71,6 +73,10 @@
 // THaRun::ProvidesInitInfo() and THaRun::GetInitInfoFileName to reflect that.
 // Details naturally depend on the experiment-specific DAQ configuration.
 //
+// Files can be read via memory mappings instead of the EVIO library, which
+// avoids copying each event (see Decoder::CodaMmapFile). This is selected
+// per stream with SetMappedIO().
+//
 // Like THaRun, this class can be persisted through ROOT I/O. This will
 // save, among other data, the paths and stream/segment info of all input
 // files matched at initialization time.
@@ -84,6 +90,7 @@
 #include <memory>
 #include <utility>
 #include <functional>    // std::function
+#include <map>
 
 class TRegexp;
 
@@ -117,10 +124,14 @@ public:
   virtual void   Print( Option_t* opt="" ) const;
   virtual Int_t  ReadEvent();
   virtual Int_t  SetFilename( const char* name );
+  virtual Int_t  SetReadAhead( UInt_t depth, size_t max_bytes = 0 );
   bool           SetFileList( std::vector<std::string> filelist );
   bool           SetPathList( std::vector<std::string> pathlist );
   void           SetFlags( UInt_t set ) { fFlags = set; }
   UInt_t         GetFlags() const { return fFlags; }
+  // Read files of the given stream (-1 = all) via a memory mapping
+  void           SetMappedIO( Bool_t enable = true, Int_t stream = -1 );
+  Bool_t         IsMappedIO( Int_t stream ) const;
 
   // These getters will return valid data after Init()
   // Number of input files found in all streams
@@ -179,6 +190,7 @@ public:
     }
     Int_t Open();
     Int_t Read();
+    void  SetMappedIO( Bool_t mapped );
     Int_t Close();
     Bool_t IsGood() const;
     const UInt_t* GetEvBuffer() const;
@@ -191,6 +203,7 @@ public:
     Int_t  fFileIndex;       //! Index of currently open file
     ULong64_t fEvNum;        //! Number of most recent physics event
     Bool_t fActive;          //! Stream has not yet reached EOF
+    Bool_t fMapped;          //! fCodaData is a memory-mapped file
   private:
     Int_t OpenCurrent();
     Int_t FetchEventNumber();
@@ -214,11 +227,14 @@ protected:
   UInt_t fMaxSegments;                 // Maximum number of segments to process
   UInt_t fMaxStreams;                  // Maximum number of streams to process
   UInt_t fFlags;                       // Flags (see EFlags)
+  std::map<Int_t,Bool_t> fMappedIO;    // Memory-mapped input per stream (-1 = default)
   Bool_t fNameIsRegexp;                // Interpret path/file names as TRegexp
   // Working data
   Int_t  fLastUsedStream;              //! Index of last stream that was read
   Int_t  fNActive;                     //! Number of active streams
   ULong64_t fNevRead;                  //! Number of events read
+  // Min-heap of active streams, ordered by (event number, stream index)
+  std::vector<std::pair<ULong64_t,Int_t>> fStreamQueue; //!
 
   virtual Int_t    BuildInputList();
   virtual Bool_t   FindSegmentNumber();
@@ -227,6 +243,7 @@ protected:
   virtual TString  GetInitInfoFileName( TString fname );
 
   bool  CheckWarnAbsFilename();
+  size_t GetStreamReadAheadBytes( size_t max_bytes ) const;
   void  ClearStreams();
   void  ExpandFileName( std::string& str ) const;
   bool  HasWildcards( const TString& str ) const;
@@ -255,7 +272,7 @@ private:
 
   enum { kResolvingWildcard = BIT(18) };
 
-  ClassDef(MultiFileRun, 2)            // CODA data from multiple files
+  ClassDef(MultiFileRun, 3)            // CODA data from multiple files
 };
 
 } //namespace Podd
@@ -25,6 +25,7 @@
 #pragma link C++ class THaCut+;
 #pragma link C++ class THaCutList+;
 #pragma link C++ class THaHashList+;
+#pragma link C++ class THaCutBlock+;
 #pragma link C++ class THaInterface+;
 #pragma link C++ class THaRun+;
 #pragma link C++ class THaRunBase+;
@@ -0,0 +1,119 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// Podd::ScalerTreeBuffer
+//
+// Event buffer for the scaler trees written by the scaler event handlers
+// if typed branches are enabled (see SetTypedBranches).
+//
+// All variables go into one leaf list branch, so each scaler readout
+// fills a single basket instead of one basket per variable. Counts are
+// stored as UInt_t, as read from the modules, rates as Double_t and event
+// counters as ULong64_t. Leaf lists are not padded, so the buffer holds
+// the 8-byte leaves first, followed by the 4-byte ones. The order of the
+// leaves therefore generally differs from the order in which the variables
+// were added. Readers should access the leaves by name.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "ScalerTreeBuffer.h"
+#include "TTree.h"
+#include <cstring>
+
+using namespace std;
+
+namespace Podd {
+
+Bool_t ScalerTreeBuffer::fgTypedBranches = false;
+
+//_____________________________________________________________________________
+static size_t LeafSize( ScalerTreeBuffer::ELeafType type )
+{
+  return type == ScalerTreeBuffer::kUInt ? sizeof(UInt_t) : sizeof(Double_t);
+}
+
+//_____________________________________________________________________________
+Int_t ScalerTreeBuffer::Add( const char* name, ELeafType type )
+{
+  if( fBranched || !name || !*name )
+    return -1;
+  fVars.push_back({name, type, 0});
+  return static_cast<Int_t>(fVars.size() - 1);
+}
+
+//_____________________________________________________________________________
+TBranch* ScalerTreeBuffer::Branch( TTree* tree, const char* name,
+                                   Int_t bufsize )
+{
+  if( fBranched || !tree || fVars.empty() )
+    return nullptr;
+
+  // Lay out the 8-byte leaves first so that every leaf is aligned
+  string leaflist;
+  size_t offset = 0;
+  for( size_t size : { sizeof(Double_t), sizeof(UInt_t) } ) {
+    for( auto& var : fVars ) {
+      if( LeafSize(var.type) != size )
+        continue;
+      var.offset = offset;
+      offset += size;
+      if( !leaflist.empty() )
+        leaflist += ':';
+      leaflist += var.name;
+      leaflist += '/';
+      leaflist += static_cast<char>(var.type);
+    }
+  }
+  fBuf.assign((offset + sizeof(Double_t) - 1) / sizeof(Double_t), 0);
+
+  TBranch* br = tree->Branch(name, fBuf.data(), leaflist.c_str(), bufsize);
+  fBranched = (br != nullptr);
+  return br;
+}
+
+//_____________________________________________________________________________
+void ScalerTreeBuffer::Clear()
+{
+  fVars.clear();
+  fBuf.clear();
+  fBranched = false;
+}
+
+//_____________________________________________________________________________
+void ScalerTreeBuffer::Set( Int_t i, Double_t val )
+{
+  if( !fBranched || i < 0 || static_cast<size_t>(i) >= fVars.size() )
+    return;
+  const auto& var = fVars[i];
+  char* loc = reinterpret_cast<char*>(fBuf.data()) + var.offset;
+  switch( var.type ) {
+    case kULong64: {
+      ULong64_t x = val > 0 ? static_cast<ULong64_t>(val) : 0;
+      memcpy(loc, &x, sizeof(x));
+      break;
+    }
+    case kUInt: {
+      UInt_t x = val > 0 ? static_cast<UInt_t>(val) : 0;
+      memcpy(loc, &x, sizeof(x));
+      break;
+    }
+    case kDouble:
+      memcpy(loc, &val, sizeof(val));
+      break;
+  }
+}
+
+//_____________________________________________________________________________
+void ScalerTreeBuffer::Set( Int_t i, ULong64_t val )
+{
+  if( !fBranched || i < 0 || static_cast<size_t>(i) >= fVars.size() )
+    return;
+  const auto& var = fVars[i];
+  if( var.type != kULong64 ) {
+    Set(i, static_cast<Double_t>(val));
+    return;
+  }
+  char* loc = reinterpret_cast<char*>(fBuf.data()) + var.offset;
+  memcpy(loc, &val, sizeof(val));
+}
+
+} // namespace Podd
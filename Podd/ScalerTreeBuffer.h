@@ -0,0 +1,65 @@
+#ifndef Podd_ScalerTreeBuffer_h_
+#define Podd_ScalerTreeBuffer_h_
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Podd::ScalerTreeBuffer
+//
+// Event buffer for the scaler trees written by the scaler event handlers,
+// stored as a single branch with one leaf per variable in its native type.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "Rtypes.h"
+#include <string>
+#include <vector>
+
+class TTree;
+class TBranch;
+
+namespace Podd {
+
+class ScalerTreeBuffer {
+
+public:
+  // Leaf types, as in TTree leaf lists
+  enum ELeafType : char { kULong64 = 'l', kUInt = 'i', kDouble = 'D' };
+
+  // Add a variable of type 'type' and return its index for Set().
+  // Returns -1 if the branch has already been created.
+  Int_t    Add( const char* name, ELeafType type );
+  // Create the branch 'name' in 'tree' holding all variables added so far.
+  // No variables can be added afterwards.
+  TBranch* Branch( TTree* tree, const char* name, Int_t bufsize );
+  void     Clear();
+  Bool_t   HasBranch() const { return fBranched; }
+  UInt_t   GetSize()   const { return fVars.size(); }
+
+  // Set variable 'i' for the next Fill() of the tree, converting
+  // 'val' to the type of the variable
+  void     Set( Int_t i, Double_t val );
+  void     Set( Int_t i, ULong64_t val );
+
+  // Have the scaler event handlers write one branch with typed leaves
+  // rather than one Double_t branch per variable (default). This changes
+  // the layout of the scaler trees. Takes effect when a handler creates
+  // its tree.
+  static void   SetTypedBranches( Bool_t enable = true ) { fgTypedBranches = enable; }
+  static Bool_t TypedBranchesEnabled() { return fgTypedBranches; }
+
+private:
+  struct Var_t {
+    std::string name;
+    ELeafType   type;
+    size_t      offset;  // Offset in fBuf, in bytes
+  };
+  std::vector<Var_t>    fVars;
+  std::vector<Double_t> fBuf;       // Leaf data, 8-byte aligned
+  Bool_t                fBranched{false};
+
+  static Bool_t fgTypedBranches;  // Use typed scaler tree branches
+};
+
+} // namespace Podd
+
+#endif
@@ -18,8 +18,9 @@ namespace Podd {
 
 //_____________________________________________________________________________
 SeqCollectionMethodVar::SeqCollectionMethodVar( THaVar* pvar, const void* addr,
-	VarType type, MethodPtr_t method )
-  : Variable(pvar,addr,type), MethodVar(pvar,addr,type,std::move(method)),
+	VarType type, MethodPtr_t method, MethodThunk thunk )
+  : Variable(pvar,addr,type),
+    MethodVar(pvar,addr,type,std::move(method),std::move(thunk)),
     SeqCollectionVar(pvar,addr,type,0)
 {
   // Constructor
@@ -29,7 +30,7 @@ SeqCollectionMethodVar::SeqCollectionMethodVar( THaVar* pvar, const void* addr,
 Variable::VarPtr_t SeqCollectionMethodVar::clone( THaVar* pvar ) const
 {
   return make_unique<SeqCollectionMethodVar>(pvar, fValueP, fType,
-                                    make_unique<TMethodCall>(*fMethod));
+                                            CloneMethod(), fThunk);
 }
 
 //_____________________________________________________________________________
@@ -19,7 +19,7 @@ namespace Podd {
 
   public:
     SeqCollectionMethodVar( THaVar* pvar, const void* addr, VarType type,
-                            MethodPtr_t method );
+                            MethodPtr_t method, MethodThunk thunk = {} );
 
     virtual VarPtr_t     clone( THaVar* pvar ) const;
 
@@ -0,0 +1,104 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// Podd::SymbolTable
+//
+// Interned names with stable integer IDs.
+//
+// Each name is stored once and assigned the next free ID. The IDs index
+// plain vectors in the owning lists (THaVarList, THaCutList), so objects
+// can be looked up by ID without any string operations. Names remain in
+// the table when the corresponding object is deleted, so an object
+// redefined under the same name gets the same ID.
+//
+// Lookup by name uses an open-addressing hash table with linear probing.
+// While names are being added, the table is kept at most half full.
+// Freeze() rebuilds it at a load of at most 1/4 once the set of names is
+// complete, which keeps probe sequences very short for the many lookups
+// during initialization.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "SymbolTable.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace Podd {
+
+//_____________________________________________________________________________
+SymbolTable::SymbolTable()
+  : fMask(0), fMaxProbe(0), fFrozen(false)
+{
+  // Constructor
+}
+
+//_____________________________________________________________________________
+SymbolTable::ID_t SymbolTable::Intern( string_view name )
+{
+  // Return the ID of 'name'. Unknown names are added.
+
+  ID_t id = Find(name);
+  if( id != kNoID )
+    return id;
+
+  id = static_cast<ID_t>(fNames.size());
+  fNames.emplace_back(name);
+  fFrozen = false;
+  if( 2 * fNames.size() > fSlots.size() )
+    Rehash(max<size_t>(16, 2 * fSlots.size()));
+  else
+    Insert(Hash(name), id);
+  return id;
+}
+
+//_____________________________________________________________________________
+void SymbolTable::Freeze()
+{
+  // Rebuild the hash table for the current names at a low load factor
+
+  size_t nslots = 16;
+  while( nslots < 4 * fNames.size() )
+    nslots *= 2;
+  Rehash(nslots);
+  fFrozen = true;
+}
+
+//_____________________________________________________________________________
+void SymbolTable::Clear()
+{
+  // Remove all names. Invalidates all IDs.
+
+  fNames.clear();
+  fSlots.clear();
+  fMask = fMaxProbe = 0;
+  fFrozen = false;
+}
+
+//_____________________________________________________________________________
+void SymbolTable::Rehash( size_t nslots )
+{
+  // Rebuild hash table with 'nslots' slots (a power of 2)
+
+  fSlots.assign(nslots, Slot_t{0, kNoID});
+  fMask = static_cast<UInt_t>(nslots - 1);
+  fMaxProbe = 0;
+  for( ID_t id = 0; id < GetSize(); ++id )
+    Insert(Hash(fNames[id]), id);
+}
+
+//_____________________________________________________________________________
+void SymbolTable::Insert( UInt_t hash, ID_t id )
+{
+  // Insert 'id' into the first free slot of its probe sequence
+
+  UInt_t i = hash & fMask, n = 0;
+  while( fSlots[i].id != kNoID ) {
+    i = (i + 1) & fMask;
+    ++n;
+  }
+  fSlots[i] = {hash, id};
+  if( n > fMaxProbe )
+    fMaxProbe = n;
+}
+
+} // namespace Podd
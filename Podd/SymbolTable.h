@@ -0,0 +1,86 @@
+#ifndef Podd_SymbolTable_h_
+#define Podd_SymbolTable_h_
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Podd::SymbolTable
+//
+// Interned names with stable integer IDs and an open-addressing hash
+// for lookup by name.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "Rtypes.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Podd {
+
+class SymbolTable {
+
+public:
+  using ID_t = Int_t;
+  static constexpr ID_t kNoID = -1;
+
+  SymbolTable();
+
+  // Return the ID of 'name', adding it if necessary. IDs are assigned
+  // consecutively from 0 and remain valid until Clear() is called.
+  ID_t               Intern( std::string_view name );
+  // ID of 'name', or kNoID if the name is unknown
+  ID_t               Find( std::string_view name ) const
+  {
+    if( fSlots.empty() )
+      return kNoID;
+    UInt_t h = Hash(name);
+    for( UInt_t i = h & fMask, n = 0; n <= fMaxProbe; i = (i + 1) & fMask, ++n ) {
+      const Slot_t& s = fSlots[i];
+      if( s.id == kNoID )
+        return kNoID;
+      if( s.hash == h && fNames[s.id] == name )
+        return s.id;
+    }
+    return kNoID;
+  }
+  const std::string& GetName( ID_t id ) const { return fNames[id]; }
+  ID_t               GetSize() const { return static_cast<ID_t>(fNames.size()); }
+  // Longest probe sequence of any name in the hash table
+  UInt_t             GetMaxProbe() const { return fMaxProbe; }
+
+  // Rebuild the hash table for the current set of names, which is expected
+  // to change rarely from now on. Names can still be added.
+  void               Freeze();
+  Bool_t             IsFrozen() const { return fFrozen; }
+  void               Clear();
+
+  static UInt_t      Hash( std::string_view name )
+  {
+    // 32-bit FNV-1a
+    UInt_t h = 2166136261U;
+    for( unsigned char c: name ) {
+      h ^= c;
+      h *= 16777619U;
+    }
+    return h;
+  }
+
+private:
+  struct Slot_t {
+    UInt_t hash;   // Hash of the name
+    ID_t   id;     // ID of the name, kNoID if slot is empty
+  };
+
+  std::vector<std::string> fNames;    // Names, indexed by ID
+  std::vector<Slot_t>      fSlots;    // Hash table (size is a power of 2)
+  UInt_t                   fMask;     // fSlots.size() - 1
+  UInt_t                   fMaxProbe; // Longest probe sequence in fSlots
+  Bool_t                   fFrozen;   // No names added since Freeze()
+
+  void   Rehash( size_t nslots );
+  void   Insert( UInt_t hash, ID_t id );
+};
+
+} // namespace Podd
+
+#endif
@@ -17,6 +17,7 @@
 #include "THaVarList.h"
 #include "THaGlobals.h"
 #include "TClass.h"
+#include "TMethod.h"
 #include "TDatime.h"
 #include "TROOT.h"
 #include "TMath.h"
@@ -35,6 +36,7 @@
 #include <iomanip>
 #include <type_traits>
 #include <limits>
+#include <optional>
 
 using namespace std;
 using namespace Podd;
@@ -53,6 +55,7 @@ THaAnalysisObject::THaAnalysisObject( const char* name,
   , fProperties(0)
   , fOKOut(false)
   , fInitDate(19950101,0)
+  , fDBFingerprintClass(nullptr)
   , fNEventsWithWarnings(0)
   , fExtra(nullptr)
 {
@@ -71,6 +74,7 @@ THaAnalysisObject::THaAnalysisObject()
   , fIsSetup(false)
   , fProperties(0)
   , fOKOut(false)
+  , fDBFingerprintClass(nullptr)
   , fNEventsWithWarnings(0)
   , fExtra(nullptr)
 {
@@ -445,8 +449,15 @@ THaAnalysisObject::EStatus THaAnalysisObject::Init( const TDatime& date )
   // especially subdetectors may have their own idea what prefix they like.
   MakePrefix();
 
-  // Skip reinitialization if there is no (relevant) date change.
-  if( DBDatesDiffer(date, fInitDate) ) {
+  // Skip reinitialization if there is no (relevant) date change. For classes
+  // that enabled it with UseDBFingerprint(), this includes the case where the
+  // database files read previously give the same results for this date.
+  bool use_fp = IsDBFingerprintUsable();
+  if( DBDatesDiffer(date, fInitDate) && !(use_fp && fDBInputs.IsValidFor(date)) ) {
+    // Record the database files opened by the readers
+    std::optional<Podd::DBFingerprint::Recorder> dbrec;
+    if( use_fp )
+      dbrec.emplace(fDBInputs, date);
     try {
       // Open the run database and call the reader. If database cannot be opened,
       // fail only if this object needs the run database
@@ -458,17 +469,23 @@ THaAnalysisObject::EStatus THaAnalysisObject::Init( const TDatime& date )
 
       // Read the database for this object.
       // Don't bother if this object has not implemented its own database reader.
+      bool complete = true;
       if( IsA()->GetMethodAllAny("ReadDatabase") !=
           gROOT->GetClass("THaAnalysisObject")->GetMethodAllAny("ReadDatabase") ) {
 
         // Call this object's actual database reader
+        UInt_t nfiles = fDBInputs.GetNFiles();
         if( (status = ReadDatabase(date)) )
           throw database_error(status, GetDBFileName());
+        // If the reader did not use OpenDBFile, we don't know its inputs
+        complete = (fDBInputs.GetNFiles() > nfiles);
 
       } else if( fDebug > 2 ) {
         Info(Here(here), "No ReadDatabase function defined. "
                          "Database not read.");
       }
+      if( dbrec && complete )
+        dbrec->Commit();
     }
 
     catch( const database_error& e ) {
@@ -489,7 +506,7 @@ THaAnalysisObject::EStatus THaAnalysisObject::Init( const TDatime& date )
       return fStatus = kInitError;
     }
   } else if( fDebug > 1 ) {
-    Info(Here(here), "Not re-reading database for same date.");
+    Info(Here(here), "Database unchanged, not re-reading.");
   }
 
   // Save the last successful initialization date. This is used to prevent
@@ -631,12 +648,46 @@ void THaAnalysisObject::SetConfig( const char* label )
   // seek to a section header [ config=label ] if the module supports it.
 
   fConfig = label;
+  fDBInputs.Clear();  // Force re-reading the database
   if( fConfig.IsNull() )
     fProperties &= ~kConfigOverride;
   else
     fProperties |= kConfigOverride;
 }
 
+//_____________________________________________________________________________
+void THaAnalysisObject::UseDBFingerprint( const TClass* cl )
+{
+  // Allow Init() to skip re-reading the database for a new date if the
+  // database files read previously give the same results for that date
+  // (see Podd::DBFingerprint).
+  //
+  // Call this from the constructor of class 'cl' only if its ReadDatabase()
+  // and ReadRunDatabase() read all their inputs via OpenFile, OpenRunDBFile
+  // or OpenDBFile and depend on the date only through these files.
+  // The setting has no effect for derived classes that override either
+  // reader, unless they call UseDBFingerprint() themselves.
+
+  fDBFingerprintClass = cl;
+  fDBInputs.Clear();
+}
+
+//_____________________________________________________________________________
+Bool_t THaAnalysisObject::IsDBFingerprintUsable() const
+{
+  // True if the database readers called for this object are those of the
+  // class that enabled the database fingerprint, or of one of its bases
+
+  if( !fDBFingerprintClass )
+    return false;
+  for( const char* reader : { "ReadDatabase", "ReadRunDatabase" } ) {
+    auto* m = IsA()->GetMethodAllAny(reader);
+    if( !m || !m->GetClass() || !fDBFingerprintClass->InheritsFrom(m->GetClass()) )
+      return false;
+  }
+  return true;
+}
+
 //_____________________________________________________________________________
 void THaAnalysisObject::SetDebug( Int_t level )
 {
@@ -26,6 +26,7 @@ class TVector3;
 class THaRunBase;
 class THaOutput;
 class TObjArray;
+class TClass;
 
 class THaAnalysisObject : public TNamed {
 
@@ -117,6 +118,8 @@ protected:
   UInt_t          fProperties;// Properties of this object (see EProperties)
   Bool_t          fOKOut;     // Flag indicating object-output prepared
   TDatime         fInitDate;  // Date passed to Init
+  Podd::DBFingerprint fDBInputs; //! Database files read for fInitDate
+  const TClass*   fDBFingerprintClass; //! Class that enabled fDBInputs
 
   std::map<std::string,UInt_t> fMessages; // Warning messages & count
   UInt_t          fNEventsWithWarnings;   // Events with warnings
@@ -150,6 +153,7 @@ protected:
   virtual Int_t        ReadDatabase( const TDatime& date );
   virtual Int_t        ReadRunDatabase( const TDatime& date );
           Int_t        RemoveVariables();
+          void         UseDBFingerprint( const TClass* cl );
 
 #ifdef WITH_DEBUG
   void DebugPrint( const DBRequest* list ) const;
@@ -162,7 +166,8 @@ protected:
   THaAnalysisObject( const char* name, const char* description );
 
 private:
-  Int_t DefineVariablesWrapper( EMode mode = kDefine );
+  Int_t  DefineVariablesWrapper( EMode mode = kDefine );
+  Bool_t IsDBFingerprintUsable() const;
 
   static TList* fgModules;  // List of all currently existing Analysis Modules
 
@@ -26,10 +26,12 @@
 #include "THaGlobals.h"
 #include "THaSpectrometer.h"
 #include "THaCutList.h"
+#include "FormulaJIT.h"
 #include "THaPhysicsModule.h"
 #include "InterStageModule.h"
 #include "THaPostProcess.h"
 #include "THaBenchmark.h"
+#include "StageProfiler.h"
 #include "THaEvtTypeHandler.h"
 #include "THaEpicsEvtHandler.h"
 #include "TList.h"
@@ -43,7 +45,11 @@
 #include "TDirectory.h"
 #include "THaDetMap.h"   // for crate map access
 #include "THaCrateMap.h"
+#include "THaCodaRun.h"
 #include "Helper.h"
+#include "EventPartition.h"
+#include "TH1.h"
+#include "TKey.h"
 
 #include <iostream>
 #include <iomanip>
@@ -51,6 +57,17 @@
 #include <algorithm>
 #include <vector>
 #include <ctime>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <set>
+#include <string>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 using namespace std;
 using namespace Decoder;
@@ -103,6 +120,46 @@ inline string CurrentTime()
     timestr = buff;
   return timestr;
 }
+
+//_____________________________________________________________________________
+// Steps through the per-module profiler IDs of a module list in parallel
+// with the loop over the modules. Yields kNoStage if module timing is off.
+class ModuleTimerIDs {
+public:
+  explicit ModuleTimerIDs( const vector<UInt_t>& ids ) : fIDs{ids}, fIdx{0} {}
+  UInt_t Next()
+  {
+    return fIdx < fIDs.size() ? fIDs[fIdx++] : StageProfiler::kNoStage;
+  }
+private:
+  const vector<UInt_t>& fIDs;
+  size_t fIdx;
+};
+
+//_____________________________________________________________________________
+// Statistics counters of all cuts, in the order of the global cut list
+void GetCutStatistics( vector<UInt_t>& ncalled, vector<UInt_t>& npassed )
+{
+  ncalled.clear();
+  npassed.clear();
+  for( const auto* obj : *gHaCuts->GetCutList() ) {
+    const auto* cut = static_cast<const THaCut*>(obj);
+    ncalled.push_back(cut->GetNCalled());
+    npassed.push_back(cut->GetNPassed());
+  }
+}
+
+void SetCutStatistics( const vector<UInt_t>& ncalled,
+                       const vector<UInt_t>& npassed )
+{
+  size_t i = 0;
+  for( auto* obj : *gHaCuts->GetCutList() ) {
+    if( i >= ncalled.size() || i >= npassed.size() )
+      break;
+    static_cast<THaCut*>(obj)->SetStatistics(ncalled[i], npassed[i]);
+    ++i;
+  }
+}
 } // namespace
 
 //_____________________________________________________________________________
@@ -118,6 +175,11 @@ THaAnalyzer::THaAnalyzer()
   , fCompress(1)
   , fVerbose(2)
   , fCountMode(kCountRaw)
+  , fReadAheadDepth(0)
+  , fReadAheadBytes(0)
+  , fCutVarChanges(0)
+  , fNumWorkers(0)
+  , fPartition(nullptr)
   , fBench(nullptr)
   , fPrevEvent(nullptr)
   , fRun(nullptr)
@@ -128,11 +190,13 @@ THaAnalyzer::THaAnalyzer()
   , fUpdateRun(true)
   , fOverwrite(true)
   , fDoBench(false)
+  , fDoModuleTiming(false)
   , fDoHelicity(false)
   , fDoPhysics(true)
   , fDoOtherEvents(true)
   , fDoSlowControl(true)
   , fUseAltEvType(false)
+  , fProfID{}
   , fFirstPhysics(true)
   , fExtra(nullptr)
 {
@@ -154,6 +218,13 @@ THaAnalyzer::THaAnalyzer()
 
   // Timers
   fBench = new THaBenchmark;
+  auto& prof = StageProfiler::Instance();
+  const char* const names[kNProfStages] = {
+    "Init", "Begin", "RawDecode", "Decode", "CoarseTracking",
+    "CoarseReconstruct", "Tracking", "Reconstruct", "Physics", "End",
+    "Output", "Cuts", "PostProcess" };
+  for( Int_t i = 0; i < kNProfStages; ++i )
+    fProfID[i] = prof.Register(string("Analyzer/") + names[i]);
 }
 
 //_____________________________________________________________________________
@@ -329,7 +400,12 @@ void THaAnalyzer::Close()
 //_____________________________________________________________________________
 void THaAnalyzer::EnableBenchmarks( Bool_t b )
 {
+  // Enable/disable detailed timing of the event loop stages of the
+  // analyzer, the output module and the decoder via the global stage
+  // profiler. See PrintTimingSummary() and SetTimingFile().
+
   fDoBench = b;
+  StageProfiler::Instance().Enable(fDoBench || fDoModuleTiming);
 }
 
 //_____________________________________________________________________________
@@ -338,6 +414,19 @@ void THaAnalyzer::EnableHelicity( Bool_t b )
   fDoHelicity = b;
 }
 
+//_____________________________________________________________________________
+void THaAnalyzer::EnableModuleTiming( Bool_t b )
+{
+  // Enable/disable timing of the individual Decode, CoarseTrack,
+  // CoarseReconstruct, Track, Reconstruct and Process calls of each
+  // analysis module. Call counts, mean/p99 latencies and heap allocation
+  // counts are printed at the end of the run and written to the output
+  // file as tree "ModuleTiming". Takes effect at the next Process().
+
+  fDoModuleTiming = b;
+  StageProfiler::Instance().Enable(fDoBench || fDoModuleTiming);
+}
+
 //_____________________________________________________________________________
 void THaAnalyzer::EnableRunUpdate( Bool_t b )
 {
@@ -383,7 +472,7 @@ bool THaAnalyzer::EvalStage( int n )
   // If event is skipped, increment associated statistics counter.
   // Call InitCuts() before using!  This is an internal function.
 
-  if( fDoBench ) fBench->Begin("Cuts");
+  StageProfiler::Scope timer(fProfID[kProfCuts]);
 
   const Stage_t& theStage = fStages[n];
 
@@ -394,7 +483,7 @@ bool THaAnalyzer::EvalStage( int n )
 
   bool ret = true;
   if( theStage.cut_list ) {
-    THaCutList::EvalBlock( theStage.cut_list );
+    theStage.cut_list->Eval();
     if( theStage.master_cut &&
 	!theStage.master_cut->GetResult() ) {
       if( theStage.countkey >= 0 ) // stage may not have a counter
@@ -402,7 +491,6 @@ bool THaAnalyzer::EvalStage( int n )
       ret = false;
     }
   }
-  if( fDoBench ) fBench->Stop("Cuts");
   return ret;
 }
 
@@ -471,8 +559,12 @@ void THaAnalyzer::InitCuts()
 {
   // Internal function that sets up structures to handle cuts more efficiently:
   //
-  // - Find pointers to the THaNamedList lists that hold the cut blocks.
-  // - find pointer to each block's master cut
+  // - Find pointers to the THaCutBlock lists that hold the cut blocks.
+  // - find pointer to each block's master cut and register it with the block
+  // - if enabled, compile each block to a native function. Blocks with
+  //   any cut that cannot be compiled are evaluated by the interpreter.
+  //   Compiled code is used only in eager mode (see THaCutBlock::Eval),
+  //   so nothing is compiled if the cut list evaluates lazily.
 
   for( auto& theStage : fStages ) {
     // If block not found, this will return nullptr and work just fine later.
@@ -483,6 +575,18 @@ void THaAnalyzer::InitCuts()
       master_cut.Append( '_' );
       master_cut.Append( kMasterCutName );
       theStage.master_cut = gHaCuts->FindCut( master_cut );
+      theStage.cut_list->SetMaster( theStage.master_cut );
+      theStage.cut_list->SetCompiled( nullptr );
+
+      if( Podd::FormulaJIT::IsEnabled() &&
+          gHaCuts->GetEvalMode() == THaCutList::kEager ) {
+        auto jit = make_shared<Podd::FormulaJIT>( theStage.name );
+        if( jit->AddBlock( theStage.cut_list ) && jit->Compile() )
+          theStage.cut_list->SetCompiled( std::move(jit) );
+        else if( fVerbose > 0 )
+          Info( "InitCuts", "Cuts of stage %s are evaluated by the "
+                "interpreter", theStage.name );
+      }
     } else
       theStage.master_cut = nullptr;
   }
@@ -535,12 +639,15 @@ Int_t THaAnalyzer::Init( THaRunBase* run )
   // This is a wrapper, so we can conveniently control the benchmark counter
   if( !run ) return -1;
 
-  if( !fIsInit ) fBench->Reset();
+  if( !fIsInit ) {
+    fBench->Reset();
+    StageProfiler::Instance().Reset();
+  }
   fBench->Begin("Total");
 
-  if( fDoBench ) fBench->Begin("Init");
+  StageProfiler::Scope timer(fProfID[kProfInit]);
   Int_t retval = DoInit( run );
-  if( fDoBench ) fBench->Stop("Init");
+  timer.Stop();
 
   // Stop "Total" counter since Init() may be called separately from Process()
   fBench->Stop("Total");
@@ -832,6 +939,10 @@ Int_t THaAnalyzer::DoInit( THaRunBase* run )
   retval = InitModules(modulesToInit, run_time);
   if( retval == 0 ) {
 
+    // All global variables are now defined. Optimize lookups by name
+    // for the formulas, cuts and output definitions set up below.
+    gHaVars->Freeze();
+
     // Set up cuts here, now that all global variables are available
     if( fCutFileName.IsNull() ) {
       // No test definitions -> make sure list is clear
@@ -844,11 +955,16 @@ Int_t THaAnalyzer::DoInit( THaRunBase* run )
 	gHaCuts->Load( fCutFileName );
 	fLoadedCutFileName = fCutFileName;
       }
-      // Ensure all tests are up-to-date. Global variables may have changed.
-      gHaCuts->Compile();
+      // Ensure all tests are up-to-date if global variables have changed.
+      // Unchanged variables keep their addresses, so recompiling is not
+      // necessary then.
+      if( gHaVars->GetChangeCount() != fCutVarChanges )
+        gHaCuts->Compile();
     }
+    fCutVarChanges = gHaVars->GetChangeCount();
     // Initialize local pointers to test blocks and master cuts
     InitCuts();
+    gHaCuts->Freeze();
 
     // fOutput must be initialized after all apparatuses are
     // initialized and before adding anything to its tree.
@@ -931,7 +1047,7 @@ Int_t THaAnalyzer::ReadOneEvent()
   // Read one event from current run (fRun) and raw-decode it using the
   // current decoder (fEvData)
 
-  if( fDoBench ) fBench->Begin("RawDecode");
+  StageProfiler::Scope timer(fProfID[kProfRawDecode]);
 
   // Find next event buffer in CODA file. Quit if error.
   Int_t status = THaRunBase::READ_OK;
@@ -973,10 +1089,53 @@ Int_t THaAnalyzer::ReadOneEvent()
     break;
   }
 
-  if( fDoBench ) fBench->Stop("RawDecode");
   return status;
 }
 
+//_____________________________________________________________________________
+void THaAnalyzer::SetReadAhead( UInt_t depth, size_t max_bytes )
+{
+  // Read up to 'depth' raw events ahead of the analysis on a background
+  // thread, using at most about 'max_bytes' of memory (0 = default limit).
+  // depth = 0 (default) disables read-ahead.
+  //
+  // This is a default for CODA runs. A setting made for the run itself
+  // with THaCodaRun::SetReadAhead() takes precedence.
+
+  fReadAheadDepth = depth;
+  fReadAheadBytes = max_bytes;
+}
+
+//_____________________________________________________________________________
+void THaAnalyzer::SetNumWorkers( UInt_t n )
+{
+  // Replay physics events in 'n' parallel worker processes. n < 2 (default)
+  // replays serially in this process.
+  //
+  // Each worker reads and decodes the entire run. Physics events are
+  // divided into blocks of Podd::EventPartition::kDefaultBlockSize, and each
+  // worker analyzes every n-th block. Other events (EPICS, scalers etc.)
+  // are analyzed by all workers. Process() then merges the workers' results
+  // into the output file: the output tree in the original event order, the
+  // other trees as written by the first worker, and the sums of all
+  // histograms and statistics counters.
+  //
+  // Limitations:
+  //  - Modules must not carry state from one physics event to the next
+  //    (e.g. helicity sequence tracking). Event type handlers see all events.
+  //  - Only histograms and trees that exist in the output file when the
+  //    workers start, and trees that the workers create, are merged.
+  //    Other objects that modules create during the replay are lost.
+  //  - If the analysis is terminated early, output tree entries are merged
+  //    up to the block where it stopped. Statistics may then include events
+  //    that a serial replay would not have analyzed.
+  //  - Post-processing modules (e.g. event filters) need all events in order.
+  //    If any are defined, the replay falls back to serial.
+  //  - Module timing and benchmarks only reflect this (the parent) process.
+
+  fNumWorkers = n;
+}
+
 //_____________________________________________________________________________
 void THaAnalyzer::SetEpicsEvtType(Int_t itype)
 {
@@ -1105,19 +1264,21 @@ void THaAnalyzer::PrintCutSummary() const
 //_____________________________________________________________________________
 void THaAnalyzer::PrintTimingSummary() const
 {
-  // Print timing statistics, if benchmarking enabled
-  if( (fVerbose > 1 || fDoBench) ) {
-    vector<TString> names;
-    if( fDoBench ) {
-      cout << "Timing summary:" << endl;
-      names = {
-        "Init", "Begin", "RawDecode", "Decode", "CoarseTracking",
-        "CoarseReconstruct", "Tracking", "Reconstruct", "Physics", "End",
-        "Output", "Cuts"
-      };
+  // Print timing statistics, if benchmarking enabled. If a timing file
+  // was requested, also write the detailed statistics (including latency
+  // histograms) there, as JSON or CSV depending on the file name.
+  // With module timing only, just the per-module statistics are reported.
+  if( (fVerbose > 1 || fDoBench || fDoModuleTiming) ) {
+    if( fDoBench || fDoModuleTiming ) {
+      const auto& prof = StageProfiler::Instance();
+      const char* prefix = fDoBench ? "" : "Module/";
+      cout << (fDoBench ? "Timing summary (" : "Module timing summary (")
+           << prof.GetClockName() << "):" << endl;
+      prof.Print(prefix);
+      if( !fTimingFileName.IsNull() )
+        prof.WriteFile(fTimingFileName, prefix);
     }
-    names.emplace_back("Total");
-    fBench->PrintByName(names);
+    fBench->PrintByName({"Total"});
   }
 }
 
@@ -1161,6 +1322,55 @@ void THaAnalyzer::PrintSummary( EExitStatus exit_status ) const
 
 }
 
+//_____________________________________________________________________________
+Int_t THaAnalyzer::WriteModuleTiming() const
+{
+  // If module timing is enabled, write the per-module statistics to the
+  // current directory as tree "ModuleTiming", one entry per module and call.
+  // Times are in ns. 'hist' is the latency histogram with bin edges
+  // 0, 1, 2, 4, ... ns (see Podd::StageProfiler). 'allocs' is the total number
+  // of heap allocations, or -1 if allocations were not counted.
+
+  if( !fDoModuleTiming )
+    return 0;
+
+  const auto stats = StageProfiler::Instance().GetStats("Module/");
+  string module, call;
+  ULong64_t count = 0, total = 0, tmax = 0;
+  Long64_t allocs = 0;
+  Double_t mean = 0, p50 = 0, p99 = 0;
+  ULong64_t hist[StageProfiler::kNbins];
+  TTree tree("ModuleTiming", "Per-module timing statistics");
+  tree.Branch("module", &module);
+  tree.Branch("call", &call);
+  tree.Branch("count", &count, "count/l");
+  tree.Branch("total", &total, "total/l");
+  tree.Branch("mean", &mean, "mean/D");
+  tree.Branch("p50", &p50, "p50/D");
+  tree.Branch("p99", &p99, "p99/D");
+  tree.Branch("max", &tmax, "max/l");
+  tree.Branch("allocs", &allocs, "allocs/L");
+  tree.Branch("hist", hist, Form("hist[%u]/l", StageProfiler::kNbins));
+
+  Bool_t have_allocs = StageProfiler::HaveAllocationCounts();
+  for( const auto& st : stats ) {
+    // Name is "Module/<module name>/<call>"
+    auto pos = st.name.rfind('/');
+    module = st.name.substr(7, pos - 7);
+    call = st.name.substr(pos + 1);
+    count = st.count;
+    total = st.total;
+    mean = st.Mean();
+    p50 = st.Quantile(0.5);
+    p99 = st.Quantile(0.99);
+    tmax = st.max;
+    allocs = have_allocs ? SINT(st.allocs) : -1;
+    std::copy(ALL(st.hist), hist);
+    tree.Fill();
+  }
+  return tree.Write();
+}
+
 //_____________________________________________________________________________
 Int_t THaAnalyzer::BeginAnalysis()
 {
@@ -1171,7 +1381,7 @@ Int_t THaAnalyzer::BeginAnalysis()
 
   fFirstPhysics = true;
 
-  if( fDoBench ) fBench->Begin("Begin");
+  StageProfiler::Scope timer(fProfID[kProfBegin]);
 
   for( auto* theModule : fAnalysisModules ) {
     theModule->Begin( fRun );
@@ -1181,8 +1391,6 @@ Int_t THaAnalyzer::BeginAnalysis()
     obj->Begin(fRun);
   }
 
-  if( fDoBench ) fBench->Stop("Begin");
-
   return 0;
 }
 
@@ -1192,7 +1400,7 @@ Int_t THaAnalyzer::EndAnalysis()
   // Execute End() for all Apparatus and Physics modules. Internal function
   // called right after event loop is finished for each run.
 
-  if( fDoBench ) fBench->Begin("End");
+  StageProfiler::Scope timer(fProfID[kProfEnd]);
 
   for( auto* theModule : fAnalysisModules ) {
     theModule->End( fRun );
@@ -1202,8 +1410,6 @@ Int_t THaAnalyzer::EndAnalysis()
     obj->End(fRun);
   }
 
-  if( fDoBench ) fBench->Stop("End");
-
   return 0;
 }
 
@@ -1232,30 +1438,32 @@ Int_t THaAnalyzer::PhysicsAnalysis( Int_t code )
   fRun->IncrNumAnalyzed();
   Incr(kNevAnalyzed);
 
+  // Slow control values valid for this event
+  if( fEpicsHandler )
+    fEpicsHandler->UpdateChannels(fEvData->GetEvNum());
+
   //--- Process all apparatuses that are defined in fApps
   //    First Decode(), then Reconstruct()
 
   const char* stage = "";
   THaAnalysisObject* obj = nullptr;  // current module, for exception error message
+  StageProfiler::Scope timer;
 
   try {
     stage = "Decode";
-    if( fDoBench ) fBench->Begin(stage);
+    timer.Start(fProfID[kProfDecode]);
     for( auto* mod : fAnalysisModules ) {
       obj = mod;
       mod->Clear();
     }
+    ModuleTimerIDs decode_ids(fModProfID[kModDecode]);
     for( auto* app : fApps ) {
       obj = app;
+      StageProfiler::Scope modtimer(decode_ids.Next());
       app->Decode(*fEvData);
     }
-    for( auto* mod : fInterStage ) {
-      if( mod->GetStage() == kDecode ) {
-        obj = mod;
-        mod->Process(*fEvData);
-      }
-    }
-    if( fDoBench ) fBench->Stop(stage);
+    InterStageAnalysis(kDecode, obj);
+    timer.Stop();
     if( !EvalStage(kDecode) ) return kSkip;
 
     //--- Main physics analysis. Calls the following for each defined apparatus
@@ -1269,75 +1477,65 @@ Int_t THaAnalyzer::PhysicsAnalysis( Int_t code )
     //-- Coarse processing
 
     stage = "CoarseTracking";
-    if( fDoBench ) fBench->Begin(stage);
+    timer.Start(fProfID[kProfCoarseTracking]);
+    ModuleTimerIDs coarsetrack_ids(fModProfID[kModCoarseTrack]);
     for( auto* spectro : fSpectrometers ) {
       obj = spectro;
+      StageProfiler::Scope modtimer(coarsetrack_ids.Next());
       spectro->CoarseTrack();
     }
-    for( auto* mod : fInterStage ) {
-      if( mod->GetStage() == kCoarseTrack ) {
-        obj = mod;
-        mod->Process(*fEvData);
-      }
-    }
-    if( fDoBench ) fBench->Stop(stage);
+    InterStageAnalysis(kCoarseTrack, obj);
+    timer.Stop();
     if( !EvalStage(kCoarseTrack) )  return kSkip;
 
 
     stage = "CoarseReconstruct";
-    if( fDoBench ) fBench->Begin(stage);
+    timer.Start(fProfID[kProfCoarseReconstruct]);
+    ModuleTimerIDs coarsereconstruct_ids(fModProfID[kModCoarseReconstruct]);
     for( auto* app : fApps ) {
       obj = app;
+      StageProfiler::Scope modtimer(coarsereconstruct_ids.Next());
       app->CoarseReconstruct();
     }
-    for( auto* mod : fInterStage ) {
-      if( mod->GetStage() == kCoarseRecon ) {
-        obj = mod;
-        mod->Process(*fEvData);
-      }
-    }
-    if( fDoBench ) fBench->Stop(stage);
+    InterStageAnalysis(kCoarseRecon, obj);
+    timer.Stop();
     if( !EvalStage(kCoarseRecon) )  return kSkip;
 
     //-- Fine (Full) Reconstruct().
 
     stage = "Tracking";
-    if( fDoBench ) fBench->Begin(stage);
+    timer.Start(fProfID[kProfTracking]);
+    ModuleTimerIDs track_ids(fModProfID[kModTrack]);
     for( auto* spectro : fSpectrometers ) {
       obj = spectro;
+      StageProfiler::Scope modtimer(track_ids.Next());
       spectro->Track();
     }
-    for( auto* mod : fInterStage ) {
-      if( mod->GetStage() == kTracking ) {
-        obj = mod;
-        mod->Process(*fEvData);
-      }
-    }
-    if( fDoBench ) fBench->Stop(stage);
+    InterStageAnalysis(kTracking, obj);
+    timer.Stop();
     if( !EvalStage(kTracking) )  return kSkip;
 
 
     stage = "Reconstruct";
-    if( fDoBench ) fBench->Begin(stage);
+    timer.Start(fProfID[kProfReconstruct]);
+    ModuleTimerIDs reconstruct_ids(fModProfID[kModReconstruct]);
     for( auto* app : fApps ) {
       obj = app;
+      StageProfiler::Scope modtimer(reconstruct_ids.Next());
       app->Reconstruct();
     }
-    for( auto* mod : fInterStage ) {
-      if( mod->GetStage() == kReconstruct ) {
-        obj = mod;
-        mod->Process(*fEvData);
-      }
-    }
-    if( fDoBench ) fBench->Stop(stage);
+    InterStageAnalysis(kReconstruct, obj);
+    timer.Stop();
     if( !EvalStage(kReconstruct) )  return kSkip;
 
     //--- Process the list of physics modules
 
     stage = "Physics";
-    if( fDoBench ) fBench->Begin(stage);
+    timer.Start(fProfID[kProfPhysics]);
+    ModuleTimerIDs process_ids(fModProfID[kModProcess]);
     for( auto* physmod : fPhysics ) {
       obj = physmod;
+      StageProfiler::Scope modtimer(process_ids.Next());
       Int_t err = physmod->Process( *fEvData );
       if( err == THaPhysicsModule::kTerminate )
         code = kTerminate;
@@ -1346,13 +1544,8 @@ Int_t THaAnalyzer::PhysicsAnalysis( Int_t code )
         break;
       }
     }
-    for( auto* mod : fInterStage ) {
-      if( mod->GetStage() == kPhysics ) {
-        obj = mod;
-        mod->Process(*fEvData);
-      }
-    }
-    if( fDoBench ) fBench->Stop(stage);
+    InterStageAnalysis(kPhysics, obj);
+    timer.Stop();
     if( code == kFatal ) return kFatal;
 
     //--- Evaluate "Physics" test block
@@ -1368,13 +1561,13 @@ Int_t THaAnalyzer::PhysicsAnalysis( Int_t code )
     Error( here, "Caught exception %s in module %s (%s) during %s analysis "
 	   "stage. Terminating analysis.", e.what(), module_name.Data(),
 	   module_desc.Data(), stage );
-    if( fDoBench ) fBench->Stop(stage);
+    timer.Stop();
     code = kFatal;
     goto errexit;
   }
 
   //---  Process output
-  if( fDoBench ) fBench->Begin("Output");
+  timer.Start(fProfID[kProfOutput]);
   try {
     //--- If Event defined, fill it.
     if( fEvent ) {
@@ -1396,12 +1589,29 @@ Int_t THaAnalyzer::PhysicsAnalysis( Int_t code )
 	   "Terminating analysis.", e.what(), fNev );
     code = kFatal;
   }
-  if( fDoBench ) fBench->Stop("Output");
+  timer.Stop();
 
  errexit:
   return code;
 }
 
+//_____________________________________________________________________________
+void THaAnalyzer::InterStageAnalysis( Int_t stage, THaAnalysisObject*& obj )
+{
+  // Process the inter-stage modules that run after analysis stage 'stage'.
+  // 'obj' is set to the current module, for error reporting.
+
+  ModuleTimerIDs ids(fInterProfID);
+  for( auto* mod : fInterStage ) {
+    auto id = ids.Next();
+    if( mod->GetStage() == stage ) {
+      obj = mod;
+      StageProfiler::Scope modtimer(id);
+      mod->Process(*fEvData);
+    }
+  }
+}
+
 //_____________________________________________________________________________
 Int_t THaAnalyzer::SlowControlAnalysis( Int_t code )
 {
@@ -1412,9 +1622,9 @@ Int_t THaAnalyzer::SlowControlAnalysis( Int_t code )
   if( code == kFatal )
     return code;
   if ( !fEpicsHandler ) return kOK;
-  if( fDoBench ) fBench->Begin("Output");
+  StageProfiler::Scope timer(fProfID[kProfOutput]);
   if( fOutput ) fOutput->ProcEpics(fEvData, fEpicsHandler);
-  if( fDoBench ) fBench->Stop("Output");
+  timer.Stop();
   if( code == kTerminate )
     return code;
   return kOK;
@@ -1440,27 +1650,41 @@ Int_t THaAnalyzer::PostProcess( Int_t code )
   // THaPostProcess::Process() function for optional evaluation,
   // e.g. skipping events that fail analysis stage cuts.
 
-  if( fDoBench ) fBench->Begin("PostProcess");
-
   if( code == kFatal )
     return code;
+  StageProfiler::Scope timer(fProfID[kProfPostProcess]);
   for( auto* obj : fPostProcess ) {
     Int_t ret = obj->Process(fEvData,fRun,code);
     if( obj->TestBits(THaPostProcess::kUseReturnCode) &&
 	ret > code )
       code = ret;
   }
-  if( fDoBench ) fBench->Stop("PostProcess");
   return code;
 }
 
 //_____________________________________________________________________________
-Int_t THaAnalyzer::MainAnalysis()
+void THaAnalyzer::EvtHandlerAnalysis()
 {
-  // Main analysis carried out for each event
+  // Let all event type handlers analyze the current event
 
   static const char* const here = "MainAnalysis";
 
+  for( auto* obj : fEvtHandlers ) {
+    try {
+      obj->Analyze(fEvData);
+    }
+    catch( const exception& e) {
+      // Generic exceptions are not fatal. Print message and continue.
+      Error( here, "%s", e.what() );
+    }
+  }
+}
+
+//_____________________________________________________________________________
+Int_t THaAnalyzer::MainAnalysis()
+{
+  // Main analysis carried out for each event
+
   Int_t retval = kOK;
 
   Incr(kNevGood);
@@ -1474,15 +1698,7 @@ Int_t THaAnalyzer::MainAnalysis()
 
   //FIXME Move to "OtherAnalysis"?
   //FIXME EpicsHandler is part of this list, but analyzed again below?
-  for( auto* obj : fEvtHandlers ) {
-    try {
-      obj->Analyze(fEvData);
-    }
-    catch( const exception& e) {
-      // Generic exceptions are not fatal. Print message and continue.
-      Error( here, "%s", e.what() );
-    }
-  }
+  EvtHandlerAnalysis();
 
   bool evdone = false;
   //=== Physics triggers ===
@@ -1524,84 +1740,29 @@ Int_t THaAnalyzer::MainAnalysis()
 }
 
 //_____________________________________________________________________________
-Long64_t THaAnalyzer::Process( THaRunBase* run )
+Int_t THaAnalyzer::EventLoop( bool& terminate, bool& fatal )
 {
-  // Process the given run. Loop over all events in the event range and
-  // analyze all apparatuses defined in the global apparatus list.
-  // Fill Event structure if it is defined.
-  // If Event and Filename are defined, then fill the output tree with Event
-  // and write the file.
+  // The main event loop. Read and analyze events until the end of the run,
+  // the event limit, or until the analysis is terminated. Returns the
+  // status of the last read.
+  //
+  // In a worker process of an event-parallel replay (fPartition set),
+  // analyze only this worker's physics events. Other events are analyzed
+  // by all workers, but only the first one counts them.
 
   static const char* const here = "Process";
 
-  if( !run ) {
-    if( fRun )
-      run = fRun;
-    else
-      return -1;
-  }
-
-  //--- Initialization. Creates fFile, fOutput, and fEvent if necessary.
-  //    Also copies run to fRun if run is different from fRun
-  Int_t status = Init( run );
-  if( status != 0 ) {
-    return status;
-  }
-
-  // Restart "Total" since it is stopped in Init()
-  fBench->Begin("Total");
-
-  //--- Re-open the data source. Should succeed since this was tested in Init().
-  if( (status = fRun->Open()) != THaRunBase::READ_OK ) {
-    Error( here, "Failed to re-open the input file. "
-	   "Make sure the file still exists.");
-    fBench->Stop("Total");
-    return -4;
-  }
-
-  // Make the current run available globally - the run parameters are
-  // needed by some modules
-  gHaRun = fRun;
-
-  // Configure decoder flags
-  // Enable/disable helicity decoding as requested
-  fEvData->EnableHelicity( HelicityEnabled() );
-  // Set decoder reporting level. FIXME: update when THaEvData is updated
-  fEvData->SetVerbose( (fVerbose>2) );
-  fEvData->SetDebug( (fVerbose>3) );
-  // Use alternate event type (currently only implemented by CodaDecoder)
-  fEvData->EnableAltEvType(AltEvTypeEnabled());
-
-  // Informational messages
-  if( fVerbose>1 ) {
-    cout << "Decoder: helicity "
-	 << (fEvData->HelicityEnabled() ? "enabled" : "disabled")
-	 << endl;
-    cout << endl << "Starting analysis" << endl;
-  }
-  // Events prior to fRun->GetFirstEvent() are skipped in MainAnalysis()
-  if( fVerbose>2 && fRun->GetFirstEvent()>1 )
-    cout << "Skipping " << fRun->GetFirstEvent() << " events" << endl;
-
-  //--- The main event loop.
-
-  if( fDoBench ) fBench->Begin("Init");
-  fNev = 0;
-  bool terminate = false, fatal = false;
+  StageProfiler::Scope timer;
+  Int_t status = THaRunBase::READ_OK;
   UInt_t nlast = fRun->GetLastEvent();
-  fAnalysisStarted = true;
-  PrepareModuleList();
-  if( fDoBench ) fBench->Stop("Init");
-  BeginAnalysis();
-  if( fFile ) {
-    if( fDoBench ) fBench->Begin("Output");
-    fFile->cd();
-    fRun->Write("Run_Data");  // Save run data to first ROOT file
-    if( fDoBench ) fBench->Stop("Output");
-  }
-
   UInt_t errcount = 0;
   constexpr UInt_t MAXSEQERR = 10;
+  ULong64_t nphys = 0;
+  TTree* tree = fOutput ? fOutput->GetTree() : nullptr;
+  const bool other_worker = fPartition && fPartition->GetWorker() != 0;
+  vector<ULong64_t> counts;
+  vector<UInt_t> ncalled, npassed;
+
   while ( !terminate && fNev < nlast &&
 	  (status = ReadOneEvent()) != THaRunBase::READ_EOF ) {
 
@@ -1641,7 +1802,8 @@ Long64_t THaAnalyzer::Process( THaRunBase* run )
     }
 
     //--- Print marks periodically
-    if( fVerbose > 1 && fNev > 0 && (fNev % fMarkInterval == 0) &&
+    if( fVerbose > 1 && !other_worker && fNev > 0 &&
+        (fNev % fMarkInterval == 0) &&
         // Avoid duplicates that may occur if a physics event is followed by
         // non-physics events. Only physics events update the event number.
         (fCountMode == kCountAll || fEvData->IsPhysicsTrigger()) )
@@ -1651,38 +1813,494 @@ Long64_t THaAnalyzer::Process( THaRunBase* run )
     if( fUpdateRun )
       fRun->Update( fEvData );
 
+    //--- Event-parallel replay: physics events of other workers only go
+    //    to the event type handlers. Stop once past the last block.
+    const bool physics = fDoPhysics && fEvData->IsPhysicsTrigger();
+    if( fPartition && physics ) {
+      const ULong64_t iphys = nphys++;
+      fPartition->Next(iphys, tree ? tree->GetEntries() : 0);
+      if( fPartition->IsStopped() )
+        break;
+      if( !fPartition->IsMine(iphys) ) {
+        EvtHandlerAnalysis();
+        continue;
+      }
+    }
+    if( other_worker && !physics ) {
+      for( const auto& theCounter : fCounters )
+        counts.push_back(theCounter.count);
+      GetCutStatistics(ncalled, npassed);
+    }
+
     //--- Clear all tests/cuts
-    if( fDoBench ) fBench->Begin("Cuts");
+    timer.Start(fProfID[kProfCuts]);
     gHaCuts->ClearAll();
-    if( fDoBench ) fBench->Stop("Cuts");
+    timer.Stop();
 
     //--- Perform the analysis
     Int_t err = MainAnalysis();
     switch( err ) {
     case kOK:
+      Incr(kNevAccepted);
       break;
     case kSkip:
-      continue;
+      break;
     case kFatal:
       fatal = terminate = true;
-      continue;
+      break;
     case kTerminate:
       terminate = true;
+      Incr(kNevAccepted);
       break;
     default:
       Error( here, "Unknown return code from MainAnalysis(): %d", err );
       terminate = fatal = true;
-      continue;
+      break;
     }
 
-    Incr(kNevAccepted);
+    if( other_worker && !physics ) {
+      for( size_t i = 0; i < counts.size(); ++i )
+        fCounters[i].count = counts[i];
+      counts.clear();
+      SetCutStatistics(ncalled, npassed);
+    }
+    // Other workers finish the blocks before this one
+    if( terminate && fPartition && physics )
+      fPartition->Stop();
 
   }  // End of event loop
 
+  return status;
+}
+
+//_____________________________________________________________________________
+Bool_t THaAnalyzer::UseWorkers() const
+{
+  // True if the current run is to be replayed in worker processes
+
+  static const char* const here = "Process";
+
+  if( fNumWorkers < 2 || !fFile )
+    return false;
+  if( !fPostProcess.empty() ) {
+    Warning( here, "Post-processing modules need all events in order. "
+             "Ignoring SetNumWorkers(%u), replaying serially.", fNumWorkers );
+    return false;
+  }
+  if( !fDoPhysics ) {
+    Warning( here, "Physics events disabled. Ignoring SetNumWorkers(%u), "
+             "replaying serially.", fNumWorkers );
+    return false;
+  }
+  return true;
+}
+
+//_____________________________________________________________________________
+TString THaAnalyzer::WorkerFileName( UInt_t worker ) const
+{
+  // Output file of the given worker process. The worker's report for the
+  // parent process goes to the same name with ".rep" appended.
+
+  return TString::Format("%s.worker%u", fOutFileName.Data(), worker);
+}
+
+//_____________________________________________________________________________
+Int_t THaAnalyzer::RunWorkers( bool& terminate, bool& fatal )
+{
+  // Replay the current run in fNumWorkers worker processes and merge their
+  // results into this analyzer. Returns the status of the last read,
+  // like EventLoop().
+  //
+  // The workers are forked before the data source is opened, so that none
+  // of them inherits an open file or a read-ahead thread.
+
+  static const char* const here = "Process";
+
+  // Last block to analyze, shared by all workers
+  void* mem = mmap(nullptr, sizeof(atomic<Long64_t>), PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if( mem == MAP_FAILED ) {
+    Error( here, "Cannot set up worker processes: %s", strerror(errno) );
+    terminate = fatal = true;
+    return THaRunBase::READ_FATAL;
+  }
+  auto* stop = new(mem) atomic<Long64_t>(kMaxLong64);
+
+  // Don't let the workers inherit unwritten output
+  cout.flush();
+  cerr.flush();
+  fflush(nullptr);
+
+  vector<pid_t> pids;
+  for( UInt_t k = 0; k < fNumWorkers; ++k ) {
+    pid_t pid = fork();
+    if( pid == 0 ) {
+      Int_t ret = 1;
+      try {
+        EventPartition part(fNumWorkers, k);
+        part.SetStopFlag(stop);
+        ret = RunWorker(part);
+      }
+      catch( const exception& e ) {
+        Error( here, "Worker %u: %s", k, e.what() );
+      }
+      cout.flush();
+      cerr.flush();
+      fflush(nullptr);
+      // Skip exit handlers. They would clean up the parent's ROOT objects.
+      _exit(ret);
+    }
+    if( pid < 0 ) {
+      Error( here, "Cannot start worker process: %s", strerror(errno) );
+      // Stop the workers already running
+      stop->store(-1);
+      break;
+    }
+    pids.push_back(pid);
+  }
+
+  bool ok = (pids.size() == fNumWorkers);
+  for( UInt_t k = 0; k < pids.size(); ++k ) {
+    int wstatus = 0;
+    pid_t ret;
+    while( (ret = waitpid(pids[k], &wstatus, 0)) < 0 && errno == EINTR )
+      ;
+    if( ret < 0 || !WIFEXITED(wstatus) || WEXITSTATUS(wstatus) != 0 ) {
+      Error( here, "Worker process %u failed", k );
+      ok = false;
+    }
+  }
+  Long64_t lastblock = stop->load();
+  munmap(mem, sizeof(atomic<Long64_t>));
+
+  Int_t status = THaRunBase::READ_FATAL;
+  if( ok )
+    status = MergeWorkers(lastblock < kMaxLong64 ? lastblock : -1,
+                          terminate, fatal);
+  else
+    terminate = fatal = true;
+
+  for( UInt_t k = 0; k < fNumWorkers; ++k ) {
+    TString fname = WorkerFileName(k);
+    gSystem->Unlink(fname);
+    gSystem->Unlink(fname + ".rep");
+  }
+  return status;
+}
+
+//_____________________________________________________________________________
+Int_t THaAnalyzer::RunWorker( EventPartition& part )
+{
+  // Replay this worker's share of the current run into the worker's own
+  // output file, and write the report that the parent process needs for
+  // merging. Runs in the worker process. Returns 0 on success.
+
+  static const char* const here = "Process";
+
+  TString fname = WorkerFileName(part.GetWorker());
+  auto* file = new TFile(fname, "RECREATE");
+  if( file->IsZombie() ) {
+    Error( here, "Cannot create worker output file %s", fname.Data() );
+    return 1;
+  }
+  file->SetCompressionLevel(fCompress);
+  // The parent looks for the output trees in this file only
+  TTree::SetMaxTreeSize(kMaxLong64);
+
+  // Fill the output trees and histograms afresh in the worker's file.
+  // The parent process keeps their previous contents.
+  vector<TObject*> objs;
+  for( auto* obj : *fFile->GetList() )
+    objs.push_back(obj);
+  for( auto* obj : objs ) {
+    if( auto* tree = dynamic_cast<TTree*>(obj) ) {
+      tree->Reset();
+      tree->SetDirectory(file);
+    } else if( auto* hist = dynamic_cast<TH1*>(obj) ) {
+      hist->Reset();
+      hist->SetDirectory(file);
+    }
+  }
+  fFile = file;
+  fFile->cd();
+  fPartition = &part;
+
+  if( fRun->Open() != THaRunBase::READ_OK ) {
+    Error( here, "Worker %u failed to open the input file", part.GetWorker() );
+    return 1;
+  }
+  bool terminate = false, fatal = false;
+  Int_t status = EventLoop(terminate, fatal);
+  TTree* tree = fOutput ? fOutput->GetTree() : nullptr;
+  part.Finish(tree ? tree->GetEntries() : 0);
+  EndAnalysis();
+  fRun->Close();
+
+  fFile->cd();
+  if( fOutput )
+    fOutput->End();
+  if( part.GetWorker() == 0 )
+    fRun->Write("Run_Data");
+  fFile->Write(nullptr, TObject::kOverwrite);
+  fFile->Close();
+
+  WorkerReport rep;
+  for( const auto& theCounter : fCounters )
+    rep.counters.push_back(theCounter.count);
+  GetCutStatistics(rep.ncalled, rep.npassed);
+  rep.blockends = part.GetBlockEnds();
+  rep.nev = fNev;
+  rep.nanalyzed = fRun->GetNumAnalyzed();
+  rep.status = status;
+  rep.terminate = terminate;
+  rep.fatal = fatal;
+  if( !rep.Write((fname + ".rep").Data()) ) {
+    Error( here, "Cannot write worker report %s.rep", fname.Data() );
+    return 1;
+  }
+  return 0;
+}
+
+//_____________________________________________________________________________
+Int_t THaAnalyzer::MergeWorkers( Long64_t lastblock, bool& terminate,
+                                 bool& fatal )
+{
+  // Merge the results of the worker processes into this analyzer as if
+  // the run had been replayed serially. 'lastblock' is the block in which
+  // the analysis was terminated, or -1. Returns the status of the last read.
+
+  static const char* const here = "Process";
+
+  const UInt_t nworkers = fNumWorkers;
+  vector<WorkerReport> reps(nworkers);
+  vector<unique_ptr<TFile>> files(nworkers);
+  for( UInt_t k = 0; k < nworkers; ++k ) {
+    TString fname = WorkerFileName(k);
+    files[k].reset(TFile::Open(fname, "READ"));
+    if( !files[k] || files[k]->IsZombie() ||
+        !reps[k].Read((fname + ".rep").Data()) ||
+        reps[k].counters.size() != fCounters.size() ||
+        reps[k].ncalled.size() != static_cast<size_t>(gHaCuts->GetSize()) ) {
+      Error( here, "Cannot read results of worker process %u", k );
+      terminate = fatal = true;
+      return THaRunBase::READ_FATAL;
+    }
+  }
+  // The worker that terminated the analysis, if any, has the final status
+  const auto& last = reps[lastblock >= 0 ? lastblock % nworkers : 0];
+  fNev = last.nev;
+  terminate = last.terminate;
+  fatal = last.fatal;
+
+  // Histograms: sums over all workers
+  for( auto* obj : *fFile->GetList() ) {
+    auto* hist = dynamic_cast<TH1*>(obj);
+    if( !hist )
+      continue;
+    for( const auto& file : files ) {
+      TH1* h = nullptr;
+      file->GetObject(hist->GetName(), h);
+      if( h ) {
+        hist->Add(h);
+        delete h;
+      }
+    }
+  }
+
+  // Trees other than the output tree (EPICS, scalers): from the first worker,
+  // which analyzed all non-physics events. Append to the trees of previous
+  // runs, if any.
+  TTree* tree = fOutput ? fOutput->GetTree() : nullptr;
+  set<string> done;
+  TIter nextkey(files[0]->GetListOfKeys());
+  while( auto* key = static_cast<TKey*>(nextkey()) ) {
+    TClass* cl = TClass::GetClass(key->GetClassName());
+    string name = key->GetName();
+    if( !cl || !cl->InheritsFrom(TTree::Class()) ||
+        (tree && name == tree->GetName()) || !done.insert(name).second )
+      continue;
+    TTree* from = nullptr;
+    files[0]->GetObject(name.c_str(), from);
+    if( !from )
+      continue;
+    fFile->cd();
+    TTree* to = nullptr;
+    fFile->GetObject(name.c_str(), to);
+    if( to ) {
+      to->CopyAddresses(from);
+      for( Long64_t i = 0; i < from->GetEntries(); ++i ) {
+        from->GetEntry(i);
+        to->Fill();
+      }
+      to->CopyAddresses(from, true);
+    } else
+      to = from->CloneTree(-1, "fast");
+    if( to )
+      to->Write(nullptr, TObject::kOverwrite);
+  }
+
+  // Output tree: the workers' entries in event order
+  if( tree ) {
+    vector<TTree*> src(nworkers, nullptr);
+    vector<vector<Long64_t>> ends;
+    for( UInt_t k = 0; k < nworkers; ++k ) {
+      files[k]->GetObject(tree->GetName(), src[k]);
+      if( !src[k] ) {
+        Error( here, "Output tree missing from worker process %u", k );
+        terminate = fatal = true;
+        return THaRunBase::READ_FATAL;
+      }
+      tree->CopyAddresses(src[k]);
+      ends.push_back(reps[k].blockends);
+    }
+    for( const auto& range : EventPartition::MergeOrder(ends, lastblock) ) {
+      for( Long64_t i = range.first; i < range.last; ++i ) {
+        src[range.worker]->GetEntry(i);
+        tree->Fill();
+      }
+    }
+    for( auto* t : src )
+      tree->CopyAddresses(t, true);
+  }
+
+  // Statistics. Every worker read all events, and the first one also
+  // counted all non-physics events. Every other count is the sum of
+  // the workers' increments.
+  for( size_t i = 0; i < fCounters.size(); ++i ) {
+    auto& count = fCounters[i].count;
+    if( i == kNevRead || i == kDecodeErr || i == kCodaErr )
+      count = reps[0].counters[i];
+    else {
+      const ULong64_t base = count;
+      for( const auto& rep : reps )
+        count += rep.counters[i] - base;
+    }
+  }
+  vector<UInt_t> ncalled, npassed;
+  GetCutStatistics(ncalled, npassed);
+  const auto base_called = ncalled, base_passed = npassed;
+  for( const auto& rep : reps ) {
+    for( size_t i = 0; i < ncalled.size(); ++i ) {
+      ncalled[i] += rep.ncalled[i] - base_called[i];
+      npassed[i] += rep.npassed[i] - base_passed[i];
+    }
+  }
+  SetCutStatistics(ncalled, npassed);
+
+  // Run parameters as updated by the first worker, plus the physics
+  // events analyzed by the others
+  const ULong64_t base = fRun->GetNumAnalyzed();
+  THaRunBase* run0 = nullptr;
+  files[0]->GetObject("Run_Data", run0);
+  if( run0 ) {
+    fRun->THaRunBase::operator=(*run0);
+    delete run0;
+  }
+  ULong64_t nanalyzed = base;
+  for( const auto& rep : reps )
+    nanalyzed += rep.nanalyzed - base;
+  fRun->IncrNumAnalyzed(
+    static_cast<Int_t>(nanalyzed - fRun->GetNumAnalyzed()));
+
+  fFile->cd();
+  return last.status;
+}
+
+//_____________________________________________________________________________
+Long64_t THaAnalyzer::Process( THaRunBase* run )
+{
+  // Process the given run. Loop over all events in the event range and
+  // analyze all apparatuses defined in the global apparatus list.
+  // Fill Event structure if it is defined.
+  // If Event and Filename are defined, then fill the output tree with Event
+  // and write the file.
+
+  static const char* const here = "Process";
+
+  if( !run ) {
+    if( fRun )
+      run = fRun;
+    else
+      return -1;
+  }
+
+  //--- Initialization. Creates fFile, fOutput, and fEvent if necessary.
+  //    Also copies run to fRun if run is different from fRun
+  Int_t status = Init( run );
+  if( status != 0 ) {
+    return status;
+  }
+
+  // Restart "Total" since it is stopped in Init()
+  fBench->Begin("Total");
+
+  // Read ahead by default, unless set up differently for this run
+  auto* codarun = dynamic_cast<THaCodaRun*>(fRun);
+  if( codarun && codarun->SetDefaultReadAhead(fReadAheadDepth, fReadAheadBytes)
+                 != THaRunBase::READ_OK )
+    Warning( here, "Data source of run \"%s\" does not support read-ahead. "
+             "Reading events synchronously.", fRun->GetName() );
+
+  // With worker processes, each worker opens the data source itself
+  const bool workers = UseWorkers();
+
+  //--- Re-open the data source. Should succeed since this was tested in Init().
+  if( !workers && (status = fRun->Open()) != THaRunBase::READ_OK ) {
+    Error( here, "Failed to re-open the input file. "
+	   "Make sure the file still exists.");
+    fBench->Stop("Total");
+    return -4;
+  }
+
+  // Make the current run available globally - the run parameters are
+  // needed by some modules
+  gHaRun = fRun;
+
+  // Configure decoder flags
+  // Enable/disable helicity decoding as requested
+  fEvData->EnableHelicity( HelicityEnabled() );
+  // Set decoder reporting level. FIXME: update when THaEvData is updated
+  fEvData->SetVerbose( (fVerbose>2) );
+  fEvData->SetDebug( (fVerbose>3) );
+  // Use alternate event type (currently only implemented by CodaDecoder)
+  fEvData->EnableAltEvType(AltEvTypeEnabled());
+
+  // Informational messages
+  if( fVerbose>1 ) {
+    cout << "Decoder: helicity "
+	 << (fEvData->HelicityEnabled() ? "enabled" : "disabled")
+	 << endl;
+    cout << endl << "Starting analysis" << endl;
+  }
+  // Events prior to fRun->GetFirstEvent() are skipped in MainAnalysis()
+  if( fVerbose>2 && fRun->GetFirstEvent()>1 )
+    cout << "Skipping " << fRun->GetFirstEvent() << " events" << endl;
+
+  //--- The main event loop.
+
+  StageProfiler::Scope timer(fProfID[kProfInit]);
+  fNev = 0;
+  bool terminate = false, fatal = false;
+  UInt_t nlast = fRun->GetLastEvent();
+  fAnalysisStarted = true;
+  PrepareModuleList();
+  timer.Stop();
+  BeginAnalysis();
+  if( fFile ) {
+    timer.Start(fProfID[kProfOutput]);
+    fFile->cd();
+    fRun->Write("Run_Data");  // Save run data to first ROOT file
+    timer.Stop();
+  }
+
+  status = workers ? RunWorkers(terminate, fatal)
+                   : EventLoop(terminate, fatal);
+
   EndAnalysis();
 
   //--- Close the input file
-  fRun->Close();
+  if( !workers )
+    fRun->Close();
 
   // Save final run parameters in run object of caller, if any
   *run = *fRun;
@@ -1691,7 +2309,7 @@ Long64_t THaAnalyzer::Process( THaRunBase* run )
   // This writes the Tree as well as any objects (histograms etc.)
   // that are defined in the current directory.
 
-  if( fDoBench ) fBench->Begin("Output");
+  timer.Start(fProfID[kProfOutput]);
   // Ensure that we are in the output file's current directory
   // ... someone might have pulled the rug from under our feet
 
@@ -1702,10 +2320,11 @@ Long64_t THaAnalyzer::Process( THaRunBase* run )
   if( fOutput ) fOutput->End();
   if( fFile ) {
     fRun->Write("Run_Data");  // Save run data to ROOT file
+    WriteModuleTiming();
     //    fFile->Write();//already done by fOutput->End()
     fFile->Purge();         // get rid of excess object "cycles"
   }
-  if( fDoBench ) fBench->Stop("Output");
+  timer.Stop();
 
   fBench->Stop("Total");
 
@@ -1750,7 +2369,9 @@ void THaAnalyzer::SetCodaVersion( Int_t vers )
 void THaAnalyzer::PrepareModuleList()
 {
   // Fill fAnalysisModules in the order fApps, fInterStage, fPhysics to be
-  // used with PhysicsAnalysis().
+  // used with PhysicsAnalysis(). If module timing is enabled, also register
+  // a profiler stage "Module/<name>/<call>" for each call that
+  // PhysicsAnalysis() makes to each module.
 
   fAnalysisModules.clear();
   fAnalysisModules.reserve(fApps.size() + fInterStage.size() +
@@ -1758,6 +2379,30 @@ void THaAnalyzer::PrepareModuleList()
   fAnalysisModules.insert(fAnalysisModules.end(), ALL(fApps));
   fAnalysisModules.insert(fAnalysisModules.end(), ALL(fInterStage));
   fAnalysisModules.insert(fAnalysisModules.end(), ALL(fPhysics));
+
+  for( auto& ids : fModProfID )
+    ids.clear();
+  fInterProfID.clear();
+  if( !fDoModuleTiming )
+    return;
+
+  auto& prof = StageProfiler::Instance();
+  auto reg = [&prof]( const TObject* obj, const char* call ) {
+    return prof.Register(string("Module/") + obj->GetName() + "/" + call);
+  };
+  for( const auto* app : fApps ) {
+    fModProfID[kModDecode].push_back(reg(app, "Decode"));
+    fModProfID[kModCoarseReconstruct].push_back(reg(app, "CoarseReconstruct"));
+    fModProfID[kModReconstruct].push_back(reg(app, "Reconstruct"));
+  }
+  for( const auto* spectro : fSpectrometers ) {
+    fModProfID[kModCoarseTrack].push_back(reg(spectro, "CoarseTrack"));
+    fModProfID[kModTrack].push_back(reg(spectro, "Track"));
+  }
+  for( const auto* physmod : fPhysics )
+    fModProfID[kModProcess].push_back(reg(physmod, "Process"));
+  for( const auto* mod : fInterStage )
+    fInterProfID.push_back(reg(mod, "Process"));
 }
 
 //_____________________________________________________________________________
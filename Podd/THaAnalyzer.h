@@ -9,6 +9,7 @@
 
 #include "TObject.h"
 #include "TString.h"
+#include <array>
 #include <vector>
 #include <memory>
 
@@ -20,6 +21,7 @@ class TIter;
 class TFile;
 class TDatime;
 class THaCut;
+class THaCutBlock;
 class THaBenchmark;
 class THaEvData;
 class THaPostProcess;
@@ -31,6 +33,7 @@ class THaPhysicsModule;
 class THaAnalysisObject;
 namespace Podd {
   class InterStageModule;
+  class EventPartition;
 }
 
 class THaAnalyzer : public TObject {
@@ -53,6 +56,7 @@ public:
 
   void           EnableBenchmarks( Bool_t b = true );
   void           EnableHelicity( Bool_t b = true );
+  void           EnableModuleTiming( Bool_t b = true );
   void           EnableOtherEvents( Bool_t b = true );
   void           EnableOverwrite( Bool_t b = true );
   void           EnablePhysicsEvents( Bool_t b = true );
@@ -63,6 +67,7 @@ public:
   const char*    GetCutFileName()      const  { return fCutFileName.Data(); }
   const char*    GetOdefFileName()     const  { return fOdefFileName.Data(); }
   const char*    GetSummaryFileName()  const  { return fSummaryFileName.Data(); }
+  const char*    GetTimingFileName()   const  { return fTimingFileName.Data(); }
   TFile*         GetOutFile()          const  { return fFile; }
   Int_t          GetCompressionLevel() const  { return fCompress; }
   THaEvent*      GetEvent()            const  { return fEvent; }
@@ -79,6 +84,7 @@ public:
                  GetPostProcess()      const  { return fPostProcess; }
   Bool_t         HasStarted()          const  { return fAnalysisStarted; }
   Bool_t         HelicityEnabled()     const  { return fDoHelicity; }
+  Bool_t         ModuleTimingEnabled() const  { return fDoModuleTiming; }
   Bool_t         PhysicsEnabled()      const  { return fDoPhysics; }
   Bool_t         OtherEventsEnabled()  const  { return fDoOtherEvents; }
   Bool_t         SlowControlEnabled()  const  { return fDoSlowControl; }
@@ -92,9 +98,13 @@ public:
   void           SetCutFile( const char* name )     { fCutFileName = name; }
   void           SetOdefFile( const char* name )    { fOdefFileName = name; }
   void           SetSummaryFile( const char* name ) { fSummaryFileName = name; }
+  void           SetTimingFile( const char* name )  { fTimingFileName = name; }
   void           SetCompressionLevel( Int_t level ) { fCompress = level; }
   void           SetMarkInterval( UInt_t interval ) { fMarkInterval = interval; }
   void           SetVerbosity( Int_t level )        { fVerbose = level; }
+  void           SetReadAhead( UInt_t depth, size_t max_bytes = 0 );
+  void           SetNumWorkers( UInt_t n );
+  UInt_t         GetNumWorkers()       const  { return fNumWorkers; }
   void           SetCodaVersion(Int_t vers);
 
   // Set the EPICS event type
@@ -125,7 +135,7 @@ protected:
     Int_t         key;
     Int_t         countkey;
     const char*   name;
-    TList*        cut_list;
+    THaCutBlock*  cut_list;
     TList*        hist_list;
     THaCut*       master_cut;
   };
@@ -153,6 +163,7 @@ protected:
   TString        fLoadedCutFileName;//Name of last loaded cut definition file
   TString        fOdefFileName;    //Name of output definition file
   TString        fSummaryFileName; //Name of test/cut statistics output file
+  TString        fTimingFileName;  //Name of timing statistics file (JSON/CSV)
   THaEvent*      fEvent;           //The event structure to be written to file.
   Int_t          fWantCodaVers;    //Version of CODA assumed for file
   std::vector<Stage_t>   fStages;  //Parameters for analysis stages
@@ -162,7 +173,12 @@ protected:
   Int_t          fCompress;        //Compression level for ROOT output file
   Int_t          fVerbose;         //Verbosity level
   Int_t          fCountMode;       //Event counting mode (see ECountMode)
-  THaBenchmark*  fBench;           //Counters for timing statistics
+  UInt_t         fReadAheadDepth;  //Default events to read ahead (0 = off)
+  size_t         fReadAheadBytes;  //Default memory limit for read-ahead
+  UInt_t         fCutVarChanges;   //gHaVars->GetChangeCount() at last cut compilation
+  UInt_t         fNumWorkers;      //Worker processes for event-parallel replay
+  Podd::EventPartition* fPartition;//!Events of this worker process, if any
+  THaBenchmark*  fBench;           //Counter for total run time
   THaEvent*      fPrevEvent;       //Event structure from last Init()
   THaRunBase*    fRun;             //Pointer to current run
   THaEvData*     fEvData;          //Instance of decoder used by us
@@ -186,12 +202,28 @@ protected:
   Bool_t         fUpdateRun;       // Update run parameters during replay
   Bool_t         fOverwrite;       // Overwrite existing output files
   Bool_t         fDoBench;         // Collect detailed timing statistics
+  Bool_t         fDoModuleTiming;  // Time each analysis module separately
   Bool_t         fDoHelicity;      // Enable helicity decoding
   Bool_t         fDoPhysics;       // Enable physics event processing
   Bool_t         fDoOtherEvents;   // Enable other event processing
   Bool_t         fDoSlowControl;   // Enable slow control processing
   Bool_t         fUseAltEvType;    // Take event type from trigger supervisor
 
+  // Event loop stages timed with Podd::StageProfiler
+  enum EProfStage { kProfInit, kProfBegin, kProfRawDecode, kProfDecode,
+                    kProfCoarseTracking, kProfCoarseReconstruct,
+                    kProfTracking, kProfReconstruct, kProfPhysics, kProfEnd,
+                    kProfOutput, kProfCuts, kProfPostProcess, kNProfStages };
+  std::array<UInt_t,kNProfStages> fProfID; //! Profiler stage IDs
+
+  // Per-module timing of the calls made by PhysicsAnalysis
+  enum EModCall { kModDecode, kModCoarseTrack, kModCoarseReconstruct,
+                  kModTrack, kModReconstruct, kModProcess, kNModCalls };
+  // Profiler IDs for each call, parallel to the module list that the call
+  // iterates over (fApps, fSpectrometers or fPhysics). Empty if disabled.
+  std::array<std::vector<UInt_t>,kNModCalls> fModProfID; //!
+  std::vector<UInt_t> fInterProfID; //! Same for fInterStage
+
   // Variables used by analysis functions
   Bool_t         fFirstPhysics;    // Status flag for physics analysis
 
@@ -206,11 +238,22 @@ protected:
   virtual Int_t  PostProcess( Int_t code );
   virtual Int_t  ReadOneEvent();
 
+  // Event loop and event-parallel replay
+  Int_t          EventLoop( bool& terminate, bool& fatal );
+  void           EvtHandlerAnalysis();
+  Bool_t         UseWorkers() const;
+  TString        WorkerFileName( UInt_t worker ) const;
+  Int_t          RunWorkers( bool& terminate, bool& fatal );
+  Int_t          RunWorker( Podd::EventPartition& part );
+  Int_t          MergeWorkers( Long64_t lastblock, bool& terminate,
+                               bool& fatal );
+
   // Support methods & data
   void           ClearCounters();
   ULong64_t      GetCount( Int_t which ) const;
   ULong64_t      Incr( Int_t which );
   virtual bool   EvalStage( int n );
+  void           InterStageAnalysis( Int_t stage, THaAnalysisObject*& obj );
   virtual void   InitCounters();
   virtual void   InitCuts();
   virtual void   InitStages();
@@ -226,6 +269,7 @@ protected:
   virtual void   PrintCutSummary() const;
   virtual void   PrintTimingSummary() const;
   virtual void   PrintSummary( EExitStatus exit_status ) const;
+  virtual Int_t  WriteModuleTiming() const;
 
   static THaAnalyzer* fgAnalyzer;  //Pointer to instance of this class
 
@@ -31,6 +31,8 @@ THaBPM::THaBPM( const char* name, const char* description,
   fRot2HCSPos(NCHAN/2,NCHAN/2), fCalibRot(0)
 {
   // Constructor
+
+  UseDBFingerprint(Class());
 }
 
 
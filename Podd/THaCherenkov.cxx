@@ -33,6 +33,8 @@ THaCherenkov::THaCherenkov( const char* name, const char* description,
   , fASUM_c(kBig)
 {
   // Constructor
+
+  UseDBFingerprint(Class());
 }
 
 //_____________________________________________________________________________
@@ -19,6 +19,7 @@ using namespace Decoder;
 //_____________________________________________________________________________
 THaCodaRun::THaCodaRun( const char* description )
   : THaRunBase(description), fCodaData(nullptr)
+  , fReadAheadDepth(0), fReadAheadBytes(0), fReadAheadSet(false)
 {
   // Normal & default constructor
 }
@@ -26,6 +27,8 @@ THaCodaRun::THaCodaRun( const char* description )
 //_____________________________________________________________________________
 THaCodaRun::THaCodaRun( const THaCodaRun& rhs )
   : THaRunBase(rhs), fCodaData(nullptr)
+  , fReadAheadDepth(rhs.fReadAheadDepth), fReadAheadBytes(rhs.fReadAheadBytes)
+  , fReadAheadSet(rhs.fReadAheadSet)
 {
   // Normal & default constructor
 }
@@ -43,6 +46,11 @@ THaCodaRun& THaCodaRun::operator=(const THaRunBase& rhs)
   if( this != &rhs ) {
     THaRunBase::operator=(rhs);
     fCodaData = nullptr;
+    if( const auto* codarun = dynamic_cast<const THaCodaRun*>(&rhs) ) {
+      fReadAheadDepth = codarun->fReadAheadDepth;
+      fReadAheadBytes = codarun->fReadAheadBytes;
+      fReadAheadSet   = codarun->fReadAheadSet;
+    }
   }
   return *this;
 }
@@ -125,5 +133,42 @@ Int_t THaCodaRun::ReadEvent()
   return ReturnCode( fCodaData->codaRead() );
 }
 
+//_____________________________________________________________________________
+Int_t THaCodaRun::SetReadAhead( UInt_t depth, size_t max_bytes )
+{
+  // Read up to 'depth' events ahead on a background thread, keeping at most
+  // about 'max_bytes' of event buffers in memory (0 = default limit).
+  // ReadEvent() and GetEvBuffer() then hand out the read-ahead buffers
+  // without copying. depth = 0 (default) disables read-ahead.
+  //
+  // The setting is copied with the run. It overrides any default given
+  // with SetDefaultReadAhead(). It cannot be changed while events are being
+  // read ahead, i.e. between the first ReadEvent() after Open() and Close().
+  // Returns READ_ERROR if the data source does not support read-ahead.
+
+  if( fCodaData ) {
+    Int_t st = ReturnCode(fCodaData->setReadAhead(depth, max_bytes));
+    if( st != READ_OK )
+      return st;
+  }
+  fReadAheadDepth = depth;
+  fReadAheadBytes = max_bytes;
+  fReadAheadSet = true;
+  return READ_OK;
+}
+
+//_____________________________________________________________________________
+Int_t THaCodaRun::SetDefaultReadAhead( UInt_t depth, size_t max_bytes )
+{
+  // Like SetReadAhead(), but only if read-ahead has not been configured
+  // explicitly for this run. Used by THaAnalyzer to apply its default.
+
+  if( fReadAheadSet )
+    return READ_OK;
+  Int_t st = SetReadAhead(depth, max_bytes);
+  fReadAheadSet = false;
+  return st;
+}
+
 //_____________________________________________________________________________
 ClassImp(THaCodaRun)
@@ -26,11 +26,19 @@ public:
   virtual Int_t          SetDataVersion( Int_t version );
   Int_t                  GetCodaVersion();
   Int_t                  SetCodaVersion( Int_t version );
+  virtual Int_t          SetReadAhead( UInt_t depth, size_t max_bytes = 0 );
+  Int_t                  SetDefaultReadAhead( UInt_t depth, size_t max_bytes = 0 );
+  UInt_t                 GetReadAheadDepth() const { return fReadAheadDepth; }
+  size_t                 GetReadAheadBytes() const { return fReadAheadBytes; }
+  Bool_t                 IsReadAheadSet()    const { return fReadAheadSet; }
 
 protected:
   static Int_t ReturnCode( Int_t coda_retcode);
 
   std::unique_ptr<Decoder::THaCodaData> fCodaData;  //! CODA data associated with this run
+  UInt_t  fReadAheadDepth;   //! Max. events to read ahead (0 = no read-ahead)
+  size_t  fReadAheadBytes;   //! Max. bytes of read-ahead buffers (0 = default)
+  Bool_t  fReadAheadSet;     //! Read-ahead configured with SetReadAhead()
 
   ClassDef(THaCodaRun,2)    // ABC for a run based on CODA data
 };
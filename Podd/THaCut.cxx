@@ -10,7 +10,9 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "THaCut.h"
+#include "THaCutList.h"
 #include "THaPrintOption.h"
+#include "THaVar.h"
 #include "THaGlobals.h"
 #include "TMath.h"
 
@@ -24,7 +26,8 @@ using namespace std;
 
 //_____________________________________________________________________________
 THaCut::THaCut()
-  : THaFormula(), fLastResult(false), fNCalled(0), fNPassed(0), fMode(kAND)
+  : THaFormula(), fLastResult(false), fNCalled(0), fNPassed(0), fMode(kAND),
+    fGenPtr(nullptr), fBlock(nullptr), fGeneration(0), fBusy(false)
 {
   // Default constructor
 }
@@ -33,7 +36,8 @@ THaCut::THaCut()
 THaCut::THaCut( const char* name, const char* expression, const char* block,
 		const THaVarList* vlst, const THaCutList* clst )
   : THaFormula(), fLastResult(false), fBlockname(block), fNCalled(0),
-    fNPassed(0), fMode(kAND)
+    fNPassed(0), fMode(kAND), fGenPtr(nullptr), fBlock(nullptr),
+    fGeneration(0), fBusy(false)
 {
   // Create a cut 'name' according to 'expression'.
   // The cut may use global variables from the list 'vlst' and other,
@@ -65,6 +69,20 @@ THaCut::THaCut( const char* name, const char* expression, const char* block,
   Compile();
 }
 
+//_____________________________________________________________________________
+Int_t THaCut::Compile( const char* expression )
+{
+  // Compile the expression and record the cuts and global variables
+  // it depends on
+
+  Int_t status = THaFormula::Compile( expression );
+  fDepends.clear();
+  fReads.clear();
+  if( !IsError() )
+    GetDependencies( fDepends, fReads );
+  return status;
+}
+
 //_____________________________________________________________________________
 Int_t THaCut::DefinedVariable(TString& name, Int_t& action)
 {
@@ -100,6 +118,7 @@ Double_t THaCut::Eval()
 
   ResetBit(kInvalid);
   fNCalled++;
+  fBusy = true;
   if( IsError() ) {
     fLastResult = false;
   }
@@ -147,6 +166,23 @@ Double_t THaCut::Eval()
       fNPassed++;
     }
   }
+  if( fGenPtr )
+    fGeneration = *fGenPtr;
+  fBusy = false;
+  return fLastResult;
+}
+
+//_____________________________________________________________________________
+Bool_t THaCut::Demand() const
+{
+  // Result of a cut of a THaCutList that has not yet been evaluated in the
+  // current event. If the list evaluates lazily and the cut's block has
+  // been reached in this event, evaluate the cut now. Otherwise, the cut
+  // is cleared, i.e. false.
+
+  if( fBusy || !fBlock || !fBlock->IsOpen() || !fBlock->IsLazy() )
+    return false;
+  const_cast<THaCut*>(this)->Eval();
   return fLastResult;
 }
 
@@ -227,7 +263,7 @@ void THaCut::Print( Option_t* option ) const
     cout << setw(nn) << GetName() << "  "
 	 << setw(nt) << GetTitle() << "  ";
     if( !strcmp( s.GetOption(), kPRINTLINE )) {
-      cout << setw(1)  << (bool)fLastResult << "  "
+      cout << setw(1)  << (IsCurrent() && fLastResult) << "  "
 	   << setw(nb) << fBlockname << "  ";
     }
     cout << setw(9)  << fNCalled << "  "
@@ -244,8 +280,17 @@ void THaCut::Print( Option_t* option ) const
 
     cout.flags( ios::right );
     THaFormula::Print( s.GetOption() );
-    cout << "Curval: " << setw(9) << (bool)fLastResult << "  "
+    cout << "Curval: " << setw(9) << (IsCurrent() && fLastResult) << "  "
 	 << "Block:  " << fBlockname << endl;
+    if( !strcmp( s.GetOption(), kPRINTFULL ) &&
+        (!fDepends.empty() || !fReads.empty()) ) {
+      cout << "Uses:   ";
+      for( const auto* cut : fDepends )
+        cout << " " << cut->GetName();
+      for( const auto* var : fReads )
+        cout << " " << var->GetName();
+      cout << endl;
+    }
     cout << "Called: " << setw(9) << fNCalled << "  "
 	 << "Passed: " << setw(9) << fNPassed;
     if( fNCalled > 0 ) {
@@ -9,6 +9,8 @@
 
 #include "THaFormula.h"
 
+class THaCutBlock;
+
 class THaCut : public THaFormula {
 
 public:
@@ -23,7 +25,8 @@ public:
 
   enum EvalMode { kModeErr = -1, kAND, kOR, kXOR };
 
-          void         ClearResult()        { fLastResult = false; }
+          void         ClearResult()        { fLastResult = false; fGeneration = 0; }
+  virtual Int_t        Compile( const char* expression="" );
   // Requires ROOT >= 4.00/00
   virtual Int_t        DefinedVariable( TString& variable, Int_t& action );
   virtual Double_t     Eval();
@@ -33,7 +36,13 @@ public:
           EvalMode     GetMode()      const { return fMode; }
           UInt_t       GetNCalled()   const { return fNCalled; }
           UInt_t       GetNPassed()   const { return fNPassed; }
-          Bool_t       GetResult()    const { return fLastResult; }
+          Bool_t       GetResult()    const;
+  // Cuts and global variables referenced by the expression
+  const std::vector<THaCut*>&       GetCutDependencies() const { return fDepends; }
+  const std::vector<const THaVar*>& GetVarDependencies() const { return fReads; }
+  // True if the result is that of the current event of the owning THaCutList
+          Bool_t       IsCurrent()    const
+  { return !fGenPtr || fGeneration == *fGenPtr; }
   virtual Bool_t       IsArray()      const { return false; }
   virtual Bool_t       IsVarArray()   const { return false; }
   virtual void         Print( Option_t *opt="" ) const;
@@ -41,6 +50,11 @@ public:
   virtual void         SetBlockname( const Text_t* name );
   virtual void         SetName( const Text_t* name );
   virtual void         SetNameTitle( const Text_t* name, const Text_t* title );
+  // Record the result of an evaluation done elsewhere, e.g. by compiled code
+          void         SetResult( Bool_t result );
+  // Set the statistics counters, e.g. to the totals of several processes
+          void         SetStatistics( UInt_t ncalled, UInt_t npassed )
+  { fNCalled = ncalled; fNPassed = npassed; }
 
 protected:
   Bool_t      fLastResult;  // Result of last evaluation of this formula
@@ -49,10 +63,43 @@ protected:
   UInt_t      fNPassed;     // Number of times this cut was true when evaluated
   EvalMode    fMode;        // Evaluation mode of array expressions (AND/OR etc.)
 
+  // Bookkeeping for cuts held in a THaCutList
+  const ULong64_t*    fGenPtr;     //! Event generation of the owning list
+  const THaCutBlock*  fBlock;      //! Block holding this cut
+  ULong64_t           fGeneration; //! Generation of fLastResult
+  Bool_t              fBusy;       //! Evaluation in progress
+  std::vector<THaCut*>       fDepends; //! Cuts referenced in the expression
+  std::vector<const THaVar*> fReads;   //! Global variables read
+
+  Bool_t      Demand() const;
   Bool_t      EvalElement( Int_t instance );
   EvalMode    ParsePrefix( TString& expr );
 
+  friend class THaCutList;
+
   ClassDef(THaCut,0)   // A logical cut (a.k.a. test)
 };
 
+//__________________inlines____________________________________________________
+inline
+Bool_t THaCut::GetResult() const
+{
+  if( !IsCurrent() )
+    return Demand();
+  return fLastResult;
+}
+
+//_____________________________________________________________________________
+inline
+void THaCut::SetResult( Bool_t result )
+{
+  ResetBit(kInvalid);
+  fNCalled++;
+  fLastResult = result;
+  if( result )
+    fNPassed++;
+  if( fGenPtr )
+    fGeneration = *fGenPtr;
+}
+
 #endif
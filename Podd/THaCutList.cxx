@@ -7,11 +7,25 @@
 //
 // Class to manage dynamically-defined cuts (tests).
 //
+// Results of cuts are valid for one event only. ClearAll() starts a new
+// event by incrementing a generation counter; a cut whose result was
+// computed in an earlier generation reads as false. Clearing thus takes
+// constant time regardless of the number of cuts.
+//
+// By default (kEager), Eval()/EvalBlock() evaluate all cuts of a block.
+// In kLazy mode, evaluating a block evaluates only its master cut, if one
+// is set, and the cuts it depends on. Any other cut of the block is
+// evaluated when its result is first requested in the event, and at most
+// once per event. Cuts of blocks that have not been evaluated in the
+// current event read as false. Note that in this mode the cut statistics
+// count only those events in which a cut was actually needed.
+//
 //////////////////////////////////////////////////////////////////////////
 
 #include "THaCut.h"
 #include "THaNamedList.h"
 #include "THaCutList.h"
+#include "FormulaJIT.h"
 #include "THaPrintOption.h"
 #include "Textvars.h"
 #include "THaGlobals.h"
@@ -48,10 +62,87 @@ void THaHashList::PrintOpt( Option_t* opt ) const
     obj->Print(opt);
 }
 
+//_____________________________________________________________________________
+THaCutBlock::THaCutBlock( const char* name, const THaCutList* owner )
+  : THaNamedList(name), fOwner(owner), fOpened(0), fMaster(nullptr)
+{
+  // Constructor. 'owner' provides the current event generation and
+  // evaluation mode.
+}
+
+//_____________________________________________________________________________
+void THaCutBlock::ClearResults()
+{
+  // Clear the results of all cuts in this block
+
+  if( fCutVec.size() != static_cast<size_t>(GetSize()) )
+    Update();
+  for( auto* pcut : fCutVec )
+    pcut->ClearResult();
+  fOpened = 0;
+}
+
+//_____________________________________________________________________________
+Int_t THaCutBlock::Eval()
+{
+  // Evaluate all cuts of this block in order of definition, with the
+  // compiled code if available. In lazy mode, evaluate only the master cut,
+  // unless already done in this event. Compiled code is not used in lazy
+  // mode since it always evaluates all cuts.
+  // Returns the number of cuts in the block, like THaCutList::EvalBlock.
+
+  if( fCutVec.size() != static_cast<size_t>(GetSize()) )
+    Update();
+  if( fOwner )
+    fOpened = fOwner->GetGeneration();
+  if( IsLazy() ) {
+    if( fMaster )
+      fMaster->GetResult();
+  } else if( fCompiled ) {
+    fCompiled->Eval();
+  } else {
+    for( auto* pcut : fCutVec )
+      pcut->EvalCut();
+  }
+  return static_cast<Int_t>(fCutVec.size());
+}
+
+//_____________________________________________________________________________
+void THaCutBlock::SetCompiled( std::shared_ptr<Podd::FormulaJIT> jit )
+{
+  // Evaluate the cuts of this block with 'jit', which must have been
+  // compiled from this block in its current state. nullptr reverts to
+  // the interpreter.
+
+  if( fCutVec.size() != static_cast<size_t>(GetSize()) )
+    Update();
+  fCompiled = std::move(jit);
+}
+
+//_____________________________________________________________________________
+void THaCutBlock::Update()
+{
+  // Rebuild the array of cuts from the list. Objects that are not cuts
+  // are ignored. Must be called when cuts are removed from the block.
+  // Compiled code, if any, no longer matches the cuts and is dropped.
+
+  fCompiled.reset();
+  fCutVec.clear();
+  fCutVec.reserve(GetSize());
+  TIter next(this);
+  while( TObject* obj = next() ) {
+    if( auto* pcut = dynamic_cast<THaCut*>(obj) )
+      fCutVec.push_back(pcut);
+  }
+  if( fMaster && find(fCutVec.begin(), fCutVec.end(), fMaster) == fCutVec.end() )
+    fMaster = nullptr;
+}
+
 //______________________________________________________________________________
 THaCutList::THaCutList()
   : fCuts(new THaHashList()), fBlocks(new THaHashList()),
-    fVarList(nullptr)
+    fVarList(nullptr), fGeneration(1), fEvalMode(kEager),
+    fChangeCount(0)
 {
   // Default constructor. No variable list is defined. Either define it
   // later with SetList() or pass the list as an argument to Define().
@@ -61,17 +152,37 @@ THaCutList::THaCutList()
 
 //______________________________________________________________________________
 THaCutList::THaCutList( const THaCutList& rhs )
-  : fCuts(new THaHashList(rhs.fCuts)), fBlocks(new THaHashList(rhs.fBlocks)),
-    fVarList(rhs.fVarList)
+  : fCuts(new THaHashList()), fBlocks(new THaHashList()),
+    fVarList(rhs.fVarList), fGeneration(1), fEvalMode(rhs.fEvalMode),
+    fChangeCount(0)
 {
-  // Copy constructor
-  
+  // Copy constructor. Defines new cuts with the names, expressions and
+  // blocks of the cuts in 'rhs', in the same order, so that cuts used in
+  // expressions refer to the new cuts. Block master cuts are carried over.
+
+  TIter next( rhs.fCuts );
+  while( auto* pcut = static_cast<THaCut*>( next() )) {
+    // The evaluation mode prefix was stripped from the expression
+    TString expr = pcut->GetTitle();
+    if( pcut->GetMode() == THaCut::kAND )
+      expr.Prepend("AND:");
+    else if( pcut->GetMode() == THaCut::kXOR )
+      expr.Prepend("XOR:");
+    Define( pcut->GetName(), expr, pcut->GetVarList(), pcut->GetBlockname() );
+  }
+  TIter nextb( rhs.fBlocks );
+  while( auto* plist = static_cast<THaCutBlock*>( nextb() )) {
+    THaCutBlock* block = FindBlock( plist->GetName() );
+    if( block && plist->GetMaster() )
+      block->SetMaster( FindCut( plist->GetMaster()->GetName() ));
+  }
 }
 
 //______________________________________________________________________________
 THaCutList::THaCutList( const THaVarList* lst ) 
   : fCuts(new THaHashList()), fBlocks(new THaHashList()),
-    fVarList(lst)
+    fVarList(lst), fGeneration(1), fEvalMode(kEager),
+    fChangeCount(0)
 {
   // Constructor from variable list. Create the main lists and set the variable
   // list.
@@ -96,6 +207,8 @@ void THaCutList::Clear( Option_t* )
 
   fBlocks->Delete();
   fCuts->Delete();
+  fCutByID.assign(fCutByID.size(), nullptr);
+  ++fChangeCount;
 }
 
 //______________________________________________________________________________
@@ -103,9 +216,7 @@ void THaCutList::ClearAll( Option_t* )
 {
   // Clear the results of all defined cuts
 
-  TIter next( fCuts );
-  while( auto* pcut = static_cast<THaCut*>( next() ))
-    pcut->ClearResult();
+  ++fGeneration;
 }
 
 //______________________________________________________________________________
@@ -113,9 +224,8 @@ void THaCutList::ClearBlock( const char* block, Option_t* )
 {
   // Clear the results of the defined cuts in the named block
 
-  TIter next( FindBlock(block) );
-  while( auto* pcut = static_cast<THaCut*>( next() ))
-    pcut->ClearResult();
+  if( THaCutBlock* plist = FindBlock(block) )
+    plist->ClearResults();
 }
 
 //______________________________________________________________________________
@@ -196,7 +306,7 @@ Int_t THaCutList::Define( const char* cutname, const char* expr,
 	   "%s %s block: %s", cutname, expr, block );
     return -7;
   }
-  if( fCuts->FindObject(cutname) ) {
+  if( FindCut(cutname) ) {
     Error( here, "duplicate cut name, cut not created: %s %s block: %s",
 	   cutname, expr, block );
     return -8;
@@ -216,12 +326,19 @@ Int_t THaCutList::Define( const char* cutname, const char* expr,
 
   auto* plist = FindBlock( block );
   if( !plist ) {
-    plist = new THaNamedList( block );
+    plist = new THaCutBlock( block, this );
     fBlocks->Add( plist );
   }
 
+  pcut->fGenPtr = &fGeneration;
+  pcut->fBlock  = plist;
   fCuts->AddLast( pcut );
   plist->AddLast( pcut );
+  Int_t id = fNames.Intern( pcut->GetName() );
+  if( id >= (Int_t)fCutByID.size() )
+    fCutByID.resize( id+1, nullptr );
+  fCutByID[id] = pcut;
+  ++fChangeCount;
   return 0;
 }
 
@@ -234,8 +351,8 @@ Int_t THaCutList::Eval()
 
   Int_t i = 0;
   TIter next( fBlocks );
-  while( auto* plist = static_cast<THaNamedList*>( next() ))
-    i += EvalBlock( plist );
+  while( auto* plist = static_cast<THaCutBlock*>( next() ))
+    i += plist->Eval();
 
   return i;
 }
@@ -248,6 +365,8 @@ Int_t THaCutList::EvalBlock( const TList* plist )
   // Only TObject* in the given list that inherit from THaCut* are evaluated.
 
   if( !plist ) return -1;
+  if( auto* pblock = dynamic_cast<const THaCutBlock*>(plist) )
+    return const_cast<THaCutBlock*>(pblock)->Eval();
   Int_t i = 0;
   TIter next( plist );
   while( TObject* pobj = next() ) {
@@ -503,7 +622,7 @@ void THaCutList::PrintCut( const char* cutname, Option_t* option ) const
 {
   // Print the definition of a single cut
 
-  auto* pcut = dynamic_cast<THaCut*>( fCuts->FindObject( cutname ));
+  THaCut* pcut = FindCut( cutname );
   if( !pcut ) return;
   pcut->Print( option );
 }
@@ -552,7 +671,7 @@ Int_t THaCutList::Result( const char* cutname, EWarnMode mode )
   // (0 if false, 1 if true).
   // If cut does not exist, return -1. Also, print warning if mode=kWarn.
 
-  auto* pcut = static_cast<THaCut*>( fCuts->FindObject( cutname ));
+  THaCut* pcut = FindCut( cutname );
   if( !pcut ) {
     if( mode == kWarn )
       Warning("Result", "No such cut: %s", cutname );
@@ -566,12 +685,17 @@ Int_t THaCutList::Remove( const char* cutname )
 {
   // Remove the named cut completely
 
-  auto* pcut = static_cast<THaCut*>( fCuts->FindObject( cutname ));
+  THaCut* pcut = FindCut( cutname );
   if ( !pcut ) return 0;
   const char* block = pcut->GetBlockname();
-  auto* plist = static_cast<THaNamedList*>(fBlocks->FindObject( block ));
-  if ( plist ) plist->Remove( pcut );
+  auto* plist = FindBlock( block );
+  if ( plist ) {
+    plist->Remove( pcut );
+    plist->Update();
+  }
   fCuts->Remove( pcut );
+  fCutByID[GetCutID( cutname )] = nullptr;
+  ++fChangeCount;
   delete pcut;
   return 1;
 }
@@ -590,10 +714,13 @@ Int_t THaCutList::RemoveBlock( const char* block )
     if( pcut ) i++;
     lnk = lnk->Next();
     fCuts->Remove( pcut );
+    if( pcut )
+      fCutByID[GetCutID( pcut->GetName() )] = nullptr;
   }
   plist->Delete();   // this should delete all pcuts
   fBlocks->Remove( plist );
   delete plist;
+  ++fChangeCount;
 
   return i;
 }
@@ -629,3 +756,4 @@ UInt_t IntDigits( Long64_t n )
 //______________________________________________________________________________
 ClassImp(THaCutList)
 ClassImp(THaHashList)
+ClassImp(THaCutBlock)
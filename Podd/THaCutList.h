@@ -10,10 +10,16 @@
 #include "THashList.h"
 #include "THaCut.h"
 #include "THaNamedList.h"
+#include "SymbolTable.h"
+#include <memory>
+#include <vector>
 
 class TList;
 class THaVarList;
 class THaPrintOption;
+namespace Podd {
+  class FormulaJIT;
+}
 
 // Utility class that provides the PrintOpt method
 class THaHashList : public THashList {
@@ -27,7 +33,39 @@ public:
   virtual void PrintOpt( Option_t* opt ) const;
   ClassDef(THaHashList,1) //A THashList list with a PrintOpt method
 };
-  
+
+class THaCutList;
+
+// A block of cuts. Evaluates its cuts from an array in order of definition
+// and remembers in which event it was last evaluated, see THaCutList.
+class THaCutBlock : public THaNamedList {
+public:
+  explicit THaCutBlock( const char* name = "", const THaCutList* owner = nullptr );
+
+  Int_t     Eval();
+  void      ClearResults();
+  THaCut*   GetMaster() const { return fMaster; }
+  Bool_t    IsLazy()    const;
+  Bool_t    IsOpen()    const;
+  // The block is decided by its master cut, if any. In lazy mode, Eval()
+  // evaluates only the master cut and the cuts it depends on.
+  void      SetMaster( THaCut* cut ) { fMaster = cut; }
+  // Compiled code for all cuts of the block (see Podd::FormulaJIT::AddBlock).
+  // Used by Eval() in eager mode. Dropped when the block changes.
+  void      SetCompiled( std::shared_ptr<Podd::FormulaJIT> jit );
+  Bool_t    IsCompiled() const { return fCompiled != nullptr; }
+  void      Update();
+
+protected:
+  const THaCutList*    fOwner;   //! List holding this block
+  ULong64_t            fOpened;  //! Generation in which block was evaluated
+  THaCut*              fMaster;  //! Cut that decides the block, if any
+  std::vector<THaCut*> fCutVec;  //! Cuts in order of definition
+  std::shared_ptr<Podd::FormulaJIT> fCompiled; //! Compiled cuts, if any
+
+  ClassDef(THaCutBlock,0) //A block of cuts
+};
+
 class THaCutList {
 
 public:
@@ -35,6 +73,7 @@ public:
   static const char* const kDefaultCutFile;
 
   enum EWarnMode { kWarn, kNoWarn };
+  enum EEvalMode { kEager, kLazy };
 
   THaCutList();
   THaCutList( const THaCutList& clst );
@@ -54,13 +93,25 @@ public:
   virtual Int_t     Eval();
   virtual Int_t     EvalBlock( const char* block=kDefaultBlockName );
   THaCut*           FindCut( const char* name ) const
-    { return static_cast<THaCut*>(fCuts->FindObject( name )); }
-  THaNamedList*     FindBlock( const char* block ) const
-    { return static_cast<THaNamedList*>(fBlocks->FindObject( block )); }
+    { return name ? FindCutByID( fNames.Find( name )) : nullptr; }
+  // Cut names are interned with IDs that remain valid when cuts are
+  // deleted and redefined under the same name
+  THaCut*           FindCutByID( Int_t id ) const
+    { return (id >= 0 && id < (Int_t)fCutByID.size()) ? fCutByID[id] : nullptr; }
+          Int_t     GetCutID( const char* name ) const
+    { return name ? fNames.Find( name ) : Podd::SymbolTable::kNoID; }
+  // Optimize name lookup once all cuts are defined
+          void      Freeze() { fNames.Freeze(); }
+  THaCutBlock*      FindBlock( const char* block ) const
+    { return static_cast<THaCutBlock*>(fBlocks->FindObject( block )); }
   const THashList*  GetCutList()   const { return fCuts; }   //These might disappear
   const THashList*  GetBlockList() const { return fBlocks; } //in future versions
           Int_t     GetNblocks()   const { return fBlocks->GetSize(); }
           Int_t     GetSize()      const { return fCuts->GetSize(); }
+          EEvalMode GetEvalMode()  const { return fEvalMode; }
+          ULong64_t GetGeneration() const { return fGeneration; }
+  // Incremented whenever cuts are added or removed
+          UInt_t    GetChangeCount() const { return fChangeCount; }
   virtual Int_t     Load( const char* filename=kDefaultCutFile );
   virtual void      Print( Option_t* option="" ) const;
   virtual void      PrintCut( const char* cutname, Option_t* option="" ) const;
@@ -70,6 +121,7 @@ public:
   virtual Int_t     Result( const char* cutname = "", EWarnMode mode=kWarn );
   virtual Int_t     Remove( const char* cutname );
   virtual Int_t     RemoveBlock( const char* block=kDefaultBlockName );
+          void      SetEvalMode( EEvalMode mode ) { fEvalMode = mode; }
   virtual void      SetList( THaVarList* lst );
 
   static  Int_t     EvalBlock( const TList* plist );
@@ -77,8 +129,13 @@ public:
 protected:
   THaHashList*      fCuts;    //Hash list holding all cuts
   THaHashList*      fBlocks;  //Hash list holding blocks of cuts.
-                              //Elements of this table are THaNamedLists of THaCuts
+                              //Elements of this table are THaCutBlocks of THaCuts
   const THaVarList* fVarList; //Pointer to list of variables
+  ULong64_t         fGeneration; //Current event, incremented by ClearAll()
+  EEvalMode         fEvalMode;   //Evaluate all cuts of a block, or on demand
+  Podd::SymbolTable fNames;      //!Interned cut names
+  std::vector<THaCut*> fCutByID; //!Cuts indexed by name ID
+  UInt_t            fChangeCount;  //!Change counter, see GetChangeCount()
 
   static  void      MakePrintOption( THaPrintOption& opt, 
 				     const TList* plist );
@@ -88,6 +145,20 @@ protected:
   ClassDef(THaCutList,0)  //Hash list of TCuts with support for blocks of cuts
 };
 
+//__________________inlines____________________________________________________
+inline
+Bool_t THaCutBlock::IsLazy() const
+{
+  return fOwner && fOwner->GetEvalMode() == THaCutList::kLazy;
+}
+
+//_____________________________________________________________________________
+inline
+Bool_t THaCutBlock::IsOpen() const
+{
+  return fOwner && fOpened == fOwner->GetGeneration();
+}
+
 // Global utility function
 UInt_t IntDigits( Long64_t n );
 
@@ -12,6 +12,8 @@
 #include "THaEpicsEbeam.h"
 #include "VarDef.h"
 #include "THaEvData.h"
+#include "THaAnalyzer.h"
+#include "THaEpicsEvtHandler.h"
 #include "TMath.h"
 
 //_____________________________________________________________________________
@@ -20,7 +22,7 @@ THaEpicsEbeam::THaEpicsEbeam( const char* name, const char* description,
 			      Double_t scale_factor ) : 
   THaPhysicsModule( name,description ), fEcorr(0.0), fEpicsIsMomentum(false),
   fScaleFactor(scale_factor), fBeamName(beam), fEpicsVar(epics_var), 
-  fBeamModule(nullptr)
+  fBeamModule(nullptr), fSlowControl(nullptr), fEpicsChan(-1)
 {
   // Constructor.
 }
@@ -54,6 +56,16 @@ THaAnalysisObject::EStatus THaEpicsEbeam::Init( const TDatime& run_time )
   if( !fBeamModule )
     return fStatus;
 
+  // Get the EPICS data from the analyzer's slow control service, if any.
+  // Otherwise, fall back to the decoder's EPICS interface.
+  fSlowControl = nullptr;
+  fEpicsChan = -1;
+  if( auto* analyzer = THaAnalyzer::GetInstance() ) {
+    fSlowControl = analyzer->GetEpicsEvtHandler();
+    if( fSlowControl )
+      fEpicsChan = fSlowControl->RegisterChannel(fEpicsVar);
+  }
+
   //this is done by THaBeamInfo::operator= in Process
   //  fBeamIfo.SetBeam( fBeamModule->GetBeamInfo()->GetBeam() );
 
@@ -88,8 +100,16 @@ Int_t THaEpicsEbeam::Process( const THaEvData& evdata )
 
   // Obtain current beam energy (or momentum) from EPICS
   // If requested EPICS variable not loaded, do nothing
-  if( evdata.IsLoadedEpics(fEpicsVar) ) {
-    Double_t e = evdata.GetEpicsData(fEpicsVar);
+  Bool_t have_epics = false;
+  Double_t e = 0;
+  if( fSlowControl && fSlowControl->IsValid(fEpicsChan) ) {
+    e = fSlowControl->GetValue(fEpicsChan);
+    have_epics = true;
+  } else if( evdata.IsLoadedEpics(fEpicsVar) ) {
+    e = evdata.GetEpicsData(fEpicsVar);
+    have_epics = true;
+  }
+  if( have_epics ) {
     // the scale factor must convert the EPICS value to GeV
     e *= fScaleFactor;
     Double_t m = fBeamIfo.GetM();
@@ -11,6 +11,8 @@
 #include "THaBeamModule.h"
 #include "TString.h"
 
+class THaEpicsEvtHandler;
+
 class THaEpicsEbeam : public THaPhysicsModule, public THaBeamModule {
   
 public:
@@ -47,6 +49,8 @@ protected:
   TString        fBeamName;    // Name of input beam module
   TString        fEpicsVar;    // Name of EPICS variable to use for beam energy
   THaBeamModule* fBeamModule;  // Pointer to input beam module
+  THaEpicsEvtHandler* fSlowControl; // Slow control service, if available
+  Int_t          fEpicsChan;   // Channel ID of fEpicsVar in fSlowControl
 
   ClassDef(THaEpicsEbeam,0)    // Beam module using beam energy from EPICS
 };
@@ -15,6 +15,18 @@
 //   To use as a plugin with your own modifications, you can do this:
 //       gHaEvtHandlers->Add (new THaEpicsEvtHandler("epics","HA EPICS event type 131"));
 //
+//   Slow control service: physics modules that need EPICS values,
+//   e.g. THaEpicsEbeam, register the channels in their Init() with
+//   RegisterChannel() on the analyzer's handler
+//   (THaAnalyzer::GetEpicsEvtHandler()). For each physics event, the
+//   analyzer calls UpdateChannels(), which moves a cursor along each
+//   channel's history to the current event, so the values are then
+//   available by channel ID via GetValue() and as global variables,
+//   without any lookups by name. Channels registered with kInterpolate
+//   are interpolated between the readings before and after the event
+//   whenever the later reading is already in the history, e.g. when the
+//   EPICS data of the run have been loaded ahead of the physics events.
+//
 /////////////////////////////////////////////////////////////////////
 
 #include "THaEvtTypeHandler.h"
@@ -25,7 +37,9 @@
 #include "TTree.h"
 #include "TString.h"
 #include <iostream>
+#include <algorithm>
 #include "THaVarList.h"
+#include "DataType.h"   // for kBig
 
 using namespace std;
 using namespace Decoder;
@@ -37,6 +51,14 @@ THaEpicsEvtHandler::THaEpicsEvtHandler( const char* name,
 {
 }
 
+THaEpicsEvtHandler::~THaEpicsEvtHandler() {
+  if( gHaVars ) {
+    for( const auto& ch : fSlowChans )
+      if( !ch.varname.IsNull() )
+        gHaVars->RemoveName(ch.varname);
+  }
+}
+
 Int_t THaEpicsEvtHandler::End( THaRunBase* ) {
   return 0;
 }
@@ -64,6 +86,89 @@ TString THaEpicsEvtHandler::GetString( const char* tag, UInt_t event ) const {
   return {fEpics->GetString(tag, event).c_str()};
 }
 
+Int_t THaEpicsEvtHandler::RegisterChannel( const char* tag, ESlowMode mode ) {
+  // Register EPICS channel 'tag' with the slow control service. Returns the
+  // channel ID for IsValid() and GetValue(), or -1 on error. Registering
+  // the same tag and mode again returns the same ID.
+  //
+  // kLastKnown:   value of the most recent EPICS reading at or before the
+  //               physics event.
+  // kInterpolate: linear interpolation, in event number, between that
+  //               reading and the next one in the history (a look-ahead of
+  //               one reading). If the next reading has not been loaded
+  //               yet, the last-known value is used, see IsInterpolated().
+  //
+  // The value is invalid if there is no reading at or before the event, or
+  // if the reading has been dropped from the history (see SetRetention).
+  //
+  // The value is also defined as global variable <prefix><tag> (suffix
+  // "_interp" for kInterpolate), with characters that TTree::Draw would
+  // misinterpret replaced by '_', like in the EPICS tree.
+
+  if( !tag || !*tag || !fEpics )
+    return -1;
+  auto handle = fEpics->GetHandle(tag);
+  for( size_t i = 0; i < fSlowChans.size(); ++i ) {
+    if( fSlowChans[i].handle == handle && fSlowChans[i].mode == mode )
+      return static_cast<Int_t>(i);
+  }
+  fSlowChans.push_back({handle, mode, 0, false, false, kBig, ""});
+  auto& ch = fSlowChans.back();
+
+  if( !fPrefix || !*fPrefix )
+    MakePrefix();
+  TString name = tag;
+  for( const char* c = ":+-*/="; *c; ++c )
+    name.ReplaceAll(TString(*c), "_");
+  name.Prepend(fPrefix);
+  if( mode == kInterpolate )
+    name.Append("_interp");
+  if( gHaVars && !gHaVars->Find(name) ) {
+    TString desc = TString("EPICS ") + tag;
+    if( mode == kInterpolate )
+      desc.Append(" (interpolated)");
+    if( gHaVars->Define(name, desc, ch.value) )
+      ch.varname = name;
+  }
+  return static_cast<Int_t>(fSlowChans.size() - 1);
+}
+
+void THaEpicsEvtHandler::UpdateChannels( ULong64_t event ) {
+  // Set the values of all registered channels for physics event 'event'.
+  // Each channel keeps a cursor into its history. Since events are normally
+  // analyzed in order, moving it to 'event' takes at most a few steps.
+  // The cursor is an index, so it shifts to later entries when old ones are
+  // pruned (see SetRetention). The backward walk corrects for this.
+
+  for( auto& ch : fSlowChans ) {
+    ch.valid = false;
+    ch.interpolated = false;
+    ch.value = kBig;
+    UInt_t n = fEpics->GetNEntries(ch.handle);
+    if( n == 0 )
+      continue;
+    UInt_t i = std::min(ch.cursor, n-1);
+    while( i > 0 && fEpics->GetEntry(ch.handle, i).GetEvNum() > event )
+      --i;
+    while( i+1 < n && fEpics->GetEntry(ch.handle, i+1).GetEvNum() <= event )
+      ++i;
+    ch.cursor = i;
+    const EpicsChan& a = fEpics->GetEntry(ch.handle, i);
+    if( a.GetEvNum() > event )
+      continue;  // No reading yet
+    ch.value = a.GetData();
+    ch.valid = true;
+    if( ch.mode == kInterpolate && i+1 < n ) {
+      // The entry after the cursor is the first reading after the event
+      const EpicsChan& b = fEpics->GetEntry(ch.handle, i+1);
+      ch.value += (b.GetData() - a.GetData()) *
+        static_cast<Double_t>(event - a.GetEvNum()) /
+        static_cast<Double_t>(b.GetEvNum() - a.GetEvNum());
+      ch.interpolated = true;
+    }
+  }
+}
+
 Int_t THaEpicsEvtHandler::Analyze( THaEvData* evdata ) {
 
   if ( !IsMyEvent(evdata->GetEvType()) ) return -1;
@@ -82,11 +187,16 @@ Int_t THaEpicsEvtHandler::Analyze( THaEvData* evdata ) {
 
   if (fDebugFile) EvDump(evdata);
 
-  fEpics->LoadData(evbuffer, recent_event);
+  LoadData(evbuffer, recent_event);
 
   return 1;
 }
 
+Int_t THaEpicsEvtHandler::LoadData( const UInt_t* evbuffer, ULong64_t event ) {
+  if ( !fEpics || !evbuffer ) return 0;
+  return fEpics->LoadData(evbuffer, event);
+}
+
 THaAnalysisObject::EStatus THaEpicsEvtHandler::Init( const TDatime& ) {
 
   if( fDebug )
@@ -16,6 +16,7 @@
 #include "TString.h"
 #include <string>
 #include <vector>
+#include <deque>
 #include <memory>
 
 class THaEpicsEvtHandler : public THaEvtTypeHandler {
@@ -23,18 +24,59 @@ class THaEpicsEvtHandler : public THaEvtTypeHandler {
 public:
 
    THaEpicsEvtHandler(const char* name, const char* description);
+   virtual ~THaEpicsEvtHandler();
 
    virtual Int_t Analyze(THaEvData *evdata);
    virtual EStatus Init( const TDatime& run_time);
    virtual Int_t End( THaRunBase* r=nullptr );
+   // Load the EPICS data in 'evbuffer', recorded at physics event 'event'
+   Int_t LoadData( const UInt_t* evbuffer, ULong64_t event );
    Bool_t IsLoaded(const char* tag) const;
    Double_t GetData( const char* tag, UInt_t event = 0 ) const;
    time_t GetTime( const char* tag, UInt_t event = 0 ) const;
    TString GetString( const char* tag, UInt_t event = 0 ) const;
 
+   // Fast access for repeated lookups, see THaEpics::GetHandle/GetChan
+   Decoder::THaEpics::Handle_t GetHandle( const char* tag )
+   { return fEpics ? fEpics->GetHandle(tag) : Decoder::THaEpics::kNoHandle; }
+   const Decoder::EpicsChan* GetChan( Decoder::THaEpics::Handle_t h,
+                                      ULong64_t event = 0 ) const
+   { return fEpics ? fEpics->GetChan(h, event) : nullptr; }
+   // Limit history kept per channel to 'nevents' (0 = unlimited)
+   void SetRetention( ULong64_t nevents )
+   { if( fEpics ) fEpics->SetRetention(nevents); }
+
+   // Slow control service for physics modules. Channels are registered
+   // once, typically in the module's Init(), and their values at the
+   // current physics event are then available by channel ID.
+   enum ESlowMode { kLastKnown, kInterpolate };
+   Int_t    RegisterChannel( const char* tag, ESlowMode mode = kLastKnown );
+   Bool_t   IsValid( Int_t id ) const
+   { return id >= 0 && id < (Int_t)fSlowChans.size() && fSlowChans[id].valid; }
+   Double_t GetValue( Int_t id ) const { return fSlowChans[id].value; }
+   // True if the current value of a kInterpolate channel was interpolated,
+   // false if it is the last-known value
+   Bool_t   IsInterpolated( Int_t id ) const
+   { return IsValid(id) && fSlowChans[id].interpolated; }
+   // Set values of all registered channels for physics event 'event'.
+   // Called by the analyzer before the physics analysis of each event.
+   void     UpdateChannels( ULong64_t event );
+
 private:
 
    std::unique_ptr<Decoder::THaEpics> fEpics;
+
+   struct SlowChan_t {
+     Decoder::THaEpics::Handle_t handle; // Channel in fEpics
+     ESlowMode mode;        // Last-known or interpolated value
+     UInt_t    cursor;      // Index of last entry at or before current event
+     Bool_t    valid;       // Value available for current event
+     Bool_t    interpolated; // Value interpolated to current event
+     Double_t  value;       // Value at current event (global variable)
+     TString   varname;     // Name of global variable
+   };
+   std::deque<SlowChan_t> fSlowChans;  //! Registered channels (deque, since
+                                       //  global variables point to 'value')
    static const Int_t MAXDATA=20000;
 
    THaEpicsEvtHandler(const THaEpicsEvtHandler& fh);
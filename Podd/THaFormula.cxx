@@ -31,6 +31,11 @@
 #include <algorithm>
 #include <numeric>
 #include <vector>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <limits>
+#include <cstdint>
 
 using namespace std;
 
@@ -51,11 +56,52 @@ inline Int_t NumberOfSetBits( ULong64_t v )
     Podd::NumberOfSetBits( static_cast<UInt_t>(v>>32) );
 }}
 
+// Bytecode operations. Operands are registers unless noted otherwise.
+enum EOpCode {
+  kOpImm,          // dst = fImm[arg]
+  kOpLoadElem,     // dst = element fLoads[arg].index of variable, all lanes
+  kOpLoadArray,    // dst = elements first ... first+n-1 of fLoads[arg]
+  kOpDefined,      // dst = DefinedValue(arg), all lanes
+  kOpDefinedLanes, // dst = DefinedValue(arg) evaluated for each instance
+  kOpIteration,    // dst = instance number
+  kOpAdd, kOpSub, kOpMul, kOpDiv, kOpMod, kOpPow, kOpFmod, kOpAtan2,
+  kOpMin, kOpMax, kOpAnd, kOpOr, kOpEq, kOpNe, kOpLt, kOpGt, kOpLe, kOpGe,
+  kOpBitAnd, kOpBitOr, kOpShl, kOpShr,
+  kOpNeg, kOpNot, kOpAbs, kOpSign, kOpInt, kOpSq, kOpSqrt,
+  kOpSin, kOpCos, kOpTan, kOpAsin, kOpAcos, kOpAtan,
+  kOpSinh, kOpCosh, kOpTanh, kOpAsinh, kOpAcosh, kOpAtanh,
+  kOpExp, kOpLog, kOpLog10,
+  kOpJumpIfFalse,  // if a == 0: dst = 0, continue at arg (scalar only)
+  kOpJumpIfTrue    // if a != 0: dst = 1, continue at arg (scalar only)
+};
+
+//_____________________________________________________________________________
+namespace {
+template<typename F>
+inline void Unary( Double_t* d, const Double_t* x, Int_t n, F f )
+{
+  for( Int_t l = 0; l < n; ++l )
+    d[l] = f(x[l]);
+}
+
+//_____________________________________________________________________________
+template<typename F>
+inline void Binary( Double_t* d, const Double_t* x, const Double_t* y,
+                    Int_t n, F f )
+{
+  for( Int_t l = 0; l < n; ++l )
+    d[l] = f(x[l], y[l]);
+}
+} // namespace
+
+Bool_t THaFormula::fgBytecode = true;
+
 //_____________________________________________________________________________
 THaFormula::THaFormula()
   : fVarList(nullptr)
   , fCutList(nullptr)
   , fInstance(0)
+  , fHasJumps(false)
 {
   // Default constructor
 
@@ -69,6 +115,7 @@ THaFormula::THaFormula( const char* name, const char* expression,
   : fVarList(vlst)
   , fCutList(clst)
   , fInstance(0)
+  , fHasJumps(false)
 {
   // Create a formula 'expression' with name 'name' and symbolic variables
   // from the list 'lst'.
@@ -158,7 +205,9 @@ Int_t THaFormula::Init( const char* name, const char* expression )
 //_____________________________________________________________________________
 THaFormula::THaFormula( const THaFormula& rhs ) : // NOLINT(misc-no-recursion)
   TFormula(rhs), fVarDef(rhs.fVarDef),
-  fVarList(rhs.fVarList), fCutList(rhs.fCutList), fInstance(0)
+  fVarList(rhs.fVarList), fCutList(rhs.fCutList), fInstance(0),
+  fCode(rhs.fCode), fLoads(rhs.fLoads), fImm(rhs.fImm), fRegs(rhs.fRegs),
+  fHasJumps(rhs.fHasJumps)
 {
   // Copy ctor
 }
@@ -175,6 +224,11 @@ THaFormula& THaFormula::operator=( const THaFormula& rhs )
     fVarList = rhs.fVarList;
     fCutList = rhs.fCutList;
     fInstance = 0;
+    fCode    = rhs.fCode;
+    fLoads   = rhs.fLoads;
+    fImm     = rhs.fImm;
+    fRegs    = rhs.fRegs;
+    fHasJumps = rhs.fHasJumps;
   }
   return *this;
 }
@@ -240,6 +294,7 @@ Int_t THaFormula::Compile( const char* expression )
   fNval = 0;
   fAlreadyFound.ResetAllBits(); // Seems to be missing in ROOT
   fVarDef.clear();
+  fCode.clear();
   ResetBit(kArrayFormula);
 
   Int_t status = TFormula::Compile( expression );
@@ -257,6 +312,8 @@ Int_t THaFormula::Compile( const char* expression )
     // but the best we can do with the implementation of TFormula.
     if( fNstring > 0 && fNval > 0 )
       fNval = fNstring = static_cast<Int_t>(fVarDef.size());
+
+    Translate();
   }
   return status;
 }
@@ -361,11 +418,8 @@ Double_t THaFormula::DefinedValue( Int_t i ) // NOLINT(misc-no-recursion)
 	return NumberOfSetBits( static_cast<ULong64_t>(y) );
       }
 
-      vector<Double_t> values;
-      values.reserve(ndata);
-      for( Int_t instance = 0; instance < ndata; ++instance ) {
-	values.push_back( func->EvalInstance(instance) );
-      }
+      vector<Double_t>& values = fScratch;
+      func->EvalAll(values);
       if( func->IsInvalid() ) {
 	SetBit(kInvalid);
 	return 1.0;
@@ -717,6 +771,616 @@ Double_t THaFormula::EvalInstance( Int_t instance ) // NOLINT(misc-no-recursion)
   return y;
 }
 
+//_____________________________________________________________________________
+Int_t THaFormula::EvalAll( vector<Double_t>& result ) // NOLINT(misc-no-recursion)
+{
+  // Evaluate all instances of this formula into 'result'. Returns the
+  // number of instances. Instances that cannot be evaluated are set to kBig,
+  // and the kInvalid bit is set if there were any.
+  //
+  // With bytecode, instances are evaluated in blocks of up to kMaxLanes,
+  // where each instruction processes the entire block.
+
+  ResetBit(kInvalid);
+  Int_t ndata = IsError() ? 0 : GetNdata();
+  result.resize(ndata);
+  Bool_t invalid = false;
+  if( !fCode.empty() && !fHasJumps ) {
+    for( Int_t first = 0; first < ndata; first += kMaxLanes ) {
+      Int_t n = std::min(kMaxLanes, ndata - first);
+      ResetBit(kInvalid);
+      fInstance = first;
+      RunProgram(first, n, &result[first]);
+      if( IsInvalid() ) {
+        std::fill_n(&result[first], n, kBig);
+        invalid = true;
+      }
+    }
+  } else {
+    for( Int_t i = 0; i < ndata; ++i ) {
+      result[i] = EvalInstance(i);
+      invalid = invalid || IsInvalid();
+    }
+  }
+  SetBit(kInvalid, invalid);
+  return ndata;
+}
+
+//_____________________________________________________________________________
+Bool_t THaFormula::Translate()
+{
+  // Translate the compiled expression to bytecode, unless disabled.
+  // Returns true if the formula is now evaluated with bytecode.
+
+  fCode.clear();
+  if( !fgBytecode || IsError() )
+    return false;
+
+  // Verify once that the bytecode agrees with TFormula
+  static const Bool_t ok = CheckTranslation();
+  if( !ok )
+    return false;
+
+  return BuildProgram();
+}
+
+//_____________________________________________________________________________
+Bool_t THaFormula::BuildProgram()
+{
+  // Translate TFormula's list of operations into bytecode. Operands are
+  // resolved here as far as possible: constants are collected, and data
+  // of basic global variables are read through typed pointers rather than
+  // via DefinedValue() and THaVar::GetValue().
+  // Returns false, leaving the bytecode empty, if the expression contains
+  // any operation not supported by the bytecode engine, e.g. strings,
+  // parameters, calls to other TFormulas or the ternary operator.
+
+  fCode.clear();
+  fLoads.clear();
+  fImm.clear();
+  fRegs.clear();
+  fHasJumps = false;
+  if( fNpar > 0 || fNoper <= 0 )
+    return false;
+
+  vector<Instr_t> code;
+  code.reserve(fNoper);
+  Int_t sp = 0, nreg = 0;
+  for( Int_t i = 0; i < fNoper; ++i ) {
+    Int_t action = GetAction(i);
+    Int_t param  = GetActionParam(i);
+    Instr_t ins{};
+    Int_t nargs = 0;
+    switch( action ) {
+    case TFormula::kConstant:
+    case TFormula::kpi:
+      ins.op  = kOpImm;
+      ins.arg = static_cast<Int_t>(fImm.size());
+      fImm.push_back(action == TFormula::kpi ? TMath::Pi() : fConst[param]);
+      break;
+    case TFormula::kDefinedVariable: {
+      if( param < 0 || param >= static_cast<Int_t>(fVarDef.size()) )
+        return false;
+      const FVarDef_t& def = fVarDef[param];
+      if( def.type == kVariable || def.type == kArray ) {
+        const auto* var = static_cast<const THaVar*>(def.obj);
+        Load_t ld{ var->GetAccessor(), def.type == kArray ? -1 : def.index,
+                   var->IsVarArray() };
+        ins.op  = (def.type == kArray) ? kOpLoadArray : kOpLoadElem;
+        ins.arg = static_cast<Int_t>(fLoads.size());
+        fLoads.push_back(ld);
+      } else if( def.type == kString ) {
+        return false;
+      } else if( def.type == kFunction ) {
+        ins.op = kOpIteration;
+      } else {
+        // Cuts, functions of arrays, and any types defined by derived
+        // classes are evaluated via DefinedValue()
+        ins.op  = (def.type == kVarFormula) ? kOpDefinedLanes : kOpDefined;
+        ins.arg = param;
+      }
+      break;
+    }
+    case TFormula::kAdd:          nargs = 2; ins.op = kOpAdd;    break;
+    case TFormula::kSubstract:    nargs = 2; ins.op = kOpSub;    break;
+    case TFormula::kMultiply:     nargs = 2; ins.op = kOpMul;    break;
+    case TFormula::kDivide:       nargs = 2; ins.op = kOpDiv;    break;
+    case TFormula::kModulo:       nargs = 2; ins.op = kOpMod;    break;
+    case TFormula::kpow:          nargs = 2; ins.op = kOpPow;    break;
+    case TFormula::kfmod:         nargs = 2; ins.op = kOpFmod;   break;
+    case TFormula::katan2:        nargs = 2; ins.op = kOpAtan2;  break;
+    case TFormula::kmin:          nargs = 2; ins.op = kOpMin;    break;
+    case TFormula::kmax:          nargs = 2; ins.op = kOpMax;    break;
+    case TFormula::kAnd:          nargs = 2; ins.op = kOpAnd;    break;
+    case TFormula::kOr:           nargs = 2; ins.op = kOpOr;     break;
+    case TFormula::kEqual:        nargs = 2; ins.op = kOpEq;     break;
+    case TFormula::kNotEqual:     nargs = 2; ins.op = kOpNe;     break;
+    case TFormula::kLess:         nargs = 2; ins.op = kOpLt;     break;
+    case TFormula::kGreater:      nargs = 2; ins.op = kOpGt;     break;
+    case TFormula::kLessThan:     nargs = 2; ins.op = kOpLe;     break;
+    case TFormula::kGreaterThan:  nargs = 2; ins.op = kOpGe;     break;
+    case TFormula::kBitAnd:       nargs = 2; ins.op = kOpBitAnd; break;
+    case TFormula::kBitOr:        nargs = 2; ins.op = kOpBitOr;  break;
+    case TFormula::kLeftShift:    nargs = 2; ins.op = kOpShl;    break;
+    case TFormula::kRightShift:   nargs = 2; ins.op = kOpShr;    break;
+    case TFormula::kSignInv:      nargs = 1; ins.op = kOpNeg;    break;
+    case TFormula::kNot:          nargs = 1; ins.op = kOpNot;    break;
+    case TFormula::kabs:          nargs = 1; ins.op = kOpAbs;    break;
+    case TFormula::ksign:         nargs = 1; ins.op = kOpSign;   break;
+    case TFormula::kint:          nargs = 1; ins.op = kOpInt;    break;
+    case TFormula::ksq:           nargs = 1; ins.op = kOpSq;     break;
+    case TFormula::ksqrt:         nargs = 1; ins.op = kOpSqrt;   break;
+    case TFormula::ksin:          nargs = 1; ins.op = kOpSin;    break;
+    case TFormula::kcos:          nargs = 1; ins.op = kOpCos;    break;
+    case TFormula::ktan:          nargs = 1; ins.op = kOpTan;    break;
+    case TFormula::kasin:         nargs = 1; ins.op = kOpAsin;   break;
+    case TFormula::kacos:         nargs = 1; ins.op = kOpAcos;   break;
+    case TFormula::katan:         nargs = 1; ins.op = kOpAtan;   break;
+    case TFormula::ksinh:         nargs = 1; ins.op = kOpSinh;   break;
+    case TFormula::kcosh:         nargs = 1; ins.op = kOpCosh;   break;
+    case TFormula::ktanh:         nargs = 1; ins.op = kOpTanh;   break;
+    case TFormula::kasinh:        nargs = 1; ins.op = kOpAsinh;  break;
+    case TFormula::kacosh:        nargs = 1; ins.op = kOpAcosh;  break;
+    case TFormula::katanh:        nargs = 1; ins.op = kOpAtanh;  break;
+    case TFormula::kexp:          nargs = 1; ins.op = kOpExp;    break;
+    case TFormula::klog:          nargs = 1; ins.op = kOpLog;    break;
+    case TFormula::klog10:        nargs = 1; ins.op = kOpLog10;  break;
+    case TFormula::kBoolOptimize: {
+      // Short-circuit of && and ||. The parameter is 1 (&&) or 2 (||)
+      // plus 10 times the number of operations to skip.
+      if( sp < 1 )
+        return false;
+      Int_t target = i + param / 10 + 1;
+      if( target > fNoper || (param % 10 != 1 && param % 10 != 2) )
+        return false;
+      ins.op  = (param % 10 == 1) ? kOpJumpIfFalse : kOpJumpIfTrue;
+      ins.dst = ins.a = sp - 1;
+      ins.arg = target;
+      fHasJumps = true;
+      code.push_back(ins);
+      continue;
+    }
+    default:
+      return false;
+    }
+    if( nargs > 0 ) {
+      if( sp < nargs )
+        return false;
+      sp -= nargs;
+      ins.a = sp;
+      ins.b = (nargs > 1) ? sp + 1 : sp;
+    }
+    ins.dst = sp++;
+    nreg = std::max(nreg, sp);
+    code.push_back(ins);
+  }
+  if( sp != 1 )
+    return false;
+
+  fCode = std::move(code);
+  fRegs.assign(static_cast<size_t>(nreg) * kMaxLanes, 0.0);
+  return true;
+}
+
+//_____________________________________________________________________________
+void THaFormula::RunProgram( Int_t first, Int_t n, Double_t* result ) // NOLINT(misc-no-recursion)
+{
+  // Evaluate instances first ... first+n-1 (n <= kMaxLanes) with the
+  // bytecode and store the results in 'result'. Sets the kInvalid bit,
+  // like DefinedValue(), if referenced data do not exist.
+
+  assert( n > 0 && n <= kMaxLanes );
+  Double_t* R = fRegs.data();
+  const auto ncode = static_cast<Int_t>(fCode.size());
+  for( Int_t pc = 0; pc < ncode; ++pc ) {
+    const Instr_t& in = fCode[pc];
+    Double_t* d = R + in.dst * kMaxLanes;
+    const Double_t* x = R + in.a * kMaxLanes;
+    const Double_t* y = R + in.b * kMaxLanes;
+    switch( in.op ) {
+    case kOpImm:
+      std::fill_n(d, n, fImm[in.arg]);
+      break;
+    case kOpLoadElem: {
+      const Load_t& ld = fLoads[in.arg];
+      Double_t v = 1.0;
+      if( ld.varlen && ld.index >= ld.acc.GetLen() ) {
+        SetBit(kInvalid);
+      } else if( ld.acc.Gather(&v, ld.index, 1) != 1 ) {
+        SetBit(kInvalid);
+        v = 1.0;
+      }
+      std::fill_n(d, n, v);
+      break;
+    }
+    case kOpLoadArray: {
+      const Load_t& ld = fLoads[in.arg];
+      if( first + n > ld.acc.GetLen() || ld.acc.Gather(d, first, n) != n ) {
+        SetBit(kInvalid);
+        std::fill_n(d, n, 1.0);
+      }
+      break;
+    }
+    case kOpDefined:
+      std::fill_n(d, n, DefinedValue(in.arg));
+      break;
+    case kOpDefinedLanes:
+      for( Int_t l = 0; l < n; ++l ) {
+        fInstance = first + l;
+        d[l] = DefinedValue(in.arg);
+      }
+      fInstance = first;
+      break;
+    case kOpIteration:
+      for( Int_t l = 0; l < n; ++l )
+        d[l] = first + l;
+      break;
+    // Semantics of the operations follow ROOT::v5::TFormula::EvalPar
+    case kOpAdd: Binary(d, x, y, n, []( Double_t a, Double_t b ) { return a + b; }); break;
+    case kOpSub: Binary(d, x, y, n, []( Double_t a, Double_t b ) { return a - b; }); break;
+    case kOpMul: Binary(d, x, y, n, []( Double_t a, Double_t b ) { return a * b; }); break;
+    case kOpDiv:
+      Binary(d, x, y, n, []( Double_t a, Double_t b ) { return b == 0 ? 0. : a / b; });
+      break;
+    case kOpMod:
+      Binary(d, x, y, n, []( Double_t a, Double_t b ) {
+        auto i1 = static_cast<Long64_t>(a), i2 = static_cast<Long64_t>(b);
+        return i2 == 0 ? 0. : static_cast<Double_t>(i1 % i2); });
+      break;
+    case kOpPow:   Binary(d, x, y, n, []( Double_t a, Double_t b ) { return TMath::Power(a, b); }); break;
+    case kOpFmod:  Binary(d, x, y, n, []( Double_t a, Double_t b ) { return TMath::Fmod(a, b); }); break;
+    case kOpAtan2: Binary(d, x, y, n, []( Double_t a, Double_t b ) { return TMath::ATan2(a, b); }); break;
+    case kOpMin:   Binary(d, x, y, n, []( Double_t a, Double_t b ) { return TMath::Min(a, b); }); break;
+    case kOpMax:   Binary(d, x, y, n, []( Double_t a, Double_t b ) { return TMath::Max(a, b); }); break;
+    case kOpAnd: Binary(d, x, y, n, []( Double_t a, Double_t b ) { return (a != 0 && b != 0) ? 1. : 0.; }); break;
+    case kOpOr:  Binary(d, x, y, n, []( Double_t a, Double_t b ) { return (a != 0 || b != 0) ? 1. : 0.; }); break;
+    case kOpEq:  Binary(d, x, y, n, []( Double_t a, Double_t b ) { return a == b ? 1. : 0.; }); break;
+    case kOpNe:  Binary(d, x, y, n, []( Double_t a, Double_t b ) { return a != b ? 1. : 0.; }); break;
+    case kOpLt:  Binary(d, x, y, n, []( Double_t a, Double_t b ) { return a <  b ? 1. : 0.; }); break;
+    case kOpGt:  Binary(d, x, y, n, []( Double_t a, Double_t b ) { return a >  b ? 1. : 0.; }); break;
+    case kOpLe:  Binary(d, x, y, n, []( Double_t a, Double_t b ) { return a <= b ? 1. : 0.; }); break;
+    case kOpGe:  Binary(d, x, y, n, []( Double_t a, Double_t b ) { return a >= b ? 1. : 0.; }); break;
+    case kOpBitAnd:
+      Binary(d, x, y, n, []( Double_t a, Double_t b ) {
+        return static_cast<Double_t>(static_cast<ULong64_t>(a) & static_cast<ULong64_t>(b)); });
+      break;
+    case kOpBitOr:
+      Binary(d, x, y, n, []( Double_t a, Double_t b ) {
+        return static_cast<Double_t>(static_cast<ULong64_t>(a) | static_cast<ULong64_t>(b)); });
+      break;
+    case kOpShl:
+      Binary(d, x, y, n, []( Double_t a, Double_t b ) {
+        return static_cast<Double_t>(static_cast<ULong64_t>(a) << static_cast<ULong64_t>(b)); });
+      break;
+    case kOpShr:
+      Binary(d, x, y, n, []( Double_t a, Double_t b ) {
+        return static_cast<Double_t>(static_cast<ULong64_t>(a) >> static_cast<ULong64_t>(b)); });
+      break;
+    case kOpNeg:  Unary(d, x, n, []( Double_t a ) { return -a; }); break;
+    case kOpNot:  Unary(d, x, n, []( Double_t a ) { return a != 0 ? 0. : 1.; }); break;
+    case kOpAbs:  Unary(d, x, n, []( Double_t a ) { return TMath::Abs(a); }); break;
+    case kOpSign: Unary(d, x, n, []( Double_t a ) { return a < 0 ? -1. : 1.; }); break;
+    case kOpInt:
+      Unary(d, x, n, []( Double_t a ) { return static_cast<Double_t>(static_cast<Int_t>(a)); });
+      break;
+    case kOpSq:   Unary(d, x, n, []( Double_t a ) { return a * a; }); break;
+    case kOpSqrt: Unary(d, x, n, []( Double_t a ) { return TMath::Sqrt(a); }); break;
+    case kOpSin:  Unary(d, x, n, []( Double_t a ) { return TMath::Sin(a); }); break;
+    case kOpCos:  Unary(d, x, n, []( Double_t a ) { return TMath::Cos(a); }); break;
+    case kOpTan:
+      Unary(d, x, n, []( Double_t a ) {
+        Double_t c = TMath::Cos(a);
+        return c == 0 ? 0. : TMath::Tan(a); });
+      break;
+    case kOpAsin:
+      Unary(d, x, n, []( Double_t a ) { return TMath::Abs(a) > 1 ? 0. : TMath::ASin(a); });
+      break;
+    case kOpAcos:
+      Unary(d, x, n, []( Double_t a ) { return TMath::Abs(a) > 1 ? 0. : TMath::ACos(a); });
+      break;
+    case kOpAtan:  Unary(d, x, n, []( Double_t a ) { return TMath::ATan(a); }); break;
+    case kOpSinh:  Unary(d, x, n, []( Double_t a ) { return TMath::SinH(a); }); break;
+    case kOpCosh:  Unary(d, x, n, []( Double_t a ) { return TMath::CosH(a); }); break;
+    case kOpTanh:  Unary(d, x, n, []( Double_t a ) { return TMath::TanH(a); }); break;
+    case kOpAsinh: Unary(d, x, n, []( Double_t a ) { return TMath::ASinH(a); }); break;
+    case kOpAcosh:
+      Unary(d, x, n, []( Double_t a ) { return a < 1 ? 0. : TMath::ACosH(a); });
+      break;
+    case kOpAtanh:
+      Unary(d, x, n, []( Double_t a ) { return TMath::Abs(a) > 1 ? 0. : TMath::ATanH(a); });
+      break;
+    case kOpExp:
+      Unary(d, x, n, []( Double_t a ) {
+        return a < -700 ? 0. : TMath::Exp(a > 709 ? 709. : a); });
+      break;
+    case kOpLog:
+      Unary(d, x, n, []( Double_t a ) { return a > 0 ? TMath::Log(a) : 0.; });
+      break;
+    case kOpLog10:
+      Unary(d, x, n, []( Double_t a ) { return a > 0 ? TMath::Log10(a) : 0.; });
+      break;
+    case kOpJumpIfFalse:
+      assert( n == 1 );
+      if( x[0] == 0 ) {
+        d[0] = 0;
+        pc = in.arg - 1;
+      }
+      break;
+    case kOpJumpIfTrue:
+      assert( n == 1 );
+      if( x[0] != 0 ) {
+        d[0] = 1;
+        pc = in.arg - 1;
+      }
+      break;
+    default:
+      assert(false); // not reached
+      break;
+    }
+  }
+  std::copy_n(R, n, result);
+}
+
+//_____________________________________________________________________________
+Bool_t THaFormula::CheckTranslation()
+{
+  // Compare the bytecode with TFormula's interpreter for a set of constant
+  // expressions covering all translated operations. The bytecode relies on
+  // the details of TFormula's compiled representation and on its handling
+  // of special cases, so disable the bytecode if there are any differences.
+
+  static const char* const exprs[] = {
+    "3+4*2-1", "7/2", "5/0", "7%3", "-7%3", "2^10", "2**0.5", "-(3.5)",
+    "!0+!5", "1&&0", "1&&2", "0||0", "0||3", "0&&1/0", "1||0", "3==3",
+    "3!=3", "2<3", "2>3", "2<=2", "3>=4", "6&3", "6|3", "1<<4", "256>>2",
+    "abs(-2.5)", "sign(-3)", "sign(0)", "int(2.7)", "int(-2.7)", "sq(3)",
+    "sqrt(16)", "sin(0.5)", "cos(0.5)", "tan(0.5)", "asin(0.5)", "asin(2)",
+    "acos(0.5)", "acos(-2)", "atan(0.5)", "atan2(1,2)", "sinh(0.5)",
+    "cosh(0.5)", "tanh(0.5)", "asinh(0.5)", "acosh(1.5)", "acosh(0.5)",
+    "atanh(0.5)", "atanh(2)", "exp(1)", "exp(-800)", "exp(800)", "log(2)",
+    "log(0)", "log10(100)", "log10(-1)", "fmod(7.5,2)", "min(2,3)",
+    "max(2,3)", "pow(2,3)", "pi", "(1<2)&&(3>2)||(0&&1)", "-2^2",
+    "2*-3+4/2-1", nullptr
+  };
+
+  Bool_t save = fgBytecode;
+  fgBytecode = false;
+  Bool_t ok = true;
+  Int_t save_level = gErrorIgnoreLevel;
+  gErrorIgnoreLevel = kBreak;
+  for( const char* const* e = exprs; *e && ok; ++e ) {
+    THaFormula f("bytecode$check", *e, false, nullptr, nullptr);
+    if( f.IsError() || !f.BuildProgram() )
+      continue;
+    Double_t y1 = f.EvalPar(nullptr), y2 = 0;
+    f.RunProgram(0, 1, &y2);
+    if( y1 != y2 && !(std::isnan(y1) && std::isnan(y2)) ) {
+      ::Warning("THaFormula", "Bytecode result %g for \"%s\" differs from "
+                "TFormula result %g. Bytecode disabled.", y2, *e, y1);
+      ok = false;
+    }
+  }
+  gErrorIgnoreLevel = save_level;
+  fgBytecode = save;
+  return ok;
+}
+
+//_____________________________________________________________________________
+namespace {
+const char* CodeTemplate( Int_t op )
+{
+  // C++ expression for bytecode operation 'op', with '@' and '#' standing
+  // for the first and second operand, or nullptr if none.
+  // Semantics must be the same as in THaFormula::RunProgram.
+
+  switch( op ) {
+  case kOpAdd:    return "@ + #";
+  case kOpSub:    return "@ - #";
+  case kOpMul:    return "@ * #";
+  case kOpDiv:    return "(# == 0 ? 0. : @ / #)";
+  case kOpMod:    return "(Long64_t(#) == 0 ? 0. : Double_t(Long64_t(@) % Long64_t(#)))";
+  case kOpPow:    return "TMath::Power(@, #)";
+  case kOpFmod:   return "TMath::Fmod(@, #)";
+  case kOpAtan2:  return "TMath::ATan2(@, #)";
+  case kOpMin:    return "TMath::Min(@, #)";
+  case kOpMax:    return "TMath::Max(@, #)";
+  case kOpAnd:    return "(@ != 0 && # != 0 ? 1. : 0.)";
+  case kOpOr:     return "(@ != 0 || # != 0 ? 1. : 0.)";
+  case kOpEq:     return "(@ == # ? 1. : 0.)";
+  case kOpNe:     return "(@ != # ? 1. : 0.)";
+  case kOpLt:     return "(@ < # ? 1. : 0.)";
+  case kOpGt:     return "(@ > # ? 1. : 0.)";
+  case kOpLe:     return "(@ <= # ? 1. : 0.)";
+  case kOpGe:     return "(@ >= # ? 1. : 0.)";
+  case kOpBitAnd: return "Double_t(ULong64_t(@) & ULong64_t(#))";
+  case kOpBitOr:  return "Double_t(ULong64_t(@) | ULong64_t(#))";
+  case kOpShl:    return "Double_t(ULong64_t(@) << ULong64_t(#))";
+  case kOpShr:    return "Double_t(ULong64_t(@) >> ULong64_t(#))";
+  case kOpNeg:    return "-@";
+  case kOpNot:    return "(@ != 0 ? 0. : 1.)";
+  case kOpAbs:    return "TMath::Abs(@)";
+  case kOpSign:   return "(@ < 0 ? -1. : 1.)";
+  case kOpInt:    return "Double_t(Int_t(@))";
+  case kOpSq:     return "@ * @";
+  case kOpSqrt:   return "TMath::Sqrt(@)";
+  case kOpSin:    return "TMath::Sin(@)";
+  case kOpCos:    return "TMath::Cos(@)";
+  case kOpTan:    return "(TMath::Cos(@) == 0 ? 0. : TMath::Tan(@))";
+  case kOpAsin:   return "(TMath::Abs(@) > 1 ? 0. : TMath::ASin(@))";
+  case kOpAcos:   return "(TMath::Abs(@) > 1 ? 0. : TMath::ACos(@))";
+  case kOpAtan:   return "TMath::ATan(@)";
+  case kOpSinh:   return "TMath::SinH(@)";
+  case kOpCosh:   return "TMath::CosH(@)";
+  case kOpTanh:   return "TMath::TanH(@)";
+  case kOpAsinh:  return "TMath::ASinH(@)";
+  case kOpAcosh:  return "(@ < 1 ? 0. : TMath::ACosH(@))";
+  case kOpAtanh:  return "(TMath::Abs(@) > 1 ? 0. : TMath::ATanH(@))";
+  case kOpExp:    return "(@ < -700 ? 0. : TMath::Exp(@ > 709 ? 709. : @))";
+  case kOpLog:    return "(@ > 0 ? TMath::Log(@) : 0.)";
+  case kOpLog10:  return "(@ > 0 ? TMath::Log10(@) : 0.)";
+  default:        return nullptr;
+  }
+}
+
+//_____________________________________________________________________________
+const char* CodeTypeName( VarType type )
+{
+  switch( type ) {
+  case kDouble: return "Double_t";
+  case kFloat:  return "Float_t";
+  case kLong:   return "Long_t";
+  case kULong:  return "ULong_t";
+  case kInt:    return "Int_t";
+  case kUInt:   return "UInt_t";
+  case kShort:  return "Short_t";
+  case kUShort: return "UShort_t";
+  case kChar:   return "Char_t";
+  case kUChar:  return "UChar_t";
+  default:      return nullptr;
+  }
+}
+} // namespace
+
+//_____________________________________________________________________________
+Bool_t THaFormula::GenerateCode( ostream& os, const string& result,
+                                 const string& label,
+                                 const Podd::FormulaJIT::CutRef_t& cutref ) const
+{
+  // Write C++ statements that evaluate this formula's bytecode and store
+  // the value in the Double_t lvalue 'result'. Global variables are read
+  // from their fixed addresses. 'label' is the prefix of jump labels and
+  // must be unique within the generated function. References to cuts are
+  // resolved by 'cutref'.
+  // Only scalar formulas without variable-size arrays, strings, functions
+  // of arrays, or data that may move can be translated. Returns false,
+  // writing nothing, for any other formula.
+
+  if( fCode.empty() || IsArray() || TestBit(kFuncOfVarArray) )
+    return false;
+
+  const auto ncode = static_cast<Int_t>(fCode.size());
+  Int_t nreg = 0;
+  vector<char> target(ncode + 1, 0);
+  for( const auto& in : fCode ) {
+    nreg = std::max(nreg, in.dst + 1);
+    if( in.op == kOpJumpIfFalse || in.op == kOpJumpIfTrue )
+      target[in.arg] = 1;
+  }
+  ostringstream s;
+  s.precision(numeric_limits<Double_t>::max_digits10);
+  s << "  {\n    Double_t r0";
+  for( Int_t r = 1; r < nreg; ++r )
+    s << ", r" << r;
+  s << ";\n";
+  for( Int_t pc = 0; pc <= ncode; ++pc ) {
+    if( target[pc] )
+      s << "  " << label << pc << ":;\n";
+    if( pc == ncode )
+      break;
+    const Instr_t& in = fCode[pc];
+    const string d = "r" + to_string(in.dst);
+    const string a = "r" + to_string(in.a), b = "r" + to_string(in.b);
+    ostringstream expr;
+    expr.precision(s.precision());
+    switch( in.op ) {
+    case kOpImm:
+      if( !std::isfinite(fImm[in.arg]) )
+        return false;
+      expr << fImm[in.arg];
+      break;
+    case kOpLoadElem: {
+      const Load_t& ld = fLoads[in.arg];
+      const char* tname = CodeTypeName(ld.acc.GetElemType());
+      if( !ld.acc.IsFixed() || ld.varlen || !tname )
+        return false;
+      const void* addr = ld.acc.GetElement(ld.index);
+      if( !addr )
+        return false;
+      expr << "*(const " << tname << "*)0x" << hex
+           << reinterpret_cast<uintptr_t>(addr) << "ULL";
+      break;
+    }
+    case kOpIteration:
+      expr << "0.";
+      break;
+    case kOpDefined: {
+      const FVarDef_t& def = fVarDef[in.arg];
+      Podd::FormulaJIT::ECutValue what{};
+      switch( def.type ) {
+      case kCut:        what = Podd::FormulaJIT::kResult;  break;
+      case kCutScaler:  what = Podd::FormulaJIT::kNPassed; break;
+      case kCutNCalled: what = Podd::FormulaJIT::kNCalled; break;
+      default:
+        return false;
+      }
+      string ref = cutref(static_cast<const THaCut*>(def.obj), what);
+      if( ref.empty() )
+        return false;
+      expr << ref;
+      break;
+    }
+    case kOpJumpIfFalse:
+    case kOpJumpIfTrue:
+      s << "    if( " << a << (in.op == kOpJumpIfFalse ? " == 0" : " != 0")
+        << " ) { " << d << (in.op == kOpJumpIfFalse ? " = 0" : " = 1")
+        << "; goto " << label << in.arg << "; }\n";
+      continue;
+    default: {
+      const char* t = CodeTemplate(in.op);
+      if( !t )
+        return false;
+      for( ; *t; ++t ) {
+        if( *t == '@' )      expr << a;
+        else if( *t == '#' ) expr << b;
+        else                 expr << *t;
+      }
+      break;
+    }
+    }
+    s << "    " << d << " = " << expr.str() << ";\n";
+  }
+  s << "    " << result << " = r0;\n  }\n";
+  os << s.str();
+  return true;
+}
+
+//_____________________________________________________________________________
+void THaFormula::GetDependencies( vector<THaCut*>& cuts,
+                                  vector<const THaVar*>& vars ) const // NOLINT(misc-no-recursion)
+{
+  // Append the cuts and global variables referenced by this formula,
+  // including those in functions of arrays, to 'cuts' and 'vars'.
+  // Elements already present are not added again.
+
+  for( const auto& def : fVarDef ) {
+    switch( def.type ) {
+    case kVariable:
+    case kString:
+    case kArray: {
+      const auto* var = static_cast<const THaVar*>(def.obj);
+      if( var && find(ALL(vars), var) == vars.end() )
+        vars.push_back(var);
+      break;
+    }
+    case kCut:
+    case kCutScaler:
+    case kCutNCalled: {
+      auto* cut = static_cast<THaCut*>(def.obj);
+      if( cut && find(ALL(cuts), cut) == cuts.end() )
+        cuts.push_back(cut);
+      break;
+    }
+    case kFormula:
+    case kVarFormula:
+      if( def.obj )
+        static_cast<const THaFormula*>(def.obj)->GetDependencies(cuts, vars);
+      break;
+    default:
+      break;
+    }
+  }
+}
+
 //_____________________________________________________________________________
 Int_t THaFormula::GetNdataUnchecked() const // NOLINT(misc-no-recursion)
 {
@@ -774,9 +1438,13 @@ void THaFormula::Print( Option_t* option ) const
   //   "BRIEF" -- short, one line
   //   "FULL"  -- full, multiple lines
 
-  if( !strcmp( option, kPRINTFULL ))
+  if( !strcmp( option, kPRINTFULL )) {
     TFormula::Print( option );
-  else
+    if( !fCode.empty() )
+      cout << "Bytecode: " << fCode.size() << " instructions, "
+           << fRegs.size() / kMaxLanes << " registers, "
+           << fLoads.size() << " variable operands" << endl;
+  } else
     TNamed::Print(option);
 }
 
@@ -9,11 +9,15 @@
 
 #include "RVersion.h"
 #include "v5/TFormula.h"
+#include "VarType.h"
+#include "FormulaJIT.h"
+#include "VarAccessor.h"
 #include <vector>
 #include <iostream>
 
 class THaVarList;
 class THaCutList;
+class THaCut;
 class THaVar;
 
 
@@ -46,15 +50,32 @@ public:
   // need to hack this-pointer to be non-const - courtesy of ROOT team
   { return const_cast<THaFormula*>(this)->Eval(); }
   virtual Double_t    EvalInstance( Int_t instance );
+  // Evaluate all instances. Returns GetNdata(). Invalid results are kBig.
+          Int_t       EvalAll( std::vector<Double_t>& result );
+  // Append the cuts and global variables referenced by this formula
+          void        GetDependencies( std::vector<THaCut*>& cuts,
+                                       std::vector<const THaVar*>& vars ) const;
   virtual Int_t       GetNdata()   const;
   virtual Bool_t      IsArray()    const { return TestBit(kArrayFormula); }
   virtual Bool_t      IsVarArray() const { return TestBit(kVarArray); }
           Bool_t      IsError()    const { return TestBit(kError); }
           Bool_t      IsInvalid()  const { return TestBit(kInvalid); }
   virtual void        Print( Option_t* option="" ) const;
+  const   THaVarList* GetVarList() const { return fVarList; }
           void        SetList( const THaVarList* lst )    { fVarList = lst; }
           void        SetCutList( const THaCutList* lst ) { fCutList = lst; }
 
+  // Evaluate formulas with the bytecode engine where possible (default).
+  // Takes effect at the next Compile().
+  static  void        SetBytecode( Bool_t enable = true ) { fgBytecode = enable; }
+  static  Bool_t      BytecodeEnabled() { return fgBytecode; }
+          Bool_t      HasBytecode() const { return !fCode.empty(); }
+  // Emit C++ code that stores the value of this formula in 'result',
+  // for compilation by Podd::FormulaJIT. Returns false if not possible.
+          Bool_t      GenerateCode( std::ostream& os, const std::string& result,
+                                    const std::string& label,
+                                    const Podd::FormulaJIT::CutRef_t& cutref ) const;
+
 protected:
 
   enum {
@@ -87,6 +108,38 @@ protected:
   const THaCutList* fCutList;          //Pointer to list of cuts
   Int_t             fInstance;         //Current instance to evaluate
 
+  // Bytecode translation of the compiled expression. Each operation of
+  // the TFormula program becomes one instruction on a register file
+  // whose registers are the slots of TFormula's evaluation stack.
+  // Registers hold kMaxLanes values so that consecutive instances of
+  // array formulas can be evaluated in one pass.
+  static constexpr Int_t kMaxLanes = 64;
+  struct Instr_t {
+    Int_t op;    // Operation code
+    Int_t dst;   // Destination register
+    Int_t a;     // First operand register
+    Int_t b;     // Second operand register
+    Int_t arg;   // Index of constant, load or variable, or jump target
+  };
+  struct Load_t {
+    Podd::VarAccessor acc; // Typed access to the variable's data
+    Int_t         index;   // Element index, or -1 for array instances
+    Bool_t        varlen;  // Length may change, check index at run time
+  };
+  std::vector<Instr_t>  fCode;         //! Bytecode, empty if not available
+  std::vector<Load_t>   fLoads;        //! Pre-resolved variable operands
+  std::vector<Double_t> fImm;          //! Constants
+  std::vector<Double_t> fRegs;         //! Register file
+  std::vector<Double_t> fScratch;      //! Values of function arguments
+  Bool_t            fHasJumps;         //! Bytecode contains branches
+
+  static Bool_t     fgBytecode;        // Use bytecode engine
+
+          Bool_t    BuildProgram();
+          void      RunProgram( Int_t first, Int_t n, Double_t* result );
+          Bool_t    Translate();
+  static  Bool_t    CheckTranslation();
+
           Double_t  EvalInstanceUnchecked( Int_t instance );
           Int_t     GetNdataUnchecked() const;
           Int_t     Init( const char* name, const char* expression );
@@ -101,6 +154,11 @@ inline
 Double_t THaFormula::EvalInstanceUnchecked( Int_t instance )
 {
   fInstance = instance;
+  if( !fCode.empty() ) {
+    Double_t y;
+    RunProgram(instance, 1, &y);
+    return y;
+  }
   if( fNoper == 1 && fVarDef.size() == 1 )
     return DefinedValue(0);
   else
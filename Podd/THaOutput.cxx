@@ -17,9 +17,11 @@
 #include "THaOutput.h"
 #include "TROOT.h"
 #include "THaVform.h"
+#include "FormulaJIT.h"
 #include "THaVhist.h"
 #include "THaVarList.h"
 #include "THaVar.h"
+#include "THaCutList.h"
 #include "Textvars.h"
 #include "THaGlobals.h"
 #include "TH1.h"
@@ -35,6 +37,7 @@
 #include "Helper.h"
 
 #include <algorithm>
+#include <cctype>
 #include <fstream>
 #include <cstring>
 #include <iostream>
@@ -42,7 +45,7 @@
 #include <utility>
 #include <vector>
 
-#include "THaBenchmark.h"
+#include "StageProfiler.h"
 #include <stdexcept>
 #include <cassert>
 
@@ -53,6 +56,43 @@ using namespace Podd;
 static const char comment('#');
 const Int_t kNocut = -1;
 
+Bool_t THaOutput::fgNativeTypes = false;
+
+//_____________________________________________________________________________
+static char LeafTypeOf( const string& name )
+{
+  // Branch leaf type for global variable 'name'
+
+  if( !THaOutput::NativeTypesEnabled() )
+    return 'D';
+  const auto* pvar = gHaVars->Find(name.c_str());
+  return pvar ? THaOcolumn::LeafType(pvar->GetType()) : 'D';
+}
+
+//_____________________________________________________________________________
+static string FormKey( const char* type, const string& def )
+{
+  // Key identifying a formula or cut definition. Whitespace is ignored.
+
+  string key(type);
+  key += ':';
+  for( char c : def ) {
+    if( !isspace(static_cast<unsigned char>(c)) )
+      key += c;
+  }
+  return key;
+}
+
+//_____________________________________________________________________________
+static bool IsEyeVar( const string& var )
+{
+  // True if 'var' is an "eye" variable, "[I]" or "[I+offset]".
+  // Each histogram handles these itself, see THaVhist::FindEye.
+
+  string uvar = ToUpper(var);
+  return uvar == "[I]" || uvar.find("[I+") != string::npos;
+}
+
 //_____________________________________________________________________________
 class THaEpicsKey {
 // Utility class used by THaOutput to store a list of
@@ -187,16 +227,238 @@ Bool_t THaOdata::Resize( Int_t i, bool save_old_data )
   return true;
 }
 
+//_____________________________________________________________________________
+THaOcolumn::THaOcolumn( string _name, Bool_t is_array, char _leaftype )
+  : tree{nullptr}, name{std::move(_name)}, var{nullptr}, ndata{0}, nsize{0},
+    size{LeafSize(_leaftype)}, leaftype{_leaftype}, isarray{is_array},
+    method{kNone}
+{
+  if( size == 0 ) {
+    leaftype = 'D';
+    size = sizeof(Double_t);
+  }
+  Resize(1);
+  if( !isarray )
+    ndata = 1;
+}
+
+//_____________________________________________________________________________
+char THaOcolumn::LeafType( VarType type )
+{
+  // Map the element type of 'type' to a ROOT leaf type code. Pointers,
+  // pointer arrays, vectors and matrices map to the type of their elements.
+
+  VarType t = type;
+  if( type >= kDoubleP && type <= kUCharP )
+    t = static_cast<VarType>(type - kDoubleP + kDouble);
+  else if( type >= kDouble2P && type <= kUChar2P )
+    t = static_cast<VarType>(type - kDouble2P + kDouble);
+  else if( type == kIntV || type == kIntM )
+    t = kInt;
+  else if( type == kUIntV )
+    t = kUInt;
+  else if( type == kFloatV || type == kFloatM )
+    t = kFloat;
+  else if( type == kDoubleV || type == kDoubleM )
+    t = kDouble;
+
+  char code = 'D';
+  switch( t ) {
+    case kFloat:  code = 'F'; break;
+    case kLong:   code = 'L'; break;
+    case kULong:  code = 'l'; break;
+    case kInt:    code = 'I'; break;
+    case kUInt:   code = 'i'; break;
+    case kShort:  code = 'S'; break;
+    case kUShort: code = 's'; break;
+    case kChar:   code = 'B'; break;
+    case kUChar:  code = 'b'; break;
+    default:      break;
+  }
+  // Long_t is only usable as 'L' where it has 64 bits
+  if( Vars::GetTypeSize(t) != LeafSize(code) )
+    code = 'D';
+  return code;
+}
+
+//_____________________________________________________________________________
+size_t THaOcolumn::LeafSize( char _leaftype )
+{
+  switch( _leaftype ) {
+    case 'D': case 'L': case 'l': return 8;
+    case 'F': case 'I': case 'i': return 4;
+    case 'S': case 's':           return 2;
+    case 'B': case 'b':           return 1;
+    default:                      return 0;
+  }
+}
+
+//_____________________________________________________________________________
+static inline void MapNoData( Double_t* x, Int_t n )
+{
+  // The integer "no data" marker kMinInt is written as kBig to Double_t
+  // branches, regardless of how the data were copied
+
+  for( Int_t i = 0; i < n; ++i )
+    if( x[i] == kMinInt ) x[i] = kBig;
+}
+
+//_____________________________________________________________________________
+void THaOcolumn::AddBranch( TTree* _tree, Int_t bufsize )
+{
+  tree = _tree;
+  if( isarray ) {
+    string leaf = "Ndata." + name;
+    tree->Branch(leaf.c_str(), &ndata, (leaf + "/I").c_str());
+    leaf = name + "[" + leaf + "]/" + leaftype;
+    tree->Branch(name.c_str(), data.data(), leaf.c_str());
+  } else {
+    string leaf = name + "/" + leaftype;
+    tree->Branch(name.c_str(), data.data(), leaf.c_str(), bufsize);
+  }
+}
+
+//_____________________________________________________________________________
+void THaOcolumn::Attach( const THaVar* _var )
+{
+  // Set the variable to write and decide how to copy its data.
+  // Data can be copied directly only if their type matches that of the
+  // branch, which was fixed when the branch was created.
+
+  var = _var;
+  acc = Podd::VarAccessor(var);
+  method = kNone;
+  if( !var )
+    return;
+  method = kValue;
+  if( LeafType(var->GetType()) != leaftype ||
+      Vars::GetTypeSize(var->GetType()) != size )
+    return;
+  if( acc.IsContiguous() )
+    method = kCopy;
+  else if( acc.GetLayout() == Podd::VarAccessor::kPointerArray )
+    method = kElement;
+}
+
+//_____________________________________________________________________________
+// Grow buffer to hold at least 'n' elements. Contents are not preserved.
+// Returns 'true' if successful, false otherwise (n > 1 Mi).
+Bool_t THaOcolumn::Resize( Int_t n )
+{
+  if( n > kMaxSize ) return false;
+  Int_t newsize = nsize > 0 ? nsize : 1;
+  while( n > newsize ) { newsize *= 2; }
+  if( newsize > kMaxSize ) newsize = kMaxSize;
+  try {
+    data.assign((newsize * size + sizeof(Long64_t) - 1) / sizeof(Long64_t), 0);
+  } catch( const bad_alloc& e ) {
+    return false;
+  }
+  nsize = newsize;
+  if( tree )
+    tree->SetBranchAddress(name.c_str(), data.data());
+  return true;
+}
+
+//_____________________________________________________________________________
+void THaOcolumn::Store( Int_t i )
+{
+  // Convert element 'i' of the variable to the branch type.
+  // As before, the integer "no data" marker kMinInt is written as kBig
+  // to Double_t branches.
+
+  auto* buf = reinterpret_cast<char*>(data.data()) + i * size;
+  if( leaftype == 'D' ) {
+    Double_t x = acc.Get(i);
+    if( x == kMinInt ) x = kBig;
+    memcpy(buf, &x, sizeof(x));
+  } else if( leaftype == 'F' ) {
+    auto x = static_cast<Float_t>(acc.Get(i));
+    memcpy(buf, &x, sizeof(x));
+  } else {
+    Long64_t x = var->IsFloat() ? static_cast<Long64_t>(acc.Get(i))
+                                : var->GetValueInt(i);
+    switch( size ) {
+      case 8: memcpy(buf, &x, 8); break;
+      case 4: { auto y = static_cast<Int_t>(x);   memcpy(buf, &y, 4); break; }
+      case 2: { auto y = static_cast<Short_t>(x); memcpy(buf, &y, 2); break; }
+      case 1: { auto y = static_cast<Char_t>(x);  memcpy(buf, &y, 1); break; }
+      default: break;
+    }
+  }
+}
+
+//_____________________________________________________________________________
+Int_t THaOcolumn::Fill()
+{
+  // Copy the current data of the variable into the buffer.
+  // Returns 1 if successful, 0 if the data had to be truncated.
+
+  if( isarray )
+    ndata = 0;
+  if( !var )
+    return 1;
+  Int_t ret = 1;
+  Int_t n = isarray ? acc.GetLen() : 1;
+  if( n <= 0 )
+    return 1;
+  if( n > nsize && !Resize(n) ) {
+    if( nsize < kMaxSize )
+      Resize(kMaxSize);
+    n = std::min(n, nsize);
+    ret = 0;
+  }
+  auto* buf = reinterpret_cast<char*>(data.data());
+  switch( method ) {
+    case kCopy:
+      if( const void* src = acc.GetBase() )
+        memcpy(buf, src, n * size);
+      else
+        n = 0;
+      break;
+    case kElement:
+      for( Int_t i = 0; i < n; ++i ) {
+        const void* src = acc.GetElement(i);
+        if( !src ) { n = i; break; }
+        memcpy(buf + i * size, src, size);
+      }
+      break;
+    case kValue:
+      if( leaftype == 'D' ) {
+        // Convert all elements in one pass
+        acc.Gather(reinterpret_cast<Double_t*>(buf), 0, n);
+      } else {
+        for( Int_t i = 0; i < n; ++i )
+          Store(i);
+      }
+      break;
+    case kNone:
+      break;
+  }
+  if( leaftype == 'D' && method != kNone )
+    MapNoData(reinterpret_cast<Double_t*>(buf), n);
+  if( isarray )
+    ndata = n;
+  return ret;
+}
+
 //_____________________________________________________________________________
 THaOutput::THaOutput()
-  : fNvar(0), fVar(nullptr), fEpicsVar(nullptr), fTree(nullptr),
+  : fNvar(0), fEpicsVar(nullptr), fFormulaJIT(nullptr), fTree(nullptr),
     fEpicsTimestamp(-1), fEpicsEvtNum(0), fEpicsTree(nullptr),
-    fInit(false), fDoBench(false), fVerbose(1), fBench(new THaBenchmark),
+    fInit(false), fVerbose(1), fVarChanges(0), fCutChanges(0), fProfID{},
     fExtra(nullptr), fEpicsHandler(nullptr),
     nx(0), ny(0), iscut(0), xlo(0), xhi(0), ylo(0), yhi(0),
     fOpenEpics(false), fFirstEpics(false), fIsScalar(false)
 {
   // Constructor
+
+  auto& prof = StageProfiler::Instance();
+  const char* const names[kNProfStages] = {
+    "Init", "Attach", "EPICS", "Formulas", "Cuts", "Variables", "Histos",
+    "TreeFill", "End" };
+  for( Int_t i = 0; i < kNProfStages; ++i )
+    fProfID[i] = prof.Register(string("Output/") + names[i]);
 }
 
 //_____________________________________________________________________________
@@ -204,7 +466,6 @@ THaOutput::~THaOutput()
 {
   // Destructor
 
-  delete fBench; fBench = nullptr;
   delete fExtra; fExtra = nullptr;
 
   // Delete Trees and histograms only if ROOT system is initialized.
@@ -216,12 +477,13 @@ THaOutput::~THaOutput()
     delete fTree;
     delete fEpicsTree;
   }
-  delete [] fVar;
   delete [] fEpicsVar;
-  for (auto & od : fOdata) delete od;
+  for (auto & col : fColumns) delete col;
+  delete fFormulaJIT;
   for (auto & form : fFormulas) delete form;
   for (auto & cut : fCuts) delete cut;
   for (auto & histo : fHistos) delete histo;
+  for (auto & form : fHistForms) delete form;
   for (auto & ek : fEpicsKey) delete ek;
 }
 
@@ -233,6 +495,14 @@ Int_t THaOutput::Init( const char* filename )
   // Only re-attach to variables and re-compile cuts and formulas
   // upon re-initialization (eg: continuing analysis with another file)
   if( fInit ) {
+    if( gHaVars && gHaVars->GetChangeCount() == fVarChanges &&
+        (!gHaCuts || gHaCuts->GetChangeCount() == fCutChanges) ) {
+      // No variables or cuts were added or removed. Pointers are still valid.
+      if( fVerbose > 1 )
+        cout << "\nTHaOutput::Init: Info: Global variables unchanged. "
+             << "Keeping existing definitions." << endl;
+      return 1;
+    }
     cout << "\nTHaOutput::Init: Info: THaOutput cannot be completely"
 	 << " re-initialized. Keeping existing definitions." << endl;
     cout << "Global Variables are being re-attached and formula/cuts"
@@ -249,7 +519,7 @@ Int_t THaOutput::Init( const char* filename )
 
   if( !gHaVars ) return -2;
 
-  if( fDoBench ) fBench->Begin("Init");
+  StageProfiler::Scope timer(fProfID[kProfInit]);
 
   fTree = new TTree("T","Hall A Analyzer Output DST");
   fTree->SetAutoSave(200000000);
@@ -257,7 +527,6 @@ Int_t THaOutput::Init( const char* filename )
   fFirstEpics = true;
 
   Int_t err = LoadFile( filename );
-  if( fDoBench && err != 0 ) fBench->Stop("Init");
 
   if( err == -1 ) {
     return 0;       // No error if file not found, but please
@@ -276,7 +545,6 @@ Int_t THaOutput::Init( const char* filename )
     if (pvar) {
       if (pvar->IsArray()) {
 	fArrayNames.push_back(fVarnames[ivar]);
-        fOdata.push_back(new THaOdata());
       } else {
 	fVNames.push_back(fVarnames[ivar]);
       }
@@ -286,10 +554,12 @@ Int_t THaOutput::Init( const char* filename )
       cout << "There is probably a typo error... "<<endl;
     }
   }
+  // Formulas and cuts with identical definitions are evaluated only once
+  // per event. Duplicates copy the results of the first definition.
+  map<string, THaVform*> shared;
   UInt_t k = 0;
   for (auto inam = fFormnames.begin(); inam != fFormnames.end(); ++inam, ++k) {
     string tinfo = Form("f%d",k);
-    // FIXME: avoid duplicate formulas
     auto* pform = new THaVform("formula",inam->c_str(),fFormdef[k].c_str());
     Int_t status = pform->Init();
     if ( status != 0) {
@@ -303,6 +573,8 @@ Int_t THaOutput::Init( const char* filename )
     }
     pform->SetOutput(fTree);
     fFormulas.push_back(pform);
+    auto ins = shared.emplace(FormKey("formula", fFormdef[k]), pform);
+    fFormulaSrc.push_back(ins.second ? nullptr : ins.first->second);
     if( fVerbose > 2 )
       pform->LongPrint();  // for debug
 // Add variables (i.e. those var's used by the formula) to tree.
@@ -314,10 +586,8 @@ Int_t THaOutput::Init( const char* filename )
       if (pvar) {
 	if (pvar->IsArray()) {
           auto found = find(fArrayNames.begin(), fArrayNames.end(), svar);
-	  if( found == fArrayNames.end() ) {
+	  if( found == fArrayNames.end() )
 	    fArrayNames.push_back(svar);
-	    fOdata.push_back(new THaOdata());
-	  }
 	} else {
           auto found = find(fVNames.begin(), fVNames.end(), svar);
 	  if( found == fVNames.end() )
@@ -326,18 +596,23 @@ Int_t THaOutput::Init( const char* filename )
       }
     }
   }
-  k = 0;
-  for( auto iodat = fOdata.begin(); iodat != fOdata.end(); ++iodat, ++k )
-    (*iodat)->AddBranches(fTree, fArrayNames[k]);
+  // Branches keep the variables' types unless native types are disabled,
+  // in which case everything is written as Double_t, as in older versions
   fNvar = fVNames.size();
-  fVar = new Double_t[fNvar];
-  for (k = 0; k < fNvar; ++k) {
-    string tinfo = fVNames[k] + "/D";
-    fTree->Branch(fVNames[k].c_str(), &fVar[k], tinfo.c_str(), kNbout);
-  }
+  fArrayIDs.clear();
+  fVarIDs.clear();
+  for( const auto& nam : fArrayNames )
+    fArrayIDs.push_back(gHaVars->GetID(nam.c_str()));
+  for( const auto& nam : fVNames )
+    fVarIDs.push_back(gHaVars->GetID(nam.c_str()));
+  for( const auto& nam : fArrayNames )
+    fColumns.push_back(new THaOcolumn(nam, true, LeafTypeOf(nam)));
+  for( const auto& nam : fVNames )
+    fColumns.push_back(new THaOcolumn(nam, false, LeafTypeOf(nam)));
+  for( auto* col : fColumns )
+    col->AddBranch(fTree, kNbout);
   k = 0;
   for( auto inam = fCutnames.begin(); inam != fCutnames.end(); ++inam, ++k ) {
-    // FIXME: avoid duplicate cuts
     auto* pcut = new THaVform("cut", inam->c_str(), fCutdef[k].c_str());
     Int_t status = pcut->Init();
     if ( status != 0 ) {
@@ -351,6 +626,8 @@ Int_t THaOutput::Init( const char* filename )
     }
     pcut->SetOutput(fTree);
     fCuts.push_back(pcut);
+    auto ins = shared.emplace(FormKey("cut", fCutdef[k]), pcut);
+    fCutSrc.push_back(ins.second ? nullptr : ins.first->second);
     if( fVerbose > 2 )
       pcut->LongPrint();  // for debug
   }
@@ -360,25 +637,37 @@ Int_t THaOutput::Init( const char* filename )
 // histograms and potentially reassign variables.
 // A histogram variable or cut is either a string (which can
 // encode a formula) or an externally defined THaVform.
+// Expressions that are not the name of an output formula or cut are
+// shared by all histograms (and output definitions) that use them.
     sfvarx = pVhist->GetVarX();
     sfvary = pVhist->GetVarY();
+    THaVform *formx = nullptr, *formy = nullptr, *formc = nullptr;
     for( auto* pVform : fFormulas ) {
       string stemp(pVform->GetName());
       if (CmpNoCase(sfvarx,stemp) == 0) {
-	pVhist->SetX(pVform);
+	formx = pVform;
       }
       if (CmpNoCase(sfvary,stemp) == 0) {
-	pVhist->SetY(pVform);
+	formy = pVform;
       }
     }
+    if (!formx)
+      formx = SharedForm("formula", sfvarx, shared);
+    if (!formy && !sfvary.empty())
+      formy = SharedForm("formula", sfvary, shared);
+    if (formx) pVhist->SetX(formx);
+    if (formy) pVhist->SetY(formy);
     if (pVhist->HasCut()) {
       scut   = pVhist->GetCutStr();
       for( auto* pcut : fCuts ) {
         string stemp(pcut->GetName());
         if (CmpNoCase(scut,stemp) == 0) {
-	  pVhist->SetCut(pcut);
+	  formc = pcut;
         }
       }
+      if (!formc)
+        formc = SharedForm("cut", scut, shared);
+      if (formc) pVhist->SetCut(formc);
     }
     pVhist->Init();
   }
@@ -404,17 +693,41 @@ Int_t THaOutput::Init( const char* filename )
 
   fInit = true;
 
-  if( fDoBench ) fBench->Stop("Init");
-
-  if( fDoBench ) fBench->Begin("Attach");
+  timer.Start(fProfID[kProfAttach]);
   Int_t st = Attach();
-  if( fDoBench ) fBench->Stop("Attach");
+  timer.Stop();
   if ( st )
     return -4;
 
   return 0;
 }
 
+//_____________________________________________________________________________
+THaVform* THaOutput::SharedForm( const char* type, const string& def,
+                                 map<string, THaVform*>& shared )
+{
+  // Find or create the formula or cut with definition 'def' for use by
+  // histograms. Shared objects are processed once per event by THaOutput.
+  // Returns nullptr for "eye" variables and for definitions with errors,
+  // which THaVhist handles and reports itself.
+
+  if( def.empty() || IsEyeVar(def) )
+    return nullptr;
+  string key = FormKey(type, def);
+  auto it = shared.find(key);
+  if( it != shared.end() )
+    return it->second;
+  auto* pform = new THaVform(type, def.c_str(), def.c_str());
+  if( pform->Init() != 0 ) {
+    delete pform;
+    return nullptr;
+  }
+  fHistForms.push_back(pform);
+  shared.emplace(key, pform);
+  return pform;
+}
+
+//_____________________________________________________________________________
 void THaOutput::BuildList( const vector<string>& vdata)
 {
   // Build list of EPICS variables and
@@ -455,7 +768,9 @@ Int_t THaOutput::Attach()
 {
   // Get the pointers for the global variables
   // Also, sets the size of the fVariables and fArrays vectors
-  // according to the size of the related names array
+  // according to the size of the related names array.
+  // Variables are looked up by their name IDs, which remain valid when
+  // variables are redefined, e.g. when modules are re-initialized.
 
   if( !gHaVars ) return -2;
 
@@ -467,7 +782,7 @@ Int_t THaOutput::Attach()
 
   // simple variable-type names
   for (UInt_t ivar = 0; ivar < NVar; ivar++) {
-    auto* pvar = gHaVars->Find(fVNames[ivar].c_str());
+    auto* pvar = gHaVars->FindByID(fVarIDs[ivar]);
     if (pvar) {
       if ( !pvar->IsArray() ) {
 	fVariables[ivar] = pvar;
@@ -486,7 +801,7 @@ Int_t THaOutput::Attach()
 
   // arrays
   for (UInt_t ivar = 0; ivar < NAry; ivar++) {
-    auto* pvar = gHaVars->Find(fArrayNames[ivar].c_str());
+    auto* pvar = gHaVars->FindByID(fArrayIDs[ivar]);
     if (pvar) {
       if ( pvar->IsArray() ) {
 	fArrays[ivar] = pvar;
@@ -503,6 +818,14 @@ Int_t THaOutput::Attach()
     }
   }
 
+  // Decide how to copy the data of each variable
+  if( fColumns.size() == NAry + NVar ) {
+    for (UInt_t i = 0; i < NAry; i++)
+      fColumns[i]->Attach(fArrays[i]);
+    for (UInt_t i = 0; i < NVar; i++)
+      fColumns[NAry + i]->Attach(fVariables[i]);
+  }
+
   // Reattach formulas, cuts, histos
 
   for (auto & form : fFormulas) {
@@ -511,10 +834,37 @@ Int_t THaOutput::Attach()
   for (auto & cut : fCuts) {
     cut->ReAttach();
   }
+  for (auto & form : fHistForms) {
+    form->ReAttach();
+  }
   for (auto & hist : fHistos) {
     hist->ReAttach();
   }
 
+  // If enabled, compile the scalar formulas, now that they are attached
+  delete fFormulaJIT; fFormulaJIT = nullptr;
+  fFormulaJITIndex.clear();
+  if( Podd::FormulaJIT::IsEnabled() && !fFormulas.empty() ) {
+    auto* jit = new Podd::FormulaJIT("Output");
+    vector<Int_t> index(fFormulas.size(), -1);
+    for( size_t i = 0; i < fFormulas.size(); ++i ) {
+      if( fFormulaSrc[i] )
+        continue;
+      if( THaFormula* f = fFormulas[i]->GetScalarFormula() )
+        index[i] = jit->Add(f);
+    }
+    if( jit->GetSize() > 0 && jit->Compile() ) {
+      fFormulaJIT = jit;
+      fFormulaJITIndex = std::move(index);
+      if( fVerbose > 1 )
+        cout << "THaOutput: compiled " << jit->GetSize() << " of "
+             << fFormulas.size() << " formulas" << endl;
+    } else
+      delete jit;
+  }
+
+  fVarChanges = gHaVars->GetChangeCount();
+  fCutChanges = gHaCuts ? gHaCuts->GetChangeCount() : 0;
   return 0;
 
 }
@@ -527,30 +877,32 @@ Int_t THaOutput::ProcEpics(THaEvData *evdata, THaEpicsEvtHandler *epicshandle)
   if ( !epicshandle ) return 0;
   if ( !epicshandle->IsMyEvent(evdata->GetEvType())
        || fEpicsKey.empty() || !fEpicsTree ) return 0;
-  if( fDoBench ) fBench->Begin("EPICS");
+  StageProfiler::Scope timer(fProfID[kProfEPICS]);
   fEpicsTimestamp = -1;
   fEpicsEvtNum = SINT(evdata->GetEvNum()); // most recent physics event number
   auto siz = fEpicsKey.size();
+  if( epicshandle != fEpicsHandler || fEpicsHandle.size() != siz ) {
+    // Look up the channels once, not by name for every EPICS event
+    fEpicsHandle.resize(siz);
+    for( size_t i = 0; i < siz; ++i )
+      fEpicsHandle[i] = epicshandle->GetHandle(fEpicsKey[i]->GetName().c_str());
+    fEpicsHandler = epicshandle;
+  }
   for( size_t i = 0; i < siz; ++i ) {
-    if (epicshandle->IsLoaded(fEpicsKey[i]->GetName().c_str())) {
-      //      cout << "EPICS name "<<fEpicsKey[i]->GetName()<<"    val "
-      //      << epicshandle->GetString(fEpicsKey[i]->GetName().c_str())<<endl;
+    if( const auto* chan = epicshandle->GetChan(fEpicsHandle[i]) ) {
       if (fEpicsKey[i]->IsString()) {
-        fEpicsVar[i] =
-          fEpicsKey[i]->Eval(
-            epicshandle->GetString(fEpicsKey[i]->GetName().c_str()));
+        fEpicsVar[i] = fEpicsKey[i]->Eval(chan->GetString());
       } else {
-        fEpicsVar[i] = epicshandle->GetData(fEpicsKey[i]->GetName().c_str());
+        fEpicsVar[i] = chan->GetData();
       }
  // fill time stamp (once is ok since this is an EPICS event)
  //FIXME: check for inconsistent time stamps?
-      fEpicsTimestamp = epicshandle->GetTime(fEpicsKey[i]->GetName().c_str());
+      fEpicsTimestamp = chan->GetTimeStamp();
     } else {
       fEpicsVar[i] = -1e32;  // data not yet found
     }
   }
   if (fEpicsTree) fEpicsTree->Fill();
-  if( fDoBench ) fBench->Stop("EPICS");
   return 1;
 }
 
@@ -560,58 +912,43 @@ Int_t THaOutput::Process()
   // Process the variables, formulas, and histograms.
   // This is called by THaAnalyzer.
 
-  if( fDoBench ) fBench->Begin("Formulas");
-  for (auto & form : fFormulas)
-    if (form) form->Process();
-  if( fDoBench ) fBench->Stop("Formulas");
-
-  if( fDoBench ) fBench->Begin("Cuts");
-  for (auto & cut : fCuts)
-    if (cut) cut->Process();
-  if( fDoBench ) fBench->Stop("Cuts");
+  StageProfiler::Scope timer(fProfID[kProfFormulas]);
+  if( fFormulaJIT )
+    fFormulaJIT->Eval();
+  for( size_t i = 0; i < fFormulas.size(); ++i ) {
+    if( fFormulaSrc[i] )
+      fFormulas[i]->CopyData(*fFormulaSrc[i]);
+    else if( fFormulaJIT && fFormulaJITIndex[i] >= 0 )
+      fFormulas[i]->SetData(fFormulaJIT->GetResult(fFormulaJITIndex[i]));
+    else
+      fFormulas[i]->Process();
+  }
 
-  if( fDoBench ) fBench->Begin("Variables");
-  for (UInt_t ivar = 0; ivar < fNvar; ivar++) {
-    const auto* pvar = fVariables[ivar];
-    if( pvar ) {
-      Double_t x = pvar->GetValue();
-      if( x == kMinInt ) x = kBig;
-      fVar[ivar] = x;
-    }
+  timer.Start(fProfID[kProfCuts]);
+  for( size_t i = 0; i < fCuts.size(); ++i ) {
+    if( fCutSrc[i] )
+      fCuts[i]->CopyData(*fCutSrc[i]);
+    else
+      fCuts[i]->Process();
   }
-  Int_t k = 0;
-  for (auto it = fOdata.begin(); it != fOdata.end(); ++it, ++k) {
-    THaOdata* pdat(*it);
-    pdat->Clear();
-    const auto* pvar = fArrays[k];
-    if ( pvar == nullptr ) continue;
-    // Fill array in reverse order so that fOdata[k] gets resized just once
-    Int_t i = pvar->GetLen();
-    bool first = true;
-    while( i-- > 0 ) {
-      // FIXME: for better efficiency, should use pointer to data and
-      // Fill(int n,double* data) method in case of a contiguous array
-      Double_t x = pvar->GetValue(i);
-      if( x == kMinInt ) x = kBig;
-      if (pdat->Fill(i,x) != 1) {
-	if( fVerbose > 0 && first ) {
-	  cerr << "THaOutput::ERROR: storing too much variable sized data: "
-	       << pvar->GetName() <<"  "<<pvar->GetLen()<<endl;
-	  first = false;
-	}
-      }
+
+  timer.Start(fProfID[kProfVariables]);
+  for( auto* col : fColumns ) {
+    if( col->Fill() != 1 && fVerbose > 0 ) {
+      cerr << "THaOutput::ERROR: storing too much variable sized data: "
+           << col->GetName() << endl;
     }
   }
-  if( fDoBench ) fBench->Stop("Variables");
 
-  if( fDoBench ) fBench->Begin("Histos");
+  timer.Start(fProfID[kProfHistos]);
+  for (auto & form : fHistForms)
+    form->Process();
   for (auto & hist : fHistos)
     hist->Process();
-  if( fDoBench ) fBench->Stop("Histos");
 
-  if( fDoBench ) fBench->Begin("TreeFill");
+  timer.Start(fProfID[kProfTreeFill]);
   if (fTree) fTree->Fill();
-  if( fDoBench ) fBench->Stop("TreeFill");
+  timer.Stop();
 
   return 0;
 }
@@ -619,26 +956,12 @@ Int_t THaOutput::Process()
 //_____________________________________________________________________________
 Int_t THaOutput::End()
 {
-  if( fDoBench ) fBench->Begin("End");
+  StageProfiler::Scope timer(fProfID[kProfEnd]);
 
   if (fTree) fTree->Write();
   if (fEpicsTree) fEpicsTree->Write();
   for (auto & hist : fHistos)
     hist->End();
-  if( fDoBench ) fBench->Stop("End");
-
-  if( fDoBench ) {
-    cout << "Output timing summary:" << endl;
-    fBench->Print("Init");
-    fBench->Print("Attach");
-    fBench->Print("Variables");
-    fBench->Print("Formulas");
-    fBench->Print("Cuts");
-    fBench->Print("Histos");
-    fBench->Print("TreeFill");
-    fBench->Print("EPICS");
-    fBench->Print("End");
-  }
   return 0;
 }
 
@@ -1070,6 +1393,9 @@ void THaOutput::Print() const
       }
       if( !fHistos.empty() ) {
 	cout << "=== Number of histograms "<<fHistos.size()<<endl;
+	if( !fHistForms.empty() )
+	  cout << "=== Number of formulas/cuts shared by histograms "
+	       << fHistForms.size() << endl;
 	if( fVerbose > 1 ) {
 	  cout << endl;
 	  UInt_t i = 0;
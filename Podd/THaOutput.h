@@ -8,6 +8,9 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "TObject.h"
+#include "VarType.h"
+#include "VarAccessor.h"
+#include <array>
 #include <vector>
 #include <map>
 #include <string> 
@@ -22,7 +25,9 @@ class THaVhist;
 class THaEvData;
 class TTree;
 class THaEvtTypeHandler;
-class THaBenchmark;
+namespace Podd {
+  class FormulaJIT;
+}
 
 class THaOdata {
 // Utility class used by THaOutput to store arrays 
@@ -78,6 +83,52 @@ private:
   Bool_t Resize( Int_t i, bool save_old_data = false );
 };
 
+class THaOcolumn {
+// Utility class used by THaOutput to write one global variable, scalar
+// or array, to a tree branch in the variable's native type.
+// Contiguous basic data are copied with a single memcpy. Pointer arrays
+// are copied element by element. Other data are read through a typed
+// accessor (see Podd::VarAccessor) and converted to the branch type.
+public:
+  THaOcolumn( std::string name, Bool_t is_array, char leaftype );
+  THaOcolumn( const THaOcolumn& ) = delete;
+  THaOcolumn& operator=( const THaOcolumn& ) = delete;
+  ~THaOcolumn() = default;
+
+  void  AddBranch( TTree* T, Int_t bufsize );
+  void  Attach( const THaVar* var );
+  Int_t Fill();
+
+  const std::string& GetName()     const { return name; }
+  char               GetLeafType() const { return leaftype; }
+  Int_t              GetNdata()    const { return ndata; }
+  const void*        GetData()     const { return data.data(); }
+
+  // Branch leaf type code ('D', 'F', 'I', ...) for variables of type 'type'.
+  // Returns 'D' for types that have no native leaf type.
+  static char LeafType( VarType type );
+  static size_t LeafSize( char leaftype );
+
+private:
+  enum EFill { kNone, kCopy, kElement, kValue };
+  static constexpr Int_t kMaxSize = 1<<20;  // Max. number of array elements
+
+  Bool_t Resize( Int_t n );
+  void   Store( Int_t i );
+
+  TTree*              tree;      // Tree that we belong to
+  std::string         name;      // Name of the tree branch for the data
+  const THaVar*       var;       // Global variable to write
+  Podd::VarAccessor   acc;       // Typed access to the variable's data
+  Int_t               ndata;     // Number of valid array elements
+  Int_t               nsize;     // Capacity of the buffer in elements
+  size_t              size;      // Size of one element in bytes
+  char                leaftype;  // ROOT leaf type code
+  Bool_t              isarray;   // Variable-size array branch
+  EFill               method;    // How to copy the variable's data
+  std::vector<Long64_t> data;    // Data buffer, 8-byte aligned
+};
+
 
 class THaEpicsKey;
 class THaEpicsEvtHandler;
@@ -97,6 +148,13 @@ public:
   virtual TTree* GetTree() const { return fTree; };
 
   void SetVerbosity( Int_t level );
+
+  // Write global variables in their native types rather than converting
+  // everything to Double_t (default). This changes the branch types of
+  // the output tree, and integer and Float_t branches store the "no data"
+  // marker kMinInt as is rather than as kBig. Takes effect at the next Init().
+  static void   SetNativeTypes( Bool_t enable = true ) { fgNativeTypes = enable; }
+  static Bool_t NativeTypesEnabled() { return fgNativeTypes; }
   
 protected:
 
@@ -111,33 +169,45 @@ protected:
   static std::vector<std::string> reQuote(const std::vector<std::string>& input);
   static std::string CleanEpicsName(const std::string& var);
   void BuildList(const std::vector<std::string>& vdata);
+  THaVform* SharedForm(const char* type, const std::string& def,
+                       std::map<std::string, THaVform*>& shared);
   void Print() const;
 
   // Variables, Formulas, Cuts, Histograms
   UInt_t fNvar;
-  Double_t *fVar, *fEpicsVar;
+  Double_t *fEpicsVar;
   std::vector<std::string> fVarnames, 
                            fFormnames, fFormdef,
                            fCutnames, fCutdef,
                            fArrayNames, fVNames; 
   std::vector<THaVar* >  fVariables, fArrays;
+  std::vector<Int_t> fVarIDs, fArrayIDs;  // Name IDs in gHaVars, see Attach()
   std::vector<THaVform* > fFormulas, fCuts;
+  std::vector<const THaVform* > fFormulaSrc, fCutSrc; // Identical earlier definition, if any
+  std::vector<THaVform* > fHistForms;  // Formulas and cuts shared by histograms
   std::vector<THaVhist* > fHistos;
-  std::vector<THaOdata* > fOdata;
+  std::vector<THaOcolumn* > fColumns;  // Arrays first, then scalars
+  Podd::FormulaJIT* fFormulaJIT;       // Compiled scalar formulas, if any
+  std::vector<Int_t> fFormulaJITIndex; // Index of fFormulas in fFormulaJIT, or -1
   TTree* fTree;
 
   // EPICS tree
   std::vector<THaEpicsKey*>  fEpicsKey;
+  std::vector<Int_t> fEpicsHandle; // Channel handles of fEpicsKey in fEpicsHandler
   Long64_t fEpicsTimestamp;  // Timestamp of entry in EPICS tree
   Long64_t fEpicsEvtNum;     // Most recent physics event before entry in EPICS tree
   TTree* fEpicsTree;
 
   // Status, parameters
   Bool_t fInit;
-  Bool_t fDoBench;
   Int_t  fVerbose;
+  UInt_t fVarChanges, fCutChanges; // Change counts of gHaVars/gHaCuts at last Attach()
 
-  THaBenchmark* fBench;
+  // Output stages timed with Podd::StageProfiler
+  enum EProfStage { kProfInit, kProfAttach, kProfEPICS, kProfFormulas,
+                    kProfCuts, kProfVariables, kProfHistos, kProfTreeFill,
+                    kProfEnd, kNProfStages };
+  std::array<UInt_t,kNProfStages> fProfID; //! Profiler stage IDs
 
   enum EId {kVar = 1, kForm, kCut, kH1f, kH1d, kH2f, kH2d, kBlock,
             kBegin, kEnd, kRate, kCount };
@@ -158,6 +228,8 @@ private:
   Float_t xlo,xhi,ylo,yhi;
   Bool_t fOpenEpics,fFirstEpics,fIsScalar;
 
+  static Bool_t fgNativeTypes;  // Write variables in their native types
+
   ClassDef(THaOutput,0)  
 };
 
@@ -34,6 +34,7 @@ THaRaster::THaRaster( const char* name, const char* description,
   fRaw2Pos[0].ResizeTo(NPOS, NBPM);
   fRaw2Pos[1].ResizeTo(NPOS, NBPM);
   fRaw2Pos[2].ResizeTo(NPOS, NBPM);
+  UseDBFingerprint(Class());
 }
 
 
@@ -180,6 +180,8 @@ Int_t THaRun::Open()
 
   fOpened = false;
   Int_t st = fCodaData->codaOpen( fFilename );
+  if( st == CODA_OK )
+    st = fCodaData->setReadAhead( fReadAheadDepth, fReadAheadBytes );
   if( st == CODA_OK ) {
     // Get CODA version from data; however, if a version was set
     // explicitly by the user, use that instead
@@ -19,6 +19,12 @@
 //      NOTE: if you don't have the scaler map file (e.g. db_LeftScalevt.dat)
 //      there will be no variable output to the Trees.
 //
+//      Each variable is a Double_t branch of the "TS" tree. To write a
+//      single branch "scalers" with one leaf per variable in its native
+//      type instead, put this in the setup script:
+//
+//        Podd::ScalerTreeBuffer::SetTypedBranches();
+//
 //   To use in the analyzer, your setup script needs something like this
 //       gHaEvtHandlers->Add (new THaScalerEvtHandler("Left","HA scaler event type 140"));
 //
@@ -104,14 +110,26 @@ Int_t THaScalerEvtHandler::Analyze(THaEvData *evdata)
     fScalerTree = new TTree(sname2.Data(),sname3.Data());
     fScalerTree->SetAutoSave(200000000);
 
-    TString name = "evcount";
-    TString tinfo = name + "/D";
-    fScalerTree->Branch(name.Data(), &evcount, tinfo.Data(), 4000);
-
-    for( size_t i = 0; i < scalerloc.size(); i++) {
-      name = scalerloc[i]->name;
-      tinfo = name + "/D";
-      fScalerTree->Branch(name.Data(), &dvars[i], tinfo.Data(), 4000);
+    if( Podd::ScalerTreeBuffer::TypedBranchesEnabled() ) {
+      // One branch "scalers" with leaf "evcount" (ULong64_t) and one
+      // leaf per variable: counts as UInt_t, rates as Double_t
+      fTreeBuf.Clear();
+      fTreeBuf.Add("evcount", Podd::ScalerTreeBuffer::kULong64);
+      for( const auto* loc: scalerloc )
+        fTreeBuf.Add(loc->name.Data(), loc->ikind == ICOUNT
+                     ? Podd::ScalerTreeBuffer::kUInt
+                     : Podd::ScalerTreeBuffer::kDouble);
+      fTreeBuf.Branch(fScalerTree, "scalers", kScalerBasketSize);
+    } else {
+      TString name = "evcount";
+      TString tinfo = name + "/D";
+      fScalerTree->Branch(name.Data(), &evcount, tinfo.Data(), kScalerBasketSize);
+
+      for( size_t i = 0; i < scalerloc.size(); i++) {
+        name = scalerloc[i]->name;
+        tinfo = name + "/D";
+        fScalerTree->Branch(name.Data(), &dvars[i], tinfo.Data(), kScalerBasketSize);
+      }
     }
 
   }  // if (!fScalerTree)
@@ -133,25 +151,23 @@ Int_t THaScalerEvtHandler::Analyze(THaEvData *evdata)
   const UInt_t *pstop = p+ndata;
   Bool_t ifound = false;
 
+  // Look up each word in the table of scaler headers. Words that are
+  // not the header of a scaler are skipped. (The raw data were dumped
+  // above, if debugging.)
   while( p < pstop ) {
-    if( fDebugFile ) {
-      *fDebugFile << "p  and  pstop  " << p << "   " << pstop
-                  << "   " << hex << *p << "   " << dec << endl;
+    UInt_t j = 0;
+    UInt_t nskip = fDispatch.Decode(p, pstop, j);
+    if( nskip == 0 ) {
+      ++p;
+      continue;
     }
-    Int_t nskip = 1;
-    for( size_t j = 0; j < scalers.size(); j++ ) {
-      nskip = scalers[j]->Decode(p);
-      if( fDebugFile && nskip > 1 ) {
-        *fDebugFile << "\n===== Scaler # " << j << "     fName = " << fName
-                    << "   nskip = " << nskip << endl;
-        scalers[j]->DebugPrint(fDebugFile);
-      }
-      if( nskip > 1 ) {
-        ifound = true;
-        break;
-      }
+    ifound = true;
+    if( fDebugFile ) {
+      *fDebugFile << "\n===== Scaler # " << j << "     fName = " << fName
+                  << "   nskip = " << nskip << endl;
+      scalers[j]->DebugPrint(fDebugFile);
     }
-    p = p + nskip;
+    p += nskip;
   }
 
   if( fDebugFile ) {
@@ -190,6 +206,12 @@ Int_t THaScalerEvtHandler::Analyze(THaEvData *evdata)
 
   evcount += 1.0;
 
+  if( fTreeBuf.HasBranch() ) {
+    fTreeBuf.Set(0, evcount);
+    for( size_t i = 0; i < scalerloc.size(); i++ )
+      fTreeBuf.Set(static_cast<Int_t>(i + 1), dvars[i]);
+  }
+
   for( auto* s: scalers )
     s->Clear();
 
@@ -420,6 +442,9 @@ THaAnalysisObject::EStatus THaScalerEvtHandler::Init(const TDatime& date)
   // Identify indices of scalers[] vector to variables.
   SetIndices();
 
+  // Header word lookup table for Analyze()
+  fDispatch.Build(scalers);
+
   if(fDebugFile) {
     *fDebugFile << "THaScalerEvtHandler:: Name of scaler bank "<<fName<<endl;
     for (size_t i=0; i<scalers.size(); i++) {
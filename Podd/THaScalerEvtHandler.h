@@ -11,6 +11,8 @@
 
 #include "THaEvtTypeHandler.h"
 #include "Decoder.h"
+#include "ScalerDispatch.h"
+#include "ScalerTreeBuffer.h"
 #include "TString.h"
 #include <vector>
 #include <string>
@@ -62,11 +64,13 @@ protected:
    void AssignNormScaler();
 
    std::vector<Decoder::GenScaler*> scalers;
+   Decoder::ScalerDispatch fDispatch;  //! Header word lookup for scalers
    std::vector<ScalerLoc*> scalerloc;
    Double_t evcount;
    UInt_t fNormIdx, fNormSlot;
    Double_t *dvars;
    TTree *fScalerTree;
+   Podd::ScalerTreeBuffer fTreeBuf;  //! Typed scaler tree branch, if enabled
 
    ClassDef(THaScalerEvtHandler,0)  // Scaler Event handler
 
@@ -41,6 +41,7 @@ THaScintillator::THaScintillator( const char* name, const char* description,
   // Constructor
 
   fNviews = 2;
+  UseDBFingerprint(Class());
 }
 
 //_____________________________________________________________________________
@@ -43,6 +43,8 @@ THaShower::THaShower( const char* name, const char* description,
   , fADCData(nullptr)
 {
   // Constructor
+
+  UseDBFingerprint(Class());
 }
 
 //_____________________________________________________________________________
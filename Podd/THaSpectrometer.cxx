@@ -24,6 +24,7 @@
 #include "TList.h"
 #include "TMath.h"
 #include "VarDef.h"
+#include "MethodThunk.h"
 
 #ifdef WITH_DEBUG
 #include <iostream>
@@ -215,6 +216,22 @@ Int_t THaSpectrometer::DefineVariables( EMode mode )
   // Define/delete standard variables for a spectrometer (tracks etc.)
   // Can be overridden or extended by derived (actual) apparatuses
 
+  // Call the track member functions below directly rather than through
+  // the interpreter. They are evaluated for every track of every event.
+  using Podd::MethodThunk;
+  [[maybe_unused]] static const Bool_t methods_registered =
+    MethodThunk::Register<&THaTrack::GetLabPx>("GetLabPx") &&
+    MethodThunk::Register<&THaTrack::GetLabPy>("GetLabPy") &&
+    MethodThunk::Register<&THaTrack::GetLabPz>("GetLabPz") &&
+    MethodThunk::Register<&THaTrack::GetVertexX>("GetVertexX") &&
+    MethodThunk::Register<&THaTrack::GetVertexY>("GetVertexY") &&
+    MethodThunk::Register<&THaTrack::GetVertexZ>("GetVertexZ") &&
+    MethodThunk::Register<&THaTrack::GetPathLen>("GetPathLen") &&
+    MethodThunk::Register<&THaTrack::GetTime>("GetTime") &&
+    MethodThunk::Register<&THaTrack::GetdTime>("GetdTime") &&
+    MethodThunk::Register<&THaTrack::GetBeta>("GetBeta") &&
+    MethodThunk::Register<&THaTrack::GetdBeta>("GetdBeta");
+
   RVarDef vars[] = {
     { "tr.n",    "Number of tracks",             "GetNTracks()" },
     { "tr.x",    "Track x coordinate (m)",       "fTracks.THaTrack.fX" },
@@ -38,6 +38,7 @@ THaTotalShower::THaTotalShower( const char* name, const char* description,
   // and variable names like "L.ts.sh.nhits".
 
   Setup( name, "sh", "ps", description, apparatus, true );
+  UseDBFingerprint(Class());
 }
 
 //_____________________________________________________________________________
@@ -59,6 +60,7 @@ THaTotalShower::THaTotalShower( const char* name,
   // names like "L.sh.nhits".
 
   Setup( name, shower_name, preshower_name, description, apparatus, false );
+  UseDBFingerprint(Class());
 }
 
 //_____________________________________________________________________________
@@ -191,6 +191,69 @@ THaVar::THaVar( const char* name, const char* descript, const void* obj,
     MakeZombie();
 }
 
+//_____________________________________________________________________________
+THaVar::THaVar( const char* name, const char* descript, const void* obj,
+	Int_t offset, const Podd::MethodThunk& method )
+  : TNamed(name,descript)
+  , fImpl(nullptr)
+{
+  // Constructor for a member function call on a single object (offset < 0)
+  // or on each object in a TSeqCollection (offset >= 0). The function is
+  // called through 'method' (used by THaVarList::DefineByRTTI).
+
+  if( !method ) {
+    Error( here, "Variable %s: Invalid member function", name );
+    MakeZombie();
+    return;
+  }
+  if( offset >= 0 ) {
+    if( offset > 0 ) {
+      Warning( here, "Variable %s: Offset > 0 ignored for method call on "
+	       "object in collection. Fix code or call expert", name );
+    }
+    fImpl = make_unique<Podd::SeqCollectionMethodVar>(this, obj,
+                                                      method.GetType(),
+                                                      nullptr, method);
+  } else
+    fImpl = make_unique<Podd::MethodVar>(this, obj, method.GetType(),
+                                         nullptr, method);
+
+  if( fImpl->IsError() )
+    MakeZombie();
+}
+
+//_____________________________________________________________________________
+THaVar::THaVar( const char* name, const char* descript, const void* obj,
+	Int_t elem_size, Int_t offset, const Podd::MethodThunk& method )
+  : TNamed(name,descript)
+  , fImpl(nullptr)
+{
+  // Constructor for a member function call on each object in a
+  // std::vector<TObject(*)>. The function is called through 'method'
+  // (used by THaVarList::DefineByRTTI).
+
+  if( !method ) {
+    Error( here, "Variable %s: Invalid member function", name );
+    MakeZombie();
+    return;
+  }
+  if( elem_size < 0 || offset < 0 ) {
+    Error( here, "Variable %s: Illegal parameters elem_size = %d, "
+	   "offset = %d. Must be >= 0", name, elem_size, offset );
+    MakeZombie();
+    return;
+  }
+  if( offset > 0 ) {
+    Warning( here, "Variable %s: Offset > 0 ignored for method call on "
+	     "object", name );
+  }
+  fImpl = make_unique<Podd::VectorObjMethodVar>(this, obj, method.GetType(),
+                                                elem_size, nullptr, method);
+
+  if( fImpl->IsError() )
+    MakeZombie();
+}
+
 //_____________________________________________________________________________
 THaVar::THaVar( const THaVar& src )
   : TNamed(src)
@@ -12,6 +12,8 @@
 #include "TNamed.h"
 #include "VarType.h"
 #include "Variable.h"
+#include "VarAccessor.h"
+#include "MethodThunk.h"
 #include "TMethodCall.h"
 #include <vector>
 #include <memory>
@@ -36,6 +38,13 @@ public:
           VarType type, Int_t elem_size, Int_t offset,
           std::unique_ptr<TMethodCall> method=nullptr );
 
+  // Member function variables with compiled calls, see Podd::MethodThunk
+  THaVar( const char* name, const char* descript, const void* obj,
+          Int_t offset, const Podd::MethodThunk& method );
+
+  THaVar( const char* name, const char* descript, const void* obj,
+          Int_t elem_size, Int_t offset, const Podd::MethodThunk& method );
+
   THaVar( const THaVar& src );
   THaVar( THaVar&& src ) noexcept;
   THaVar& operator=( const THaVar& );
@@ -43,6 +52,7 @@ public:
   ~THaVar() override = default;
 
   Int_t        GetLen()                         const { return fImpl->GetLen(); }
+  const Int_t* GetLenPointer()                  const { return fImpl->GetLenPointer(); }
   Int_t        GetNdim()                        const { return fImpl->GetNdim(); }
   const Int_t* GetDim()                         const { return fImpl->GetDim(); }
 
@@ -61,6 +71,10 @@ public:
 
   Bool_t       HasSizeVar()                     const { return fImpl->HasSizeVar(); }
 
+  // Typed accessor for fast reading of the data. Must be obtained again
+  // if the variable is redefined.
+  Podd::VarAccessor GetAccessor()               const { return Podd::VarAccessor(this); }
+
   Bool_t       HasSameSize( const THaVar& rhs ) const;
   Bool_t       HasSameSize( const THaVar* rhs ) const;
   Int_t        Index( const char* subscripts )  const;
@@ -51,6 +51,7 @@
 #include "THaVarList.h"
 #include "THaVar.h"
 #include "THaRTTI.h"
+#include "MethodThunk.h"
 #include "THaArrayString.h"
 #include "TRegexp.h"
 #include "TString.h"
@@ -61,7 +62,9 @@
 
 #include <string>  // for TFunction::GetReturnTypeNormalizedName
 #include <cassert>
+#include <cstring>
 #include <memory>
+#include <string_view>
 
 ClassImp(THaVarList)
 
@@ -71,7 +74,9 @@ static const Int_t kInitVarListCapacity = 100;
 static const Int_t kVarListRehashLevel  = 3;
 
 //_____________________________________________________________________________
-THaVarList::THaVarList() : THashList(kInitVarListCapacity, kVarListRehashLevel)
+THaVarList::THaVarList()
+  : THashList(kInitVarListCapacity, kVarListRehashLevel)
+  , fChangeCount(0)
 {
   // Default constructor
 
@@ -80,6 +85,129 @@ THaVarList::THaVarList() : THashList(kInitVarListCapacity, kVarListRehashLevel)
   SetOwner(true);
 }
 
+//_____________________________________________________________________________
+void THaVarList::Register( TObject* obj )
+{
+  // Add variable 'obj' to the name index
+
+  auto* var = dynamic_cast<THaVar*>(obj);
+  if( !var )
+    return;
+  Int_t id = fNames.Intern(var->GetName());
+  if( id >= (Int_t)fByID.size() )
+    fByID.resize(id + 1, nullptr);
+  fByID[id] = var;
+  ++fChangeCount;
+}
+
+//_____________________________________________________________________________
+void THaVarList::Unregister( const TObject* obj )
+{
+  // Remove variable 'obj' from the name index. Its name keeps its ID.
+
+  if( !obj )
+    return;
+  Int_t id = fNames.Find(obj->GetName());
+  if( id != Podd::SymbolTable::kNoID && fByID[id] == obj ) {
+    fByID[id] = nullptr;
+    ++fChangeCount;
+  }
+}
+
+//_____________________________________________________________________________
+void THaVarList::AddFirst( TObject* obj )
+{
+  THashList::AddFirst(obj);
+  Register(obj);
+}
+
+//_____________________________________________________________________________
+void THaVarList::AddFirst( TObject* obj, Option_t* opt )
+{
+  THashList::AddFirst(obj, opt);
+  Register(obj);
+}
+
+//_____________________________________________________________________________
+void THaVarList::AddLast( TObject* obj )
+{
+  THashList::AddLast(obj);
+  Register(obj);
+}
+
+//_____________________________________________________________________________
+void THaVarList::AddLast( TObject* obj, Option_t* opt )
+{
+  THashList::AddLast(obj, opt);
+  Register(obj);
+}
+
+//_____________________________________________________________________________
+void THaVarList::AddAt( TObject* obj, Int_t idx )
+{
+  THashList::AddAt(obj, idx);
+  Register(obj);
+}
+
+//_____________________________________________________________________________
+void THaVarList::AddAfter( const TObject* after, TObject* obj )
+{
+  THashList::AddAfter(after, obj);
+  Register(obj);
+}
+
+//_____________________________________________________________________________
+void THaVarList::AddAfter( TObjLink* after, TObject* obj )
+{
+  THashList::AddAfter(after, obj);
+  Register(obj);
+}
+
+//_____________________________________________________________________________
+void THaVarList::AddBefore( const TObject* before, TObject* obj )
+{
+  THashList::AddBefore(before, obj);
+  Register(obj);
+}
+
+//_____________________________________________________________________________
+void THaVarList::AddBefore( TObjLink* before, TObject* obj )
+{
+  THashList::AddBefore(before, obj);
+  Register(obj);
+}
+
+//_____________________________________________________________________________
+TObject* THaVarList::Remove( TObject* obj )
+{
+  Unregister(obj);
+  return THashList::Remove(obj);
+}
+
+//_____________________________________________________________________________
+TObject* THaVarList::Remove( TObjLink* lnk )
+{
+  if( lnk )
+    Unregister(lnk->GetObject());
+  return THashList::Remove(lnk);
+}
+
+//_____________________________________________________________________________
+void THaVarList::Clear( Option_t* option )
+{
+  fByID.assign(fByID.size(), nullptr);
+  ++fChangeCount;
+  THashList::Clear(option);
+}
+
+//_____________________________________________________________________________
+void THaVarList::Delete( Option_t* option )
+{
+  fByID.assign(fByID.size(), nullptr);
+  ++fChangeCount;
+  THashList::Delete(option);
+}
+
 //_____________________________________________________________________________
 THaVar* THaVarList::DefineByType( const char* name, const char* descript,
 				  const void* var, VarType type,
@@ -321,6 +449,28 @@ THaVar* THaVarList::DefineByRTTI( const TString& name, const TString& desc,
     assert(pos2 != kNPOS );  // else EndsWith("()") lied
     funcName = funcName(0, pos2);
 
+    // Call the function directly if it has been registered with
+    // Podd::MethodThunk. Otherwise, use the interpreter via TMethodCall.
+    Podd::MethodThunk thunk = Podd::MethodThunk::Find(theClass, funcName);
+    if( thunk ) {
+      if( !objrtti.IsObjVector() )
+        var = new THaVar( name, desc, (void*)loc, ((ndot==2) ? 0 : -1), thunk );
+      else {
+        assert( ndot == 1 );
+        VarType otype = objrtti.GetType();
+        assert( otype == kObjectV || otype == kObjectPV );
+        Int_t sz = (otype == kObjectV) ? objrtti.GetClass()->Size() : 0;
+        var = new THaVar( name, desc, (void*)loc, sz, 0, thunk );
+      }
+      if( var->IsZombie() ) {
+        Warning( errloc, "Error creating variable %s", name.Data() );
+        delete var;
+        return nullptr;
+      }
+      AddLast( var );
+      return var;
+    }
+
     auto theMethod = make_unique<TMethodCall>(theClass, funcName, "" );
     if( !theMethod->IsValid() ) {
       Warning( errloc, "Error getting function information for variable %s. "
@@ -511,6 +661,8 @@ Int_t THaVarList::DefineVariables( const RVarDef* list, const TObject* obj,
   // member functions. They can be member variables, member variables
   // of member ROOT objects, or member variables of ROOT objects
   // contained in member ROOT containers derived from TSeqCollection.
+  // Member functions registered with Podd::MethodThunk::Register are called
+  // directly, others through the interpreter (TMethodCall).
   //
   // The names of all newly created variables will be prefixed with 'prefix',
   // if given.  Error messages will include 'caller', if given.
@@ -597,12 +749,21 @@ THaVar* THaVarList::Find( const char* name ) const
 
   if( !name )
     return nullptr;
-  string s(name);
-  auto pos = s.find('[');
-  return dynamic_cast<THaVar*>(
-    (pos == string::npos) ? FindObject(name)
-                          : FindObject(s.erase(pos).c_str())
-  );
+  const char* pos = strchr(name, '[');
+  string_view s = pos ? string_view(name, pos - name) : string_view(name);
+  return FindByID(fNames.Find(s));
+}
+
+//_____________________________________________________________________________
+Int_t THaVarList::GetID( const char* name ) const
+{
+  // ID of the variable name 'name', or -1 if no such variable was ever
+  // defined. Array subscripts are ignored, as in Find().
+
+  if( !name )
+    return Podd::SymbolTable::kNoID;
+  const char* pos = strchr(name, '[');
+  return fNames.Find(pos ? string_view(name, pos - name) : string_view(name));
 }
 
 //_____________________________________________________________________________
@@ -10,6 +10,7 @@
 #include "THashList.h"
 #include "THaVar.h"
 #include "VarDef.h"
+#include "SymbolTable.h"
 #include <vector>
 
 class THaVarList : public THashList {
@@ -188,7 +189,41 @@ public:
   virtual Int_t    RemoveName( const char* name );
   virtual Int_t    RemoveRegexp( const char* expr, Bool_t wildcard = true );
 
+  // Variable names are interned with IDs that remain valid when variables
+  // are deleted and redefined under the same name
+  Int_t            GetID( const char* name ) const;
+  THaVar*          FindByID( Int_t id ) const
+    { return (id >= 0 && id < (Int_t)fByID.size()) ? fByID[id] : nullptr; }
+  // Optimize name lookup once all variables are defined
+  void             Freeze() { fNames.Freeze(); }
+  // Incremented whenever variables are added or removed. Clients holding
+  // variable pointers need to re-attach only if this has changed.
+  UInt_t           GetChangeCount() const { return fChangeCount; }
+
+  // Overrides of THashList methods to keep the name index up to date.
+  // All methods that insert or remove objects must be overridden here.
+  virtual void     AddFirst( TObject* obj );
+  virtual void     AddFirst( TObject* obj, Option_t* opt );
+  virtual void     AddLast( TObject* obj );
+  virtual void     AddLast( TObject* obj, Option_t* opt );
+  virtual void     AddAt( TObject* obj, Int_t idx );
+  virtual void     AddAfter( const TObject* after, TObject* obj );
+  virtual void     AddAfter( TObjLink* after, TObject* obj );
+  virtual void     AddBefore( const TObject* before, TObject* obj );
+  virtual void     AddBefore( TObjLink* before, TObject* obj );
+  virtual TObject* Remove( TObject* obj );
+  virtual TObject* Remove( TObjLink* lnk );
+  virtual void     Clear( Option_t* option="" );
+  virtual void     Delete( Option_t* option="" );
+
 protected:
+  Podd::SymbolTable    fNames;  //! Interned variable names
+  std::vector<THaVar*> fByID;   //! Variables indexed by name ID
+  UInt_t               fChangeCount; //! Change counter, see GetChangeCount()
+
+  void             Register( TObject* obj );
+  void             Unregister( const TObject* obj );
+
 
   ClassDef(THaVarList,2)   //List of analyzer global variables
 };
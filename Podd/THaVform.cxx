@@ -80,9 +80,11 @@ THaVform::THaVform( const THaVform& rhs ) :
   THaFormula(rhs), fNvar(rhs.fNvar), fObjSize(rhs.fObjSize),
   fEyeOffset(rhs.fEyeOffset), fData(rhs.fData),
   fType(rhs.fType), fDebug(rhs.fDebug), fAndStr(rhs.fAndStr), fOrStr(rhs.fOrStr),
-  fSumStr(rhs.fSumStr), fVarName(rhs.fVarName), fVarStat(rhs.fVarStat),
+  fSumStr(rhs.fSumStr), fVarName(rhs.fVarName), fVarID(rhs.fVarID),
+  fVarStat(rhs.fVarStat),
   fSarray(rhs.fSarray), fVectSform(rhs.fVectSform), fStitle(rhs.fStitle),
-  fVarPtr(rhs.fVarPtr), fOdata(nullptr), fPrefix(rhs.fPrefix)
+  fVarPtr(rhs.fVarPtr), fVarAcc(rhs.fVarAcc), fOdata(nullptr),
+  fPrefix(rhs.fPrefix)
 {
   // Copy ctor
 
@@ -133,6 +135,7 @@ void THaVform::Create(const THaVform &rhs)
   fOrStr = rhs.fOrStr;
   fSumStr = rhs.fSumStr;
   fVarName = rhs.fVarName;
+  fVarID = rhs.fVarID;
   fVarStat = rhs.fVarStat;
 
   for( const auto* itf : rhs.fFormula ) {
@@ -152,6 +155,7 @@ void THaVform::Create(const THaVform &rhs)
   fVectSform = rhs.fVectSform;
   fStitle = rhs.fStitle;
   fVarPtr = rhs.fVarPtr;
+  fVarAcc = rhs.fVarAcc;
   delete fOdata; fOdata = nullptr;
   if( rhs.fOdata )
     fOdata = new THaOdata(*rhs.fOdata);
@@ -295,11 +299,15 @@ Int_t THaVform::Init()
   fStitle = GetTitle();
   Int_t status = 0;
 
+  // Look up variables by name ID, here and in ReAttach()
+  fVarID.assign(fVarName.size(), Podd::SymbolTable::kNoID);
+
   for( Int_t i = 0; i < fNvar; ++i ) {
     if( fVarStat[i] == kVAType ) {  // This obj is a var. sized array.
       if( StripBracket(fStitle) == fVarName[i] ) {
  	 status = 0;
-         fVarPtr = fVarList->Find(fVarName[i].c_str());
+         fVarPtr = FindVar(i);
+         fVarAcc = Podd::VarAccessor(fVarPtr);
          if( fVarPtr ) {
            fType = kVarArray;
            fObjSize = fVarPtr->GetLen();
@@ -330,7 +338,7 @@ Int_t THaVform::Init()
       return kIllMix;
     }
     if (fVarStat[i] != kFAType ) continue;
-    auto* pvar1 = fVarList->Find(fVarName[i].c_str());
+    auto* pvar1 = FindVar(i);
     fVarPtr = pvar1; // Store one pointer to be able to get the size
                      // later since it may change. This works since all
                      // elements were verified to be the same size.
@@ -338,7 +346,7 @@ Int_t THaVform::Init()
     for( Int_t j = i + 1; j < fNvar; ++j ) {
       if( fVarStat[j] != kFAType )
         continue;
-      const auto* pvar2 = fVarList->Find(fVarName[j].c_str());
+      const auto* pvar2 = FindVar(j);
       if (!pvar1 || !pvar2) {
         status = kArrZer;
         cout << "THaVform:ERROR: Trying to use zero pointer."<<endl;
@@ -387,16 +395,33 @@ void THaVform::ReAttach( )
 // Store one pointer to be able to get the size.
 // (see explanation in Init).  Also, recompile the
 // THaCut's and THaFormula's to reattach to variables.
+// Variable sized arrays are looked up again as well.
   for (Int_t i = 0; i < fNvar; ++i) {
-    if (fVarStat[i] != kFAType ) continue;
-    fVarPtr = fVarList->Find(fVarName[i].c_str());
+    if (fVarStat[i] != kFAType && fVarStat[i] != kVAType) continue;
+    fVarPtr = FindVar(i);
     break;
   }
+  if (fType == kVarArray)
+    fVarAcc = Podd::VarAccessor(fVarPtr);
   for( auto& itc : fCut ) itc->Compile();
   for( auto& itf : fFormula ) itf->Compile();
 }
 
 
+//_____________________________________________________________________________
+THaVar* THaVform::FindVar( Int_t i )
+{
+  // Find variable fVarName[i] in fVarList via its name ID. The ID is
+  // looked up on first use, which may be before the variable is defined.
+
+  assert( fVarList && i >= 0 && i < static_cast<Int_t>(fVarName.size()) );
+  if( fVarID.size() != fVarName.size() )
+    fVarID.assign(fVarName.size(), Podd::SymbolTable::kNoID);
+  if( fVarID[i] == Podd::SymbolTable::kNoID )
+    fVarID[i] = fVarList->GetID(fVarName[i].c_str());
+  return fVarList->FindByID(fVarID[i]);
+}
+
 //_____________________________________________________________________________
 Int_t THaVform::MakeFormula(Int_t flo, Int_t fhi)
 { // Make the vector formula (fVectSform) from index flo to fhi.
@@ -598,17 +623,16 @@ Int_t THaVform::Process()
     if (!fFormula.empty()) {
       THaFormula* theFormula = fFormula[0];
       if ( !theFormula->IsError() ) {
-	//FIXME: use cached result
         fData = theFormula->Eval();
       }
     }
     if( fOdata != nullptr ) {
+      // Element 0 was evaluated above
       vector<THaFormula*>::size_type i = fFormula.size();
       while( i-- > 0 ) {
 	THaFormula* theFormula = fFormula[i];
 	if ( !theFormula->IsError()) {
-	  //FIXME: use cached result?
-	  fOdata->Fill(i,theFormula->Eval());
+	  fOdata->Fill(i, (i == 0) ? fData : theFormula->Eval());
 	}
       }
     }
@@ -620,20 +644,18 @@ Int_t THaVform::Process()
     case kNoPrefix:
       // Standard case first
       if (fOdata) {
-	fObjSize = fVarPtr->GetLen();
-	// Fill array in reverse order so that fOdata is resized just once
-	Int_t i = fObjSize;
-	Bool_t first = true;
-	while( i-- > 0 ) {
-	  // FIXME: for better efficiency, should use pointer to data and
-	  // Fill(int n,double* data) method in case of a contiguous array
-	  if (fOdata->Fill(i,fVarPtr->GetValue(i)) != 1 && first ) {
-	    cout << "THaVform::ERROR: storing too much";
-	    cout << " variable sized data: ";
-	    cout << fVarPtr->GetName() <<"  "<<fVarPtr->GetLen()<<endl;
-	    first = false;
-	  }
+	fObjSize = fVarAcc.GetLen();
+	// Size fOdata for the last element, then convert all elements
+	// in one pass
+	Int_t n = fObjSize;
+	if( n > 0 && fOdata->Fill(n-1, 0.0) != 1 ) {
+	  cout << "THaVform::ERROR: storing too much";
+	  cout << " variable sized data: ";
+	  cout << fVarPtr->GetName() <<"  "<<fObjSize<<endl;
+	  while( --n > 0 && fOdata->Fill(n-1, 0.0) != 1 ) {}
 	}
+	if( n > 0 )
+	  fVarAcc.Gather(fOdata->data, 0, n);
       }
       break;
 
@@ -643,9 +665,9 @@ Int_t THaVform::Process()
 
     case kSum:
       {
-	Int_t i = fVarPtr->GetLen();
+	Int_t i = fVarAcc.GetLen();
 	while( i-- > 0 )
-	  fData += fVarPtr->GetValue(i);
+	  fData += fVarAcc.Get(i);
 	fObjSize = 1;
       }
       break;
@@ -659,19 +681,18 @@ Int_t THaVform::Process()
     if (!fCut.empty()) {
       THaCut* theCut = fCut[0];
       if (!theCut->IsError()) {
-	  //FIXME: use cached result?
-	//        if (theCut->Result()) fData = 1.0;
         if (theCut->EvalCut()) fData = 1.0;
       }
     }
     if( fOdata ) {
+      // Element 0 was evaluated above
       vector<THaCut*>::size_type i = fCut.size();
       while( i-- > 0 ) {
 	THaCut* theCut = fCut[i];
-	if ( !theCut->IsError() )
-	  //FIXME: use cached result?
-	  //	  fOdata->Fill( i, ((theCut->GetResult()) ? 1.0 : 0.0) );  // 1 = true
-	  fOdata->Fill( i, ((theCut->EvalCut()) ? 1.0 : 0.0) );  // 1 = true
+	if ( !theCut->IsError() ) {
+	  Bool_t ok = (i == 0) ? (fData != 0) : theCut->EvalCut();
+	  fOdata->Fill( i, (ok ? 1.0 : 0.0) );  // 1 = true
+	}
       }
     }
     return 0;
@@ -686,6 +707,23 @@ Int_t THaVform::Process()
 }
 
 
+//_____________________________________________________________________________
+void THaVform::CopyData( const THaVform& src )
+{
+// Take this event's results from 'src', which must have been processed
+// already and have the same definition. Used instead of Process() for
+// duplicate definitions.
+
+  fData = src.fData;
+  fObjSize = src.fObjSize;
+  if (fOdata) {
+    if (src.fOdata && src.fOdata->ndata > 0)
+      fOdata->Fill(src.fOdata->ndata, src.fOdata->data);
+    else
+      fOdata->Clear();
+  }
+}
+
 //_____________________________________________________________________________
 Int_t THaVform::DefinedGlobalVariable( TString& name )
 {
@@ -50,6 +50,13 @@ public:
 // Must 'Process' once per event before processing the things
 // that use this object.
   Int_t Process();
+// The formula that Process() evaluates if this is a scalar formula,
+// else nullptr. Its value may be computed elsewhere and set with SetData().
+  THaFormula* GetScalarFormula() const;
+  void SetData(Double_t y) { fData = y; }
+// Copy the results of 'src', a THaVform with the same definition,
+// instead of calling Process()
+  void CopyData(const THaVform& src);
 // To get the data (from index of array).  In the case of a
 // cut this will be a 0 or 1 (false or true).
   Double_t GetData(Int_t index = 0) const;
@@ -88,8 +95,10 @@ protected:
   void  GetForm(Int_t size);
   void  Create(const THaVform& vf);
   void  Uncreate();
+  THaVar* FindVar( Int_t i );
 
   std::vector<std::string> fVarName;
+  std::vector<Int_t> fVarID; //! Name IDs of fVarName in fVarList, see Init()
   std::vector<Int_t> fVarStat;
   std::vector<THaFormula*> fFormula;
   std::vector<THaCut*> fCut;
@@ -97,6 +106,7 @@ protected:
   std::vector<std::string> fVectSform;
   std::string   fStitle;
   THaVar   *fVarPtr;
+  Podd::VarAccessor fVarAcc; //! Typed access to data of var. sized array
   THaOdata *fOdata;
   Int_t fPrefix;
 
@@ -106,6 +116,13 @@ private:
 };
 
 
+inline
+THaFormula* THaVform::GetScalarFormula() const {
+  if (fType != kForm || fOdata || fFormula.size() != 1)
+    return nullptr;
+  return fFormula[0];
+}
+
 inline
 Double_t THaVform::GetData(Int_t index) const {
   if (IsEye())
@@ -39,13 +39,42 @@
 using namespace std;
 using namespace THaString;
 
+Int_t THaVhist::fgBufSize = 0;
+
+//_____________________________________________________________________________
+inline void THaVhist::Fill( Int_t ih, Double_t x )
+{
+  // Fill histogram 'ih' with x, or buffer the entry
+
+  if (fgBufSize == 0) {
+    fH1[ih]->Fill(x);
+    return;
+  }
+  fBuf[ih].x.push_back(x);
+  if (++fNbuf >= fgBufSize) Flush();
+}
+
+//_____________________________________________________________________________
+inline void THaVhist::Fill( Int_t ih, Double_t x, Double_t y )
+{
+  // Fill histogram 'ih' with (x,y), or buffer the entry
+
+  if (fgBufSize == 0) {
+    fH1[ih]->Fill(x, y);
+    return;
+  }
+  fBuf[ih].x.push_back(x);
+  fBuf[ih].y.push_back(y);
+  if (++fNbuf >= fgBufSize) Flush();
+}
+
 //_____________________________________________________________________________
 THaVhist::THaVhist( string type, string name, string title ) :
   fType(std::move(type)), fName(std::move(name)), fTitle(std::move(title)),
   fNbinX(0), fNbinY(0), fSize(0), fInitStat(0), fScalar(0), fEye(0),
   fEyeOffset(0), fXlo(0.), fXhi(0.), fYlo(0.), fYhi(0.),
   fFirst(true), fProc(true), fFormX(nullptr), fFormY(nullptr), fCut(nullptr),
-  fMyFormX(false), fMyFormY(false), fMyCut(false), fDebug(0)
+  fMyFormX(false), fMyFormY(false), fMyCut(false), fNbuf(0), fDebug(0)
 { 
   fH1.clear();
 }
@@ -99,6 +128,8 @@ Int_t THaVhist::Init( )
     for( auto& ith : fH1 ) delete ith;
   }
   fH1.clear();
+  fBuf.clear();
+  fNbuf = 0;
   fInitStat = 0;
 
   if (fDebug) cout << "THaVhist :: init " << fName << endl;
@@ -423,6 +454,7 @@ Int_t THaVhist::BookHisto(Int_t hfirst, Int_t hlast)
       }
     }
   }
+  fBuf.resize(fH1.size());
   return 0;
 }
  
@@ -448,11 +480,12 @@ Int_t THaVhist::Process()
   }
   if ( !IsValid() ) return -1;
   
+  // Formulas and cuts set from outside are processed by their owner
   if (fMyFormX) fFormX->Process();
   if (fFormY && fMyFormY) fFormY->Process();
   Int_t sizec = 0;
-  if (fCut && fMyCut) {
-     fCut->Process();
+  if (fCut) {
+     if (fMyCut) fCut->Process();
      sizec = fCut->GetSize();
   }
 
@@ -491,7 +524,7 @@ Int_t THaVhist::Process()
 	//        cout << "THaVhist :: proc loop: data  "<<i<<"  "<<fFormX->GetData(*ix)<<"   "<<fFormY->GetData(*iy)<<"  *ic "<<*ic<<endl<<flush;
 	if ( CheckCut(*ic)==0 ) continue;
 	//  cout << "THaVhist :: proc loop:     FILLING HISTO "<<i<<endl;
- 	fH1[0]->Fill(fFormX->GetData(*ix), fFormY->GetData(*iy));
+ 	Fill(0, fFormX->GetData(*ix), fFormY->GetData(*iy));
       }
 
     } else {  // 1D histo
@@ -503,7 +536,7 @@ Int_t THaVhist::Process()
 	} else {
  	   if ( CheckCut()==0 ) continue;
 	}
-	fH1[0]->Fill(fFormX->GetData(i));
+	Fill(0, fFormX->GetData(i));
       }
     }
 
@@ -523,12 +556,12 @@ Int_t THaVhist::Process()
     if( fFormY ) {
       for( ; i < fSize; ++i ) {
 	if ( CheckCut(i)==0 ) continue; 
-	fH1[*idx]->Fill(fFormX->GetData(i), fFormY->GetData(i));
+	Fill(*idx, fFormX->GetData(i), fFormY->GetData(i));
       }
     } else {
       for( ; i < fSize; ++i ) {
 	if ( CheckCut(i)==0 ) continue; 
-	fH1[*idx]->Fill(fFormX->GetData(i));
+	Fill(*idx, fFormX->GetData(i));
       }
     }
   }
@@ -539,10 +572,37 @@ Int_t THaVhist::Process()
 //_____________________________________________________________________________
 Int_t THaVhist::End() 
 {
+  Flush();
   for( auto& ith : fH1 ) ith->Write();
   return 0;
 }
 
+//_____________________________________________________________________________
+void THaVhist::Flush()
+{
+  // Fill the buffered entries into the histograms with FillN, which is
+  // considerably faster than filling entries one by one.
+  // Entries are buffered per THaVhist object. Process() and Flush() are
+  // called only by the analysis thread.
+
+  if (fNbuf == 0) return;
+  for( size_t ih = 0; ih < fBuf.size(); ++ih ) {
+    auto& buf = fBuf[ih];
+    auto n = static_cast<Int_t>(buf.x.size());
+    if (n == 0) continue;
+    TH1* h = fH1[ih];
+    if (buf.y.empty())
+      h->FillN(n, buf.x.data(), nullptr);
+    else if (h->GetDimension() == 1)
+      h->FillN(n, buf.x.data(), buf.y.data());  // y is the weight, as in Fill(x,y)
+    else
+      h->FillN(n, buf.x.data(), buf.y.data(), nullptr, 1);
+    buf.x.clear();
+    buf.y.clear();
+  }
+  fNbuf = 0;
+}
+
 
 //_____________________________________________________________________________
 void THaVhist::ErrPrint() const
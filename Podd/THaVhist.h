@@ -48,6 +48,15 @@ public:
    Int_t Process();
 // Must End() to write histogram to output at end of analysis.
    Int_t End();
+// Fill buffered entries into the histograms. Done automatically when
+// the buffer is full and at End().
+   void  Flush();
+// Number of entries buffered per THaVhist before filling the histograms
+// in bulk. The default, 0, fills the histograms immediately. With
+// buffering, histograms do not show the latest entries until the next
+// Flush(), so enable it only if histograms are not inspected mid-run.
+   static void  SetBufferSize(Int_t n) { fgBufSize = (n > 0) ? n : 0; }
+   static Int_t GetBufferSize() { return fgBufSize; }
 // Self-explanatory printouts.
    void  Print() const;
    void  ErrPrint() const;
@@ -65,6 +74,8 @@ protected:
    Int_t FindVarSize();
    Bool_t FindEye(const string& var);
    Bool_t FindEyeOffset(const string& var);
+   void  Fill(Int_t ih, Double_t x);
+   void  Fill(Int_t ih, Double_t x, Double_t y);
 //   Int_t GetCut(Int_t index=0);
 
    enum FEr { kOK = 0, kNoBinX, kIllFox, kIllFoy, kIllCut,
@@ -80,10 +91,16 @@ protected:
    Bool_t fFirst, fProc;
 
    std::vector<TH1* > fH1;
+   // Entries not yet filled into fH1, per histogram
+   struct FillBuf_t { std::vector<Double_t> x, y; };
+   std::vector<FillBuf_t> fBuf;
+   Int_t fNbuf;          // Total number of buffered entries
    THaVform *fFormX, *fFormY, *fCut;
    Bool_t fMyFormX, fMyFormY, fMyCut;
    Int_t fDebug;
 
+   static Int_t fgBufSize;
+
 private:
 
   THaVhist(const THaVhist& vhist);
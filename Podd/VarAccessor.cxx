@@ -0,0 +1,265 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// Podd::VarAccessor
+//
+// Typed, non-virtual read access to a global variable.
+//
+// The accessor classifies the variable once, when it is created, and
+// binds reader functions specialized for the element type and memory
+// layout. For example, reading a contiguous Float_t array becomes a
+// simple conversion loop over a pointer.
+//
+// Accessors hold addresses obtained from the variable. They must be
+// recreated whenever the variable is redefined, i.e. when consumers
+// re-attach to global variables.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "VarAccessor.h"
+#include "THaVar.h"
+#include <vector>
+
+using namespace std;
+
+namespace Podd {
+
+//_____________________________________________________________________________
+VarAccessor::VarAccessor()
+  : fVar(nullptr), fData(nullptr), fLenP(nullptr), fLen(0), fVarLen(false),
+    fElemType(kDouble), fLayout(kNoData), fStride(0), fLenFn(nullptr),
+    fBaseFn(nullptr), fGetFn(nullptr), fGatherFn(nullptr)
+{
+  // Default constructor. Accesses nothing.
+
+  BindGeneric();
+  fLayout = kNoData;
+}
+
+//_____________________________________________________________________________
+VarAccessor::VarAccessor( const THaVar* var )
+  : VarAccessor()
+{
+  // Construct accessor for 'var'
+
+  fVar = var;
+  if( !fVar || !(fData = fVar->GetValuePointer()) )
+    return;
+
+  fVarLen = fVar->IsVarArray() || fVar->IsVector();
+  VarType type = fVar->GetType();
+  if( fVar->IsBasic() && !fVar->IsVector() ) {
+    if( type >= kDouble && type <= kUChar ) {
+      fLayout = kDirect;
+    } else if( type >= kDoubleP && type <= kUCharP ) {
+      fLayout = kIndirect;
+      type = static_cast<VarType>(type - kDoubleP + kDouble);
+    } else if( type >= kDouble2P && type <= kUChar2P ) {
+      fLayout = kPointerArray;
+      type = static_cast<VarType>(type - kDouble2P + kDouble);
+    }
+    if( fLayout != kNoData ) {
+      fLenP = fVar->GetLenPointer();
+      fLen = fVar->IsVarArray() ? 0 : fVar->GetLen();
+    }
+  } else if( fVar->IsVector() ) {
+    switch( type ) {
+      case kIntV:    type = kInt;    break;
+      case kUIntV:   type = kUInt;   break;
+      case kFloatV:  type = kFloat;  break;
+      case kDoubleV: type = kDouble; break;
+      default: break;
+    }
+    if( type != fVar->GetType() )
+      fLayout = kVector;
+  }
+  if( fLayout == kNoData ) {
+    fLayout = kGeneric;
+    fElemType = type;
+    return;
+  }
+
+  fElemType = type;
+  switch( type ) {
+    case kDouble: Bind<Double_t>();  break;
+    case kFloat:  Bind<Float_t>();   break;
+    case kLong:   Bind<Long64_t>();  break;
+    case kULong:  Bind<ULong64_t>(); break;
+    case kInt:    Bind<Int_t>();     break;
+    case kUInt:   Bind<UInt_t>();    break;
+    case kShort:  Bind<Short_t>();   break;
+    case kUShort: Bind<UShort_t>();  break;
+    case kChar:   Bind<Char_t>();    break;
+    case kUChar:  Bind<UChar_t>();   break;
+    default:
+      fLayout = kGeneric;
+      BindGeneric();
+      break;
+  }
+}
+
+//_____________________________________________________________________________
+template<typename T>
+void VarAccessor::Bind()
+{
+  // Select the reader functions for element type T
+
+  fStride = (fLayout == kPointerArray) ? 0 : sizeof(T);
+  fLenFn = nullptr;
+  fBaseFn = nullptr;
+  switch( fLayout ) {
+    case kDirect:
+      fGetFn = GetT<T,kDirect>;
+      fGatherFn = GatherT<T,kDirect>;
+      break;
+    case kIndirect:
+      fGetFn = GetT<T,kIndirect>;
+      fGatherFn = GatherT<T,kIndirect>;
+      break;
+    case kPointerArray:
+      fGetFn = GetT<T,kPointerArray>;
+      fGatherFn = GatherT<T,kPointerArray>;
+      break;
+    case kVector:
+      fGetFn = GetT<T,kVector>;
+      fGatherFn = GatherT<T,kVector>;
+      fLenFn = VectorLen<T>;
+      fBaseFn = VectorBase<T>;
+      break;
+    default:
+      BindGeneric();
+      break;
+  }
+}
+
+//_____________________________________________________________________________
+void VarAccessor::BindGeneric()
+{
+  // Read data with THaVar::GetValue. Used for variables that are not
+  // basic data, such as results of member functions and data in objects.
+
+  fStride = 0;
+  fGetFn = GetGeneric;
+  fGatherFn = GatherGeneric;
+  fLenFn = GenericLen;
+  fBaseFn = nullptr;
+  fLenP = nullptr;
+  fLen = 0;
+}
+
+//_____________________________________________________________________________
+const void* VarAccessor::GetElement( Int_t i ) const
+{
+  // Address of element i, or nullptr
+
+  if( const void* base = GetBase() )
+    return static_cast<const char*>(base) + i * fStride;
+  if( fLayout == kPointerArray ) {
+    const void* const* arr = *static_cast<const void* const* const*>(fData);
+    return arr ? arr[i] : nullptr;
+  }
+  if( fLayout == kGeneric && fVar )
+    return fVar->GetDataPointer(i);
+  return nullptr;
+}
+
+//_____________________________________________________________________________
+template<typename T, VarAccessor::ELayout L>
+const T* VarAccessor::BaseT( const VarAccessor& a )
+{
+  if constexpr( L == kDirect )
+    return static_cast<const T*>(a.fData);
+  else if constexpr( L == kIndirect )
+    return *static_cast<const T* const*>(a.fData);
+  else if constexpr( L == kVector )
+    return static_cast<const vector<T>*>(a.fData)->data();
+  else
+    return nullptr;
+}
+
+//_____________________________________________________________________________
+template<typename T, VarAccessor::ELayout L>
+Double_t VarAccessor::GetT( const VarAccessor& a, Int_t i )
+{
+  if constexpr( L == kPointerArray ) {
+    const T* const* arr = *static_cast<const T* const* const*>(a.fData);
+    if( !arr || !arr[i] )
+      return THaVar::kInvalid;
+    return static_cast<Double_t>(*arr[i]);
+  } else {
+    const T* p = BaseT<T,L>(a);
+    return p ? static_cast<Double_t>(p[i]) : THaVar::kInvalid;
+  }
+}
+
+//_____________________________________________________________________________
+template<typename T, VarAccessor::ELayout L>
+Int_t VarAccessor::GatherT( const VarAccessor& a, Double_t* dst,
+                           Int_t first, Int_t n )
+{
+  if constexpr( L == kPointerArray ) {
+    const T* const* arr = *static_cast<const T* const* const*>(a.fData);
+    Int_t nok = 0;
+    for( Int_t l = 0; l < n; ++l ) {
+      const T* p = arr ? arr[first + l] : nullptr;
+      if( p ) {
+        dst[l] = static_cast<Double_t>(*p);
+        ++nok;
+      } else
+        dst[l] = THaVar::kInvalid;
+    }
+    return nok;
+  } else {
+    const T* p = BaseT<T,L>(a);
+    if( !p ) {
+      for( Int_t l = 0; l < n; ++l )
+        dst[l] = THaVar::kInvalid;
+      return 0;
+    }
+    p += first;
+    for( Int_t l = 0; l < n; ++l )
+      dst[l] = static_cast<Double_t>(p[l]);
+    return n;
+  }
+}
+
+//_____________________________________________________________________________
+template<typename T>
+Int_t VarAccessor::VectorLen( const VarAccessor& a )
+{
+  return static_cast<Int_t>(static_cast<const vector<T>*>(a.fData)->size());
+}
+
+//_____________________________________________________________________________
+template<typename T>
+const void* VarAccessor::VectorBase( const VarAccessor& a )
+{
+  return static_cast<const vector<T>*>(a.fData)->data();
+}
+
+//_____________________________________________________________________________
+Int_t VarAccessor::GenericLen( const VarAccessor& a )
+{
+  return a.fVar ? a.fVar->GetLen() : 0;
+}
+
+//_____________________________________________________________________________
+Double_t VarAccessor::GetGeneric( const VarAccessor& a, Int_t i )
+{
+  return a.fVar ? a.fVar->GetValue(i) : THaVar::kInvalid;
+}
+
+//_____________________________________________________________________________
+Int_t VarAccessor::GatherGeneric( const VarAccessor& a, Double_t* dst,
+                                  Int_t first, Int_t n )
+{
+  if( !a.fVar ) {
+    for( Int_t l = 0; l < n; ++l )
+      dst[l] = THaVar::kInvalid;
+    return 0;
+  }
+  for( Int_t l = 0; l < n; ++l )
+    dst[l] = a.fVar->GetValue(first + l);
+  return n;
+}
+
+} // namespace Podd
@@ -0,0 +1,117 @@
+#ifndef Podd_VarAccessor_h_
+#define Podd_VarAccessor_h_
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Podd::VarAccessor
+//
+// Fast read access to the data of a global variable (THaVar).
+// The memory layout and element type are resolved once, when the
+// accessor is created. Reading then requires no virtual calls and no
+// switch on the variable type.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "Rtypes.h"
+#include "VarType.h"
+
+class THaVar;
+
+namespace Podd {
+
+class VarAccessor {
+
+public:
+  // How the data are laid out in memory
+  enum ELayout {
+    kNoData,        // Variable has no data (e.g. in error)
+    kDirect,        // Elements at fixed address
+    kIndirect,      // Elements at address held in a pointer ("P" types)
+    kPointerArray,  // Array of pointers to elements ("2P" types)
+    kVector,        // std::vector of elements ("V" types)
+    kGeneric        // Anything else, read with THaVar::GetValue(i)
+  };
+
+  VarAccessor();
+  explicit VarAccessor( const THaVar* var );
+
+  const THaVar* GetVar()    const { return fVar; }
+  ELayout  GetLayout()      const { return fLayout; }
+  // Type of the elements, kDouble ... kUChar, or the variable's type
+  // for generic variables
+  VarType  GetElemType()    const { return fElemType; }
+  // Size of the elements in bytes if the data are contiguous, else 0
+  size_t   GetStride()      const { return fStride; }
+  Bool_t   IsContiguous()   const { return fStride != 0; }
+  // Data at a fixed address, i.e. element 0 never moves
+  Bool_t   IsFixed()        const { return fLayout == kDirect; }
+  Bool_t   IsVarArray()     const { return fVarLen; }
+
+  // Current number of elements
+  Int_t    GetLen() const
+  {
+    if( fLenP )
+      return *fLenP;
+    if( fLenFn )
+      return fLenFn(*this);
+    return fLen;
+  }
+  // Address of element 0 of contiguous data, or nullptr
+  const void* GetBase() const
+  {
+    switch( fLayout ) {
+      case kDirect:   return fData;
+      case kIndirect: return *static_cast<const void* const*>(fData);
+      case kVector:   return fBaseFn(*this);
+      default:        return nullptr;
+    }
+  }
+  // Address of element i, or nullptr. The index is not checked.
+  const void* GetElement( Int_t i ) const;
+  // Value of element i. The index is not checked.
+  // Elements that cannot be read give THaVar::kInvalid.
+  Double_t Get( Int_t i ) const { return fGetFn(*this, i); }
+  // Convert elements first ... first+n-1 to Double_t. The range is not
+  // checked. Returns the number of elements that could be read.
+  Int_t    Gather( Double_t* dst, Int_t first, Int_t n ) const
+  {
+    return fGatherFn(*this, dst, first, n);
+  }
+
+private:
+  using LenFn_t    = Int_t (*)( const VarAccessor& );
+  using BaseFn_t   = const void* (*)( const VarAccessor& );
+  using GetFn_t    = Double_t (*)( const VarAccessor&, Int_t );
+  using GatherFn_t = Int_t (*)( const VarAccessor&, Double_t*, Int_t, Int_t );
+
+  const THaVar* fVar;       // Variable
+  const void*   fData;      // THaVar::GetValuePointer()
+  const Int_t*  fLenP;      // Length of variable-size arrays, or nullptr
+  Int_t         fLen;       // Fixed length
+  Bool_t        fVarLen;    // Length may change
+  VarType       fElemType;  // Element type
+  ELayout       fLayout;    // Memory layout
+  size_t        fStride;    // Element size if contiguous, else 0
+  LenFn_t       fLenFn;     // Length of vectors
+  BaseFn_t      fBaseFn;    // Data of vectors
+  GetFn_t       fGetFn;     // Read one element
+  GatherFn_t    fGatherFn;  // Read consecutive elements
+
+  template<typename T> void Bind();
+  void BindGeneric();
+
+  template<typename T, ELayout L> static const T* BaseT( const VarAccessor& a );
+  template<typename T, ELayout L> static Double_t GetT( const VarAccessor& a, Int_t i );
+  template<typename T, ELayout L> static Int_t GatherT( const VarAccessor& a, Double_t* dst,
+                                                        Int_t first, Int_t n );
+  template<typename T> static Int_t VectorLen( const VarAccessor& a );
+  template<typename T> static const void* VectorBase( const VarAccessor& a );
+  static Int_t    GenericLen( const VarAccessor& a );
+  static Double_t GetGeneric( const VarAccessor& a, Int_t i );
+  static Int_t    GatherGeneric( const VarAccessor& a, Double_t* dst,
+                                 Int_t first, Int_t n );
+};
+
+} // namespace Podd
+
+#endif
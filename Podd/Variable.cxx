@@ -82,6 +82,15 @@ Int_t Variable::GetLen() const
   return 1;
 }
 
+//_____________________________________________________________________________
+const Int_t* Variable::GetLenPointer() const
+{
+  // Pointer to the variable holding the number of elements of a
+  // variable-size array, else nullptr
+
+  return nullptr;
+}
+
 //_____________________________________________________________________________
 Int_t Variable::GetNdim() const
 {
@@ -31,6 +31,7 @@ namespace Podd {
     virtual VarPtr_t     clone( THaVar* pvar ) const;
 
     virtual Int_t        GetLen()  const;
+    virtual const Int_t* GetLenPointer() const;
     virtual Int_t        GetNdim() const;
     virtual const Int_t* GetDim()  const;
 
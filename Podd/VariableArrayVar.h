@@ -21,6 +21,7 @@ namespace Podd {
     virtual VarPtr_t     clone( THaVar* pvar ) const;
 
     virtual Int_t        GetLen()  const;
+    virtual const Int_t* GetLenPointer() const { return fCount; }
     virtual Int_t        GetNdim() const;
     virtual const Int_t* GetDim()  const;
 
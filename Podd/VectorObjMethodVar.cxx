@@ -19,10 +19,10 @@ namespace Podd {
 //_____________________________________________________________________________
 VectorObjMethodVar::VectorObjMethodVar( THaVar* pvar, const void* addr,
                                         VarType type, Int_t elem_size,
-                                        MethodPtr_t method )
+                                        MethodPtr_t method, MethodThunk thunk )
   : Variable(pvar,addr,type),
     SeqCollectionVar(pvar,addr,type,0),
-    MethodVar(pvar,addr,type,std::move(method)),
+    MethodVar(pvar,addr,type,std::move(method),std::move(thunk)),
     VectorObjVar(pvar,addr,type,elem_size,0)
 {
   // Constructor
@@ -32,7 +32,7 @@ VectorObjMethodVar::VectorObjMethodVar( THaVar* pvar, const void* addr,
 Variable::VarPtr_t VectorObjMethodVar::clone( THaVar* pvar ) const
 {
   return make_unique<VectorObjMethodVar>(pvar, fValueP, fType, fElemSize,
-                                         make_unique<TMethodCall>(*fMethod));
+                                         CloneMethod(), fThunk);
 }
 
 //_____________________________________________________________________________
@@ -19,7 +19,8 @@ namespace Podd {
 
   public:
     VectorObjMethodVar( THaVar* pvar, const void* addr, VarType type,
-                        Int_t elem_size, MethodPtr_t method );
+                        Int_t elem_size, MethodPtr_t method,
+                        MethodThunk thunk = {} );
 
     virtual VarPtr_t     clone( THaVar* pvar ) const;
 
@@ -11,6 +11,40 @@
 
 using namespace std;
 
+#ifdef PODD_COUNT_ALLOCATIONS
+#include "StageProfiler.h"
+#include <cstdlib>
+#include <new>
+
+//_____________________________________________________________________________
+// Replacement global allocation functions that count heap allocations per
+// thread, so that the stage profiler can report allocations per analysis
+// module (see THaAnalyzer::EnableModuleTiming). Only built with the CMake
+// option PODD_COUNT_ALLOCATIONS, since every allocation pays for the hook.
+void* operator new( size_t size )
+{
+  Podd::StageProfiler::CountAllocation();
+  while( true ) {
+    if( void* p = malloc(size > 0 ? size : 1) )
+      return p;
+    auto* handler = get_new_handler();
+    if( !handler )
+      throw bad_alloc();
+    handler();
+  }
+}
+
+void operator delete( void* p ) noexcept
+{
+  free(p);
+}
+
+void operator delete( void* p, size_t ) noexcept
+{
+  free(p);
+}
+#endif
+
 int main(int argc, char **argv)
 {
   // Create a ROOT-style interactive interface
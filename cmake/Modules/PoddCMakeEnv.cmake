@@ -16,6 +16,7 @@ option(WITH_DEBUG "Enable additional/verbose debug messages" ON)
 option(PODD_SET_RPATH "Set RPATH on installed executables & libraries" ON)
 option(PODD_ENABLE_TESTS "Build unit and integration tests" OFF)
 option(PODD_BUILD_UTILS "Build utility programs" OFF)
+option(PODD_COUNT_ALLOCATIONS "Count heap allocations in the analyzer for the stage profiler" OFF)
 
 #----------------------------------------------------------------------------
 # System-specific build flags
@@ -16,14 +16,15 @@
 #include "DAQConfigString.h"  // for DAQConfigString
 #include "Helper.h"           // for ALL
 #include "Module.h"           // for Module
+#include "StageProfiler.h"    // for StageProfiler
 #include "TBits.h"            // for TBits
-#include "THaBenchmark.h"     // for THaBenchmark
 #include "THaCrateMap.h"      // for THaCrateMap
 #include "THaSlotData.h"      // for THaSlotData
 #include "THaUsrstrutils.h"   // for THaUsrstrutils
 #include "TString.h"          // for Form
 #include <cstdio>             // for printf
 #include <algorithm>          // for find, for_each, min, reverse, sort
+#include <bit>                // for countr_zero
 #include <cstring>            // for size_t, memcpy
 #include <exception>          // for exception
 #include <fstream>            // for ofstream
@@ -101,10 +102,60 @@ Int_t CodaDecoder::Init()
   if( ret != HED_OK )
     return ret;
   FindUsedSlots();
+  BuildSlotDispatch();
   fDAQconfig.clear();
   return HED_OK;
 }
 
+//_____________________________________________________________________________
+void CodaDecoder::BuildSlotDispatch()
+{
+  // Set up the tables that roc_decode uses to find the slot(s) to which
+  // a given header word may belong. Must be called whenever the crate map
+  // or the module configuration changes.
+
+  static_assert(MAXSLOT <= 32, "Slot sets must fit into a UInt_t");
+  for( auto& sdisp : fSlotDispatch )
+    sdisp.clear();
+  for( auto roc : fMap->GetUsedCrates() ) {
+    if( roc >= MAXROC )
+      continue;
+    auto& sdisp = fSlotDispatch[roc];
+    for( auto slot : fMap->GetUsedSlots(roc) ) {
+      // ignore bank structure slots; they are decoded with bank_decode
+      if( fMap->getBank(roc, slot) >= 0 )
+        continue;
+      sdisp.slots.emplace_back(slot, crateslot[idx(roc, slot)].get());
+    }
+    // higher slot # appears first in multiblock mode
+    // the decoding order improves efficiency
+    if( fMap->isFastBus(roc) )
+      std::reverse(ALL(sdisp.slots));
+
+    for( UInt_t i = 0; i < sdisp.slots.size(); ++i ) {
+      auto* module = sdisp.slots[i].second->GetModule();
+      UInt_t header = 0, mask = 0;
+      if( module && module->GetHeaderSignature(header, mask) )
+        sdisp.headers.Add(header, mask, i);
+      else
+        sdisp.any |= 1U << i;
+    }
+  }
+}
+
+//_____________________________________________________________________________
+UInt_t CodaDecoder::SlotDispatch::candidates( UInt_t word ) const
+{
+  // Set of slots whose header word signature matches 'word'
+
+  UInt_t ret = any;
+  headers.ForEach(word, [&ret]( UInt_t i ) {
+    ret |= 1U << i;
+    return false;
+  });
+  return ret;
+}
+
 //_____________________________________________________________________________
 Int_t CodaDecoder::LoadEvent( const UInt_t* evbuffer )
 {
@@ -245,10 +296,10 @@ Int_t CodaDecoder::physics_decode( const UInt_t* evbuffer )
       return ret;
   }
   assert(fMap);
-  if( fDoBench ) fBench->Begin("clearEvent");
+  Podd::StageProfiler::Scope timer(fProfID[kProfClearEvent]);
   for( auto i : fSlotClear )
     crateslot[i]->clearEvent();
-  if( fDoBench ) fBench->Stop("clearEvent");
+  timer.Start(fProfID[kProfPhysicsDecode]);  // until return
 
   if( fDataVersion == 3 ) {
     event_num = tbank.evtNum;
@@ -1021,7 +1072,7 @@ Int_t CodaDecoder::roc_decode( UInt_t roc, const UInt_t* evbuffer,
   if( ipt+1 >= istop )
     return HED_OK;
 
-  if( fDoBench ) fBench->Begin("roc_decode");
+  Podd::StageProfiler::Scope timer(fProfID[kProfRocDecode]);
   Int_t retval = HED_OK;
   try {
     UInt_t Nslot = fMap->getNslot(roc);
@@ -1047,37 +1098,30 @@ Int_t CodaDecoder::roc_decode( UInt_t roc, const UInt_t* evbuffer,
 
     assert(fMap->GetUsedSlots(roc).size() == Nslot); // else bug in THaCrateMap
 
-    // Build the to-do list of slots based on the contents of the crate map
-    vector<pair<UInt_t,THaSlotData*>> slots_todo; slots_todo.reserve(Nslot);
-    for( auto slot : fMap->GetUsedSlots(roc) ) {
-      assert(fMap->slotUsed(roc, slot));   // else bug in THaCrateMap
-      // ignore bank structure slots; they are decoded with bank_decode
-      if( fMap->getBank(roc, slot) >= 0 )
-        continue;
-      slots_todo.emplace_back(slot,crateslot[idx(roc,slot)].get());
-    }
+    // Slots to decode, from the crate map, in search order
+    const auto& sdisp = fSlotDispatch[roc];
+    const auto& slots = sdisp.slots;
+    assert(slots.size() <= Nslot);
     // Quit if nothing to do (all bank structure slots, decoded in bank_decode)
-    if( slots_todo.empty() )
+    if( slots.empty() )
       return HED_OK;
-
-    // higher slot # appears first in multiblock mode
-    // the decoding order improves efficiency
     bool is_fastbus = fMap->isFastBus(roc);
-    if( is_fastbus )
-      std::reverse( ALL(slots_todo) );
-
-    // Crawl through this ROC's data block. Each word is tested against all the
-    // defined modules (slots) in the crate for a match with the expected slot
-    // header. If a match is found, this word is the slot header. Zero or more
-    // words following the slot header represent the data for the slot. These
-    // data are loaded into the module's internal storage, and the corresponding
-    // slot is removed from the search list. The search for the remaining slots
-    // then resumes at the first word after the data.
+
+    // Crawl through this ROC's data block. Each word is looked up in the
+    // table of header word signatures of the defined modules (slots) in the
+    // crate. Modules whose signature matches are tested, in order, for a match
+    // with the expected slot header. If a match is found, this word is the
+    // slot header. Zero or more words following the slot header represent the
+    // data for the slot. These data are loaded into the module's internal
+    // storage, and the corresponding slot is removed from the search list.
+    // The search for the remaining slots then resumes at the first word
+    // after the data.
     const UInt_t* p = evbuffer + ipt;    // Points to ROC ID word (1 before data)
     const UInt_t* pstop = evbuffer + istop;   // Points to last word of data
-    UInt_t nextidx = 0;
+    UInt_t todo = (slots.size() < 32) ? (1U << slots.size()) - 1 : kMaxUInt;
 
-    while( p++ < pstop ) {
+    // Fastbus flag data may follow the last slot, so scan fastbus ROCs fully
+    while( (todo || is_fastbus) && p++ < pstop ) {
       if( fDebugFile )
         *fDebugFile << "CodaDecode::roc_decode:: evbuff " << (p - evbuffer)
                     << "  " << hex << *p << dec << endl;
@@ -1085,13 +1129,9 @@ Int_t CodaDecoder::roc_decode( UInt_t roc, const UInt_t* evbuffer,
       if( is_fastbus && LoadIfFlagData(p) )
         continue;
 
-      bool update_nextidx = true;
-      for( UInt_t i = nextidx; i < slots_todo.size(); ++i ) {
-        UInt_t slot = slots_todo[i].first;
-        // ignore bank structure slots; they are decoded with bank_decode
-        if( slot == kMaxUInt )
-          continue;
-        auto* sd = slots_todo[i].second;
+      for( UInt_t cand = sdisp.candidates(*p) & todo; cand; cand &= cand-1 ) {
+        auto i = static_cast<UInt_t>(std::countr_zero(cand));
+        auto [slot, sd] = slots[i];
 
         if( fDebugFile )
           *fDebugFile << "roc_decode:: slot logic " << roc << "  " << slot;
@@ -1099,11 +1139,6 @@ Int_t CodaDecoder::roc_decode( UInt_t roc, const UInt_t* evbuffer,
         // Check if data word at p belongs to the module at the current slot
         UInt_t nwords = sd->LoadIfSlot(p, pstop);
 
-        if( sd->IsMultiBlockMode() )
-          fMultiBlockMode = true;
-        if( sd->BlockIsDone() )
-          fBlockIsDone = true;
-
         if( fDebugFile )
           *fDebugFile << "CodaDecode:: roc_decode:: after LoadIfSlot "
                       << p + ((nwords > 0) ? nwords - 1 : 0) << "  " << pstop
@@ -1115,23 +1150,24 @@ Int_t CodaDecoder::roc_decode( UInt_t roc, const UInt_t* evbuffer,
                         << nwords << endl;
           // Data for this slot found and loaded. Advance to next data block.
           p += nwords-1;
-          slots_todo[i].first = kMaxUInt;  // Mark slot as done
-          if( update_nextidx )
-            nextidx = i+1;
+          todo &= ~(1U << i);  // Mark slot as done
           break;
-        } else if( update_nextidx ) {
-          nextidx = i;
-          update_nextidx = false;
         }
       }
     } //end while(p++<pstop)
+
+    for( const auto& [slot, sd] : slots ) {
+      if( sd->IsMultiBlockMode() )
+        fMultiBlockMode = true;
+      if( sd->BlockIsDone() )
+        fBlockIsDone = true;
+    }
   }
   catch( const exception& e ) {
     cerr << e.what() << endl;
     retval = HED_ERR;
   }
 
-  if( fDoBench ) fBench->Stop("roc_decode");
   return retval;
 }
 
@@ -1154,7 +1190,7 @@ Int_t CodaDecoder::bank_decode( UInt_t roc, const UInt_t* evbuffer,
   if (!fMap->isBankStructure(roc))
     return HED_OK;
 
-  if( fDoBench ) fBench->Begin("bank_decode");
+  Podd::StageProfiler::Scope timer(fProfID[kProfBankDecode]);
   if (fDebugFile)
     *fDebugFile << "CodaDecode:: bank_decode  ... " << roc << "   " << ipt
                 << "  " << istop << endl;
@@ -1200,7 +1236,6 @@ Int_t CodaDecoder::bank_decode( UInt_t roc, const UInt_t* evbuffer,
       fBlockIsDone = true;
   }
 
-  if( fDoBench ) fBench->Stop("bank_decode");
   return HED_OK;
 }
 
@@ -1378,9 +1413,6 @@ Int_t CodaDecoder::FindRocs(const UInt_t *evbuffer) {
 // ROC = ReadOut Controller, synonymous with "crate".
 
   assert( evbuffer );
-#ifdef FIXME
-  if( fDoBench ) fBench->Begin("physics_decode");
-#endif
   Int_t status = HED_OK;
 
   // The following line is not meaningful for CODA3
@@ -1399,7 +1431,6 @@ Int_t CodaDecoder::FindRocs(const UInt_t *evbuffer) {
         cout << "ERROR in EvtTypeHandler::FindRocs "<<endl;
         cout << "  illegal ROC number " <<dec<<iroc<<endl;
       }
-      if( fDoBench ) fBench->Stop("physics_decode");
 #endif
       return HED_ERR;
     }
@@ -11,12 +11,14 @@
 /////////////////////////////////////////////////////////////////////
 
 #include "THaEvData.h"  // for THaEvData, Rtypes, MAX_PSFACT
+#include "HeaderTable.h"  // for HeaderTable
 #include <array>        // for array
 #include <cassert>      // for assert
 #include <cstdint>      // for uint32_t, uint64_t, uint16_t, uint8_t
 #include <cstring>      // for size_t, memcpy, memset
 #include <stdexcept>    // for runtime_error
 #include <string>       // for string
+#include <utility>      // for pair
 #include <vector>       // for vector
 
 namespace Decoder {
@@ -201,6 +203,7 @@ protected:
   Int_t bank_decode( UInt_t roc, const UInt_t* evbuffer, UInt_t ipt, UInt_t istop );
   Int_t physics_decode( const UInt_t* evbuffer );
 
+  void BuildSlotDispatch();
   void CompareRocs();
   void ChkFbSlot( UInt_t roc, const UInt_t* evbuffer, UInt_t ipt, UInt_t istop );
   void ChkFbSlots();
@@ -226,6 +229,18 @@ protected:
   std::vector<BankDat_t> bankdat;
   BankDat_t* CheckForBank( UInt_t roc, UInt_t slot );
 
+  // Per-ROC lookup tables for roc_decode, built from the crate map in Init().
+  // Sets of slots are bit patterns of indices into 'slots'.
+  struct SlotDispatch {
+    void  clear() { slots.clear(); headers.Clear(); any = 0; }
+    UInt_t candidates( UInt_t word ) const;
+
+    std::vector<std::pair<UInt_t,THaSlotData*>> slots; // (slot, data) in search order
+    HeaderTable headers; // Indices into 'slots' by header signature
+    UInt_t any{0};     // Slots without known signature, always candidates
+  };
+  std::array<SlotDispatch, MAXROC> fSlotDispatch;
+
   // CODA3 stuff
   UInt_t blkidx;  // Event block index (0 <= blkidx < block_size)
   Bool_t fMultiBlockMode, fBlockIsDone;
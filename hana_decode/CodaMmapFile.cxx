@@ -0,0 +1,370 @@
+/////////////////////////////////////////////////////////////////////
+//
+//  CodaMmapFile
+//
+//  Read-only access to a CODA data file via a memory mapping.
+//  See header for details.
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "CodaMmapFile.h"
+#include "THaCodaFile.h"
+#include "evio.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cassert>
+#include <cerrno>
+#include <bit>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef __cpp_lib_byteswap
+#define bswap_32(x) std::byteswap<uint32_t>(x)
+#else
+#define bswap_32 __builtin_bswap32
+#endif
+
+using namespace std;
+
+namespace Decoder {
+
+// EVIO block header layout
+static constexpr UInt_t EV_HD_BLKSIZ = 0;  // Block size (words)
+static constexpr UInt_t EV_HD_HDSIZ  = 2;  // Header size (words)
+static constexpr UInt_t EV_HD_USED   = 4;  // Words used in block (EVIO 1-3)
+static constexpr UInt_t EV_HD_VER    = 5;  // Version and flags
+static constexpr UInt_t EV_HD_MAGIC  = 7;  // Magic number
+static constexpr UInt_t EV_HDSIZ     = 8;  // Minimum header size
+static constexpr UInt_t EV_MAGIC     = 0xc0da0100;
+static constexpr UInt_t EV_VERSION_MASK = 0xff;
+static constexpr UInt_t EV_DICTIONARY_BIT = 0x100;  // EVIO 4
+static constexpr UInt_t EV_LASTBLOCK_BIT  = 0x200;  // EVIO 4
+
+//_____________________________________________________________________________
+CodaMmapFile::CodaMmapFile()
+  : fData(nullptr), fNwords(0), fPos(0), fBlockEnd(0), fNextBlock(0)
+  , fEvent(nullptr), fEvLen(0), fVersion(0), fSwapped(false)
+  , fLastBlock(false), fReadAheadDepth(0), fReadAheadBytes(0)
+{
+  // Default constructor. Do nothing (must open file separately).
+}
+
+//_____________________________________________________________________________
+CodaMmapFile::CodaMmapFile( const char* fname )
+  : CodaMmapFile()
+{
+  // Standard constructor. Open file 'fname' for reading
+  CodaMmapFile::codaOpen(fname);
+}
+
+//_____________________________________________________________________________
+CodaMmapFile::~CodaMmapFile()
+{
+  CodaMmapFile::codaClose();
+}
+
+//_____________________________________________________________________________
+Int_t CodaMmapFile::codaOpen( const char* fname, Int_t mode )
+{
+  // Open CODA file 'fname' in read-only mode
+  return codaOpen(fname, "r", mode);
+}
+
+//_____________________________________________________________________________
+Int_t CodaMmapFile::codaOpen( const char* fname, const char* readwrite,
+                              Int_t mode )
+{
+  // Open CODA file 'fname'. Files opened for reading are mapped into memory
+  // if their format is supported. All other files are accessed via EVIO.
+
+  codaClose();
+  filename = fname;
+  if( !readwrite || readwrite[0] != 'r' )
+    return openFallback(fname, readwrite, mode);
+
+  if( mapFile(fname) != S_SUCCESS ) {
+    // Not an uncompressed EVIO 1-4 file. Let EVIO try to read it
+    if( verbose > 1 )
+      cout << "CodaMmapFile: " << fname << " cannot be mapped. "
+           << "Reading via EVIO" << endl;
+    return openFallback(fname, readwrite, mode);
+  }
+  fIsGood = true;
+  return CODA_OK;
+}
+
+//_____________________________________________________________________________
+Int_t CodaMmapFile::mapFile( const char* fname )
+{
+  // Map file 'fname' into memory and check its format.
+  // Returns S_SUCCESS or CODA_ERROR if the file cannot be mapped or its
+  // format is not supported here. Errors like "file not found" are left
+  // to the fallback reader to report.
+
+  int fd = open(fname, O_RDONLY);
+  if( fd < 0 )
+    return CODA_ERROR;
+  struct stat st{};
+  if( fstat(fd, &st) != 0 ) {
+    close(fd);
+    return CODA_ERROR;
+  }
+  size_t nbytes = st.st_size;
+  if( nbytes < EV_HDSIZ * sizeof(UInt_t) || nbytes % sizeof(UInt_t) != 0 ) {
+    close(fd);
+    return CODA_ERROR;
+  }
+  void* addr = mmap(nullptr, nbytes, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);  // the mapping keeps the file open
+  if( addr == MAP_FAILED )
+    return CODA_ERROR;
+  madvise(addr, nbytes, MADV_SEQUENTIAL);
+
+  fData = static_cast<const UInt_t*>(addr);
+  fNwords = nbytes / sizeof(UInt_t);
+  UInt_t magic = fData[EV_HD_MAGIC];
+  fSwapped = (magic == bswap_32(EV_MAGIC));
+  if( magic == EV_MAGIC || fSwapped ) {
+    fVersion = static_cast<Int_t>(word(EV_HD_VER) & EV_VERSION_MASK);
+    if( fVersion >= 1 && fVersion <= 4 ) {
+      fNextBlock = 0;
+      return S_SUCCESS;
+    }
+  }
+  // EVIO 6, compressed file, or not an EVIO file at all
+  munmap(addr, nbytes);
+  fData = nullptr;
+  fNwords = 0;
+  return CODA_ERROR;
+}
+
+//_____________________________________________________________________________
+Int_t CodaMmapFile::openFallback( const char* fname, const char* rw,
+                                  Int_t mode )
+{
+  // Open 'fname' with a regular EVIO file reader
+  fFallback = make_unique<THaCodaFile>();
+  fFallback->setVerbosity(verbose);
+  fFallback->setReadAhead(fReadAheadDepth, fReadAheadBytes);
+  Int_t status = fFallback->codaOpen(fname, rw, mode);
+  fIsGood = fFallback->isGood();
+  return status;
+}
+
+//_____________________________________________________________________________
+Int_t CodaMmapFile::codaClose()
+{
+  // Close the file. Do nothing if file not opened.
+  Int_t status = CODA_OK;
+  if( fFallback ) {
+    status = fFallback->codaClose();
+    fFallback.reset();
+  }
+  if( fData ) {
+    munmap(const_cast<UInt_t*>(fData), fNwords * sizeof(UInt_t));
+    fData = nullptr;
+  }
+  fNwords = fPos = fBlockEnd = fNextBlock = 0;
+  fEvent = nullptr;
+  fEvLen = 0;
+  fVersion = 0;
+  fSwapped = fLastBlock = false;
+  return status;
+}
+
+//_____________________________________________________________________________
+UInt_t CodaMmapFile::word( size_t i ) const
+{
+  // Header word 'i' of the file in host byte order
+  assert(i < fNwords);
+  return fSwapped ? bswap_32(fData[i]) : fData[i];
+}
+
+//_____________________________________________________________________________
+Int_t CodaMmapFile::loadBlock( size_t pos )
+{
+  // Make the block starting at 'pos' current. Returns an EVIO status code.
+
+  if( pos >= fNwords )
+    return EOF;
+  if( fNwords - pos < EV_HDSIZ )
+    return S_EVFILE_UNXPTDEOF;
+  if( word(pos + EV_HD_MAGIC) != EV_MAGIC )
+    return S_EVFILE_BADBLOCK;
+  size_t blksiz = word(pos + EV_HD_BLKSIZ);
+  size_t hdsiz = word(pos + EV_HD_HDSIZ);
+  UInt_t verword = word(pos + EV_HD_VER);
+  if( hdsiz < EV_HDSIZ || blksiz < hdsiz )
+    return S_EVFILE_BADBLOCK;
+  if( fNwords - pos < blksiz )
+    return S_EVFILE_UNXPTDEOF;
+
+  size_t used = blksiz;
+  if( fVersion < 4 ) {
+    // The block size is fixed. Only the first 'used' words hold data
+    used = word(pos + EV_HD_USED);
+    if( used < hdsiz || used > blksiz )
+      return S_EVFILE_BADBLOCK;
+  }
+  fPos = pos + hdsiz;
+  fBlockEnd = pos + used;
+  fNextBlock = pos + blksiz;
+  fLastBlock = (fVersion >= 4 && (verword & EV_LASTBLOCK_BIT));
+
+  // Skip the dictionary. EVIO reports it separately, not as an event.
+  if( fVersion >= 4 && pos == 0 && (verword & EV_DICTIONARY_BIT)
+      && fPos < fBlockEnd ) {
+    size_t len = size_t(word(fPos)) + 1;
+    if( len > fBlockEnd - fPos )
+      return S_EVFILE_BADFILE;
+    fPos += len;
+  }
+  return S_SUCCESS;
+}
+
+//_____________________________________________________________________________
+Int_t CodaMmapFile::assembleEvent( size_t len )
+{
+  // Copy an event of 'len' words spanning several blocks into the event
+  // buffer. Event fragments are only found in EVIO 1-3 files.
+
+  if( len > kMaxUInt || !evbuffer.grow(len) || evbuffer.size() < len )
+    return S_EVFILE_ALLOCFAIL;
+  UInt_t* buf = evbuffer.get();
+  size_t n = 0;
+  while( n < len ) {
+    if( fPos >= fBlockEnd ) {
+      Int_t status = loadBlock(fNextBlock);
+      if( status != S_SUCCESS )
+        return (status == EOF) ? S_EVFILE_UNXPTDEOF : status;
+      continue;
+    }
+    size_t chunk = std::min(len - n, fBlockEnd - fPos);
+    memcpy(buf + n, fData + fPos, chunk * sizeof(UInt_t));
+    fPos += chunk;
+    n += chunk;
+  }
+  fEvent = buf;
+  return S_SUCCESS;
+}
+
+//_____________________________________________________________________________
+Int_t CodaMmapFile::codaRead()
+{
+  // Advance to the next event in the file. Must be called once per event.
+
+  if( fFallback )
+    return fFallback->codaRead();
+  if( !fData ) {
+    if( verbose > 0 ) {
+      cout << "codaRead ERROR: tried to access a file that is not open" << endl;
+      cout << "You need to call codaOpen(filename)" << endl;
+      cout << "or use the constructor with (filename) arg" << endl;
+    }
+    return ReturnCode(S_EVFILE_BADHANDLE);
+  }
+
+  fEvent = nullptr;
+  fEvLen = 0;
+  errno = 0;
+  Int_t status = S_SUCCESS;
+  while( status == S_SUCCESS && fPos >= fBlockEnd )
+    status = fLastBlock ? EOF : loadBlock(fNextBlock);
+
+  if( status == S_SUCCESS ) {
+    size_t len = size_t(word(fPos)) + 1;
+    if( len < 2 )
+      status = S_EVFILE_BADFILE;
+    else if( len <= fBlockEnd - fPos ) {
+      // Usual case: event contained in the current block
+      fEvent = fData + fPos;
+      fPos += len;
+    } else if( fVersion < 4 )
+      status = assembleEvent(len);
+    else
+      status = S_EVFILE_BADFILE;  // EVIO 4 events never span blocks
+
+    // Swap a copy of the event. The mapping itself is read-only.
+    if( status == S_SUCCESS && fSwapped && fEvent != evbuffer.get() ) {
+      if( !evbuffer.grow(len) || evbuffer.size() < len )
+        status = S_EVFILE_ALLOCFAIL;
+      else {
+        memcpy(evbuffer.get(), fEvent, len * sizeof(UInt_t));
+        fEvent = evbuffer.get();
+      }
+    }
+    if( status == S_SUCCESS ) {
+      fEvLen = len;
+      if( fSwapped )
+        evioswap(evbuffer.get(), 1, nullptr);
+      if( fEvent == evbuffer.get() )
+        evbuffer.recordSize();
+    } else
+      fEvent = nullptr;
+  }
+  fIsGood = (status == S_SUCCESS || status == EOF);
+  staterr("read", status);
+  return ReturnCode(status);
+}
+
+//_____________________________________________________________________________
+UInt_t* CodaMmapFile::getEvBuffer()
+{
+  // Buffer holding the most recently read event
+  if( fFallback )
+    return fFallback->getEvBuffer();
+  // Events in the mapping are read-only, even though the interface
+  // does not say so
+  return fEvent ? const_cast<UInt_t*>(fEvent) : THaCodaData::getEvBuffer();
+}
+
+//_____________________________________________________________________________
+UInt_t CodaMmapFile::getBuffSize() const
+{
+  if( fFallback )
+    return fFallback->getBuffSize();
+  return fEvent ? fEvLen : THaCodaData::getBuffSize();
+}
+
+//_____________________________________________________________________________
+Int_t CodaMmapFile::getCodaVersion()
+{
+  // Get CODA version of the open file
+  if( fFallback )
+    return fFallback->getCodaVersion();
+  if( !fData )
+    return -1;
+  return (fVersion < 4) ? 2 : 3;
+}
+
+//_____________________________________________________________________________
+Int_t CodaMmapFile::setReadAhead( UInt_t depth, size_t max_bytes )
+{
+  // Configure read-ahead. For mapped files, this is done by the kernel's
+  // page cache read-ahead, so the setting only applies to files read
+  // via EVIO.
+  if( fFallback ) {
+    Int_t status = fFallback->setReadAhead(depth, max_bytes);
+    if( status != CODA_OK )
+      return status;
+  }
+  fReadAheadDepth = depth;
+  fReadAheadBytes = max_bytes;
+  return CODA_OK;
+}
+
+//_____________________________________________________________________________
+Bool_t CodaMmapFile::isOpen() const
+{
+  if( fFallback )
+    return fFallback->isOpen();
+  return (fData != nullptr);
+}
+
+} // namespace Decoder
+
+//_____________________________________________________________________________
+ClassImp(Decoder::CodaMmapFile)
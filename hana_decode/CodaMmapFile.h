@@ -0,0 +1,83 @@
+#ifndef Podd_CodaMmapFile_h_
+#define Podd_CodaMmapFile_h_
+
+/////////////////////////////////////////////////////////////////////
+//
+//  CodaMmapFile
+//
+//  Read-only access to a CODA data file via a memory mapping.
+//
+//  The file is mapped into memory as a whole, and the EVIO block
+//  and event headers are parsed directly. getEvBuffer() returns a
+//  pointer into the mapping, so events are neither copied nor read
+//  with system calls. Only CODA 2 events that span block boundaries
+//  are assembled in the event buffer.
+//
+//  Supported are EVIO format versions 1-4 (CODA 2 and CODA 3).
+//  Byte-swapped files are swapped lazily, one event at a time, as
+//  events are read. Each event is copied to the event buffer and
+//  swapped there. The mapping is read-only, so its pages always remain
+//  clean page cache that the kernel can reclaim.
+//
+//  Files that cannot be handled this way, in particular EVIO 6
+//  files, which may contain compressed data, or files opened for
+//  writing, are transparently handed over to a THaCodaFile.
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "THaCodaData.h"
+#include <memory>
+
+namespace Decoder {
+
+class CodaMmapFile : public THaCodaData {
+
+public:
+
+  CodaMmapFile();
+  explicit CodaMmapFile(const char* filename);
+  CodaMmapFile(const CodaMmapFile &fn) = delete;
+  CodaMmapFile& operator=(const CodaMmapFile &fn) = delete;
+  virtual ~CodaMmapFile();
+  virtual Int_t codaOpen(const char* filename, Int_t mode=1);
+  virtual Int_t codaOpen(const char* filename, const char* rw, Int_t mode=1);
+  virtual Int_t codaClose();
+  virtual Int_t codaRead();
+  virtual UInt_t* getEvBuffer();
+  virtual UInt_t  getBuffSize() const;
+  virtual Int_t getCodaVersion();
+  virtual Int_t setReadAhead( UInt_t depth, size_t max_bytes = 0 );
+  virtual Bool_t isOpen() const;
+
+  // True if the open file is read via the mapping (not via THaCodaFile)
+  Bool_t isMapped() const { return fData != nullptr; }
+
+private:
+
+  Int_t  mapFile( const char* fname );
+  Int_t  openFallback( const char* fname, const char* rw, Int_t mode );
+  Int_t  loadBlock( size_t pos );
+  Int_t  assembleEvent( size_t len );
+  UInt_t word( size_t i ) const;
+
+  const UInt_t* fData;      // Start of mapped file (nullptr = not mapped)
+  size_t  fNwords;          // Mapped file size (words)
+  size_t  fPos;             // Position of next event
+  size_t  fBlockEnd;        // End of event data in current block
+  size_t  fNextBlock;       // Position of next block header
+  const UInt_t* fEvent;     // Current event
+  UInt_t  fEvLen;           // Length of current event (words)
+  Int_t   fVersion;         // EVIO format version of mapped file
+  Bool_t  fSwapped;         // File byte order differs from host
+  Bool_t  fLastBlock;       // Current block is flagged as last (EVIO 4)
+  UInt_t  fReadAheadDepth;  // Read-ahead settings for fallback
+  size_t  fReadAheadBytes;
+  std::unique_ptr<THaCodaFile> fFallback; //! File reader for unmappable files
+
+  ClassDef(CodaMmapFile,0)  // Memory-mapped file of CODA data
+
+};
+
+} // namespace Decoder
+
+#endif
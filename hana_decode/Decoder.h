@@ -16,6 +16,7 @@ namespace Decoder {
   class THaUsrstrutils;
   class THaCodaData;
   class THaCodaFile;
+  class CodaMmapFile;
   class THaEtClient;
   class CodaDecoder;
   class Lecroy1875Module;
@@ -0,0 +1,190 @@
+/////////////////////////////////////////////////////////////////////
+//
+//   EvtBufferRing
+//
+//   Bounded ring of event buffers filled ahead of time by a
+//   background thread. See header for details.
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "EvtBufferRing.h"
+#include <cassert>
+#include <utility>
+#include <algorithm>
+
+using namespace std;
+
+namespace Decoder {
+
+//_____________________________________________________________________________
+EvtBufferRing::EvtBufferRing( UInt_t depth, size_t max_bytes )
+  : fDepth{std::max(depth, 1U)}
+  , fMaxBytes{max_bytes}
+  , fHead{0}
+  , fCount{0}
+  , fBytes{0}
+  , fCurrent{-1}
+  , fLastStatus{0}
+  , fDone{false}
+  , fStop{false}
+{}
+
+//_____________________________________________________________________________
+EvtBufferRing::~EvtBufferRing()
+{
+  Stop();
+}
+
+//_____________________________________________________________________________
+void EvtBufferRing::Start( FillFunc_t fill )
+{
+  // Start the read-ahead thread. 'fill' is called repeatedly on that thread
+  // until it sets its 'last' argument or Stop() is called. Any previously
+  // running thread is stopped first, discarding its unread buffers.
+
+  Stop();
+  assert(fill);
+  fFill = std::move(fill);
+  fSlots.resize(fDepth);
+  fThread = thread(&EvtBufferRing::Produce, this);
+}
+
+//_____________________________________________________________________________
+void EvtBufferRing::Stop()
+{
+  // Stop the read-ahead thread, if any, and release all buffers.
+  // If the thread is busy in the fill function, wait for it to return.
+
+  {
+    lock_guard<mutex> lock(fMutex);
+    fStop = true;
+  }
+  fCanFill.notify_all();
+  if( fThread.joinable() )
+    fThread.join();
+
+  fSlots.clear();
+  fFill = nullptr;
+  fHead = fCount = 0;
+  fBytes = 0;
+  fCurrent = -1;
+  fLastStatus = 0;
+  fDone = fStop = false;
+  fError = nullptr;
+}
+
+//_____________________________________________________________________________
+void EvtBufferRing::Produce()
+{
+  // Read-ahead thread main loop
+
+  const auto depth = static_cast<UInt_t>(fSlots.size());
+  try {
+    while( true ) {
+      UInt_t idx = 0;
+      {
+        unique_lock<mutex> lock(fMutex);
+        fCanFill.wait(lock, [this, depth] {
+          if( fStop )
+            return true;
+          UInt_t inuse = fCount + (fCurrent >= 0 ? 1 : 0);
+          return inuse < depth && (fCount == 0 || fBytes < fMaxBytes);
+        });
+        if( fStop )
+          return;
+        idx = (fHead + fCount) % depth;
+      }
+      // The slot at 'idx' is neither queued nor held by the consumer,
+      // so it can be filled without holding the lock
+      Slot& slot = fSlots[idx];
+      Bool_t last = false;
+      slot.status = fFill(slot.buf, last);
+      slot.bytes = slot.buf.size() * sizeof(UInt_t);
+      {
+        lock_guard<mutex> lock(fMutex);
+        ++fCount;
+        fBytes += slot.bytes;
+        if( last ) {
+          fDone = true;
+          fLastStatus = slot.status;
+        }
+      }
+      fCanRead.notify_one();
+      if( last )
+        return;
+    }
+  }
+  catch( ... ) {
+    {
+      lock_guard<mutex> lock(fMutex);
+      fError = current_exception();
+      fDone = true;
+    }
+    fCanRead.notify_one();
+  }
+}
+
+//_____________________________________________________________________________
+Int_t EvtBufferRing::Next()
+{
+  // Release the current buffer and make the next filled buffer current.
+  // Blocks until a buffer is available. Once the final buffer has been
+  // consumed, returns the final status on every subsequent call.
+  // Exceptions thrown by the fill function are rethrown here, after all
+  // buffers filled before the exception have been delivered.
+
+  assert(IsRunning() || fDone);
+  unique_lock<mutex> lock(fMutex);
+  if( fCurrent >= 0 ) {
+    fBytes -= fSlots[fCurrent].bytes;
+    fCurrent = -1;
+    fCanFill.notify_one();
+  }
+  fCanRead.wait(lock, [this] { return fCount > 0 || fDone; });
+  if( fCount == 0 ) {
+    if( fError )
+      rethrow_exception(fError);
+    return fLastStatus;
+  }
+  fCurrent = static_cast<Int_t>(fHead);
+  fHead = (fHead + 1) % fSlots.size();
+  --fCount;
+  return fSlots[fCurrent].status;
+}
+
+//_____________________________________________________________________________
+const UInt_t* EvtBufferRing::GetBuffer() const
+{
+  // Current event buffer. Valid until the next call to Next() or Stop().
+
+  assert(fCurrent >= 0);
+  return fSlots[fCurrent].buf.get();
+}
+
+//_____________________________________________________________________________
+UInt_t* EvtBufferRing::GetBuffer()
+{
+  assert(fCurrent >= 0);
+  return fSlots[fCurrent].buf.get();
+}
+
+//_____________________________________________________________________________
+UInt_t EvtBufferRing::GetBuffSize() const
+{
+  assert(fCurrent >= 0);
+  return fSlots[fCurrent].buf.size();
+}
+
+//_____________________________________________________________________________
+void EvtBufferRing::SetDepth( UInt_t depth )
+{
+  fDepth = std::max(depth, 1U);
+}
+
+//_____________________________________________________________________________
+void EvtBufferRing::SetMaxBytes( size_t max_bytes )
+{
+  fMaxBytes = max_bytes;
+}
+
+} // namespace Decoder
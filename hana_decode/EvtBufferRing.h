@@ -0,0 +1,97 @@
+#ifndef Podd_EvtBufferRing_h_
+#define Podd_EvtBufferRing_h_
+
+/////////////////////////////////////////////////////////////////////
+//
+//   EvtBufferRing
+//
+//   Bounded ring of event buffers filled ahead of time by a
+//   background thread. The buffers are handed to the consumer in
+//   the order in which they were filled, without copying.
+//
+//   The producer is a user-supplied function that fills one
+//   EvtBuffer per call and returns a status code. It sets its
+//   'last' argument to true when no more data will follow (EOF,
+//   fatal error). The status codes are passed through unchanged;
+//   their meaning is up to the caller.
+//
+//   Read-ahead is limited both by the number of slots ("depth")
+//   and by the total memory held by filled buffers. At least one
+//   event is always allowed in the ring, so very large events
+//   cannot deadlock the reader.
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "THaCodaData.h"   // for EvtBuffer
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+namespace Decoder {
+
+class EvtBufferRing {
+public:
+  using FillFunc_t = std::function<Int_t( EvtBuffer& buf, Bool_t& last )>;
+
+  explicit EvtBufferRing( UInt_t depth = kDefaultDepth,
+                          size_t max_bytes = kDefaultMaxBytes );
+  EvtBufferRing( const EvtBufferRing& ) = delete;
+  EvtBufferRing& operator=( const EvtBufferRing& ) = delete;
+  ~EvtBufferRing();
+
+  // Start/stop the read-ahead thread. Stop() discards unread buffers.
+  void          Start( FillFunc_t fill );
+  void          Stop();
+  Bool_t        IsRunning() const { return fThread.joinable(); }
+
+  // Advance to the next filled buffer, blocking if necessary.
+  // Returns the status reported by the fill function for that buffer.
+  // The previous buffer is released and may be refilled.
+  Int_t         Next();
+  Bool_t        HasBuffer() const { return fCurrent >= 0; }
+  const UInt_t* GetBuffer() const;
+  UInt_t*       GetBuffer();
+  UInt_t        GetBuffSize() const;
+
+  // Configuration. Takes effect at the next Start().
+  void          SetDepth( UInt_t depth );
+  void          SetMaxBytes( size_t max_bytes );
+  UInt_t        GetDepth()    const { return fDepth; }
+  size_t        GetMaxBytes() const { return fMaxBytes; }
+
+  static constexpr UInt_t kDefaultDepth    = 16;
+  static constexpr size_t kDefaultMaxBytes = 64ULL << 20;  // 64 MiB
+
+private:
+  struct Slot {
+    EvtBuffer buf;
+    Int_t     status{0};
+    size_t    bytes{0};
+  };
+
+  void Produce();
+
+  std::vector<Slot>       fSlots;     // Ring storage
+  UInt_t                  fDepth;     // Maximum number of slots
+  size_t                  fMaxBytes;  // Soft limit for memory held by slots
+  FillFunc_t              fFill;      // Producer function
+  std::thread             fThread;    // Read-ahead thread
+  mutable std::mutex      fMutex;
+  std::condition_variable fCanFill;   // Signaled when a slot was released
+  std::condition_variable fCanRead;   // Signaled when a slot was filled
+  UInt_t                  fHead;      // Index of oldest unread slot
+  UInt_t                  fCount;     // Number of filled, unread slots
+  size_t                  fBytes;     // Memory held by filled + current slots
+  Int_t                   fCurrent;   // Slot held by consumer (-1 = none)
+  Int_t                   fLastStatus;// Status of final buffer
+  Bool_t                  fDone;      // Producer has delivered its last buffer
+  Bool_t                  fStop;      // Stop requested
+  std::exception_ptr      fError;     // Exception thrown by producer
+};
+
+} // namespace Decoder
+
+#endif
@@ -53,11 +53,11 @@
 #include "Module.h"       // for Module
 #include "THaSlotData.h"  // for THaSlotData
 #include "TString.h"      // for TString
+#include <algorithm>      // for copy_n, max, min
 #include <cassert>        // for assert
 #include <fstream>        // for basic_ofstream
 #include <iostream>       // for basic_ostream, operator<<, char_traits, endl
 #include <map>            // for map, operator!=, operator==
-#include <numeric>        // for accumulate
 #include <sstream>        // for basic_ostringstream
 #include <stdexcept>      // for logic_error, overflow_error
 #include <string>         // for basic_string, string
@@ -71,6 +71,12 @@ using namespace std;
 #include <fstream>
 #endif
 
+#if (defined(__x86_64__) || defined(__i386__)) && \
+  (defined(__GNUC__) || defined(__clang__))
+#define FADC_HAVE_AVX2
+#include <immintrin.h>
+#endif
+
 namespace Decoder {
 
 using vsiz_t = vector<int>::size_type;
@@ -78,11 +84,117 @@ using vsiz_t = vector<int>::size_type;
 Module::TypeIter_t Fadc250Module::fgThisType =
   DoRegister(ModuleType("Decoder::Fadc250Module", 250));
 
+//_____________________________________________________________________________
+// Unpacking of window raw data words. Each word holds two 13-bit samples
+// (12-bit value plus overflow bit), each with a "not valid" flag. Invalid
+// samples are stored as zero.
+namespace {
+
+struct WindowStats {
+  uint32_t sum;      // Sum of samples
+  uint32_t peak;     // Largest sample without overflow bit
+  uint32_t bits;     // OR of all samples
+  bool     invalid;  // Any sample flagged as not valid
+};
+
+// Unpack 'n' words from 'in' into 2*n samples at 'out'
+using UnpackFunc_t = void (*)( const UInt_t* in, size_t n, uint32_t* out,
+                               WindowStats& st );
+
+//_____________________________________________________________________________
+void UnpackWindowScalar( const UInt_t* in, size_t n, uint32_t* out,
+                         WindowStats& st )
+{
+  for( size_t i = 0; i < n; ++i ) {
+    uint32_t w = in[i];
+    uint32_t s1 = (w & (1U << 29)) ? 0 : (w >> 16) & 0x1FFF;
+    uint32_t s2 = (w & (1U << 13)) ? 0 : w & 0x1FFF;
+    out[2 * i] = s1;
+    out[2 * i + 1] = s2;
+    st.sum += s1 + s2;
+    st.peak = std::max({ st.peak, s1 & 0xFFF, s2 & 0xFFF });
+    st.bits |= s1 | s2;
+    st.invalid |= ((w >> 29) | (w >> 13)) & 1;
+  }
+}
+
+#ifdef FADC_HAVE_AVX2
+//_____________________________________________________________________________
+__attribute__((target("avx2")))
+void UnpackWindowAVX2( const UInt_t* in, size_t n, uint32_t* out,
+                       WindowStats& st )
+{
+  // Process 8 words (16 samples) per iteration. Swapping the 16-bit halves
+  // of each word puts the samples in output order, after which each 16-bit
+  // lane holds one sample with its "not valid" flag in bit 13.
+
+  const __m256i k1fff = _mm256_set1_epi16(0x1FFF);
+  const __m256i k2000 = _mm256_set1_epi16(0x2000);
+  const __m256i k0fff = _mm256_set1_epi16(0x0FFF);
+  const __m256i kOnes = _mm256_set1_epi16(1);
+  __m256i sum = _mm256_setzero_si256(), peak = sum, bits = sum, inv = sum;
+  size_t i = 0;
+  for( ; i + 8 <= n; i += 8 ) {
+    __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+    __m256i h = _mm256_or_si256(_mm256_slli_epi32(w, 16),
+                                _mm256_srli_epi32(w, 16));
+    __m256i bad = _mm256_cmpeq_epi16(_mm256_and_si256(h, k2000), k2000);
+    __m256i v = _mm256_andnot_si256(bad, _mm256_and_si256(h, k1fff));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i),
+                        _mm256_cvtepu16_epi32(_mm256_castsi256_si128(v)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i + 8),
+                        _mm256_cvtepu16_epi32(_mm256_extracti128_si256(v, 1)));
+    sum = _mm256_add_epi32(sum, _mm256_madd_epi16(v, kOnes));
+    peak = _mm256_max_epu16(peak, _mm256_and_si256(v, k0fff));
+    bits = _mm256_or_si256(bits, v);
+    inv = _mm256_or_si256(inv, bad);
+  }
+  alignas(32) uint32_t s32[8];
+  alignas(32) uint16_t p16[16], b16[16];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(s32), sum);
+  _mm256_store_si256(reinterpret_cast<__m256i*>(p16), peak);
+  _mm256_store_si256(reinterpret_cast<__m256i*>(b16), bits);
+  for( auto x : s32 )
+    st.sum += x;
+  for( size_t k = 0; k < 16; ++k ) {
+    st.peak = std::max<uint32_t>(st.peak, p16[k]);
+    st.bits |= b16[k];
+  }
+  st.invalid |= !_mm256_testz_si256(inv, inv);
+
+  UnpackWindowScalar(in + i, n - i, out + 2 * i, st);
+}
+#endif
+
+//_____________________________________________________________________________
+UnpackFunc_t SelectUnpackWindow()
+{
+#ifdef FADC_HAVE_AVX2
+  __builtin_cpu_init();
+  if( __builtin_cpu_supports("avx2") )
+    return UnpackWindowAVX2;
+#endif
+  return UnpackWindowScalar;
+}
+
+//_____________________________________________________________________________
+void UnpackWindow( const UInt_t* in, size_t n, uint32_t* out, WindowStats& st )
+{
+  // The kernel is selected on first use, not during static initialization
+  static const UnpackFunc_t unpack = SelectUnpackWindow();
+  unpack(in, n, out, st);
+}
+
+} // namespace
+
 //_____________________________________________________________________________
 Fadc250Module::Fadc250Module( UInt_t crate, UInt_t slot )
   : PipeliningModule(crate, slot)
   , fadc_data{}
-  , fPulseData(NADCCHAN)
+  , fArenaUsed(0)
+  , fPulseData{}
+  , fSampleSummary{}
+  , fNPedSamples(4)
   , data_type_4(false)
   , data_type_6(false)
   , data_type_7(false)
@@ -121,30 +233,80 @@ Bool_t Fadc250Module::HasCapability( Decoder::EModuleType type )
 inline
 void Fadc250Module::ClearDataVectors()
 {
-  // Clear all data objects
-  assert(fPulseData.size() == NADCCHAN);  // Initialization error in constructor
-  for( uint32_t i = 0; i < NADCCHAN; i++ ) {
-    fPulseData[i].clear();
+  // Clear all data objects. Keeps the memory of fArena for the next event.
+  fArenaUsed = 0;
+  memset(fPulseData.data(), 0, sizeof(fPulseData));
+  memset(fSampleSummary.data(), 0, sizeof(fSampleSummary));
+}
+
+//_____________________________________________________________________________
+// Data of type 'item' for channel 'chan'
+inline
+span<const uint32_t> Fadc250Module::Items( UInt_t chan, EItem item ) const
+{
+  assert(chan < NADCCHAN);
+  const auto& sp = fPulseData[chan][static_cast<size_t>(item)];
+  return { fArena.data() + sp.off, sp.len };
+}
+
+//_____________________________________________________________________________
+// Ensure that there is space for at least 'n' more elements in span 'sp'.
+// Returns pointer to the first free element.
+uint32_t* Fadc250Module::Reserve( ArenaSpan& sp, size_t n )
+{
+  // Minimum space to reserve for a span. Enough for the maximum number of
+  // pulses per channel reported by the FADC250 firmware.
+  static constexpr size_t kMinCap = 4;
+
+  if( sp.len + n > sp.cap ) {
+    size_t cap = std::max({ size_t(2) * sp.cap, sp.len + n, kMinCap });
+    if( cap > kMaxUInt )
+      throw overflow_error("ERROR! Fadc250Module::Reserve: "
+                           "integer overflow");
+    if( sp.cap > 0 && sp.off + sp.cap == fArenaUsed )
+      fArenaUsed = sp.off;  // Last span in the buffer: grow in place
+    if( fArenaUsed + cap > fArena.size() )
+      fArena.resize(std::max(2 * fArena.size(), fArenaUsed + cap));
+    // Otherwise, move the data to the end of the buffer
+    if( sp.off != fArenaUsed )
+      copy_n(fArena.begin() + sp.off, sp.len, fArena.begin() + fArenaUsed);
+    sp.off = fArenaUsed;
+    sp.cap = cap;
+    fArenaUsed += cap;
   }
+  return fArena.data() + sp.off + sp.len;
 }
 
 //_____________________________________________________________________________
 // Require that slot from base class and slot from
-//   data match before populating data vectors
+//   data match before populating data for the current channel
 inline
-void Fadc250Module::PopulateDataVector( vector<uint32_t>& data_vector,
-                                        uint32_t data ) const
+void Fadc250Module::PopulateData( EItem item, uint32_t data )
 {
-  if( slots_match )
-    data_vector.push_back(data);
+  if( slots_match ) {
+    auto& sp = fPulseData[fadc_data.chan][static_cast<size_t>(item)];
+    *Reserve(sp, 1) = data;
+    ++sp.len;
+  }
 }
 
 //_____________________________________________________________________________
-// Sum elements contained in data vector
+// Store a raw sample for the current channel and update the channel's
+// sample summary
 inline
-uint32_t Fadc250Module::SumVectorElements( const vector<uint32_t>& data_vector )
+void Fadc250Module::StoreSample( uint32_t sample )
 {
-  return accumulate(data_vector.begin(), data_vector.end(), 0U);
+  if( slots_match ) {
+    auto& sp = fPulseData[fadc_data.chan][static_cast<size_t>(EItem::kSamples)];
+    auto& summary = fSampleSummary[fadc_data.chan];
+    if( sp.len < fNPedSamples )
+      summary.pedsum += sample;
+    summary.sum += sample;
+    summary.peak = std::max(summary.peak, sample & 0xFFF);
+    summary.overflow |= (sample >> 12) & 0x1;
+    *Reserve(sp, 1) = sample;
+    ++sp.len;
+  }
 }
 
 //_____________________________________________________________________________
@@ -188,28 +350,28 @@ UInt_t Fadc250Module::GetNumEvents( EModuleType emode, UInt_t chan ) const
   vsiz_t ret = 0;
   switch( emode ) {
     case kSampleADC:
-      ret = fPulseData[chan].samples.size();
+      ret = Items(chan, EItem::kSamples).size();
       break;
     case kPulseIntegral:
-      ret = fPulseData[chan].integral.size();
+      ret = Items(chan, EItem::kIntegral).size();
       break;
     case kPulseTime:
-      ret = fPulseData[chan].time.size();
+      ret = Items(chan, EItem::kTime).size();
       break;
     case kPulsePeak:
-      ret = fPulseData[chan].peak.size();
+      ret = Items(chan, EItem::kPeak).size();
       break;
     case kPulsePedestal:
       if( fFirmwareVers >= 2 )
-        ret = fPulseData[chan].pedestal.size();
+        ret = Items(chan, EItem::kPedestal).size();
       else
-        ret = fPulseData[chan].integral.size();
+        ret = Items(chan, EItem::kIntegral).size();
       break;
     case kCoarseTime:
-      ret = fPulseData[chan].coarse_time.size();
+      ret = Items(chan, EItem::kCoarseTime).size();
       break;
     case kFineTime:
-      ret = fPulseData[chan].fine_time.size();
+      ret = Items(chan, EItem::kFineTime).size();
       break;
   }
   if( ret > kMaxUInt )
@@ -243,7 +405,7 @@ UInt_t Fadc250Module::GetData( EModuleType emode, UInt_t chan, UInt_t ievent ) c
 //_____________________________________________________________________________
 UInt_t Fadc250Module::GetPulseIntegralData( UInt_t chan, UInt_t ievent ) const
 {
-  vsiz_t nevent = fPulseData[chan].integral.size();
+  vsiz_t nevent = Items(chan, EItem::kIntegral).size();
   if( ievent >= nevent ) {
     cout << "ERROR:: Fadc250Module:: GetPulseIntegralData:: invalid event number for slot = " << fSlot << ", channel = "
          << chan << endl;
@@ -258,16 +420,16 @@ UInt_t Fadc250Module::GetPulseIntegralData( UInt_t chan, UInt_t ievent ) const
     if( fDebugFile )
       *fDebugFile << "Fadc250Module::GetPulseIntegralData channel "
                   << chan << ", event " << ievent << " = "
-                  << fPulseData[chan].integral[ievent] << endl;
+                  << Items(chan, EItem::kIntegral)[ievent] << endl;
 #endif
-    return fPulseData[chan].integral[ievent];
+    return Items(chan, EItem::kIntegral)[ievent];
   }
 }
 
 //_____________________________________________________________________________
 UInt_t Fadc250Module::GetEmulatedPulseIntegralData( UInt_t chan ) const
 {
-  vsiz_t nevent = fPulseData[chan].samples.size();
+  vsiz_t nevent = Items(chan, EItem::kSamples).size();
   if( nevent == 0 ) {
     cout << "ERROR:: Fadc250Module:: GetEmulatedPulseIntegralData:: data vector empty  for slot = " << fSlot
          << ", channel = " << chan << "\n"
@@ -277,16 +439,37 @@ UInt_t Fadc250Module::GetEmulatedPulseIntegralData( UInt_t chan ) const
 #ifdef WITH_DEBUG
     if( fDebugFile )
       *fDebugFile << "Fadc250Module::GetEmulatedPulseIntegralData channel "
-                  << chan << " = " << SumVectorElements(fPulseData[chan].samples) << endl;
+                  << chan << " = " << fSampleSummary[chan].sum << endl;
 #endif
-    return SumVectorElements(fPulseData[chan].samples);
+    return fSampleSummary[chan].sum;
   }
 }
 
+//_____________________________________________________________________________
+UInt_t Fadc250Module::GetEmulatedPedestalData( UInt_t chan ) const
+{
+  assert(chan < NADCCHAN);
+  return fSampleSummary[chan].pedsum;
+}
+
+//_____________________________________________________________________________
+UInt_t Fadc250Module::GetEmulatedPulsePeakData( UInt_t chan ) const
+{
+  assert(chan < NADCCHAN);
+  return fSampleSummary[chan].peak;
+}
+
+//_____________________________________________________________________________
+Bool_t Fadc250Module::GetSampleOverflow( UInt_t chan ) const
+{
+  assert(chan < NADCCHAN);
+  return fSampleSummary[chan].overflow;
+}
+
 //_____________________________________________________________________________
 UInt_t Fadc250Module::GetPulseTimeData( UInt_t chan, UInt_t ievent ) const
 {
-  vsiz_t nevent = fPulseData[chan].time.size();
+  vsiz_t nevent = Items(chan, EItem::kTime).size();
   if( ievent >= nevent ) {
     cout << "ERROR:: Fadc250Module:: GetPulseTimeData:: invalid event number for slot = " << fSlot << ", channel = "
          << chan << endl;
@@ -301,16 +484,16 @@ UInt_t Fadc250Module::GetPulseTimeData( UInt_t chan, UInt_t ievent ) const
     if( fDebugFile )
       *fDebugFile << "Fadc250Module::GetPulseTimeData channel "
                   << chan << ", event " << ievent << " = "
-                  << fPulseData[chan].time[ievent] << endl;
+                  << Items(chan, EItem::kTime)[ievent] << endl;
 #endif
-    return fPulseData[chan].time[ievent];
+    return Items(chan, EItem::kTime)[ievent];
   }
 }
 
 //_____________________________________________________________________________
 UInt_t Fadc250Module::GetPulseCoarseTimeData( UInt_t chan, UInt_t ievent ) const
 {
-  vsiz_t nevent = fPulseData[chan].coarse_time.size();
+  vsiz_t nevent = Items(chan, EItem::kCoarseTime).size();
   if( ievent >= nevent ) {
     cout << "ERROR:: Fadc250Module:: GetPulseCoarseTimeData:: invalid event number for slot = " << fSlot
          << ", channel = " << chan << endl;
@@ -325,16 +508,16 @@ UInt_t Fadc250Module::GetPulseCoarseTimeData( UInt_t chan, UInt_t ievent ) const
     if( fDebugFile )
       *fDebugFile << "Fadc250Module::GetPulseCoarseTimeData channel "
                   << chan << ", event " << ievent << " = "
-                  << fPulseData[chan].coarse_time[ievent] << endl;
+                  << Items(chan, EItem::kCoarseTime)[ievent] << endl;
 #endif
-    return fPulseData[chan].coarse_time[ievent];
+    return Items(chan, EItem::kCoarseTime)[ievent];
   }
 }
 
 //_____________________________________________________________________________
 UInt_t Fadc250Module::GetPulseFineTimeData( UInt_t chan, UInt_t ievent ) const
 {
-  vsiz_t nevent = fPulseData[chan].fine_time.size();
+  vsiz_t nevent = Items(chan, EItem::kFineTime).size();
   if( ievent >= nevent ) {
     cout << "ERROR:: Fadc250Module:: GetPulseCoarseTimeData:: invalid event number for slot = " << fSlot
          << ", channel = " << chan << endl;
@@ -349,16 +532,16 @@ UInt_t Fadc250Module::GetPulseFineTimeData( UInt_t chan, UInt_t ievent ) const
     if( fDebugFile )
       *fDebugFile << "Fadc250Module::GetPulseFineTimeData channel "
                   << chan << ", event " << ievent << " = "
-                  << fPulseData[chan].fine_time[ievent] << endl;
+                  << Items(chan, EItem::kFineTime)[ievent] << endl;
 #endif
-    return fPulseData[chan].fine_time[ievent];
+    return Items(chan, EItem::kFineTime)[ievent];
   }
 }
 
 //_____________________________________________________________________________
 UInt_t Fadc250Module::GetPulsePeakData( UInt_t chan, UInt_t ievent ) const
 {
-  vsiz_t nevent = fPulseData[chan].peak.size();
+  vsiz_t nevent = Items(chan, EItem::kPeak).size();
   if( ievent >= nevent ) {
     cout << "ERROR:: Fadc250Module:: GetPulsePeakData:: invalid event number for slot = " << fSlot << ", channel = "
          << chan << endl;
@@ -373,16 +556,16 @@ UInt_t Fadc250Module::GetPulsePeakData( UInt_t chan, UInt_t ievent ) const
     if( fDebugFile )
       *fDebugFile << "Fadc250Module::GetPulsePeakData channel "
                   << chan << ", event " << ievent << " = "
-                  << fPulseData[chan].peak[ievent] << endl;
+                  << Items(chan, EItem::kPeak)[ievent] << endl;
 #endif
-    return fPulseData[chan].peak[ievent];
+    return Items(chan, EItem::kPeak)[ievent];
   }
 }
 
 //_____________________________________________________________________________
 UInt_t Fadc250Module::GetPulsePedestalData( UInt_t chan, UInt_t ievent ) const
 {
-  vsiz_t nevent = fPulseData[chan].pedestal.size();
+  vsiz_t nevent = Items(chan, EItem::kPedestal).size();
   if( nevent == 0 ) {
     cout << "ERROR:: Fadc250Module:: GetPulsePedestalData:: data vector empty for slot = " << fSlot << ", channel = "
          << chan << endl;
@@ -398,9 +581,9 @@ UInt_t Fadc250Module::GetPulsePedestalData( UInt_t chan, UInt_t ievent ) const
       if( fDebugFile )
         *fDebugFile << "Fadc250Module::GetPulsePedestalData channel "
                     << chan << ", event " << ievent << " = "
-                    << fPulseData[chan].pedestal[ievent] << endl;
+                    << Items(chan, EItem::kPedestal)[ievent] << endl;
 #endif
-      return fPulseData[chan].pedestal[ievent];
+      return Items(chan, EItem::kPedestal)[ievent];
     }
   }
   if( nevent != 1 ) {
@@ -412,16 +595,16 @@ UInt_t Fadc250Module::GetPulsePedestalData( UInt_t chan, UInt_t ievent ) const
     if( fDebugFile )
       *fDebugFile << "Fadc250Module::GetPulsePedestalData channel "
                   << chan << ", event " << ievent << " = "
-                  << fPulseData[chan].pedestal[0] << endl;
+                  << Items(chan, EItem::kPedestal)[0] << endl;
 #endif
-    return fPulseData[chan].pedestal[0];
+    return Items(chan, EItem::kPedestal)[0];
   }
 }
 
 //_____________________________________________________________________________
 UInt_t Fadc250Module::GetPedestalQuality( UInt_t chan, UInt_t ievent ) const
 {
-  vsiz_t nevent = fPulseData[chan].pedestal_quality.size();
+  vsiz_t nevent = Items(chan, EItem::kPedestalQuality).size();
   if( nevent == 0 ) {
     cout << "ERROR:: Fadc250Module:: GetPedestalQuality:: data vector empty for slot = "
          << fSlot << ", channel = " << chan << endl;
@@ -437,9 +620,9 @@ UInt_t Fadc250Module::GetPedestalQuality( UInt_t chan, UInt_t ievent ) const
       if( fDebugFile )
         *fDebugFile << "Fadc250Module::GetPulsePedestalQuality channel "
                     << chan << ", event " << ievent << " = "
-                    << fPulseData[chan].pedestal_quality[ievent] << endl;
+                    << Items(chan, EItem::kPedestalQuality)[ievent] << endl;
 #endif
-      return fPulseData[chan].pedestal_quality[ievent];
+      return Items(chan, EItem::kPedestalQuality)[ievent];
     }
   }
   if( nevent != 1 ) {
@@ -451,16 +634,16 @@ UInt_t Fadc250Module::GetPedestalQuality( UInt_t chan, UInt_t ievent ) const
     if( fDebugFile )
       *fDebugFile << "Fadc250Module::GetPedestalQuality channel "
                   << chan << ", event " << ievent << " = "
-                  << fPulseData[chan].pedestal_quality[0] << endl;
+                  << Items(chan, EItem::kPedestalQuality)[0] << endl;
 #endif
-    return fPulseData[chan].pedestal_quality[0];
+    return Items(chan, EItem::kPedestalQuality)[0];
   }
 }
 
 //_____________________________________________________________________________
 UInt_t Fadc250Module::GetOverflowBit( UInt_t chan, UInt_t ievent ) const
 {
-  vsiz_t nevent = fPulseData[chan].overflow.size();
+  vsiz_t nevent = Items(chan, EItem::kOverflow).size();
   if( ievent >= nevent ) {
     cout << "ERROR:: Fadc250Module:: GetOverflowBit:: invalid event number for slot = " << fSlot << ", channel = "
          << chan << endl;
@@ -475,16 +658,16 @@ UInt_t Fadc250Module::GetOverflowBit( UInt_t chan, UInt_t ievent ) const
     if( fDebugFile )
       *fDebugFile << "Fadc250Module::GetOverflowBit channel "
                   << chan << ", event " << ievent << " = "
-                  << fPulseData[chan].overflow[ievent] << endl;
+                  << Items(chan, EItem::kOverflow)[ievent] << endl;
 #endif
-    return fPulseData[chan].overflow[ievent];
+    return Items(chan, EItem::kOverflow)[ievent];
   }
 }
 
 //_____________________________________________________________________________
 UInt_t Fadc250Module::GetUnderflowBit( UInt_t chan, UInt_t ievent ) const
 {
-  vsiz_t nevent = fPulseData[chan].underflow.size();
+  vsiz_t nevent = Items(chan, EItem::kUnderflow).size();
   if( ievent >= nevent ) {
     cout << "ERROR:: Fadc250Module:: GetUnderflowBit:: invalid event number for slot = " << fSlot << ", channel = "
          << chan << endl;
@@ -499,9 +682,9 @@ UInt_t Fadc250Module::GetUnderflowBit( UInt_t chan, UInt_t ievent ) const
     if( fDebugFile )
       *fDebugFile << "Fadc250Module::GetUnderflowBit channel "
                   << chan << ", event " << ievent << " = "
-                  << fPulseData[chan].underflow[ievent] << endl;
+                  << Items(chan, EItem::kUnderflow)[ievent] << endl;
 #endif
-    return fPulseData[chan].underflow[ievent];
+    return Items(chan, EItem::kUnderflow)[ievent];
   }
 }
 
@@ -521,7 +704,7 @@ UInt_t Fadc250Module::GetTriggerTime() const
 //_____________________________________________________________________________
 UInt_t Fadc250Module::GetPulseSamplesData( UInt_t chan, UInt_t ievent ) const
 {
-  vsiz_t nevent = fPulseData[chan].samples.size();
+  vsiz_t nevent = Items(chan, EItem::kSamples).size();
   if( ievent >= nevent ) {
     cout << "ERROR:: Fadc250Module:: GetPulseSamplesData:: invalid event number for slot = " << fSlot << ", channel = "
          << chan << endl;
@@ -536,16 +719,16 @@ UInt_t Fadc250Module::GetPulseSamplesData( UInt_t chan, UInt_t ievent ) const
     if( fDebugFile )
       *fDebugFile << "Fadc250Module::GetPulseSamplesData channel "
                   << chan << ", event " << ievent << " = "
-                  << fPulseData[chan].samples[ievent] << endl;
+                  << Items(chan, EItem::kSamples)[ievent] << endl;
 #endif
-    return fPulseData[chan].samples[ievent];
+    return Items(chan, EItem::kSamples)[ievent];
   }
 }
 
 //_____________________________________________________________________________
 vector<uint32_t> Fadc250Module::GetPulseSamplesVector( UInt_t chan ) const
 {
-  vsiz_t nevent = fPulseData[chan].samples.size();
+  vsiz_t nevent = Items(chan, EItem::kSamples).size();
   if( nevent == 0 ) {
     cout << "ERROR:: Fadc250Module:: GetPulseSamplesVector:: data vector empty for slot = " << fSlot << ", channel = "
          << chan << endl;
@@ -554,12 +737,60 @@ vector<uint32_t> Fadc250Module::GetPulseSamplesVector( UInt_t chan ) const
 #ifdef WITH_DEBUG
     if( fDebugFile )
       *fDebugFile << "Fadc250Module::GetPulseSamplesVector channel "
-                  << chan << " = " << &fPulseData[chan].samples << endl;
+                  << chan << " = " << Items(chan, EItem::kSamples).data() << endl;
 #endif
-    return fPulseData[chan].samples;
+    auto samples = Items(chan, EItem::kSamples);
+    return { samples.begin(), samples.end() };
   }
 }
 
+//_____________________________________________________________________________
+span<const uint32_t> Fadc250Module::GetPulseData( EModuleType emode,
+                                                  UInt_t chan ) const
+{
+  switch( emode ) {
+    case kSampleADC:
+      return Items(chan, EItem::kSamples);
+    case kPulseIntegral:
+      return Items(chan, EItem::kIntegral);
+    case kPulseTime:
+      return Items(chan, EItem::kTime);
+    case kPulsePeak:
+      return Items(chan, EItem::kPeak);
+    case kPulsePedestal:
+      return Items(chan, EItem::kPedestal);
+    case kCoarseTime:
+      return Items(chan, EItem::kCoarseTime);
+    case kFineTime:
+      return Items(chan, EItem::kFineTime);
+  }
+  return {};
+}
+
+//_____________________________________________________________________________
+span<const uint32_t> Fadc250Module::GetPulseSamples( UInt_t chan ) const
+{
+  return Items(chan, EItem::kSamples);
+}
+
+//_____________________________________________________________________________
+span<const uint32_t> Fadc250Module::GetPedestalQualities( UInt_t chan ) const
+{
+  return Items(chan, EItem::kPedestalQuality);
+}
+
+//_____________________________________________________________________________
+span<const uint32_t> Fadc250Module::GetOverflowBits( UInt_t chan ) const
+{
+  return Items(chan, EItem::kOverflow);
+}
+
+//_____________________________________________________________________________
+span<const uint32_t> Fadc250Module::GetUnderflowBits( UInt_t chan ) const
+{
+  return Items(chan, EItem::kUnderflow);
+}
+
 //_____________________________________________________________________________
 void Fadc250Module::PrintDataType() const
 {
@@ -617,38 +848,38 @@ UInt_t Fadc250Module::GetNumFadcEvents( UInt_t chan ) const
   // For some "old" firmware version
   if( fFirmwareVers == 1 ) {
     if( mode == 7 &&
-        (sz = fPulseData[chan].integral.size()) == fPulseData[chan].time.size() )
+        (sz = Items(chan, EItem::kIntegral).size()) == Items(chan, EItem::kTime).size() )
       return sz;
     if( mode == 8 )
-      return fPulseData[chan].samples.size();
+      return Items(chan, EItem::kSamples).size();
   }
   // The rest for "modern" firmware
   if( mode == 1 )
     return 1;
   if(
     (mode == 7 &&
-     ((sz = fPulseData[chan].integral.size()) == fPulseData[chan].time.size()) &&
-     (fPulseData[chan].pedestal.size() == sz) &&
-     (fPulseData[chan].peak.size() == sz)) ||
+     ((sz = Items(chan, EItem::kIntegral).size()) == Items(chan, EItem::kTime).size()) &&
+     (Items(chan, EItem::kPedestal).size() == sz) &&
+     (Items(chan, EItem::kPeak).size() == sz)) ||
     (mode == 8 &&
-     (sz = fPulseData[chan].time.size()) == fPulseData[chan].pedestal.size() &&
-     fPulseData[chan].peak.size() == sz) ||
+     (sz = Items(chan, EItem::kTime).size()) == Items(chan, EItem::kPedestal).size() &&
+     Items(chan, EItem::kPeak).size() == sz) ||
     (mode == 9 && fFirmwareVers >= 2 &&
-     (sz = fPulseData[chan].integral.size()) == fPulseData[chan].time.size() &&
-     fPulseData[chan].pedestal.size() == sz &&
-     fPulseData[chan].peak.size() == sz) ||
+     (sz = Items(chan, EItem::kIntegral).size()) == Items(chan, EItem::kTime).size() &&
+     Items(chan, EItem::kPedestal).size() == sz &&
+     Items(chan, EItem::kPeak).size() == sz) ||
     (mode == 10 && fFirmwareVers >= 2 &&
-     (sz = fPulseData[chan].integral.size()) == fPulseData[chan].time.size() &&
-     fPulseData[chan].pedestal.size() == sz &&
-     fPulseData[chan].peak.size() == sz) ||
+     (sz = Items(chan, EItem::kIntegral).size()) == Items(chan, EItem::kTime).size() &&
+     Items(chan, EItem::kPedestal).size() == sz &&
+     Items(chan, EItem::kPeak).size() == sz) ||
     (mode == 9 &&
-     (sz = fPulseData[chan].integral.size()) == fPulseData[chan].time.size() &&
-     fPulseData[chan].pedestal.size() <= 1 &&
-     fPulseData[chan].peak.size() == sz) ||
+     (sz = Items(chan, EItem::kIntegral).size()) == Items(chan, EItem::kTime).size() &&
+     Items(chan, EItem::kPedestal).size() <= 1 &&
+     Items(chan, EItem::kPeak).size() == sz) ||
     (mode == 10 &&
-     (sz = fPulseData[chan].integral.size()) == fPulseData[chan].time.size() &&
-     fPulseData[chan].pedestal.size() <= 1 &&
-     fPulseData[chan].peak.size() == sz)
+     (sz = Items(chan, EItem::kIntegral).size()) == Items(chan, EItem::kTime).size() &&
+     Items(chan, EItem::kPedestal).size() <= 1 &&
+     Items(chan, EItem::kPeak).size() == sz)
     ) {
 #ifdef WITH_DEBUG
     if( fDebugFile )
@@ -671,7 +902,7 @@ UInt_t Fadc250Module::GetNumFadcSamples( UInt_t chan, UInt_t ievent ) const
 {
   Int_t mode = GetFadcMode();
   if( (mode == 1) || (mode == 8) || (mode == 10) ) {
-    vsiz_t nsamples = fPulseData[chan].samples.size();
+    vsiz_t nsamples = Items(chan, EItem::kSamples).size();
     if( ievent >= nsamples ) {
       cout << "ERROR:: Fadc250Module:: GetNumFadcSamples:: invalid event number for slot = " << fSlot << ", channel = "
            << chan << endl;
@@ -685,9 +916,9 @@ UInt_t Fadc250Module::GetNumFadcSamples( UInt_t chan, UInt_t ievent ) const
     if( fDebugFile )
       *fDebugFile << "Fadc250Module::GetNumFadcSamples channel "
           << chan << ", event " << ievent << " = "
-          << fPulseData[chan].samples.size() << endl;
+          << Items(chan, EItem::kSamples).size() << endl;
 #endif
-    return fPulseData[chan].samples.size();
+    return Items(chan, EItem::kSamples).size();
   }
   cout << "ERROR:: Fadc250Module:: GetNumFadcSamples:: FADC is not in Mode 1, "
        << "8, or 10 for slot = " << fSlot << ", channel = " << chan << endl;
@@ -817,6 +1048,10 @@ void Fadc250Module::DecodeWindowRawData( UInt_t pdat, uint32_t data_type_id )
   if( data_type_id == 1 ) {
     fadc_data.chan = (pdat >> 23) & 0xF;        // FADC channel number
     fadc_data.win_width = (pdat >> 0) & 0xFFF;  // Window width
+    // Reserve space for the expected number of samples
+    if( slots_match )
+      Reserve(fPulseData[fadc_data.chan][static_cast<size_t>(EItem::kSamples)],
+              fadc_data.win_width);
     // Debug output
 #ifdef WITH_DEBUG
     if( fDebugFile )
@@ -835,15 +1070,15 @@ void Fadc250Module::DecodeWindowRawData( UInt_t pdat, uint32_t data_type_id )
     if( !invalid_1 ) sample_1 = (pdat >> 16) & 0x1FFF;  // If sample x is valid, assign value
     if( !invalid_2 ) sample_2 = (pdat >> 0) & 0x1FFF;   // If sample x+1 is valid, assign value
 
-    PopulateDataVector(fPulseData[fadc_data.chan].samples, sample_1); // Sample 1
+    StoreSample(sample_1); // Sample 1
     fadc_data.invalid_samples |= invalid_1;                        // Invalid samples
     fadc_data.overflow = (sample_1 >> 12) & 0x1;                   // Sample 1 overflow bit
     if( invalid_2 ) { // Skip last sample if not expected and flagged as invalid
-      if( fPulseData[fadc_data.chan].samples.size() == fadc_data.win_width )
+      if( Items(fadc_data.chan, EItem::kSamples).size() == fadc_data.win_width )
         return;
     }
 
-    PopulateDataVector(fPulseData[fadc_data.chan].samples, sample_2); // Sample 2
+    StoreSample(sample_2); // Sample 2
     fadc_data.invalid_samples |= invalid_2;                        // Invalid samples
     fadc_data.overflow = (sample_2 >> 12) & 0x1;                   // Sample 2 overflow bit
     // Debug output
@@ -855,12 +1090,50 @@ void Fadc250Module::DecodeWindowRawData( UInt_t pdat, uint32_t data_type_id )
                   << " >> sample 1 = " << sample_1
                   << " >> sample 2 = " << sample_2
                   << " >> size of fPulseSamples = "
-                  << fPulseData[fadc_data.chan].samples.size()
+                  << Items(fadc_data.chan, EItem::kSamples).size()
                   << endl;
 #endif
   }  // FADC data sample for window raw data
 }
 
+//_____________________________________________________________________________
+UInt_t Fadc250Module::DecodeWindowSamples( const UInt_t* p, const UInt_t* pstop )
+{
+  // Unpack the data words following a window raw data header at once.
+  // 'p' points to the first word after the header, 'pstop' one past the end
+  // of the data. Returns the number of words processed.
+  //
+  // The window's last word is left to DecodeWindowRawData, which handles
+  // the invalid padding sample of odd-length windows.
+
+  if( !slots_match )
+    return 0;
+  const size_t nmax = (fadc_data.win_width + 1) / 2;
+  size_t n = 0;
+  while( n < nmax && p + n != pstop && (p[n] & 0x80000000) == 0 )
+    ++n;
+  if( n < 2 )
+    return 0;
+  const size_t nwords = n - 1, nsamples = 2 * nwords;
+
+  auto& sp = fPulseData[fadc_data.chan][static_cast<size_t>(EItem::kSamples)];
+  uint32_t* out = Reserve(sp, nsamples);
+  WindowStats st{};
+  UnpackWindow(p, nwords, out, st);
+
+  auto& summary = fSampleSummary[fadc_data.chan];
+  for( size_t i = sp.len; i < std::min<size_t>(fNPedSamples, sp.len + nsamples); ++i )
+    summary.pedsum += out[i - sp.len];
+  summary.sum += st.sum;
+  summary.peak = std::max(summary.peak, st.peak);
+  summary.overflow |= (st.bits >> 12) & 0x1;
+  sp.len += nsamples;
+  fadc_data.invalid_samples |= st.invalid;
+  fadc_data.overflow = (out[nsamples - 1] >> 12) & 0x1;
+
+  return nwords;
+}
+
 //_____________________________________________________________________________
 void Fadc250Module::DecodePulseRawData( UInt_t pdat, uint32_t data_type_id )
 {
@@ -887,15 +1160,15 @@ void Fadc250Module::DecodePulseRawData( UInt_t pdat, uint32_t data_type_id )
     if( !invalid_1 ) sample_1 = (pdat >> 16) & 0x1FFF;  // If sample x is valid, assign value
     if( !invalid_2 ) sample_2 = (pdat >> 0) & 0x1FFF;   // If sample x+1 is valid, assign value
 
-    PopulateDataVector(fPulseData[fadc_data.chan].samples, sample_1);  // Sample 1
+    StoreSample(sample_1);  // Sample 1
     fadc_data.invalid_samples |= invalid_1;                         // Invalid samples
     fadc_data.overflow = (sample_1 >> 12) & 0x1;                    // Sample 1 overflow bit
     if( invalid_2 ) { // Skip last sample if not expected and flagged as invalid
-      if( fPulseData[fadc_data.chan].samples.size() == fadc_data.win_width )
+      if( Items(fadc_data.chan, EItem::kSamples).size() == fadc_data.win_width )
         return;
     }
 
-    PopulateDataVector(fPulseData[fadc_data.chan].samples, sample_2);  // Sample 2
+    StoreSample(sample_2);  // Sample 2
     fadc_data.invalid_samples |= invalid_2;                         // Invalid samples
     fadc_data.overflow = (sample_2 >> 12) & 0x1;                    // Sample 2 overflow bit
     // Debug output
@@ -906,7 +1179,7 @@ void Fadc250Module::DecodePulseRawData( UInt_t pdat, uint32_t data_type_id )
                   << " >> sample 1 = " << sample_1
                   << " >> sample 2 = " << sample_2
                   << " >> size of fPulseSamples = "
-                  << fPulseData[fadc_data.chan].samples.size()
+                  << Items(fadc_data.chan, EItem::kSamples).size()
                   << endl;
 #endif
   }  // FADC data sample loop for pulse raw data
@@ -921,7 +1194,7 @@ void Fadc250Module::DecodePulseIntegral( UInt_t pdat )
   fadc_data.qual_factor = (pdat >> 19) & 0x3;        // FADC quality factor (0-3)
   fadc_data.pulse_integral = (pdat >> 0) & 0x7FFFF;  // FADC pulse integral
   // Store data in arrays of vectors
-  PopulateDataVector(fPulseData[fadc_data.chan].integral, fadc_data.pulse_integral);
+  PopulateData(EItem::kIntegral, fadc_data.pulse_integral);
   // Debug output
 #ifdef WITH_DEBUG
   if( fDebugFile )
@@ -946,9 +1219,9 @@ void Fadc250Module::DecodePulseTime( UInt_t pdat )
   fadc_data.fine_pulse_time = (pdat >> 0) & 0x3F;     // FADC fine time (0.0625 ns/count)
   fadc_data.time = (pdat >> 0) & 0x7FFF;              // FADC time (0.0625 ns/count, bmoffit)
   // Store data in arrays of vectors
-  PopulateDataVector(fPulseData[fadc_data.chan].coarse_time, fadc_data.coarse_pulse_time);
-  PopulateDataVector(fPulseData[fadc_data.chan].fine_time, fadc_data.fine_pulse_time);
-  PopulateDataVector(fPulseData[fadc_data.chan].time, fadc_data.time);
+  PopulateData(EItem::kCoarseTime, fadc_data.coarse_pulse_time);
+  PopulateData(EItem::kFineTime, fadc_data.fine_pulse_time);
+  PopulateData(EItem::kTime, fadc_data.time);
   // Debug output
 #ifdef WITH_DEBUG
   if( fDebugFile )
@@ -974,8 +1247,8 @@ void Fadc250Module::DecodePulseParameters( UInt_t pdat, uint32_t data_type_id )
     fadc_data.qual_factor = (pdat >> 14) & 0x1;       // Pedestal quality
     fadc_data.pedestal_sum = (pdat >> 0) & 0x3FFF;    // Pedestal sum
     // Populate data vectors
-    PopulateDataVector(fPulseData[fadc_data.chan].pedestal, fadc_data.pedestal_sum);
-    PopulateDataVector(fPulseData[fadc_data.chan].pedestal_quality, fadc_data.qual_factor);
+    PopulateData(EItem::kPedestal, fadc_data.pedestal_sum);
+    PopulateData(EItem::kPedestalQuality, fadc_data.qual_factor);
     // Debug output
 #ifdef WITH_DEBUG
     if( fDebugFile )
@@ -998,9 +1271,9 @@ void Fadc250Module::DecodePulseParameters( UInt_t pdat, uint32_t data_type_id )
       fadc_data.samp_over_thresh =
         (pdat >> 0) & 0x1FF;  // Number of samples within NSA that the pulse is above threshold
       // Populate data vectors
-      PopulateDataVector(fPulseData[fadc_data.chan].integral, fadc_data.sample_sum);
-      PopulateDataVector(fPulseData[fadc_data.chan].overflow, fadc_data.samp_overflow);
-      PopulateDataVector(fPulseData[fadc_data.chan].underflow, fadc_data.samp_underflow);
+      PopulateData(EItem::kIntegral, fadc_data.sample_sum);
+      PopulateData(EItem::kOverflow, fadc_data.samp_overflow);
+      PopulateData(EItem::kUnderflow, fadc_data.samp_underflow);
       // Debug output
 #ifdef WITH_DEBUG
       if( fDebugFile )
@@ -1026,10 +1299,10 @@ void Fadc250Module::DecodePulseParameters( UInt_t pdat, uint32_t data_type_id )
       fadc_data.peak_above_maxped =
         (pdat >> 0) & 0x1;     // 1 or more of first four samples is above either MaxPed or TET
       // Populate data vectors
-      PopulateDataVector(fPulseData[fadc_data.chan].coarse_time, fadc_data.coarse_pulse_time);
-      PopulateDataVector(fPulseData[fadc_data.chan].fine_time, fadc_data.fine_pulse_time);
-      PopulateDataVector(fPulseData[fadc_data.chan].time, fadc_data.time);
-      PopulateDataVector(fPulseData[fadc_data.chan].peak, fadc_data.pulse_peak);
+      PopulateData(EItem::kCoarseTime, fadc_data.coarse_pulse_time);
+      PopulateData(EItem::kFineTime, fadc_data.fine_pulse_time);
+      PopulateData(EItem::kTime, fadc_data.time);
+      PopulateData(EItem::kPeak, fadc_data.pulse_peak);
       // Debug output
 #ifdef WITH_DEBUG
       if( fDebugFile )
@@ -1058,8 +1331,8 @@ void Fadc250Module::DecodePulsePedestal( UInt_t pdat )
   fadc_data.pedestal = (pdat >> 12) & 0x1FF;    // FADC pulse pedestal
   fadc_data.pulse_peak = (pdat >> 0) & 0xFFF;   // FADC pulse peak
   // Store data in arrays of vectors
-  PopulateDataVector(fPulseData[fadc_data.chan].pedestal, fadc_data.pedestal);
-  PopulateDataVector(fPulseData[fadc_data.chan].peak, fadc_data.pulse_peak);
+  PopulateData(EItem::kPedestal, fadc_data.pedestal);
+  PopulateData(EItem::kPeak, fadc_data.pulse_peak);
   // Debug output
 #ifdef WITH_DEBUG
   if( fDebugFile )
@@ -1223,20 +1496,20 @@ void Fadc250Module::LoadTHaSlotDataObj( THaSlotData* sldat )
   // Load THaSlotData
   for( uint32_t chan = 0; chan < NADCCHAN; chan++ ) {
     // Pulse Integral
-    for( vsiz_t ievent = 0; ievent < fPulseData[chan].integral.size(); ievent++ )
-      sldat->loadData("adc", chan, fPulseData[chan].integral[ievent], fPulseData[chan].integral[ievent]);
+    for( vsiz_t ievent = 0; ievent < Items(chan, EItem::kIntegral).size(); ievent++ )
+      sldat->loadData("adc", chan, Items(chan, EItem::kIntegral)[ievent], Items(chan, EItem::kIntegral)[ievent]);
     // Pulse Time
-    for( vsiz_t ievent = 0; ievent < fPulseData[chan].time.size(); ievent++ )
-      sldat->loadData("adc", chan, fPulseData[chan].time[ievent], fPulseData[chan].time[ievent]);
+    for( vsiz_t ievent = 0; ievent < Items(chan, EItem::kTime).size(); ievent++ )
+      sldat->loadData("adc", chan, Items(chan, EItem::kTime)[ievent], Items(chan, EItem::kTime)[ievent]);
     // Pulse Peak
-    for( vsiz_t ievent = 0; ievent < fPulseData[chan].peak.size(); ievent++ )
-      sldat->loadData("adc", chan, fPulseData[chan].peak[ievent], fPulseData[chan].peak[ievent]);
+    for( vsiz_t ievent = 0; ievent < Items(chan, EItem::kPeak).size(); ievent++ )
+      sldat->loadData("adc", chan, Items(chan, EItem::kPeak)[ievent], Items(chan, EItem::kPeak)[ievent]);
     // Pulse Pedestal
-    for( vsiz_t ievent = 0; ievent < fPulseData[chan].pedestal.size(); ievent++ )
-      sldat->loadData("adc", chan, fPulseData[chan].pedestal[ievent], fPulseData[chan].pedestal[ievent]);
+    for( vsiz_t ievent = 0; ievent < Items(chan, EItem::kPedestal).size(); ievent++ )
+      sldat->loadData("adc", chan, Items(chan, EItem::kPedestal)[ievent], Items(chan, EItem::kPedestal)[ievent]);
     // Pulse Samples
-    for( vsiz_t ievent = 0; ievent < fPulseData[chan].samples.size(); ievent++ )
-      sldat->loadData("adc", chan, fPulseData[chan].samples[ievent], fPulseData[chan].samples[ievent]);
+    for( vsiz_t ievent = 0; ievent < Items(chan, EItem::kSamples).size(); ievent++ )
+      sldat->loadData("adc", chan, Items(chan, EItem::kSamples)[ievent], Items(chan, EItem::kSamples)[ievent]);
   }  // Channel loop
 }
 
@@ -1261,6 +1534,9 @@ UInt_t Fadc250Module::LoadSlot( THaSlotData *sldat, const UInt_t* evbuffer,
   while( p != q ) {
     if( Decode(p++) == 1 )
       break;  // block trailer found
+    // Unpack the samples of window raw data in bulk
+    if( data_type_def == 4 && (p[-1] & 0x80000000) )
+      p += DecodeWindowSamples(p, q);
   }
 
   if( sldat )
@@ -11,7 +11,9 @@
 #include "PipeliningModule.h"  // for PipeliningModule
 #include "Decoder.h"           // for EModuleType
 #include <cstdint>             // for uint32_t, uint64_t
+#include <array>               // for array
 #include <cstring>             // for memset, size_t
+#include <span>                // for span
 #include <vector>              // for vector
 namespace Decoder { class THaSlotData; }
 
@@ -33,6 +35,14 @@ namespace Decoder {
     virtual void CheckDecoderStatus() const;
     virtual UInt_t GetPulseIntegralData( UInt_t chan, UInt_t ievent ) const;
     virtual UInt_t GetEmulatedPulseIntegralData( UInt_t chan ) const;
+    // Sum of the first GetNumPedestalSamples() samples of 'chan'
+    UInt_t GetEmulatedPedestalData( UInt_t chan ) const;
+    // Largest sample of 'chan', excluding the overflow bit
+    UInt_t GetEmulatedPulsePeakData( UInt_t chan ) const;
+    // True if any sample of 'chan' has the overflow bit set
+    Bool_t GetSampleOverflow( UInt_t chan ) const;
+    void   SetNumPedestalSamples( UInt_t n ) { fNPedSamples = n; }
+    UInt_t GetNumPedestalSamples() const { return fNPedSamples; }
     virtual UInt_t GetPulseTimeData( UInt_t chan, UInt_t ievent ) const;
     virtual UInt_t GetPulseCoarseTimeData( UInt_t chan, UInt_t ievent ) const;
     virtual UInt_t GetPulseFineTimeData( UInt_t chan, UInt_t ievent ) const;
@@ -42,7 +52,16 @@ namespace Decoder {
     virtual UInt_t GetPedestalQuality( UInt_t chan, UInt_t ievent ) const;
     virtual UInt_t GetOverflowBit( UInt_t chan, UInt_t ievent ) const;
     virtual UInt_t GetUnderflowBit( UInt_t chan, UInt_t ievent ) const;
+    // Copy of GetPulseSamples(chan)
     virtual std::vector<uint32_t> GetPulseSamplesVector( UInt_t chan ) const;
+    // Views of the current event's data for channel 'chan'. They are valid
+    // until the module is cleared or the next event is decoded.
+    std::span<const uint32_t> GetPulseData( Decoder::EModuleType mtype,
+                                            UInt_t chan ) const;
+    std::span<const uint32_t> GetPulseSamples( UInt_t chan ) const;
+    std::span<const uint32_t> GetPedestalQualities( UInt_t chan ) const;
+    std::span<const uint32_t> GetOverflowBits( UInt_t chan ) const;
+    std::span<const uint32_t> GetUnderflowBits( UInt_t chan ) const;
     virtual Int_t  GetFadcMode() const;
     virtual Int_t  GetMode() const { return GetFadcMode(); };
     virtual UInt_t GetNumFadcEvents( UInt_t chan ) const;
@@ -96,24 +115,41 @@ namespace Decoder {
       void clear() { memset(this, 0, sizeof(fadc_data_struct)); }
     } __attribute__((aligned(128))) fadc_data;  // fadc_data_struct
 
-    struct fadc_pulse_data {
-      std::vector<uint32_t> integral, time, peak, pedestal;
-      std::vector<uint32_t> samples, coarse_time, fine_time;
-      std::vector<uint32_t> pedestal_quality, overflow, underflow;
-      void clear() {
-	integral.clear(); time.clear(); peak.clear(); pedestal.clear();
-	samples.clear(); coarse_time.clear(); fine_time.clear();
-	pedestal_quality.clear(); overflow.clear(); underflow.clear();
-      }
-    } __attribute__((aligned(128)));
-    std::vector<fadc_pulse_data> fPulseData; // Pulse data for each channel
+    // Per-event pulse data. The data of all channels are kept in one
+    // buffer, fArena, in which each channel/item owns a span of reserved
+    // space. A span that runs out of space is moved to the end of the
+    // buffer. Clearing only resets the fill pointer, so no memory is
+    // allocated once the buffer has grown to the typical event size.
+    enum class EItem { kIntegral, kTime, kPeak, kPedestal, kSamples,
+                       kCoarseTime, kFineTime, kPedestalQuality,
+                       kOverflow, kUnderflow, kNumItems };
+    static constexpr size_t NITEMS = static_cast<size_t>(EItem::kNumItems);
+    struct ArenaSpan {
+      uint32_t off, len, cap;  // Offset, length, reserved space in fArena
+    };
+    using ChannelSpans_t = std::array<ArenaSpan, NITEMS>;
+    std::vector<uint32_t> fArena;     // Storage for pulse data of all channels
+    size_t                fArenaUsed; // Number of used words in fArena
+    std::array<ChannelSpans_t, NADCCHAN> fPulseData; // Spans per channel/item
+
+    // Results computed while unpacking the raw samples of each channel
+    struct SampleSummary {
+      uint32_t sum;     // Sum of all samples (incl. overflow bits)
+      uint32_t pedsum;  // Sum of the first fNPedSamples samples
+      uint32_t peak;    // Largest sample (excl. overflow bit)
+      bool     overflow;// Any sample with overflow bit set
+    };
+    std::array<SampleSummary, NADCCHAN> fSampleSummary;
+    UInt_t fNPedSamples;  // Number of samples for emulated pedestal
 
     Bool_t data_type_4, data_type_6, data_type_7, data_type_8, data_type_9, data_type_10;
     Bool_t block_header_found, block_trailer_found, event_header_found, slots_match;
 
     void ClearDataVectors();
-    void PopulateDataVector( std::vector<uint32_t>& data_vector, uint32_t data ) const;
-    static uint32_t SumVectorElements( const std::vector<uint32_t>& data_vector );
+    std::span<const uint32_t> Items( UInt_t chan, EItem item ) const;
+    uint32_t* Reserve( ArenaSpan& sp, size_t n );
+    void PopulateData( EItem item, uint32_t data );
+    void StoreSample( uint32_t sample );
     void LoadTHaSlotDataObj( THaSlotData* sldat );
     void PrintDataType() const;
 
@@ -122,6 +158,7 @@ namespace Decoder {
     void DecodeEventHeader( UInt_t pdat );
     void DecodeTriggerTime( UInt_t pdat, uint32_t data_type_id );
     void DecodeWindowRawData( UInt_t pdat, uint32_t data_type_id );
+    UInt_t DecodeWindowSamples( const UInt_t* p, const UInt_t* pstop );
     void DecodePulseRawData( UInt_t pdat, uint32_t data_type_id );
     void DecodePulseIntegral( UInt_t pdat );
     void DecodePulseTime( UInt_t pdat );
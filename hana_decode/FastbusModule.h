@@ -29,6 +29,10 @@ public:
 
    virtual Int_t  Decode(const UInt_t *evbuffer);
    virtual Bool_t IsSlot(UInt_t rdata) { return (Slot(rdata)==fSlot); };
+   virtual Bool_t GetHeaderSignature( UInt_t& header, UInt_t& mask ) const {
+     if( fSlotShift >= 32 ) return false;
+     header = fSlot << fSlotShift; mask = ~0U << fSlotShift; return true;
+   };
    virtual UInt_t LoadSlot( THaSlotData *sldat, const UInt_t* evbuffer, const UInt_t *pstop);
    void DoPrint() const;
 
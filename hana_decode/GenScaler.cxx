@@ -230,6 +230,13 @@ namespace Decoder {
     }
   }
 
+  UInt_t GenScaler::GetHeaderNumChan( UInt_t rdata ) const {
+    /// Number of channels encoded in header word 'rdata'. Headers without
+    /// a channel count imply the expected number of channels.
+    UInt_t nchan = (rdata & fNumChanMask) >> fNumChanShift;
+    return (nchan != 0) ? nchan : fWordsExpect;
+  }
+
   Bool_t GenScaler::IsSlot( UInt_t rdata ) {
     /// Check if this word is the header for the slot we are looking for
     /// Get the number of channels in this module from the header and
@@ -240,7 +247,7 @@ namespace Decoder {
     // This is a header word. Try extracting the number of channels.
     fNumChan = (rdata & fNumChanMask) >> fNumChanShift;
     if( fNumChan == 0 ) {
-      fNumChan = fWordsExpect;
+      fNumChan = GetHeaderNumChan(rdata);
       if( firsttime ) {
         firsttime = false;
         cout << "Warning::GenScaler:: (" << fCrate << "," << fSlot
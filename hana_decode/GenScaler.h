@@ -30,6 +30,8 @@ namespace Decoder {
     virtual Int_t  Decode( const UInt_t* evbuffer );
     virtual UInt_t GetData( UInt_t chan ) const;   // Raw scaler counts
     virtual Bool_t IsSlot( UInt_t rdata );
+    // Number of channels announced by header word 'rdata'
+    UInt_t GetHeaderNumChan( UInt_t rdata ) const;
     virtual void   DoPrint() const;
 
     void GenInit();
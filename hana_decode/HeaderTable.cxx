@@ -0,0 +1,43 @@
+/////////////////////////////////////////////////////////////////////
+//
+//   HeaderTable
+//
+//   Data blocks of modules start with a header word that identifies
+//   the module. Instead of offering every data word to every module,
+//   the decoders look up each word in this table. Modules are grouped
+//   by header mask, and in each group the header signatures are kept
+//   sorted, so a word that belongs to no module is usually rejected by
+//   a single range comparison. Used by CodaDecoder::roc_decode and
+//   ScalerDispatch.
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "HeaderTable.h"
+
+using namespace std;
+
+namespace Decoder {
+
+//_____________________________________________________________________________
+void HeaderTable::Add( UInt_t header, UInt_t mask, UInt_t index )
+{
+  header &= mask;
+  auto git = find_if(fGroups.begin(), fGroups.end(),
+                     [mask]( const Group& g ) { return g.mask == mask; });
+  if( git == fGroups.end() ) {
+    fGroups.push_back({mask, header, header, {}});
+    git = prev(fGroups.end());
+  }
+  auto& matches = git->matches;
+  // Insert after existing entries with the same header, so that modules
+  // sharing a header are found in the order added
+  auto mit = upper_bound(matches.begin(), matches.end(), header,
+                         []( UInt_t hdr, const Match& m ) {
+                           return hdr < m.header;
+                         });
+  matches.insert(mit, {header, index});
+  git->lo = min(git->lo, header);
+  git->hi = max(git->hi, header);
+}
+
+} // namespace Decoder
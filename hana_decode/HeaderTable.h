@@ -0,0 +1,67 @@
+#ifndef Podd_HeaderTable_h_
+#define Podd_HeaderTable_h_
+
+/////////////////////////////////////////////////////////////////////
+//
+//   HeaderTable
+//   Lookup table from data words to the modules whose header word
+//   signature (see Module::GetHeaderSignature) they match.
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "Rtypes.h"
+#include <algorithm>
+#include <vector>
+
+namespace Decoder {
+
+  class HeaderTable {
+
+  public:
+
+    // Add module number 'index' with header signature 'header' under
+    // 'mask'. Modules with the same signature are found in the order added.
+    void  Add( UInt_t header, UInt_t mask, UInt_t index );
+    void  Clear() { fGroups.clear(); }
+
+    // Call f(index) for each module whose signature matches 'word' until
+    // f returns true. Returns true if it did.
+    template<typename Func>
+    bool  ForEach( UInt_t word, Func&& f ) const;
+
+  private:
+
+    struct Match {
+      UInt_t header;   // Header word signature
+      UInt_t index;    // Module number passed to Add
+      bool operator<( UInt_t hdr ) const { return header < hdr; }
+    };
+    struct Group {     // Signatures sharing the same mask
+      UInt_t mask;
+      UInt_t lo, hi;   // Range of headers in 'matches'
+      std::vector<Match> matches;  // Sorted by header, then order added
+    };
+    std::vector<Group> fGroups;
+  };
+
+  //___________________________________________________________________________
+  template<typename Func>
+  inline bool HeaderTable::ForEach( UInt_t word, Func&& f ) const
+  {
+    for( const auto& g : fGroups ) {
+      UInt_t header = word & g.mask;
+      // Most words match no signature and are rejected here
+      if( header - g.lo > g.hi - g.lo )
+        continue;
+      auto it = std::lower_bound(g.matches.begin(), g.matches.end(), header);
+      for( ; it != g.matches.end() && it->header == header; ++it ) {
+        if( f(it->index) )
+          return true;
+      }
+    }
+    return false;
+  }
+
+}
+
+#endif
@@ -48,6 +48,7 @@ namespace Decoder {
     Bool_t IsMultiBlockMode() const {return fMultiBlockMode; };
     Bool_t BlockIsDone() const { return fBlockIsDone; };
     virtual void SetFirmware(Int_t fw) {fFirmwareVers=fw;};
+    Int_t GetFirmware() const { return fFirmwareVers; };
 
     UInt_t GetBlockSize() const { return block_size; };
 
@@ -101,6 +102,13 @@ namespace Decoder {
     virtual void   Clear( Option_t* = "" );
 
     virtual Bool_t IsSlot( UInt_t rdata );
+    // Header word signature of this module: IsSlot(rdata) can only be true
+    // if (rdata & mask) == header. The decoder uses it to look up the slot
+    // for a header word directly. Returns false if not known, in which case
+    // IsSlot is tried for every data word. Classes that override IsSlot
+    // should override this method accordingly.
+    virtual Bool_t GetHeaderSignature( UInt_t& /*header*/,
+                                       UInt_t& /*mask*/ ) const { return false; }
 
     UInt_t         GetCrate() const { return fCrate; };
     UInt_t         GetSlot()  const { return fSlot; };
@@ -0,0 +1,56 @@
+/////////////////////////////////////////////////////////////////////
+//
+//   ScalerDispatch
+//
+//   Scaler events are sequences of blocks, each starting with the
+//   header word of one scaler module. Instead of offering every word
+//   to every scaler, the scaler event handlers look up each word in
+//   a HeaderTable of the scalers' header signatures.
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "ScalerDispatch.h"
+#include "GenScaler.h"
+
+using namespace std;
+
+namespace Decoder {
+
+//_____________________________________________________________________________
+void ScalerDispatch::Build( const vector<GenScaler*>& scalers )
+{
+  // Set up the lookup table from the header signatures of 'scalers'.
+  // Scalers without a known signature are not included.
+
+  fTable.Clear();
+  fScalers = scalers;
+  for( UInt_t i = 0; i < fScalers.size(); ++i ) {
+    UInt_t header = 0, mask = 0;
+    // Scalers sharing a header are tried in list order
+    if( fScalers[i] && fScalers[i]->GetHeaderSignature(header, mask) )
+      fTable.Add(header, mask, i);
+  }
+}
+
+//_____________________________________________________________________________
+UInt_t ScalerDispatch::Decode( const UInt_t* evbuffer, const UInt_t* pstop,
+                               UInt_t& idx ) const
+{
+  // Decode the scaler whose header word is evbuffer[0], if any
+
+  const UInt_t word = *evbuffer;
+  UInt_t nwords = 0;
+  fTable.ForEach(word, [&]( UInt_t i ) {
+    GenScaler* scaler = fScalers[i];
+    if( scaler->IsDecoded() || !scaler->IsSlot(word) )  // Sets fNumChan
+      return false;
+    if( evbuffer + scaler->GetNumChan() >= pstop )
+      return false;  // Data would extend past end of buffer
+    idx = i;
+    nwords = scaler->Decode(evbuffer);
+    return true;
+  });
+  return nwords;
+}
+
+} // namespace Decoder
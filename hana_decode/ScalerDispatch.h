@@ -0,0 +1,50 @@
+#ifndef Podd_ScalerDispatch_h_
+#define Podd_ScalerDispatch_h_
+
+/////////////////////////////////////////////////////////////////////
+//
+//   ScalerDispatch
+//   Lookup table from header words to the scalers that may own them,
+//   built from the scalers' header signatures. Used by the scaler
+//   event handlers to decode scaler events in a single pass.
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "Rtypes.h"
+#include "HeaderTable.h"
+#include <vector>
+
+namespace Decoder {
+
+  class GenScaler;
+
+  // Basket size of the scaler tree branches written by the scaler event
+  // handlers. Scaler events are infrequent, so small baskets would mostly
+  // hold the basket overhead.
+  constexpr Int_t kScalerBasketSize = 32000;
+
+  class ScalerDispatch {
+
+  public:
+
+    // Set up the table for 'scalers'. Must be called again whenever the
+    // scalers or their headers change.
+    void  Build( const std::vector<GenScaler*>& scalers );
+    void  Clear() { fTable.Clear(); fScalers.clear(); }
+
+    // If evbuffer[0] is the header word of a scaler in the table that has
+    // not been decoded yet, decode it, set 'idx' to its index in the list
+    // passed to Build, and return the number of words consumed (header plus
+    // data). Otherwise, return 0. 'pstop' points past the end of the data.
+    UInt_t Decode( const UInt_t* evbuffer, const UInt_t* pstop,
+                   UInt_t& idx ) const;
+
+  private:
+
+    HeaderTable             fTable;    // Indices of scalers by header
+    std::vector<GenScaler*> fScalers;
+  };
+
+}
+
+#endif
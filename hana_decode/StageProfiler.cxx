@@ -0,0 +1,482 @@
+/////////////////////////////////////////////////////////////////////
+//
+//   StageProfiler
+//
+//   Low-overhead timing of the stages of the event loop.
+//   See header for details.
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "StageProfiler.h"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <thread>
+#include <ctime>
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+# define PROFILER_HAVE_TSC
+# include <x86intrin.h>
+# include <cpuid.h>
+#endif
+
+using namespace std;
+
+namespace Podd {
+
+atomic<bool> StageProfiler::fgEnabled{false};
+
+namespace {
+
+atomic<bool>   gUseTSC{false};   // Clock source is the time stamp counter
+atomic<double> gNsPerTick{1.0};  // Calibration of clock ticks
+once_flag      gCalibrated;
+
+thread_local uint64_t tAllocCount = 0;  // Heap allocations by this thread
+
+//_____________________________________________________________________________
+uint64_t MonotonicNs()
+{
+  timespec ts{};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return uint64_t(ts.tv_sec) * 1000000000ULL + uint64_t(ts.tv_nsec);
+}
+
+//_____________________________________________________________________________
+Bool_t HaveInvariantTSC()
+{
+#ifdef PROFILER_HAVE_TSC
+  unsigned int a = 0, b = 0, c = 0, d = 0;
+  if( __get_cpuid(0x80000007, &a, &b, &c, &d) )
+    return (d & (1U << 8)) != 0;
+#endif
+  return false;
+}
+
+//_____________________________________________________________________________
+void Calibrate()
+{
+  // Use the TSC if it runs at a constant rate. Measure its frequency
+  // against the monotonic clock.
+
+  if( !HaveInvariantTSC() )
+    return;
+#ifdef PROFILER_HAVE_TSC
+  uint64_t t0 = MonotonicNs(), c0 = __rdtsc();
+  this_thread::sleep_for(chrono::milliseconds(10));
+  uint64_t t1 = MonotonicNs(), c1 = __rdtsc();
+  if( c1 <= c0 || t1 <= t0 )
+    return;
+  gNsPerTick = double(t1 - t0) / double(c1 - c0);
+  gUseTSC = true;
+#endif
+}
+
+//_____________________________________________________________________________
+string JSONString( const string& s )
+{
+  string ret = "\"";
+  for( char ch: s ) {
+    if( ch == '"' || ch == '\\' )
+      ret += '\\';
+    if( static_cast<unsigned char>(ch) >= 0x20 )
+      ret += ch;
+  }
+  return ret + "\"";
+}
+
+} // namespace
+
+//_____________________________________________________________________________
+// Hands a thread's counter block back to the profiler when the thread exits
+struct StageProfiler::ThreadHandle {
+  ThreadBlock* block{nullptr};
+  ~ThreadHandle() { if( block ) Instance().ReleaseBlock(block); }
+};
+
+//_____________________________________________________________________________
+StageProfiler& StageProfiler::Instance()
+{
+  // Never deleted, so that threads exiting late can still return their
+  // counter blocks
+
+  static auto* instance = new StageProfiler;
+  return *instance;
+}
+
+//_____________________________________________________________________________
+void StageProfiler::Enable( Bool_t enable )
+{
+  if( enable )
+    call_once(gCalibrated, Calibrate);
+  fgEnabled = enable;
+}
+
+//_____________________________________________________________________________
+void StageProfiler::ThreadBlock::Clear()
+{
+  for( auto& ctr: c ) {
+    ctr.count.store(0, memory_order_relaxed);
+    ctr.total.store(0, memory_order_relaxed);
+    ctr.min.store(0, memory_order_relaxed);
+    ctr.max.store(0, memory_order_relaxed);
+    ctr.allocs.store(0, memory_order_relaxed);
+    for( auto& h: ctr.hist )
+      h.store(0, memory_order_relaxed);
+  }
+}
+
+//_____________________________________________________________________________
+void StageProfiler::Reset()
+{
+  // Clear the statistics of all stages. Should not be called while
+  // timers are running in other threads.
+
+  lock_guard<mutex> lock(fMutex);
+  for( auto& block: fBlocks )
+    block->Clear();
+}
+
+//_____________________________________________________________________________
+StageProfiler::ID_t StageProfiler::Register( const string& name )
+{
+  lock_guard<mutex> lock(fMutex);
+  auto it = find(fNames.begin(), fNames.end(), name);
+  if( it != fNames.end() )
+    return static_cast<ID_t>(it - fNames.begin());
+  if( fNames.size() >= kMaxStages ) {
+    cerr << "StageProfiler: too many stages, not timing \"" << name << "\""
+         << endl;
+    return kNoStage;
+  }
+  fNames.push_back(name);
+  return static_cast<ID_t>(fNames.size() - 1);
+}
+
+//_____________________________________________________________________________
+StageProfiler::ID_t StageProfiler::Find( const string& name ) const
+{
+  lock_guard<mutex> lock(fMutex);
+  auto it = find(fNames.begin(), fNames.end(), name);
+  if( it == fNames.end() )
+    return kNoStage;
+  return static_cast<ID_t>(it - fNames.begin());
+}
+
+//_____________________________________________________________________________
+string StageProfiler::GetName( ID_t id ) const
+{
+  lock_guard<mutex> lock(fMutex);
+  return id < fNames.size() ? fNames[id] : string{};
+}
+
+//_____________________________________________________________________________
+UInt_t StageProfiler::GetNstages() const
+{
+  lock_guard<mutex> lock(fMutex);
+  return fNames.size();
+}
+
+//_____________________________________________________________________________
+uint64_t StageProfiler::Now()
+{
+#ifdef PROFILER_HAVE_TSC
+  if( gUseTSC.load(memory_order_relaxed) )
+    return __rdtsc();
+#endif
+  return MonotonicNs();
+}
+
+//_____________________________________________________________________________
+const char* StageProfiler::GetClockName()
+{
+  return gUseTSC ? "tsc" : "clock_gettime";
+}
+
+//_____________________________________________________________________________
+void StageProfiler::CountAllocation() noexcept
+{
+  // To be called for each heap allocation, typically from a replacement
+  // global operator new. Cheap enough to be called unconditionally.
+
+  ++tAllocCount;
+}
+
+//_____________________________________________________________________________
+uint64_t StageProfiler::GetAllocationCount() noexcept
+{
+  return tAllocCount;
+}
+
+//_____________________________________________________________________________
+Bool_t StageProfiler::HaveAllocationCounts() noexcept
+{
+  // True if allocations are being counted. Any thread that got this far
+  // has allocated memory.
+
+  return tAllocCount > 0;
+}
+
+//_____________________________________________________________________________
+StageProfiler::ThreadBlock* StageProfiler::AcquireBlock()
+{
+  // Get a free counter block for the calling thread. Blocks of exited
+  // threads are reused, so their counts remain part of the statistics.
+
+  lock_guard<mutex> lock(fMutex);
+  for( auto& block: fBlocks ) {
+    if( !block->inuse ) {
+      block->inuse = true;
+      return block.get();
+    }
+  }
+  fBlocks.push_back(make_unique<ThreadBlock>());
+  auto* block = fBlocks.back().get();
+  block->Clear();
+  block->inuse = true;
+  return block;
+}
+
+//_____________________________________________________________________________
+void StageProfiler::ReleaseBlock( ThreadBlock* block )
+{
+  lock_guard<mutex> lock(fMutex);
+  block->inuse = false;
+}
+
+//_____________________________________________________________________________
+StageProfiler::ThreadBlock& StageProfiler::LocalBlock()
+{
+  thread_local ThreadHandle handle;
+  if( !handle.block )
+    handle.block = AcquireBlock();
+  return *handle.block;
+}
+
+//_____________________________________________________________________________
+void StageProfiler::Record( ID_t id, uint64_t start, uint64_t nalloc )
+{
+  uint64_t ticks = Now() - start;
+  if( gUseTSC.load(memory_order_relaxed) )
+    ticks = uint64_t(double(ticks) * gNsPerTick.load(memory_order_relaxed));
+  RecordNs(id, ticks, nalloc);
+}
+
+//_____________________________________________________________________________
+void StageProfiler::RecordNs( ID_t id, uint64_t ns, uint64_t nalloc )
+{
+  // Add one measurement to the calling thread's counters. Only this thread
+  // writes to them, so plain load/store suffices.
+
+  if( id >= kMaxStages )
+    return;
+  auto& ctr = LocalBlock().c[id];
+  auto n = ctr.count.load(memory_order_relaxed);
+  if( n == 0 || ns < ctr.min.load(memory_order_relaxed) )
+    ctr.min.store(ns, memory_order_relaxed);
+  if( ns > ctr.max.load(memory_order_relaxed) )
+    ctr.max.store(ns, memory_order_relaxed);
+  ctr.total.store(ctr.total.load(memory_order_relaxed) + ns,
+                  memory_order_relaxed);
+  ctr.allocs.store(ctr.allocs.load(memory_order_relaxed) + nalloc,
+                   memory_order_relaxed);
+  auto& h = ctr.hist[std::min<UInt_t>(bit_width(ns), kNbins - 1)];
+  h.store(h.load(memory_order_relaxed) + 1, memory_order_relaxed);
+  ctr.count.store(n + 1, memory_order_relaxed);
+}
+
+//_____________________________________________________________________________
+uint64_t StageProfiler::BinLow( UInt_t bin )
+{
+  return bin == 0 ? 0 : 1ULL << (bin - 1);
+}
+
+//_____________________________________________________________________________
+uint64_t StageProfiler::BinHigh( UInt_t bin )
+{
+  return bin + 1 < kNbins ? 1ULL << bin : kMaxULong64;
+}
+
+//_____________________________________________________________________________
+double StageProfiler::Stats_t::Quantile( double q ) const
+{
+  // Estimate the q-quantile (0 <= q <= 1) by linear interpolation within
+  // the histogram bin containing it. Exact for q = 0 and q = 1.
+
+  if( count == 0 )
+    return 0;
+  if( q <= 0 )
+    return double(min);
+  if( q >= 1 )
+    return double(max);
+  double target = q * double(count), sum = 0;
+  for( UInt_t i = 0; i < kNbins; ++i ) {
+    if( hist[i] == 0 )
+      continue;
+    if( sum + double(hist[i]) >= target ) {
+      double lo = std::max(double(BinLow(i)), double(min));
+      double hi = std::min(double(BinHigh(i)), double(max));
+      return lo + (hi - lo) * (target - sum) / double(hist[i]);
+    }
+    sum += double(hist[i]);
+  }
+  return double(max);
+}
+
+//_____________________________________________________________________________
+vector<StageProfiler::Stats_t> StageProfiler::GetStats( const string& prefix ) const
+{
+  vector<Stats_t> stats;
+  lock_guard<mutex> lock(fMutex);
+  for( ID_t id = 0; id < fNames.size(); ++id ) {
+    if( fNames[id].compare(0, prefix.size(), prefix) != 0 )
+      continue;
+    Stats_t st;
+    st.name = fNames[id];
+    for( const auto& block: fBlocks ) {
+      const auto& ctr = block->c[id];
+      auto n = ctr.count.load(memory_order_relaxed);
+      if( n == 0 )
+        continue;
+      auto lo = ctr.min.load(memory_order_relaxed);
+      if( st.count == 0 || lo < st.min )
+        st.min = lo;
+      st.max = std::max(st.max, ctr.max.load(memory_order_relaxed));
+      st.total += ctr.total.load(memory_order_relaxed);
+      st.allocs += ctr.allocs.load(memory_order_relaxed);
+      st.count += n;
+      for( UInt_t i = 0; i < kNbins; ++i )
+        st.hist[i] += ctr.hist[i].load(memory_order_relaxed);
+    }
+    if( st.count > 0 )
+      stats.push_back(std::move(st));
+  }
+  return stats;
+}
+
+//_____________________________________________________________________________
+void StageProfiler::Print( const string& prefix, ostream& os ) const
+{
+  // Print table of stage timing statistics. Times in microseconds, except
+  // for the total, which is in seconds. If allocations are counted, the
+  // mean number of heap allocations per call is shown as well.
+
+  auto stats = GetStats(prefix);
+  if( stats.empty() )
+    return;
+  Bool_t allocs = HaveAllocationCounts();
+  size_t w = 5;
+  for( const auto& st: stats )
+    w = std::max(w, st.name.size());
+  auto fl = os.flags();
+  auto pr = os.precision();
+  os << left << setw(int(w)) << "Stage" << right
+     << setw(12) << "Calls" << setw(11) << "Total/s"
+     << setw(11) << "Mean/us" << setw(11) << "p50/us"
+     << setw(11) << "p99/us" << setw(11) << "Max/us";
+  if( allocs )
+    os << setw(11) << "Allocs";
+  os << endl;
+  os << fixed;
+  for( const auto& st: stats ) {
+    os << left << setw(int(w)) << st.name << right
+       << setw(12) << st.count
+       << setw(11) << setprecision(3) << 1e-9 * double(st.total)
+       << setprecision(2)
+       << setw(11) << 1e-3 * st.Mean()
+       << setw(11) << 1e-3 * st.Quantile(0.5)
+       << setw(11) << 1e-3 * st.Quantile(0.99)
+       << setw(11) << 1e-3 * double(st.max);
+    if( allocs )
+      os << setw(11) << double(st.allocs) / double(st.count);
+    os << endl;
+  }
+  os.flags(fl);
+  os.precision(pr);
+}
+
+//_____________________________________________________________________________
+void StageProfiler::WriteJSON( ostream& os, const string& prefix ) const
+{
+  // Write statistics as JSON. Times in ns. The histogram lists the
+  // non-empty bins as [low edge, high edge, count]. "allocs" is the total
+  // number of heap allocations, meaningful only if "alloc_counting" is true.
+
+  auto stats = GetStats(prefix);
+  os << "{\n  \"clock\": " << JSONString(GetClockName())
+     << ",\n  \"alloc_counting\": "
+     << (HaveAllocationCounts() ? "true" : "false")
+     << ",\n  \"stages\": [";
+  for( size_t k = 0; k < stats.size(); ++k ) {
+    const auto& st = stats[k];
+    os << (k ? ",\n" : "\n")
+       << "    {\"name\": " << JSONString(st.name)
+       << ", \"count\": " << st.count
+       << ", \"total_ns\": " << st.total
+       << ", \"mean_ns\": " << uint64_t(st.Mean())
+       << ", \"min_ns\": " << st.min
+       << ", \"p50_ns\": " << uint64_t(st.Quantile(0.5))
+       << ", \"p90_ns\": " << uint64_t(st.Quantile(0.9))
+       << ", \"p99_ns\": " << uint64_t(st.Quantile(0.99))
+       << ", \"max_ns\": " << st.max
+       << ", \"allocs\": " << st.allocs
+       << ", \"histogram\": [";
+    Bool_t first = true;
+    for( UInt_t i = 0; i < kNbins; ++i ) {
+      if( st.hist[i] == 0 )
+        continue;
+      os << (first ? "" : ", ") << "[" << BinLow(i) << ", " << BinHigh(i)
+         << ", " << st.hist[i] << "]";
+      first = false;
+    }
+    os << "]}";
+  }
+  os << "\n  ]\n}" << endl;
+}
+
+//_____________________________________________________________________________
+void StageProfiler::WriteCSV( ostream& os, const string& prefix ) const
+{
+  // Write statistics as CSV, one line per stage. Times in ns.
+  // The last kNbins columns are the latency histogram.
+
+  auto stats = GetStats(prefix);
+  os << "stage,count,total_ns,mean_ns,min_ns,p50_ns,p90_ns,p99_ns,max_ns,"
+        "allocs";
+  for( UInt_t i = 0; i < kNbins; ++i )
+    os << ",ge" << BinLow(i) << "ns";
+  os << endl;
+  for( const auto& st: stats ) {
+    os << st.name << "," << st.count << "," << st.total << ","
+       << uint64_t(st.Mean()) << "," << st.min << ","
+       << uint64_t(st.Quantile(0.5)) << "," << uint64_t(st.Quantile(0.9)) << ","
+       << uint64_t(st.Quantile(0.99)) << "," << st.max << "," << st.allocs;
+    for( auto h: st.hist )
+      os << "," << h;
+    os << endl;
+  }
+}
+
+//_____________________________________________________________________________
+Int_t StageProfiler::WriteFile( const char* filename, const string& prefix ) const
+{
+  // Write statistics to file 'filename'. The format is JSON if the
+  // name ends in ".json", CSV otherwise. Returns 0 on success.
+
+  if( !filename || !*filename )
+    return -1;
+  ofstream ofs(filename);
+  if( !ofs ) {
+    cerr << "StageProfiler: cannot open timing file " << filename << endl;
+    return -2;
+  }
+  string name(filename);
+  if( name.size() > 5 && name.compare(name.size() - 5, 5, ".json") == 0 )
+    WriteJSON(ofs, prefix);
+  else
+    WriteCSV(ofs, prefix);
+  return ofs ? 0 : -3;
+}
+
+} // namespace Podd
@@ -0,0 +1,178 @@
+#ifndef Podd_StageProfiler_h_
+#define Podd_StageProfiler_h_
+
+/////////////////////////////////////////////////////////////////////
+//
+//   StageProfiler
+//
+//   Low-overhead timing of the stages of the event loop.
+//
+//   Stages are registered once by name, typically at initialization,
+//   and are referred to by integer ID afterwards. Names are of the
+//   form "Group/Stage", e.g. "Analyzer/Decode" or "Decoder/roc_decode",
+//   so that the statistics of a group can be selected by prefix.
+//
+//   Time is measured with the CPU time stamp counter where it is
+//   invariant, and with clock_gettime(CLOCK_MONOTONIC) otherwise.
+//   Each thread records into its own block of counters, so recording
+//   needs neither locks nor shared cache lines. Per stage, the number
+//   of calls, total/min/max time and a histogram of latencies in
+//   power-of-two bins of nanoseconds are kept. Percentiles are
+//   estimated from the histogram.
+//
+//   Heap allocations made while a stage is timed are counted as well,
+//   provided the program calls CountAllocation() from a replacement
+//   operator new, as the standalone analyzer does when built with the
+//   CMake option PODD_COUNT_ALLOCATIONS.
+//
+//   When disabled, a Scope costs one relaxed load of a global flag.
+//
+//   There is one process-wide instance, obtained with Instance().
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "Rtypes.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Podd {
+
+class StageProfiler {
+public:
+  using ID_t = UInt_t;
+
+  static constexpr ID_t   kNoStage   = kMaxUInt;
+  static constexpr UInt_t kMaxStages = 512;  // Maximum number of stages
+  static constexpr UInt_t kNbins     = 40;   // Latency histogram bins
+
+  StageProfiler( const StageProfiler& ) = delete;
+  StageProfiler& operator=( const StageProfiler& ) = delete;
+
+  static StageProfiler& Instance();
+
+  // Enabling calibrates the clock on first use. Disabling keeps the data.
+  void   Enable( Bool_t enable = true );
+  static Bool_t IsEnabled() { return fgEnabled.load(std::memory_order_relaxed); }
+  // Clear all statistics. Registered stages are kept.
+  void   Reset();
+
+  // Return ID of stage 'name', registering it if necessary.
+  // Returns kNoStage if the table is full.
+  ID_t   Register( const std::string& name );
+  ID_t   Find( const std::string& name ) const;
+  std::string GetName( ID_t id ) const;
+  UInt_t GetNstages() const;
+
+  // Raw clock ticks. Only differences are meaningful.
+  static uint64_t Now();
+  // Record the time elapsed since 'start' (from Now()) for stage 'id',
+  // along with the number of heap allocations made meanwhile
+  void   Record( ID_t id, uint64_t start, uint64_t nalloc = 0 );
+  // Record a latency given in nanoseconds for stage 'id'
+  void   RecordNs( ID_t id, uint64_t ns, uint64_t nalloc = 0 );
+  static const char* GetClockName();
+
+  // Per-thread heap allocation counter, see class description
+  static void     CountAllocation() noexcept;
+  static uint64_t GetAllocationCount() noexcept;
+  static Bool_t   HaveAllocationCounts() noexcept;
+
+  // Statistics of one stage, summed over all threads
+  struct Stats_t {
+    std::string name;
+    uint64_t count{0};
+    uint64_t total{0};    // ns
+    uint64_t min{0};      // ns
+    uint64_t max{0};      // ns
+    uint64_t allocs{0};   // Heap allocations
+    std::array<uint64_t,kNbins> hist{};  // bin i: [2^(i-1),2^i) ns
+
+    double Mean() const { return count ? double(total)/double(count) : 0.; }
+    double Quantile( double q ) const;
+  };
+  static uint64_t BinLow( UInt_t bin );
+  static uint64_t BinHigh( UInt_t bin );
+
+  // Statistics of all stages whose name starts with 'prefix' and that
+  // have been called at least once, in order of registration
+  std::vector<Stats_t> GetStats( const std::string& prefix = "" ) const;
+
+  void   Print( const std::string& prefix = "",
+                std::ostream& os = std::cout ) const;
+  void   WriteJSON( std::ostream& os, const std::string& prefix = "" ) const;
+  void   WriteCSV( std::ostream& os, const std::string& prefix = "" ) const;
+  // Write statistics to file. JSON if the name ends in ".json", else CSV.
+  Int_t  WriteFile( const char* filename, const std::string& prefix = "" ) const;
+
+  // RAII timer. Time from Start() (or construction) until Stop()
+  // (or destruction) is recorded for the given stage, provided the
+  // profiler was enabled when the timer started.
+  class Scope {
+  public:
+    Scope() = default;
+    explicit Scope( ID_t id ) { Start(id); }
+    Scope( const Scope& ) = delete;
+    Scope& operator=( const Scope& ) = delete;
+    ~Scope() { Stop(); }
+
+    void Start( ID_t id ) {
+      Stop();
+      if( IsEnabled() && id < kMaxStages ) {
+        fID = id;
+        fAllocs = GetAllocationCount();
+        fStart = Now();
+        fRunning = true;
+      }
+    }
+    void Stop() {
+      if( fRunning ) {
+        fRunning = false;
+        Instance().Record(fID, fStart, GetAllocationCount() - fAllocs);
+      }
+    }
+  private:
+    ID_t     fID{kNoStage};
+    uint64_t fStart{0};
+    uint64_t fAllocs{0};
+    Bool_t   fRunning{false};
+  };
+
+private:
+  StageProfiler() = default;
+
+  struct Counter {
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> total;
+    std::atomic<uint64_t> min;
+    std::atomic<uint64_t> max;
+    std::atomic<uint64_t> allocs;
+    std::array<std::atomic<uint64_t>,kNbins> hist;
+  };
+  // Counters of one thread. Only the owning thread writes to them.
+  struct ThreadBlock {
+    std::array<Counter,kMaxStages> c;
+    std::atomic<bool> inuse;
+    void Clear();
+  };
+  struct ThreadHandle;  // Returns a thread's block when the thread exits
+
+  ThreadBlock& LocalBlock();
+  ThreadBlock* AcquireBlock();
+  void         ReleaseBlock( ThreadBlock* block );
+
+  mutable std::mutex fMutex;
+  std::vector<std::string> fNames;                    // Stage names, index = ID
+  std::vector<std::unique_ptr<ThreadBlock>> fBlocks;  // All thread blocks
+
+  static std::atomic<bool> fgEnabled;
+};
+
+} // namespace Podd
+
+#endif
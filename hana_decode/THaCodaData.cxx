@@ -48,6 +48,16 @@ Int_t THaCodaData::getCodaVersion()
   return (EvioVersion < 4) ? 2 : 3;
 }
 
+//_____________________________________________________________________________
+Int_t THaCodaData::setReadAhead( UInt_t depth, size_t /* max_bytes */ )
+{
+  // Request reading up to 'depth' events ahead on a background thread.
+  // Not supported by this data source, so only depth = 0 (synchronous
+  // reads) succeeds.
+
+  return (depth == 0) ? CODA_OK : CODA_ERROR;
+}
+
 //_____________________________________________________________________________
 void THaCodaData::staterr(const char* tried_to, Int_t status) const
 {
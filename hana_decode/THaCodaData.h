@@ -46,6 +46,7 @@ public:
   Bool_t  grow( UInt_t newsize = 0 );
   UInt_t  operator[]( UInt_t i ) { assert(i < size()); return fBuffer[i]; }
   UInt_t* get()        { return fBuffer.data(); }
+  const UInt_t* get() const { return fBuffer.data(); }
   UInt_t  size() const { return fBuffer.size(); }
   void    reset();
 
@@ -73,10 +74,11 @@ public:
    virtual Int_t codaOpen(const char* file_name, const char* session, Int_t mode=1) = 0;
    virtual Int_t codaClose()=0;
    virtual Int_t codaRead()=0;
-   UInt_t*       getEvBuffer() { return evbuffer.get(); }
-   UInt_t        getBuffSize() const { return evbuffer.size(); }
+   virtual UInt_t* getEvBuffer() { return evbuffer.get(); }
+   virtual UInt_t  getBuffSize() const { return evbuffer.size(); }
    virtual Bool_t isOpen() const = 0;
    virtual Int_t getCodaVersion();
+   virtual Int_t setReadAhead( UInt_t depth, size_t max_bytes = 0 );
    void          setVerbosity(int level) { verbose = level; }
    Bool_t        isGood() const { return fIsGood; }
 
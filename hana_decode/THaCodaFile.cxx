@@ -12,6 +12,7 @@
 /////////////////////////////////////////////////////////////////////
 
 #include "THaCodaFile.h"
+#include "EvtBufferRing.h"
 #include "Helper.h"
 #include "TSystem.h"
 #include "evio.h"
@@ -29,6 +30,7 @@ namespace Decoder {
 //_____________________________________________________________________________
   THaCodaFile::THaCodaFile()
     : max_to_filt(0), maxflist(0), maxftype(0)
+    , fReadAheadDepth(0), fReadAheadBytes(0), fCodaVersion(0), fReadMode(false)
   {
     // Default constructor. Do nothing (must open file separately).
   }
@@ -36,6 +38,7 @@ namespace Decoder {
 //_____________________________________________________________________________
   THaCodaFile::THaCodaFile(const char* fname, const char* readwrite)
     : max_to_filt(0), maxflist(0), maxftype(0)
+    , fReadAheadDepth(0), fReadAheadBytes(0), fCodaVersion(0), fReadMode(false)
   {
     // Standard constructor. Pass read or write flag
     THaCodaFile::codaOpen(fname, readwrite);
@@ -61,6 +64,7 @@ namespace Decoder {
   {
     // Open CODA file 'fname' with 'readwrite' access
     init(fname);
+    fReadMode = (readwrite && readwrite[0] == 'r');
     errno = 0;
     Int_t status = evOpen((char*)fname, (char*)readwrite, &handle);
     fIsGood = (status == S_SUCCESS && handle != 0 );
@@ -74,9 +78,13 @@ namespace Decoder {
     if( !handle ) {
       return ReturnCode(S_SUCCESS);
     }
+    // The read-ahead thread must be done with the handle before closing it
+    if( fReadAhead )
+      fReadAhead->Stop();
     errno = 0;
     Int_t status = evClose(handle);
     handle = 0;
+    fCodaVersion = 0;
     fIsGood = (status == S_SUCCESS);
     staterr("close",status);
     return ReturnCode(status);
@@ -86,6 +94,8 @@ namespace Decoder {
   Int_t THaCodaFile::codaRead() {
 // codaRead: Reads data from file, stored in evbuffer.
 // Must be called once per event.
+// If read-ahead is enabled, hands out the next buffer already filled by
+// the read-ahead thread instead.
     if( !handle ) {
       if (verbose > 0) {
         cout << "codaRead ERROR: tried to access a file with handle = 0" << endl;
@@ -94,11 +104,28 @@ namespace Decoder {
       }
       return ReturnCode(S_EVFILE_BADHANDLE);
     }
+    Int_t status = S_SUCCESS;
+    if( fReadAheadDepth > 0 && fReadMode ) {
+      if( !fReadAhead || !fReadAhead->IsRunning() )
+        startReadAhead();
+      status = fReadAhead->Next();
+    } else
+      status = readBuffer(evbuffer);
+
+    fIsGood = (status == S_SUCCESS || status == EOF );
+    staterr("read",status);
+    return ReturnCode(status);
+  }
+
+//_____________________________________________________________________________
+  Int_t THaCodaFile::readBuffer( EvtBuffer& buf ) {
+// Read one event into 'buf', growing it as necessary.
+// Returns the EVIO status code.
     Int_t status = S_SUCCESS;
     do {
-      evbuffer.updateSize();
+      buf.updateSize();
       errno = 0;
-      status = evRead(handle, getEvBuffer(), getBuffSize());
+      status = evRead(handle, buf.get(), buf.size());
       if( status == S_EVFILE_TRUNC ) {
         // At least with EVIO version 5.2, probably earlier and hopefully later
         // versions too, evRead has not consumed any buffer data if this
@@ -106,19 +133,75 @@ namespace Decoder {
         // Unfortunately, the EVIO C-API does not provide any means to access
         // the actual event length here, so we have to guess how much more
         // space is needed.  TODO: Make an EVIO feature request?
-        if( !evbuffer.grow() )
+        if( !buf.grow() )
           break;
       }
     } while( status == S_EVFILE_TRUNC );
 
     if( status == S_SUCCESS )
-      evbuffer.recordSize();
+      buf.recordSize();
 
-    fIsGood = (status == S_SUCCESS || status == EOF );
-    staterr("read",status);
-    return ReturnCode(status);
+    return status;
   }
 
+//_____________________________________________________________________________
+  void THaCodaFile::startReadAhead() {
+// Start reading events on a background thread. The thread owns the EVIO
+// handle until codaClose() is called.
+    // Query the CODA version now; the handle is busy once reading starts
+    getCodaVersion();
+    if( !fReadAhead )
+      fReadAhead = make_unique<EvtBufferRing>();
+    fReadAhead->SetDepth(fReadAheadDepth);
+    fReadAhead->SetMaxBytes(fReadAheadBytes > 0 ? fReadAheadBytes
+                                                : EvtBufferRing::kDefaultMaxBytes);
+    fReadAhead->Start([this]( EvtBuffer& buf, Bool_t& last ) -> Int_t {
+      Int_t status = readBuffer(buf);
+      Int_t ret = ReturnCode(status);
+      last = (ret == CODA_EOF || ret == CODA_FATAL);
+      return status;
+    });
+  }
+
+//_____________________________________________________________________________
+  Int_t THaCodaFile::setReadAhead( UInt_t depth, size_t max_bytes ) {
+// Read up to 'depth' events, but not much more than 'max_bytes' of event
+// buffers, ahead of time on a background thread. max_bytes = 0 selects a
+// default limit. depth = 0 restores synchronous reading.
+// Takes effect with the next codaRead(). Cannot be changed while
+// read-ahead is in progress, i.e. until the file is closed.
+    if( depth == fReadAheadDepth && max_bytes == fReadAheadBytes )
+      return CODA_OK;
+    if( fReadAhead && fReadAhead->IsRunning() )
+      return CODA_ERROR;
+    fReadAheadDepth = depth;
+    fReadAheadBytes = max_bytes;
+    return CODA_OK;
+  }
+
+//_____________________________________________________________________________
+  UInt_t* THaCodaFile::getEvBuffer() {
+// Buffer holding the most recently read event
+    if( fReadAhead && fReadAhead->HasBuffer() )
+      return fReadAhead->GetBuffer();
+    return THaCodaData::getEvBuffer();
+  }
+
+//_____________________________________________________________________________
+  UInt_t THaCodaFile::getBuffSize() const {
+    if( fReadAhead && fReadAhead->HasBuffer() )
+      return fReadAhead->GetBuffSize();
+    return THaCodaData::getBuffSize();
+  }
+
+//_____________________________________________________________________________
+  Int_t THaCodaFile::getCodaVersion() {
+// Get CODA version of the open file. The result is cached so that the
+// EVIO handle need not be queried while the read-ahead thread is using it.
+    if( fCodaVersion <= 0 )
+      fCodaVersion = THaCodaData::getCodaVersion();
+    return fCodaVersion;
+  }
 
 //_____________________________________________________________________________
   Int_t THaCodaFile::codaWrite(const UInt_t* evbuf) {
@@ -17,9 +17,12 @@
 #include "THaCodaData.h"
 #include "Decoder.h"
 #include <vector>
+#include <memory>
 
 namespace Decoder {
 
+class EvtBufferRing;
+
 class THaCodaFile : public THaCodaData {
 
 public:
@@ -33,6 +36,10 @@ public:
   virtual Int_t codaOpen(const char* filename, const char* rw, Int_t mode=1);
   virtual Int_t codaClose();
   virtual Int_t codaRead();
+  virtual UInt_t* getEvBuffer();
+  virtual UInt_t  getBuffSize() const;
+  virtual Int_t getCodaVersion();
+  virtual Int_t setReadAhead( UInt_t depth, size_t max_bytes = 0 );
   Int_t codaWrite(const UInt_t* evbuffer);
   Int_t filterToFile(const char* output_file); // filter to an output file
   void  addEvTypeFilt(UInt_t evtype_to_filt);  // add an event type to list
@@ -43,9 +50,16 @@ public:
 private:
 
   void init(const char* fname="");
+  Int_t readBuffer( EvtBuffer& buf );
+  void  startReadAhead();
   UInt_t max_to_filt;
   UInt_t maxflist,maxftype;
   std::vector<UInt_t> evlist, evtypes;
+  std::unique_ptr<EvtBufferRing> fReadAhead; //! Read-ahead event buffers
+  UInt_t fReadAheadDepth;   // Max. events to read ahead (0 = no read-ahead)
+  size_t fReadAheadBytes;   // Max. bytes of buffers to read ahead (0 = default)
+  Int_t  fCodaVersion;      // CODA version of open file (0 = not yet known)
+  Bool_t fReadMode;         // File opened for reading
 
   ClassDef(THaCodaFile,0)   //  File of CODA data
 
@@ -11,10 +11,15 @@
 //   All data are received as characters and are parsed.
 //   'tags' remain characters, 'values' are either character 
 //   or double, and 'units' are characters.
-//   Data are stored in an STL map and retrievable by
-//   'tag' (e.g. IPM1H04B.XPOS) and by proximity to
+//   Data are stored per channel, sorted by event number, and are
+//   retrievable by 'tag' (e.g. IPM1H04B.XPOS) and by proximity to
 //   a physics event number (closest one is picked).
 //
+//   For repeated lookups, obtain a channel's integer handle once
+//   with GetHandle() and use GetChan(handle,event), which finds the
+//   entry by binary search and returns it without copying.
+//   SetRetention() limits the history kept per channel.
+//
 //   Replaces THaEpicsStack (obsolete)
 //
 //   author  Robert Michaels (rom@jlab.org)
@@ -22,7 +27,7 @@
 /////////////////////////////////////////////////////////////////////
 
 #include "THaEpics.h"
-#include "Helper.h"
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <sstream>
@@ -31,7 +36,6 @@
 #endif
 
 using namespace std;
-using Podd::SINT;
 
 namespace Decoder {
 
@@ -72,9 +76,10 @@ void THaEpics::Print()
   cout << "\n\n====================== \n";
   cout << "Print of Epics Data : "<<endl;
   Int_t j = 0;
-  for( auto& pm : epicsData ) {
-    const vector<EpicsChan>& vepics = pm.second;
-    const string& tag = pm.first;
+  for( const auto& vepics : fChannels ) {
+    if( vepics.empty() )
+      continue;
+    const string& tag = vepics.front().GetTag();
     j++;
     cout << "\n\nEpics Var #" << j;
     cout << "   Var Name =  \""<<tag<<"\""<<endl;
@@ -95,68 +100,116 @@ void THaEpics::Print()
 //_____________________________________________________________________________
 Bool_t THaEpics::IsLoaded(const char* tag) const
 {
-  const vector<EpicsChan> ep = GetChan(tag);
-  return !ep.empty();
+  return IsLoaded(FindHandle(tag));
 }
 
 //_____________________________________________________________________________
 Double_t THaEpics::GetData( const char* tag, ULong64_t event ) const
 {
-  const vector<EpicsChan> ep = GetChan(tag);
-  UInt_t k = FindEvent(ep, event);
-  if( k == kMaxUInt ) return 0;
-  return ep[k].GetData();
+  const EpicsChan* ch = GetChan(FindHandle(tag), event);
+  return ch ? ch->GetData() : 0;
 }
 
 //_____________________________________________________________________________
 string THaEpics::GetString( const char* tag, ULong64_t event ) const
 {
-  const vector<EpicsChan> ep = GetChan(tag);
-  UInt_t k = FindEvent(ep, event);
-  if( k == kMaxUInt ) return "";
-  return ep[k].GetString();
+  const EpicsChan* ch = GetChan(FindHandle(tag), event);
+  return ch ? ch->GetString() : "";
 }
 
 //_____________________________________________________________________________
 time_t THaEpics::GetTimeStamp( const char* tag, ULong64_t event ) const
 {
-  const vector<EpicsChan> ep = GetChan(tag);
-  UInt_t k = FindEvent(ep, event);
-  if( k == kMaxUInt ) return 0;
-  return ep[k].GetTimeStamp();
+  const EpicsChan* ch = GetChan(FindHandle(tag), event);
+  return ch ? ch->GetTimeStamp() : 0;
 }
 
 //_____________________________________________________________________________
-vector<EpicsChan> THaEpics::GetChan(const char *tag) const
+THaEpics::Handle_t THaEpics::GetHandle( const char* tag )
 {
-  // Return the vector of Epics data for 'tag' 
-  // where 'tag' is the name of the Epics variable.
-  auto pm = epicsData.find(string(tag));
-  if (pm != epicsData.end())
-    return pm->second;
-  else
-    return {};
+  // Return the handle of the channel 'tag', where 'tag' is the name
+  // of the Epics variable. Creates the channel if it does not exist yet.
+
+  if( !tag || !*tag )
+    return kNoHandle;
+  auto ins = fHandles.emplace(tag, static_cast<Handle_t>(fChannels.size()));
+  if( ins.second )
+    fChannels.emplace_back();
+  return ins.first->second;
 }
 
 //_____________________________________________________________________________
-UInt_t THaEpics::FindEvent( const std::vector<EpicsChan>& ep, ULong64_t event )
+THaEpics::Handle_t THaEpics::FindHandle( const char* tag ) const
 {
-  // Return the index in the vector of Epics data 
-  // nearest in event number to event 'event'.
-  if (ep.empty())
-    return kMaxUInt;
-  UInt_t myidx = ep.size()-1;
-  if (event == 0) return myidx;  // return last event 
-  Long64_t min = kMaxLong64;
-  for( size_t k = 0; k < ep.size(); k++ ) {
-    Long64_t diff = SINT(event - ep[k].GetEvNum());
-    if( diff < 0 ) diff = -diff;
-    if( diff < min ) {
-      min = diff;
-      myidx = k;
-    }
+  // Return the handle of the channel 'tag', or kNoHandle if not found
+
+  if( !tag )
+    return kNoHandle;
+  auto it = fHandles.find(tag);
+  return (it != fHandles.end()) ? it->second : kNoHandle;
+}
+
+//_____________________________________________________________________________
+const EpicsChan* THaEpics::GetChan( Handle_t h, ULong64_t event ) const
+{
+  // Return the Epics data of channel 'h' nearest in event number
+  // to event 'event', or nullptr if there are no data.
+
+  if( h < 0 || h >= (Handle_t)fChannels.size() )
+    return nullptr;
+  return FindEvent(fChannels[h], event);
+}
+
+//_____________________________________________________________________________
+const EpicsChan* THaEpics::FindEvent( const History_t& ep, ULong64_t event )
+{
+  // Return the entry of 'ep' nearest in event number to event 'event'.
+  // If two entries are equally close, the earlier one is returned.
+  // event = 0 returns the last entry.
+
+  if( ep.empty() )
+    return nullptr;
+  if( event == 0 )
+    return &ep.back();
+  auto it = lower_bound(ep.begin(), ep.end(), event,
+                        []( const EpicsChan& ch, ULong64_t ev ) {
+                          return ch.GetEvNum() < ev;
+                        });
+  if( it == ep.begin() )
+    return &*it;
+  // Candidate below 'event': first entry with the preceding event number
+  ULong64_t below = prev(it)->GetEvNum();
+  auto lo = lower_bound(ep.begin(), it, below,
+                        []( const EpicsChan& ch, ULong64_t ev ) {
+                          return ch.GetEvNum() < ev;
+                        });
+  if( it == ep.end() || event - below <= it->GetEvNum() - event )
+    return &*lo;
+  return &*it;
+}
+
+//_____________________________________________________________________________
+void THaEpics::AddEntry( Handle_t h, EpicsChan&& chan )
+{
+  // Add 'chan' to the history of channel 'h', keeping it sorted by event
+  // number. Entries with equal event numbers stay in the order loaded.
+
+  History_t& ep = fChannels[h];
+  ULong64_t event = chan.GetEvNum();
+  if( ep.empty() || ep.back().GetEvNum() <= event )
+    ep.push_back(std::move(chan));
+  else {
+    auto it = upper_bound(ep.begin(), ep.end(), event,
+                          []( ULong64_t ev, const EpicsChan& ch ) {
+                            return ev < ch.GetEvNum();
+                          });
+    ep.insert(it, std::move(chan));
+  }
+  if( fRetention > 0 ) {
+    ULong64_t last = ep.back().GetEvNum();
+    while( ep.size() > 1 && ep.front().GetEvNum() + fRetention < last )
+      ep.pop_front();
   }
-  return myidx;
 }
 
 //_____________________________________________________________________________
@@ -222,7 +275,8 @@ Int_t THaEpics::LoadData( const UInt_t* evbuffer, ULong64_t event )
            << endl;
 
     // Add tag/value/units to the EPICS data.    
-    epicsData[wtag].emplace_back(wtag, date, event, wval, wunits, dval );
+    AddEntry(GetHandle(wtag.c_str()),
+             EpicsChan(wtag, date, event, wval, wunits, dval));
   }
   if( fDebug ) Print();
 
@@ -11,7 +11,8 @@
 
 #include "Rtypes.h"
 #include <string>
-#include <map>
+#include <deque>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <ctime>
@@ -34,13 +35,13 @@ public:
     tag = tg; dtime = dt; evnum = ev; svalue = sv; units = un; dvalue = dv;
     MakeTime();
   };
-  Double_t    GetData()      const { return dvalue; };
-  ULong64_t   GetEvNum()     const { return evnum;  };
-  std::string GetTag()       const { return tag;    };
-  std::string GetDate()      const { return dtime;  };
-  time_t      GetTimeStamp() const { return timestamp; };
-  std::string GetString()    const { return svalue; };
-  std::string GetUnits()     const { return units;  };
+  Double_t           GetData()      const { return dvalue; };
+  ULong64_t          GetEvNum()     const { return evnum;  };
+  const std::string& GetTag()       const { return tag;    };
+  const std::string& GetDate()      const { return dtime;  };
+  time_t             GetTimeStamp() const { return timestamp; };
+  const std::string& GetString()    const { return svalue; };
+  const std::string& GetUnits()     const { return units;  };
     
 private:
   std::string tag;       // Variable name
@@ -58,6 +59,10 @@ class THaEpics {
 
 public:
 
+   // Integer handle of an EPICS channel, see GetHandle()
+   using Handle_t = Int_t;
+   static constexpr Handle_t kNoHandle = -1;
+
    THaEpics() = default;
    virtual ~THaEpics() = default;
 // Get tagged value nearest 'event'
@@ -70,11 +75,37 @@ public:
    void Print();
    void SetDebug( Int_t level ) { fDebug = level; }
 
+// Handle of the channel 'tag'. The channel is created if necessary, so
+// handles can be obtained before any data for the channel have been loaded.
+   Handle_t GetHandle( const char* tag );
+// Handle of the channel 'tag', or kNoHandle if the channel does not exist
+   Handle_t FindHandle( const char* tag ) const;
+   Bool_t IsLoaded( Handle_t h ) const
+   { return h >= 0 && h < (Handle_t)fChannels.size() && !fChannels[h].empty(); }
+// Entry of channel 'h' nearest 'event' (the most recent one if event = 0),
+// or nullptr if there is none. The pointer remains valid until the next
+// call of LoadData.
+   const EpicsChan* GetChan( Handle_t h, ULong64_t event = 0 ) const;
+// Entries of channel 'h' in order of event number (0 = oldest)
+   UInt_t GetNEntries( Handle_t h ) const
+   { return IsLoaded(h) ? (UInt_t)fChannels[h].size() : 0; }
+   const EpicsChan& GetEntry( Handle_t h, UInt_t i ) const
+   { return fChannels[h][i]; }
+// Keep only entries within 'nevents' physics events of the most recent
+// entry of each channel (0 = keep everything, the default). The most
+// recent entry is always kept.
+   void SetRetention( ULong64_t nevents ) { fRetention = nevents; }
+
 private:
 
-   std::map< std::string, std::vector<EpicsChan> > epicsData;
-   std::vector<EpicsChan> GetChan(const char *tag) const;
-  static UInt_t FindEvent( const std::vector<EpicsChan>& ep, ULong64_t event );
+   using History_t = std::deque<EpicsChan>;   // Sorted by event number
+
+   std::vector<History_t> fChannels;           // Channel data by handle
+   std::unordered_map<std::string, Handle_t> fHandles; // Handles by tag
+   ULong64_t fRetention{0};                    // Retention window (events)
+
+   void AddEntry( Handle_t h, EpicsChan&& chan );
+   static const EpicsChan* FindEvent( const History_t& ep, ULong64_t event );
 
    Int_t fDebug{0};
 
@@ -24,7 +24,7 @@
 #include "Helper.h"
 #include "THaSlotData.h"
 #include "THaCrateMap.h"
-#include "THaBenchmark.h"
+#include "StageProfiler.h"
 #include "TError.h"
 #include <cctype>
 #include <iostream>
@@ -77,6 +77,7 @@ THaEvData::THaEvData() :
   fRunTime(time(nullptr)),    // default fRunTime is NOW
   evt_time{0},
   fDoBench{false},
+  fProfID{},
   fInstance{fgInstances.FirstNullBit()},
   fNeedInit{true},
   fDebug{0},
@@ -86,13 +87,19 @@ THaEvData::THaEvData() :
   fSlotClear.reserve(MAXROCSLOT/4);
   fgInstances.SetBitNumber(fInstance);
   fInstance++;
+
+  auto& prof = Podd::StageProfiler::Instance();
+  fProfID[kProfClearEvent]    = prof.Register("Decoder/clearEvent");
+  fProfID[kProfRocDecode]     = prof.Register("Decoder/roc_decode");
+  fProfID[kProfBankDecode]    = prof.Register("Decoder/bank_decode");
+  fProfID[kProfPhysicsDecode] = prof.Register("Decoder/physics_decode");
 }
 
 //_____________________________________________________________________________
 THaEvData::~THaEvData() {
   if( fDoBench ) {
-    Float_t a,b;
-    fBench->Summary(a,b);
+    cout << "Decoder timing summary:" << endl;
+    Podd::StageProfiler::Instance().Print("Decoder/");
   }
   delete fExtra;
   fInstance--;
@@ -143,15 +150,12 @@ void THaEvData::SetRunTime( Long64_t tloc )
 //_____________________________________________________________________________
 void THaEvData::EnableBenchmarks( Bool_t enable )
 {
-  // Enable/disable run time reporting
+  // Enable/disable run time reporting. Enabling also turns on the global
+  // stage profiler. Disabling only suppresses the summary printout since
+  // other components may still be using the profiler.
   fDoBench = enable;
-  if( fDoBench ) {
-    if( !fBench ) {
-      fBench = make_unique<THaBenchmark>();
-    }
-  } else {
-    fBench = nullptr;
-  }
+  if( fDoBench )
+    Podd::StageProfiler::Instance().Enable();
 }
 
 //_____________________________________________________________________________
@@ -23,8 +23,6 @@
 #include <memory>
 #include <string>
 
-class THaBenchmark;
-
 class THaEvData : public TObject {
 
 public:
@@ -222,8 +220,12 @@ protected:
   std::vector<UShort_t> fSlotUsed;    // Indices of crateslot[] used
   std::vector<UShort_t> fSlotClear;   // Indices of crateslot[] to clear
 
-  Bool_t fDoBench;
-  std::unique_ptr<THaBenchmark> fBench;
+  Bool_t fDoBench;             // Print decoder timing summary at end
+
+  // Decoder stages timed with Podd::StageProfiler
+  enum EProfStage { kProfClearEvent, kProfRocDecode, kProfBankDecode,
+                    kProfPhysicsDecode, kNProfStages };
+  std::array<UInt_t,kNProfStages> fProfID; //! Profiler stage IDs
 
   UInt_t fInstance;            // My instance
   static TBits fgInstances;    // Number of instances of this object
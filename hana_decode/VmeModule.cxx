@@ -25,6 +25,13 @@ Bool_t VmeModule::IsSlot(UInt_t rdata) {
   return false;
 }
 
+Bool_t VmeModule::GetHeaderSignature( UInt_t& header, UInt_t& mask ) const {
+  // IsSlot tests the header word against fHeader/fHeaderMask
+  header = fHeader;
+  mask = fHeaderMask;
+  return true;
+}
+
 UInt_t VmeModule::LoadSlot( THaSlotData *sldat, const UInt_t* evbuffer,
                             const UInt_t *pstop)
 {
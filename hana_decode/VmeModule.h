@@ -22,6 +22,7 @@ public:
    using Module::LoadSlot;
 
    virtual Bool_t IsSlot(UInt_t rdata);
+   virtual Bool_t GetHeaderSignature( UInt_t& header, UInt_t& mask ) const;
    // virtual Int_t Slot(Int_t) const { return fSlot; };
    // virtual Int_t Data(Int_t rdata) const { return rdata; };
 
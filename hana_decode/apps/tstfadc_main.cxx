@@ -336,10 +336,11 @@ int main(int /* argc */, char** /* argv */)
                     // Debug output
                     if (debugfile) *debugfile << "NUM FADC SAMPLES = " << num_fadc_samples << endl;
                     // Acquire the raw samples vector and populate graphs
-                    raw_samples_vector[islot][chan] = fadc->GetPulseSamplesVector(chan);
+                    auto samples = fadc->GetPulseSamples(chan);
+                    raw_samples_vector[islot][chan].assign(samples.begin(), samples.end());
                     for (uint32_t ipeak = 0; ipeak < NPEAK; ipeak++) {
                       if (uint32_t (num_fadc_events) == ipeak+1)
-                        raw_samples_npeak_vector[islot][chan][ipeak] = fadc->GetPulseSamplesVector(chan);
+                        raw_samples_npeak_vector[islot][chan][ipeak].assign(samples.begin(), samples.end());
                     }
                     if (raw_samp_index[islot][chan] < NUMRAWEVENTS) {
                       for (uint32_t sample_num = 0; sample_num < raw_samples_vector[islot][chan].size(); sample_num++) {
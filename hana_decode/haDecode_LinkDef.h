@@ -29,6 +29,7 @@
 #pragma link C++ class Decoder::Caen792Module+;
 #pragma link C++ class Decoder::THaCodaData+;
 #pragma link C++ class Decoder::THaCodaFile+;
+#pragma link C++ class Decoder::CodaMmapFile+;
 #pragma link C++ class Decoder::THaCrateMap+;
 #pragma link C++ class Decoder::THaEpics+;
 #pragma link C++ class Decoder::THaSlotData+;
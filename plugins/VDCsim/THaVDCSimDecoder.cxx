@@ -10,7 +10,7 @@
 
 #include "THaVDCSimDecoder.h"
 #include "THaVDCSim.h"
-#include "THaBenchmark.h"
+#include "StageProfiler.h"
 #include "VarDef.h"
 
 using namespace std;
@@ -110,11 +110,11 @@ int THaVDCSimDecoder::LoadEvent(const UInt_t* evbuffer )
     if (init_slotdata() == HED_ERR) return HED_ERR;
     first_decode = false;
   }
-  if( fDoBench ) fBench->Begin("clearEvent");
+  Podd::StageProfiler::Scope timer(fProfID[kProfClearEvent]);
   Clear();
   for( auto i : fSlotClear )
     crateslot[i]->clearEvent();
-  if( fDoBench ) fBench->Stop("clearEvent");
+  timer.Stop();
 
   evscaler = 0;
 
@@ -125,7 +125,7 @@ int THaVDCSimDecoder::LoadEvent(const UInt_t* evbuffer )
   event_type = 1;
   event_num = simEvent->event_num;
 
-  if( fDoBench ) fBench->Begin("physics_decode");
+  timer.Start(fProfID[kProfPhysicsDecode]);
 
 
   // Decode the digitized data.  Populate crateslot array.
@@ -157,7 +157,7 @@ int THaVDCSimDecoder::LoadEvent(const UInt_t* evbuffer )
 
   fTracks.assign( simEvent->tracks.begin(), simEvent->tracks.end() );
 
-  if( fDoBench ) fBench->Stop("physics_decode");
+  timer.Stop();
 
   // DEBUG:
   //  cout << "SimDecoder: nTracks = " << GetNTracks() << endl;
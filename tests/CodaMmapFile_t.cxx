@@ -0,0 +1,155 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// CodaMmapFile_t                                                            //
+//                                                                           //
+// Test Decoder::CodaMmapFile with synthetic EVIO 2 and EVIO 4 files,        //
+// including events spanning blocks and byte-swapped files                   //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CATCH3
+# include <catch2/catch_test_macros.hpp>
+# include <catch2/generators/catch_generators.hpp>
+#else
+# include <catch2/catch.hpp>
+#endif
+
+#include "CodaMmapFile.h"
+#include "TSystem.h"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <cstdint>
+
+using namespace std;
+
+namespace {
+
+using Words = vector<uint32_t>;
+
+//_____________________________________________________________________________
+// Event: bank of banks (tag 1) holding one bank of uint32 (tag 5)
+Words MakeEvent( uint32_t ndata, uint32_t seed )
+{
+  Words ev{ndata + 3, (1U << 16) | (0x10U << 8) | 0xcc,
+           ndata + 1, (5U << 16) | (0x01U << 8)};
+  for( uint32_t i = 0; i < ndata; ++i )
+    ev.push_back(seed * 1000 + i);
+  return ev;
+}
+
+//_____________________________________________________________________________
+void AddBlockHeader( Words& file, uint32_t size, uint32_t num, uint32_t w3,
+                     uint32_t w4, uint32_t ver )
+{
+  file.insert(file.end(), {size, num, 8, w3, w4, ver, 0, 0xc0da0100});
+}
+
+//_____________________________________________________________________________
+// EVIO 4: variable-size blocks of up to 3 events, dictionary in first block,
+// empty last block
+Words MakeEvio4( const vector<Words>& events )
+{
+  Words file;
+  uint32_t num = 1;
+  size_t i = 0;
+  while( i < events.size() ) {
+    Words block;
+    uint32_t ver = 4;
+    if( num == 1 ) {
+      block.insert(block.end(), {3, 0x00001000, 1, 2});  // fake dictionary
+      ver |= 0x100;
+    }
+    uint32_t count = 0;
+    for( ; count < 3 && i < events.size(); ++count, ++i )
+      block.insert(block.end(), events[i].begin(), events[i].end());
+    AddBlockHeader(file, block.size() + 8, num++, count, 0, ver);
+    file.insert(file.end(), block.begin(), block.end());
+  }
+  AddBlockHeader(file, 8, num, 0, 0, 4 | 0x200);
+  return file;
+}
+
+//_____________________________________________________________________________
+// EVIO 2: fixed-size blocks, events span block boundaries
+Words MakeEvio2( const vector<Words>& events, uint32_t blksiz )
+{
+  Words data;
+  for( const auto& ev: events )
+    data.insert(data.end(), ev.begin(), ev.end());
+  Words file;
+  uint32_t num = 0;
+  for( size_t pos = 0; pos < data.size(); ) {
+    size_t n = std::min<size_t>(blksiz - 8, data.size() - pos);
+    AddBlockHeader(file, blksiz, num++, 8, 8 + n, 2);
+    file.insert(file.end(), data.begin() + pos, data.begin() + pos + n);
+    file.resize(file.size() + blksiz - 8 - n);
+    pos += n;
+  }
+  AddBlockHeader(file, blksiz, num, 0, 8, 2);
+  file.resize(file.size() + blksiz - 8);
+  return file;
+}
+
+//_____________________________________________________________________________
+// All words in the test files are 32-bit, so a plain swap is correct
+Words Swapped( Words file )
+{
+  for( auto& w: file )
+    w = __builtin_bswap32(w);
+  return file;
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// Test cases                                                                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("CodaMmapFile reads EVIO files", "[Decoder]")
+{
+  vector<Words> events;
+  for( uint32_t i = 0; i < 200; ++i )
+    events.push_back(MakeEvent((i * 7919U) % 150, i));
+
+  auto [name, file, version] = GENERATE_COPY(table<string, Words, int>({
+    {"evio4",         MakeEvio4(events),               3},
+    {"evio4_swapped", Swapped(MakeEvio4(events)),      3},
+    {"evio2",         MakeEvio2(events, 64),           2},
+    {"evio2_swapped", Swapped(MakeEvio2(events, 64)),  2},
+    {"evio2_large",   MakeEvio2(events, 8192),         2}
+  }));
+
+  string path = string(gSystem->TempDirectory()) + "/CodaMmapFile_t_"
+                + to_string(gSystem->GetPid()) + "_" + name + ".dat";
+  {
+    ofstream ofs(path, ios::binary);
+    ofs.write(reinterpret_cast<const char*>(file.data()),
+              static_cast<streamsize>(file.size() * sizeof(uint32_t)));
+  }
+  INFO("File " << name);
+  {
+    Decoder::CodaMmapFile cf;
+    cf.setVerbosity(0);
+    REQUIRE( cf.codaOpen(path.c_str()) == CODA_OK );
+    REQUIRE( cf.isMapped() );
+    CHECK( cf.getCodaVersion() == version );
+
+    size_t nev = 0;
+    Int_t status = CODA_OK;
+    while( (status = cf.codaRead()) == CODA_OK ) {
+      REQUIRE( nev < events.size() );
+      const auto& ev = events[nev];
+      REQUIRE( cf.getBuffSize() == ev.size() );
+      REQUIRE( std::equal(ev.begin(), ev.end(), cf.getEvBuffer()) );
+      ++nev;
+    }
+    CHECK( status == CODA_EOF );
+    CHECK( nev == events.size() );
+    CHECK( cf.codaClose() == CODA_OK );
+  }
+  gSystem->Unlink(path.c_str());
+}
@@ -0,0 +1,367 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// DBFileIndex_t                                                             //
+//                                                                           //
+// Test key lookups in database files. Lookups in regular files go through   //
+// an in-memory index of the file. Their results must be identical to those  //
+// of a full scan, which is what is done for streams that cannot be indexed. //
+// Indexes saved on disk must be used only while the file is unchanged.      //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CATCH3
+# include <catch2/catch_test_macros.hpp>
+#else
+# include <catch2/catch.hpp>
+#endif
+
+#include "Database.h"
+#include "Textvars.h"
+#include "TSystem.h"
+#include "TDatime.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+// Install a private set of text variables while this object exists
+class TextvarsGuard {
+public:
+  TextvarsGuard() : fSave(gHaTextvars), fVars(make_unique<Podd::Textvars>())
+  {
+    gHaTextvars = fVars.get();
+  }
+  ~TextvarsGuard() { gHaTextvars = fSave; }
+  TextvarsGuard( const TextvarsGuard& ) = delete;
+  TextvarsGuard& operator=( const TextvarsGuard& ) = delete;
+
+  Podd::Textvars* operator->() const { return fVars.get(); }
+
+private:
+  Podd::Textvars* fSave;
+  unique_ptr<Podd::Textvars> fVars;
+};
+
+// Database contents in a regular file (indexed) and in a memory stream
+// (scanned on each lookup)
+class DBContents {
+public:
+  DBContents( string name, string text )
+    : fPath(string(gSystem->TempDirectory()) + "/DBFileIndex_t_"
+            + to_string(gSystem->GetPid()) + "_" + name + ".dat")
+    , fText(std::move(text))
+  {
+    if( FILE* fo = fopen(fPath.c_str(), "w") ) {
+      fputs(fText.c_str(), fo);
+      fclose(fo);
+    }
+    fFile = fopen(fPath.c_str(), "r");
+    fMem = fmemopen(fText.data(), fText.size(), "r");
+  }
+  ~DBContents()
+  {
+    if( fFile ) fclose(fFile);
+    if( fMem ) fclose(fMem);
+    gSystem->Unlink(fPath.c_str());
+  }
+  DBContents( const DBContents& ) = delete;
+  DBContents& operator=( const DBContents& ) = delete;
+
+  bool IsOpen() const { return fFile && fMem; }
+
+  struct Result_t {
+    Int_t  status;
+    string value;
+    bool operator==( const Result_t& rhs ) const {
+      return status == rhs.status && value == rhs.value;
+    }
+  };
+  static Result_t Lookup( FILE* fi, const TDatime& date, const char* key )
+  {
+    Result_t res{0, "unset"};
+    res.status = Podd::LoadDBvalue(fi, date, key, res.value);
+    return res;
+  }
+  Result_t Indexed( const TDatime& date, const char* key ) const {
+    return Lookup(fFile, date, key);
+  }
+  Result_t Scanned( const TDatime& date, const char* key ) const {
+    return Lookup(fMem, date, key);
+  }
+  const string& GetText() const { return fText; }
+  const string& GetPath() const { return fPath; }
+
+private:
+  string fPath;
+  string fText;
+  FILE*  fFile{nullptr};
+  FILE*  fMem{nullptr};
+};
+
+// Save database indexes in a temporary directory while this object exists
+class IndexCacheGuard {
+public:
+  IndexCacheGuard()
+    : fDir(fs::path(gSystem->TempDirectory()) /
+           ("DBFileIndex_t_cache_" + to_string(gSystem->GetPid())))
+  {
+    fs::remove_all(fDir);
+    fs::create_directories(fDir);
+    Podd::SetDBIndexCacheDir(fDir.c_str());
+  }
+  ~IndexCacheGuard()
+  {
+    Podd::SetDBIndexCacheDir(nullptr);
+    std::error_code ec;
+    fs::remove_all(fDir, ec);
+  }
+  IndexCacheGuard( const IndexCacheGuard& ) = delete;
+  IndexCacheGuard& operator=( const IndexCacheGuard& ) = delete;
+
+  vector<fs::path> Files() const
+  {
+    vector<fs::path> files;
+    for( const auto& entry: fs::directory_iterator(fDir) )
+      files.push_back(entry.path());
+    return files;
+  }
+
+private:
+  fs::path fDir;
+};
+
+string ReadFile( const fs::path& path )
+{
+  ifstream ifs(path, ios::binary);
+  return {istreambuf_iterator<char>(ifs), istreambuf_iterator<char>()};
+}
+
+void WriteFile( const fs::path& path, const string& contents )
+{
+  ofstream ofs(path, ios::binary | ios::trunc);
+  ofs << contents;
+}
+
+// Run 'f' in a new thread. In-memory indexes are per thread, so a new
+// thread must get its indexes from disk, like a new job would.
+template<typename Func>
+auto InNewThread( Func f )
+{
+  decltype(f()) res{};
+  thread t([&res, &f] { res = f(); });
+  t.join();
+  return res;
+}
+
+const char* const kExplicitDB =
+  "# Test database\n"
+  "a = 1\n"
+  "\n"
+  "[ 2020-01-01 00:00:00 ]\n"
+  "a = 2\n"
+  "\n"
+  "[ 2022-01-01 00:00:00 ]\n"
+  "a = 3\n"
+  "b = x [ 2019-06-01 00:00:00 ]\n"
+  "a = 4\n"
+  "${arm}.d = ${val}\n"
+  "c = 1 2 \\\n"
+  "    3 4\n";
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// Test cases                                                                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Database key lookup with file index", "[Database]")
+{
+  TextvarsGuard tvars;
+  tvars->Add("arm", "L,R");
+  tvars->Add("val", "7");
+
+  SECTION("Time stamps, ignored sections, text variables") {
+    DBContents db("explicit", kExplicitDB);
+    REQUIRE( db.IsOpen() );
+
+    struct Case_t { Int_t date; const char* key; Int_t status; const char* value; };
+    const vector<Case_t> cases = {
+      // Sections with time stamps later than the date are ignored
+      { 20190101, "a", 0, "1" },
+      { 20210101, "a", 0, "2" },
+      // A key line with a time stamp ends the ignored section 2022 if its
+      // time stamp is not older than the last match
+      { 20191201, "a", 0, "4" },
+      { 20230101, "a", 0, "4" },
+      // ... but never matches itself while in an ignored section
+      { 20210101, "b", 1, "unset" },
+      { 20230101, "b", 0, "x [ 2019-06-01 00:00:00 ]" },
+      // Multi-valued text variable on the left-hand side
+      { 20230101, "L.d", 0, "7" },
+      { 20230101, "R.d", 0, "7" },
+      { 20190101, "L.d", 1, "unset" },
+      // Continuation line
+      { 20230101, "c", 0, "1 2 3 4" },
+      { 20230101, "nokey", 1, "unset" },
+    };
+    for( const auto& c: cases ) {
+      INFO("key = " << c.key << ", date = " << c.date);
+      TDatime date(c.date, 0);
+      auto res = db.Indexed(date, c.key);
+      CHECK( res.status == c.status );
+      CHECK( res.value == c.value );
+      CHECK( res == db.Scanned(date, c.key) );
+    }
+  }
+
+  SECTION("Text variables are substituted on every lookup") {
+    DBContents db("textvars", kExplicitDB);
+    REQUIRE( db.IsOpen() );
+    TDatime date(20230101, 0);
+    CHECK( db.Indexed(date, "L.d").value == "7" );
+    tvars->Set("val", "8");
+    CHECK( db.Indexed(date, "L.d").value == "8" );
+    tvars->Set("arm", "B");
+    CHECK( db.Indexed(date, "L.d").status == 1 );
+    CHECK( db.Indexed(date, "B.d").value == "8" );
+  }
+
+  SECTION("Generated files") {
+    // Fixed seed: the generated files and lookups are always the same
+    mt19937 rng(20201);
+    const vector<const char*> keys = {
+      "a", "b", "c", "L.a", "R.a", "L.vdc.x"
+    };
+    const vector<const char*> stamps = {
+      "[ 2020-01-01 00:00:00 ]",
+      "[ 2020-03-01 12:00:00 ]",
+      "[ 2020-02-01 00:00:00 -0500 ]",
+      "[2021-01-01 00:00:00]",
+      "[ 2019-06-01 00:00:00 ]",
+      "# [ 2020-02-15 00:00:00 ]"
+    };
+    auto pick = [&rng]( const auto& v ) { return v[rng() % v.size()]; };
+
+    size_t nfound = 0, nlookup = 0;
+    for( int ifile = 0; ifile < 100; ++ifile ) {
+      string text = "# Generated file " + to_string(ifile) + "\n";
+      for( unsigned i = 0, n = rng() % 40; i < n; ++i ) {
+        string val = to_string(rng() % 100);
+        switch( rng() % 12 ) {
+          case 0: case 1: case 2:
+            text += string(pick(keys)) + " = " + val + "\n";
+            break;
+          case 3:
+            text += string(pick(keys)) + " = " + val + " \\\n  7 8\n";
+            break;
+          case 4: case 5:
+            // Blank line so that the time stamp does not continue a key line
+            text += "\n" + string(pick(stamps)) + "\n";
+            break;
+          case 6:
+            // Key line with time stamp
+            text += string(pick(keys)) + " = x " + pick(stamps) + "\n";
+            break;
+          case 7:
+            text += "${arm}.a = " + val + "\n";
+            break;
+          case 8:
+            text += "${arm}.vdc.${coord} = ${val}\n";
+            break;
+          case 9:
+            text += string(pick(keys)) + " =\n  1 2 3\n  4 5\n\n";
+            break;
+          case 10:
+            text += "x == y\n";
+            break;
+          default:
+            text += "\n# comment a = " + val + "\n";
+            break;
+        }
+      }
+      DBContents db("generated", std::move(text));
+      REQUIRE( db.IsOpen() );
+      tvars->Set("coord", (ifile % 2) ? "x" : "y");
+      for( int j = 0; j < 20; ++j ) {
+        Int_t d = 20190101 + static_cast<Int_t>((rng() % 3) * 10000 +
+                                                (rng() % 12) * 100 + rng() % 28);
+        TDatime date(d, static_cast<Int_t>(rng() % 24) * 10000);
+        const char* key = pick(keys);
+        auto res = db.Indexed(date, key);
+        INFO("key = " << key << ", date = " << d << "\n" << db.GetText());
+        REQUIRE( res == db.Scanned(date, key) );
+        ++nlookup;
+        if( res.status == 0 )
+          ++nfound;
+      }
+    }
+    // Make sure the test is not trivial
+    CHECK( nfound > nlookup / 4 );
+    CHECK( nfound < nlookup );
+  }
+}
+
+TEST_CASE("Database indexes on disk", "[Database]")
+{
+  TextvarsGuard tvars;
+  tvars->Add("arm", "L,R");
+  tvars->Add("val", "7");
+  IndexCacheGuard cache;
+
+  DBContents db("ondisk", kExplicitDB);
+  REQUIRE( db.IsOpen() );
+  TDatime date(20230101, 0);
+  auto lookup = [&db, &date]( const char* key ) {
+    return [&db, &date, key] { return db.Indexed(date, key); };
+  };
+
+  CHECK( db.Indexed(date, "c").value == "1 2 3 4" );
+  auto files = cache.Files();
+  REQUIRE( files.size() == 1 );
+  CHECK( files[0].extension() == ".bin" );
+
+  SECTION("Index is loaded from disk") {
+    // Change a value in the saved index. The changed value is found only
+    // if the index is loaded rather than rebuilt from the file.
+    string idx = ReadFile(files[0]);
+    auto pos = idx.find("1 2 3 4");
+    REQUIRE( pos != string::npos );
+    idx.replace(pos, 7, "1 2 3 5");
+    WriteFile(files[0], idx);
+    CHECK( InNewThread(lookup("c")).value == "1 2 3 5" );
+    // Text variables are still substituted on every lookup
+    CHECK( InNewThread(lookup("L.d")).value == "7" );
+  }
+
+  SECTION("Stale index is rebuilt") {
+    string old_idx = ReadFile(files[0]);
+    WriteFile(db.GetPath(), string(kExplicitDB) + "c = 9\n");
+    CHECK( InNewThread(lookup("c")).value == "9" );
+    CHECK( db.Indexed(date, "c").value == "9" );
+    // The index on disk has been replaced
+    REQUIRE( cache.Files().size() == 1 );
+    CHECK( ReadFile(cache.Files()[0]) != old_idx );
+    CHECK( InNewThread(lookup("a")).value == "4" );
+  }
+
+  SECTION("Corrupt index is ignored") {
+    string idx = ReadFile(files[0]);
+    WriteFile(files[0], idx.substr(0, idx.size() / 2));
+    CHECK( InNewThread(lookup("c")).value == "1 2 3 4" );
+    WriteFile(files[0], "garbage");
+    CHECK( InNewThread(lookup("a")).value == "4" );
+    CHECK( InNewThread(lookup("nokey")).status == 1 );
+  }
+}
@@ -0,0 +1,182 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// DBFingerprint_t                                                           //
+//                                                                           //
+// Test Podd::DBFingerprint, the record of database files used to decide     //
+// whether the database must be re-read for a new date                       //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CATCH3
+# include <catch2/catch_test_macros.hpp>
+#else
+# include <catch2/catch.hpp>
+#endif
+
+#include "Database.h"
+#include "TSystem.h"
+#include "TDatime.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace std;
+namespace fs = std::filesystem;
+using Podd::DBFingerprint;
+
+namespace {
+
+// Temporary database directory, set as $DB_DIR while this object exists
+class TempDBDir {
+public:
+  TempDBDir()
+    : fDir(fs::path(gSystem->TempDirectory()) /
+           ("DBFingerprint_t_" + to_string(gSystem->GetPid())))
+  {
+    fs::remove_all(fDir);
+    fs::create_directories(fDir / "DEFAULT");
+    if( const char* env = getenv("DB_DIR") ) { // NOLINT(*-mt-unsafe)
+      fHadEnv = true;
+      fSaveEnv = env;
+    }
+    setenv("DB_DIR", fDir.c_str(), 1);         // NOLINT(*-mt-unsafe)
+  }
+  ~TempDBDir()
+  {
+    if( fHadEnv )
+      setenv("DB_DIR", fSaveEnv.c_str(), 1);   // NOLINT(*-mt-unsafe)
+    else
+      unsetenv("DB_DIR");                      // NOLINT(*-mt-unsafe)
+    std::error_code ec;
+    fs::remove_all(fDir, ec);
+  }
+  TempDBDir( const TempDBDir& ) = delete;
+  TempDBDir& operator=( const TempDBDir& ) = delete;
+
+  fs::path Write( const fs::path& subdir, const string& file,
+                  const string& contents ) const
+  {
+    fs::create_directories(fDir / subdir);
+    auto path = fDir / subdir / file;
+    ofstream ofs(path, ios::trunc);
+    ofs << contents;
+    return path;
+  }
+
+private:
+  fs::path fDir;
+  string   fSaveEnv;
+  bool     fHadEnv{false};
+};
+
+// Record the database file 'name' read for 'date' in 'fp'
+void Record( DBFingerprint& fp, const char* name, const TDatime& date )
+{
+  DBFingerprint::Recorder rec(fp, date);
+  if( FILE* fi = Podd::OpenDBFile(name, date, "DBFingerprint_t", "r", 0) )
+    fclose(fi);
+  rec.Commit();
+}
+
+const string kContents =
+  "# Test database\n"
+  "a = 1\n"
+  "[ 2020-06-15 12:00:00 ]\n"
+  "a = 2\n"
+  "[ 2021-01-15 12:00:00 ]\n"
+  "a = 3\n";
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// Test cases                                                                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("DBFingerprint", "[Database]")
+{
+  TempDBDir db;
+  const string name = "fptest" + to_string(gSystem->GetPid());
+  const string file = "db_" + name + ".dat";
+  auto path = db.Write("DEFAULT", file, kContents);
+
+  DBFingerprint fp;
+  CHECK_FALSE( fp.IsValidFor(TDatime(20200301, 0)) );
+
+  SECTION("Unchanged inputs") {
+    Record(fp, name.c_str(), TDatime(20200301, 0));
+    CHECK( fp.GetNFiles() == 1 );
+    CHECK( fp.IsValidFor(TDatime(20200301, 0)) );
+    CHECK( fp.IsValidFor(TDatime(20200501, 120000)) );
+    CHECK( fp.IsValidFor(TDatime(20190101, 0)) );
+  }
+
+  SECTION("Incomplete recording") {
+    {
+      DBFingerprint::Recorder rec(fp, TDatime(20200301, 0));
+      if( FILE* fi = Podd::OpenDBFile(name.c_str(), TDatime(20200301, 0),
+                                      "DBFingerprint_t", "r", 0) )
+        fclose(fi);
+    }
+    CHECK( fp.GetNFiles() == 1 );
+    CHECK_FALSE( fp.IsValidFor(TDatime(20200301, 0)) );
+  }
+
+  SECTION("Time stamp boundary") {
+    Record(fp, name.c_str(), TDatime(20200301, 0));
+    CHECK( fp.IsValidFor(TDatime(20200615, 115959)) );
+    CHECK_FALSE( fp.IsValidFor(TDatime(20200615, 120000)) );
+    CHECK_FALSE( fp.IsValidFor(TDatime(20210201, 0)) );
+
+    Record(fp, name.c_str(), TDatime(20200701, 0));
+    CHECK( fp.IsValidFor(TDatime(20201201, 0)) );
+    CHECK_FALSE( fp.IsValidFor(TDatime(20200501, 0)) );
+    CHECK_FALSE( fp.IsValidFor(TDatime(20210201, 0)) );
+  }
+
+  SECTION("File modification") {
+    Record(fp, name.c_str(), TDatime(20200301, 0));
+    REQUIRE( fp.IsValidFor(TDatime(20200501, 0)) );
+
+    SECTION("Contents changed") {
+      db.Write("DEFAULT", file, kContents + "b = 4\n");
+      CHECK_FALSE( fp.IsValidFor(TDatime(20200501, 0)) );
+    }
+    SECTION("Same size, newer time") {
+      auto t = fs::last_write_time(path);
+      fs::last_write_time(path, t + chrono::seconds(1));
+      CHECK_FALSE( fp.IsValidFor(TDatime(20200501, 0)) );
+    }
+    SECTION("Removed") {
+      fs::remove(path);
+      CHECK_FALSE( fp.IsValidFor(TDatime(20200501, 0)) );
+    }
+  }
+
+  SECTION("Path resolution") {
+    Record(fp, name.c_str(), TDatime(20200301, 0));
+
+    SECTION("New date directory after recorded date") {
+      db.Write("20200501", file, kContents);
+      CHECK( fp.IsValidFor(TDatime(20200401, 0)) );
+      CHECK_FALSE( fp.IsValidFor(TDatime(20200515, 0)) );
+    }
+    SECTION("New date directory covering recorded date") {
+      db.Write("20200201", file, kContents);
+      CHECK_FALSE( fp.IsValidFor(TDatime(20200301, 0)) );
+    }
+    SECTION("File created where none was found") {
+      const string missing = name + "x";
+      DBFingerprint fp2;
+      Record(fp2, missing.c_str(), TDatime(20200301, 0));
+      CHECK( fp2.GetNFiles() == 1 );
+      CHECK( fp2.IsValidFor(TDatime(20200401, 0)) );
+      db.Write("DEFAULT", "db_" + missing + ".dat", kContents);
+      CHECK_FALSE( fp2.IsValidFor(TDatime(20200401, 0)) );
+    }
+  }
+}
@@ -0,0 +1,170 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// EpicsEvtHandler_t                                                         //
+//                                                                           //
+// Test the slow control service of THaEpicsEvtHandler: values of registered //
+// channels at the current physics event, last-known and interpolated,       //
+// including after old EPICS readings have been pruned from the history      //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CATCH3
+# include <catch2/catch_test_macros.hpp>
+# include <catch2/matchers/catch_matchers_floating_point.hpp>
+#else
+# include <catch2/catch.hpp>
+#endif
+
+#include "THaEpicsEvtHandler.h"
+#include "THaGlobals.h"
+#include "THaVarList.h"
+#include "THaVar.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+// Load an EPICS event with a reading of 'value' for channel "hac:bcm",
+// recorded at physics event 'event'
+void Load( THaEpicsEvtHandler& epics, ULong64_t event, Double_t value )
+{
+  string text = "Thu Oct 15 12:00:00 EDT 2026\nhac:bcm " + to_string(value)
+                + " uA\n";
+  // Event header (4 words) followed by the text, zero-padded to full words
+  size_t nwords = 4 + (text.size() + sizeof(UInt_t)) / sizeof(UInt_t);
+  vector<UInt_t> buf(nwords, 0);
+  buf[0] = static_cast<UInt_t>(nwords - 1);
+  memcpy(&buf[4], text.data(), text.size());
+  REQUIRE( epics.LoadData(buf.data(), event) == 1 );
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// Test cases                                                                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("EPICS slow control service", "[EPICS]")
+{
+  THaEpicsEvtHandler epics("epicstest", "EPICS slow control test");
+  Int_t id = epics.RegisterChannel("hac:bcm");
+  REQUIRE( id >= 0 );
+  CHECK( epics.RegisterChannel("hac:bcm") == id );
+  Int_t idx = epics.RegisterChannel("never_loaded");
+  REQUIRE( idx >= 0 );
+  CHECK( idx != id );
+
+  epics.UpdateChannels(1);
+  CHECK_FALSE( epics.IsValid(id) );
+
+  Load(epics, 10, 1.0);
+  Load(epics, 20, 2.0);
+  Load(epics, 30, 3.0);
+
+  struct Case_t { ULong64_t event; bool valid; Double_t value; };
+  auto check = [&]( const vector<Case_t>& cases ) {
+    for( const auto& c: cases ) {
+      INFO("event " << c.event);
+      epics.UpdateChannels(c.event);
+      CHECK( epics.IsValid(id) == c.valid );
+      if( c.valid )
+        CHECK( epics.GetValue(id) == c.value );
+      CHECK_FALSE( epics.IsValid(idx) );
+    }
+  };
+
+  SECTION("Cursor walk") {
+    check({
+      {  5, false, 0 },
+      { 10, true,  1 },
+      { 15, true,  1 },
+      { 20, true,  2 },
+      { 29, true,  2 },
+      { 30, true,  3 },
+      { 99, true,  3 },
+      // Backwards and across several entries
+      { 12, true,  1 },
+      {  9, false, 0 },
+      { 25, true,  2 },
+      { 10, true,  1 },
+      { 31, true,  3 }
+    });
+    // Readings loaded after the cursor has passed them
+    Load(epics, 40, 4.0);
+    check({
+      { 38, true, 3 },
+      { 40, true, 4 }
+    });
+  }
+
+  SECTION("Global variable") {
+    const THaVar* var = gHaVars->Find("epicstest.hac_bcm");
+    REQUIRE( var );
+    epics.UpdateChannels(22);
+    CHECK( var->GetValue() == 2 );
+  }
+
+  SECTION("Interpolation") {
+    Int_t ii = epics.RegisterChannel("hac:bcm", THaEpicsEvtHandler::kInterpolate);
+    REQUIRE( ii >= 0 );
+    CHECK( ii != id );
+    CHECK( epics.RegisterChannel("hac:bcm", THaEpicsEvtHandler::kInterpolate) == ii );
+    CHECK( gHaVars->Find("epicstest.hac_bcm_interp") );
+
+    struct ICase_t { ULong64_t event; bool valid; bool interp; Double_t value; };
+    const vector<ICase_t> cases = {
+      {  5, false, false, 0    },
+      { 10, true,  true,  1    },
+      { 15, true,  true,  1.5  },
+      { 28, true,  true,  2.8  },
+      { 30, true,  false, 3    },   // No later reading: last-known value
+      { 50, true,  false, 3    },
+      { 12, true,  true,  1.2  }
+    };
+    for( const auto& c: cases ) {
+      INFO("event " << c.event);
+      epics.UpdateChannels(c.event);
+      CHECK( epics.IsValid(ii) == c.valid );
+      CHECK( epics.IsInterpolated(ii) == c.interp );
+      if( c.valid )
+        CHECK_THAT( epics.GetValue(ii), Catch::Matchers::WithinRel(c.value) );
+      // The last-known channel is unaffected
+      CHECK_FALSE( epics.IsInterpolated(id) );
+    }
+    // A reading loaded later makes interpolation possible
+    Load(epics, 40, 5.0);
+    epics.UpdateChannels(35);
+    CHECK( epics.IsInterpolated(ii) );
+    CHECK_THAT( epics.GetValue(ii), Catch::Matchers::WithinRel(4.0) );
+    CHECK( epics.GetValue(id) == 3 );
+  }
+
+  SECTION("Pruning under the cursor") {
+    // Cursor at the entry for event 20 (index 1)
+    epics.UpdateChannels(25);
+    REQUIRE( epics.GetValue(id) == 2 );
+
+    // Prune the entries for events 10 and 20. The cursor index now refers
+    // to the entry for event 40.
+    epics.SetRetention(15);
+    Load(epics, 40, 4.0);
+    check({
+      { 35, true,  3 },
+      { 25, false, 0 },   // Reading at event 20 no longer available
+      { 45, true,  4 }
+    });
+
+    // Prune everything but the new entry. The cursor is beyond the end.
+    Load(epics, 100, 5.0);
+    check({
+      { 100, true,  5 },
+      {  50, false, 0 },
+      { 120, true,  5 }
+    });
+  }
+}
@@ -0,0 +1,182 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// EventPartition_t                                                          //
+//                                                                           //
+// Test Podd::EventPartition, the assignment of physics events to the        //
+// workers of an event-parallel replay, and the merge order of their output  //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CATCH3
+# include <catch2/catch_test_macros.hpp>
+#else
+# include <catch2/catch.hpp>
+#endif
+
+#include "EventPartition.h"
+#include "TSystem.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+using namespace std;
+using Podd::EventPartition;
+using Podd::WorkerReport;
+
+// Simulate a replay of 'nphys' physics events by 'nworkers' workers, each
+// filling its tree with every event of its own blocks for which 'pass' is
+// true. Returns the block ends of each worker and, in 'events', the
+// event numbers in each worker's tree.
+template<typename Pass>
+static vector<vector<Long64_t>>
+Replay( UInt_t nworkers, ULong64_t blocksize, ULong64_t nphys, Pass pass,
+        vector<vector<ULong64_t>>& events,
+        atomic<Long64_t>* stop = nullptr, Long64_t stop_at = -1 )
+{
+  vector<vector<Long64_t>> ends;
+  events.assign(nworkers, {});
+  for( UInt_t k = 0; k < nworkers; ++k ) {
+    EventPartition part(nworkers, k, blocksize);
+    part.SetStopFlag(stop);
+    auto& tree = events[k];
+    for( ULong64_t i = 0; i < nphys; ++i ) {
+      part.Next(i, tree.size());
+      if( part.IsStopped() )
+        break;
+      if( !part.IsMine(i) )
+        continue;
+      if( pass(i) )
+        tree.push_back(i);
+      if( static_cast<Long64_t>(i) == stop_at ) {
+        part.Stop();
+        break;
+      }
+    }
+    part.Finish(tree.size());
+    ends.push_back(part.GetBlockEnds());
+  }
+  return ends;
+}
+
+// Event numbers in merge order
+static vector<ULong64_t>
+Merged( const vector<vector<Long64_t>>& ends,
+        const vector<vector<ULong64_t>>& events, Long64_t lastblock = -1 )
+{
+  vector<ULong64_t> merged;
+  for( const auto& r : EventPartition::MergeOrder(ends, lastblock) ) {
+    for( Long64_t i = r.first; i < r.last; ++i )
+      merged.push_back(events[r.worker][i]);
+  }
+  return merged;
+}
+
+TEST_CASE("EventPartition assignment", "[EventPartition]")
+{
+  EventPartition part(3, 1, 10);
+  CHECK( part.GetNWorkers() == 3 );
+  CHECK( part.GetWorker() == 1 );
+  CHECK( part.GetBlockSize() == 10 );
+  CHECK( part.Block(0) == 0 );
+  CHECK( part.Block(19) == 1 );
+  CHECK( part.Owner(9) == 0 );
+  CHECK( part.Owner(10) == 1 );
+  CHECK( part.Owner(35) == 0 );
+  CHECK( part.IsMine(15) );
+  CHECK( part.IsMine(45) );
+  CHECK_FALSE( part.IsMine(25) );
+  CHECK( part.GetCurrentBlock() == -1 );
+  CHECK_FALSE( part.IsStopped() );
+
+  EventPartition dflt(2, 0);
+  CHECK( dflt.GetBlockSize() == EventPartition::kDefaultBlockSize );
+}
+
+TEST_CASE("EventPartition merge order", "[EventPartition]")
+{
+  vector<vector<ULong64_t>> events;
+  for( UInt_t nworkers : {1U, 2U, 3U, 5U} ) {
+    for( ULong64_t nphys : {0ULL, 7ULL, 100ULL, 1001ULL} ) {
+      INFO("workers " << nworkers << ", events " << nphys);
+      // Every third event passes the output cuts
+      auto ends = Replay(nworkers, 10, nphys,
+                         []( ULong64_t i ) { return i % 3 != 1; }, events);
+      vector<ULong64_t> expected;
+      for( ULong64_t i = 0; i < nphys; ++i )
+        if( i % 3 != 1 )
+          expected.push_back(i);
+      CHECK( Merged(ends, events) == expected );
+    }
+  }
+  // Blocks without any output entries
+  auto ends = Replay(3, 4, 40, []( ULong64_t i ) { return i < 4 || i > 30; },
+                     events);
+  CHECK( Merged(ends, events) ==
+         vector<ULong64_t>{0, 1, 2, 3, 31, 32, 33, 34, 35, 36, 37, 38, 39} );
+  CHECK( EventPartition::MergeOrder({}).empty() );
+}
+
+TEST_CASE("EventPartition stop", "[EventPartition]")
+{
+  vector<vector<ULong64_t>> events;
+  atomic<Long64_t> stop{kMaxLong64};
+  // Worker 2 terminates at event 53 in block 5. The other workers
+  // replay before it, so they do not see the stop flag.
+  auto ends = Replay(3, 10, 200, []( ULong64_t ) { return true; }, events,
+                     &stop, 53);
+  REQUIRE( stop.load() == 5 );
+  // Workers 0 and 1 finish all blocks since they do not know about the
+  // stop; the merge ends after block 5.
+  vector<ULong64_t> expected;
+  for( ULong64_t i = 0; i <= 53; ++i )
+    expected.push_back(i);
+  CHECK( Merged(ends, events, stop.load()) == expected );
+
+  // Workers started after the stop skip all blocks after the last one
+  EventPartition part(3, 0, 10);
+  part.SetStopFlag(&stop);
+  part.Next(59, 0);
+  CHECK_FALSE( part.IsStopped() );
+  part.Next(60, 0);
+  CHECK( part.IsStopped() );
+
+  // An earlier stop wins
+  EventPartition part1(3, 1, 10);
+  part1.SetStopFlag(&stop);
+  part1.Next(15, 0);
+  part1.Stop();
+  CHECK( stop.load() == 1 );
+  part.Stop();
+  CHECK( stop.load() == 1 );
+}
+
+TEST_CASE("WorkerReport round trip", "[EventPartition]")
+{
+  WorkerReport rep;
+  rep.counters = {10, 0, 1ULL << 40};
+  rep.ncalled = {5, 6};
+  rep.npassed = {1, 2};
+  rep.blockends = {3, 17, 40};
+  rep.nev = 123;
+  rep.nanalyzed = 45;
+  rep.status = -1;
+  rep.terminate = true;
+
+  string path = string(gSystem->TempDirectory()) + "/EventPartition_t." +
+                to_string(gSystem->GetPid()) + ".rep";
+  REQUIRE( rep.Write(path) );
+  WorkerReport in;
+  REQUIRE( in.Read(path) );
+  CHECK( in.counters == rep.counters );
+  CHECK( in.ncalled == rep.ncalled );
+  CHECK( in.npassed == rep.npassed );
+  CHECK( in.blockends == rep.blockends );
+  CHECK( in.nev == rep.nev );
+  CHECK( in.nanalyzed == rep.nanalyzed );
+  CHECK( in.status == rep.status );
+  CHECK( in.terminate );
+  CHECK_FALSE( in.fatal );
+  gSystem->Unlink(path.c_str());
+
+  CHECK_FALSE( in.Read(path) );
+}
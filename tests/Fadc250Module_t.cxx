@@ -0,0 +1,174 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// Fadc250Module_t                                                           //
+//                                                                           //
+// Test storage and unpacking of per-event data in Decoder::Fadc250Module    //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CATCH3
+# include <catch2/catch_test_macros.hpp>
+#else
+# include <catch2/catch.hpp>
+#endif
+
+#include "Fadc250Module.h"
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdint>
+
+using namespace std;
+using namespace Decoder;
+
+namespace {
+
+const UInt_t kSlot = 5;
+
+//_____________________________________________________________________________
+// Mode 10 data: raw samples plus npulse pulses for each channel in 'chans'
+vector<UInt_t> MakeEvent( const vector<UInt_t>& chans, UInt_t nsamples,
+                          UInt_t npulse, UInt_t seed )
+{
+  vector<UInt_t> w{
+    0x80000000U | (kSlot << 22),  // Block header
+    0x80000000U | (2U << 27)      // Event header
+  };
+  for( auto chan : chans ) {
+    w.push_back(0x80000000U | (4U << 27) | (chan << 23) | nsamples);
+    for( UInt_t i = 0; i < nsamples; i += 2 )
+      w.push_back(((seed + chan + i) << 16) | (seed + chan + i + 1));
+  }
+  for( auto chan : chans ) {
+    w.push_back(0x80000000U | (9U << 27) | (chan << 15) | (seed + chan));
+    for( UInt_t k = 0; k < npulse; ++k ) {
+      w.push_back((1U << 30) | ((1000 + seed + k) << 12));
+      w.push_back(((chan + k) << 15) | ((200 + k) << 3));
+    }
+  }
+  return w;
+}
+
+//_____________________________________________________________________________
+// Window raw data with random samples, including invalid and overflow flags.
+// Odd-length windows end with an invalid padding sample.
+vector<UInt_t> MakeRandomWindows( mt19937& gen, UInt_t nsamples )
+{
+  uniform_int_distribution<UInt_t> rnd(0, 0x3FFF);
+  vector<UInt_t> w{
+    0x80000000U | (kSlot << 22),
+    0x80000000U | (2U << 27)
+  };
+  for( UInt_t chan = 0; chan < 16; ++chan ) {
+    w.push_back(0x80000000U | (4U << 27) | (chan << 23) | nsamples);
+    for( UInt_t i = 0; i < nsamples; i += 2 ) {
+      UInt_t s1 = rnd(gen), s2 = (i + 1 < nsamples) ? rnd(gen) : 0x2000;
+      w.push_back((s1 << 16) | s2);
+    }
+  }
+  return w;
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// Test cases                                                                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Fadc250Module pulse data", "[Decoder]")
+{
+  Fadc250Module fadc(1, kSlot);
+  const vector<UInt_t> chans{ 3, 0, 15, 7 };
+
+  // Repeat with varying sizes to exercise reuse and growth of the buffer
+  for( UInt_t npulse : { 1U, 4U, 9U, 2U } ) {
+    for( UInt_t nsamples : { 6U, 100U, 2U } ) {
+      UInt_t seed = npulse * 10 + nsamples;
+      INFO("npulse = " << npulse << ", nsamples = " << nsamples);
+      fadc.Clear();
+      for( auto word : MakeEvent(chans, nsamples, npulse, seed) )
+        fadc.Decode(&word);
+
+      CHECK( fadc.GetFadcMode() == 10 );
+      for( UInt_t chan = 0; chan < 16; ++chan ) {
+        bool active = find(chans.begin(), chans.end(), chan) != chans.end();
+        auto samples = fadc.GetPulseSamples(chan);
+        auto integral = fadc.GetPulseData(kPulseIntegral, chan);
+        auto peak = fadc.GetPulseData(kPulsePeak, chan);
+        auto time = fadc.GetPulseData(kPulseTime, chan);
+        auto ped = fadc.GetPulseData(kPulsePedestal, chan);
+        if( !active ) {
+          CHECK( samples.empty() );
+          CHECK( integral.empty() );
+          CHECK( ped.empty() );
+          continue;
+        }
+        REQUIRE( samples.size() == nsamples );
+        for( UInt_t i = 0; i < nsamples; ++i )
+          CHECK( samples[i] == seed + chan + i );
+        CHECK( fadc.GetPulseSamplesVector(chan) ==
+               vector<uint32_t>(samples.begin(), samples.end()) );
+
+        REQUIRE( integral.size() == npulse );
+        REQUIRE( peak.size() == npulse );
+        REQUIRE( time.size() == npulse );
+        CHECK( fadc.GetOverflowBits(chan).size() == npulse );
+        CHECK( fadc.GetNumFadcEvents(chan) == npulse );
+        for( UInt_t k = 0; k < npulse; ++k ) {
+          CHECK( integral[k] == 1000 + seed + k );
+          CHECK( peak[k] == 200 + k );
+          CHECK( time[k] == chan + k );
+          CHECK( fadc.GetPulseIntegralData(chan, k) == integral[k] );
+        }
+        REQUIRE( ped.size() == 1 );
+        CHECK( ped[0] == seed + chan );
+      }
+    }
+  }
+}
+
+//_____________________________________________________________________________
+TEST_CASE("Fadc250Module window raw data", "[Decoder]")
+{
+  // LoadSlot unpacks windows in bulk, Decode one word at a time.
+  // Both must give the same result.
+
+  Fadc250Module bulk(1, kSlot), single(1, kSlot);
+  mt19937 gen(4711);
+
+  for( UInt_t nsamples : { 1U, 2U, 3U, 17U, 32U, 33U, 100U, 255U } ) {
+    INFO("nsamples = " << nsamples);
+    auto words = MakeRandomWindows(gen, nsamples);
+    bulk.Clear();
+    single.Clear();
+    bulk.LoadSlot(nullptr, words.data(), 0, words.size());
+    for( auto word : words )
+      single.Decode(&word);
+
+    for( UInt_t chan = 0; chan < 16; ++chan ) {
+      auto samples = bulk.GetPulseSamples(chan);
+      auto ref = single.GetPulseSamples(chan);
+      REQUIRE( samples.size() == nsamples );
+      REQUIRE( vector<uint32_t>(samples.begin(), samples.end()) ==
+               vector<uint32_t>(ref.begin(), ref.end()) );
+
+      UInt_t sum = 0, pedsum = 0, peak = 0;
+      bool overflow = false;
+      for( UInt_t i = 0; i < nsamples; ++i ) {
+        sum += samples[i];
+        if( i < bulk.GetNumPedestalSamples() )
+          pedsum += samples[i];
+        peak = max(peak, samples[i] & 0xFFF);
+        overflow |= (samples[i] & 0x1000) != 0;
+      }
+      for( const auto* m : { &bulk, &single } ) {
+        CHECK( m->GetEmulatedPulseIntegralData(chan) == sum );
+        CHECK( m->GetEmulatedPedestalData(chan) == pedsum );
+        CHECK( m->GetEmulatedPulsePeakData(chan) == peak );
+        CHECK( m->GetSampleOverflow(chan) == overflow );
+      }
+    }
+  }
+}
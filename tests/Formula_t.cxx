@@ -18,6 +18,8 @@
 
 #include "THaFormula.h"
 #include "THaVarList.h"
+#include "THaCutList.h"
+#include "FormulaJIT.h"
 #include "TError.h"
 #include "DataType.h"   // kBig
 #include <memory>
@@ -204,3 +206,242 @@ TEST_CASE("Formulas of Global Vector Variables", "[Formula]") // NOLINT(*-functi
 
   delete [] ai;
 }
+
+TEST_CASE("Bytecode Agrees With Interpreter", "[Formula]") // NOLINT(*-function-cognitive-complexity)
+{
+  auto vars = make_shared<THaVarList>();
+
+  Int_t i = 5;
+  Short_t s = -3;
+  Float_t f = 0.75F;
+  Double_t d = 2.5;
+  vector<Int_t> vi = {7, 8, -11, -22, 43, 19, 0, 4 };
+  vector<Double_t> vd(150);
+  for( size_t k = 0; k < vd.size(); ++k )
+    vd[k] = 0.5 * static_cast<Double_t>(k) - 20.;
+  vars->Define("i", i);
+  vars->Define("s", s);
+  vars->Define("f", f);
+  vars->Define("d", d);
+  vars->Define("vi", "vector<int>", vi);
+  vars->Define("vd", "vector<double>", vd);
+
+  const char* const exprs[] = {
+    "2*i-s/f+d", "i%3+(s<0)-(f>=1)", "i>0&&d/0==0", "s>0||f<1", "!(i==5)",
+    "abs(s)+sqrt(d)+log(f)+exp(-d)", "atan2(s,i)+pow(d,1.5)", "(i&6)|(1<<s+5)",
+    "vi*2+i", "vd**2-vi", "vi>0&&vi<10", "Sum$(vd)", "Mean$(vi*d)",
+    "Length$(vi)", "Max$(vd)-Min$(vd)", "vd*Iteration$", "NumSetBits$(vi)"
+  };
+
+  for( const char* expr : exprs ) {
+    INFO("Expression " << expr);
+    THaFormula::SetBytecode(false);
+    THaFormula fold("fold", expr, false, vars.get());
+    THaFormula::SetBytecode(true);
+    THaFormula fnew("fnew", expr, false, vars.get());
+    REQUIRE_FALSE(fold.IsError());
+    REQUIRE_FALSE(fnew.IsError());
+    CHECK_FALSE(fold.HasBytecode());
+    CHECK(fnew.HasBytecode());
+    REQUIRE(fnew.GetNdata() == fold.GetNdata());
+    vector<Double_t> all;
+    CHECK(fnew.EvalAll(all) == fnew.GetNdata());
+    for( Int_t k = 0; k < fold.GetNdata(); ++k ) {
+      Double_t y = fold.EvalInstance(k);
+      auto same = Catch::Matchers::WithinRel(y, 1e-12) ||
+                  Catch::Matchers::WithinAbs(y, 1e-12);
+      CHECK_THAT(fnew.EvalInstance(k), same);
+      CHECK_THAT(all[k], same);
+    }
+    CHECK_THAT(fnew.EvalInstance(fold.GetNdata()), Catch::Matchers::WithinRel(kBig));
+  }
+}
+
+TEST_CASE("Compiled Cuts Agree With Interpreter", "[Formula]") // NOLINT(*-function-cognitive-complexity)
+{
+  auto vars = make_unique<THaVarList>();
+
+  Int_t i = 5;
+  Float_t f = 0.75F;
+  Double_t d = 2.5;
+  vector<Int_t> vi = {7, 8, -11};
+  vars->Define("i", i);
+  vars->Define("f", f);
+  vars->Define("d", d);
+  vars->Define("vi", "vector<int>", vi);
+
+  THaCutList cuts(vars.get());
+  REQUIRE(cuts.Define("pre", "d>0", "Pre") == 0);
+  REQUIRE(cuts.Define("c1", "i>3&&f<1", "Test") == 0);
+  REQUIRE(cuts.Define("c2", "c1&&pre&&d*2>4", "Test") == 0);
+  REQUIRE(cuts.Define("c3", "!c2||abs(i-d)>10", "Test") == 0);
+  REQUIRE(cuts.Define("c4", "sqrt(d)*f>1||i%3==1", "Test") == 0);
+  REQUIRE(cuts.Define("c5", "0.4*c4", "Test") == 0);
+  REQUIRE(cuts.Define("v1", "vi>0", "Vector") == 0);
+  const char* const names[] = { "c1", "c2", "c3", "c4", "c5" };
+
+  Podd::FormulaJIT vjit("Vector");
+  CHECK_FALSE(vjit.AddBlock(cuts.FindBlock("Vector")));
+
+  Podd::FormulaJIT jit("Test");
+  REQUIRE(jit.AddBlock(cuts.FindBlock("Test")));
+  REQUIRE(jit.Compile());
+  CHECK(jit.GetSize() == 5);
+
+  const Double_t values[][3] = {
+    {5, 0.75, 2.5}, {2, 0.75, 2.5}, {5, 1.5, 2.5}, {5, 0.75, -1},
+    {4, 0.5, 9}, {-20, 0.1, 1}, {7, 0.9, 1.8}
+  };
+  for( const auto& v : values ) {
+    i = static_cast<Int_t>(v[0]);
+    f = static_cast<Float_t>(v[1]);
+    d = v[2];
+    INFO("i = " << i << ", f = " << f << ", d = " << d);
+    cuts.EvalBlock("Pre");
+    cuts.EvalBlock("Test");
+    vector<Bool_t> interpreted;
+    for( const char* name : names )
+      interpreted.push_back(cuts.FindCut(name)->GetResult());
+    jit.Eval();
+    for( size_t k = 0; k < interpreted.size(); ++k ) {
+      INFO("Cut " << names[k]);
+      CHECK(cuts.FindCut(names[k])->GetResult() == interpreted[k]);
+      CHECK(jit.GetResult(static_cast<Int_t>(k)) == interpreted[k]);
+    }
+  }
+  for( const char* name : names ) {
+    const THaCut* cut = cuts.FindCut(name);
+    CHECK(cut->GetNCalled() == 2 * std::size(values));
+    CHECK(cut->GetNPassed() % 2 == 0);
+  }
+}
+
+TEST_CASE("Lazy Cut Evaluation", "[Formula]")
+{
+  auto vars = make_unique<THaVarList>();
+
+  Int_t i = 5;
+  Double_t d = 2.5;
+  vars->Define("i", i);
+  vars->Define("d", d);
+
+  THaCutList cuts(vars.get());
+  REQUIRE(cuts.Define("pre", "d>0", "Pre") == 0);
+  REQUIRE(cuts.Define("c1", "i>3", "Test") == 0);
+  REQUIRE(cuts.Define("c2", "c1&&pre", "Test") == 0);
+  REQUIRE(cuts.Define("Test_master", "c2", "Test") == 0);
+  REQUIRE(cuts.Define("unused", "d<10", "Test") == 0);
+  THaCut* c1 = cuts.FindCut("c1");
+  THaCut* c2 = cuts.FindCut("c2");
+  THaCut* master = cuts.FindCut("Test_master");
+  THaCut* unused = cuts.FindCut("unused");
+  THaCutBlock* block = cuts.FindBlock("Test");
+  REQUIRE(block);
+  block->SetMaster(master);
+
+  CHECK(c2->GetCutDependencies() == vector<THaCut*>{c1, cuts.FindCut("pre")});
+  CHECK(c2->GetVarDependencies().empty());
+  REQUIRE(c1->GetVarDependencies().size() == 1);
+  CHECK(c1->GetVarDependencies()[0] == vars->Find("i"));
+
+  cuts.SetEvalMode(THaCutList::kLazy);
+  for( Int_t ev = 0; ev < 4; ++ev ) {
+    i = ev + 2;
+    cuts.ClearAll();
+    CHECK_FALSE(c1->IsCurrent());
+    CHECK_FALSE(c1->GetResult());  // block not yet reached
+    cuts.EvalBlock("Pre");
+    cuts.EvalBlock("Test");
+    CHECK(master->IsCurrent());
+    CHECK(c1->IsCurrent());
+    CHECK_FALSE(unused->IsCurrent());
+    CHECK(master->GetResult() == (i > 3));
+    cuts.EvalBlock("Test");      // master already current
+  }
+  CHECK(c1->GetNCalled() == 4);
+  CHECK(master->GetNCalled() == 4);
+  CHECK(master->GetNPassed() == 2);
+  CHECK(unused->GetNCalled() == 0);
+  CHECK(unused->GetResult());    // evaluated on demand
+  CHECK(unused->GetNCalled() == 1);
+  CHECK(unused->GetResult());
+  CHECK(unused->GetNCalled() == 1);
+
+  cuts.ClearBlock("Test");
+  CHECK_FALSE(unused->GetResult());
+  CHECK(unused->GetNCalled() == 1);
+
+  cuts.SetEvalMode(THaCutList::kEager);
+  cuts.ClearAll();
+  cuts.EvalBlock("Pre");
+  cuts.EvalBlock("Test");
+  CHECK(unused->IsCurrent());
+  CHECK(unused->GetNCalled() == 2);
+}
+
+TEST_CASE("Compiled Cut Blocks in Eager and Lazy Mode", "[Formula]")
+{
+  auto vars = make_unique<THaVarList>();
+
+  Int_t i = 5;
+  Double_t d = 2.5;
+  vars->Define("i", i);
+  vars->Define("d", d);
+
+  THaCutList cuts(vars.get());
+  REQUIRE(cuts.Define("pre", "d>0", "Pre") == 0);
+  REQUIRE(cuts.Define("c1", "i>3", "Test") == 0);
+  REQUIRE(cuts.Define("Test_master", "c1&&pre", "Test") == 0);
+  REQUIRE(cuts.Define("unused", "d<10", "Test") == 0);
+  THaCut* master = cuts.FindCut("Test_master");
+  THaCut* unused = cuts.FindCut("unused");
+  THaCutBlock* block = cuts.FindBlock("Test");
+  REQUIRE(block);
+  block->SetMaster(master);
+
+  auto jit = make_shared<Podd::FormulaJIT>("TestBlock");
+  REQUIRE(jit->AddBlock(block));
+  REQUIRE(jit->Compile());
+  block->SetCompiled(jit);
+  REQUIRE(block->IsCompiled());
+
+  // Eager: all cuts evaluated by the compiled code
+  for( Int_t ev = 0; ev < 4; ++ev ) {
+    i = ev + 2;
+    cuts.ClearAll();
+    CHECK_FALSE(block->IsOpen());
+    cuts.EvalBlock("Pre");
+    cuts.EvalBlock("Test");
+    CHECK(block->IsOpen());
+    CHECK(master->IsCurrent());
+    CHECK(unused->IsCurrent());
+    CHECK(master->GetResult() == (i > 3));
+    CHECK(jit->GetResult(1) == (i > 3));
+  }
+  CHECK(master->GetNCalled() == 4);
+  CHECK(unused->GetNCalled() == 4);
+
+  // Lazy: only the master cut and its dependencies, on demand
+  cuts.SetEvalMode(THaCutList::kLazy);
+  i = 2;
+  cuts.ClearAll();
+  cuts.EvalBlock("Pre");
+  cuts.EvalBlock("Test");
+  CHECK(block->IsOpen());
+  CHECK(master->IsCurrent());
+  CHECK_FALSE(master->GetResult());
+  CHECK_FALSE(unused->IsCurrent());
+  CHECK(master->GetNCalled() == 5);
+  CHECK(unused->GetNCalled() == 4);
+  CHECK(unused->GetResult());    // evaluated on demand
+  CHECK(unused->GetNCalled() == 5);
+
+  // Changing the block drops the compiled code
+  REQUIRE(cuts.Remove("unused") == 1);
+  cuts.SetEvalMode(THaCutList::kEager);
+  cuts.ClearAll();
+  cuts.EvalBlock("Pre");
+  cuts.EvalBlock("Test");
+  CHECK_FALSE(block->IsCompiled());
+  CHECK(master->GetNCalled() == 6);
+}
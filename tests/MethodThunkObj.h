@@ -0,0 +1,66 @@
+#ifndef Podd_Tests_MethodThunkObj_h_
+#define Podd_Tests_MethodThunkObj_h_
+
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// Test classes for MethodThunk_t tests                                      //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TObject.h"
+
+namespace Podd::Tests {
+
+class ThunkBase : public TObject {
+public:
+  explicit ThunkBase( Double_t x = 0.0 ) : fX(x) {}
+  Double_t      X()    const { return fX; }  // non-virtual
+  virtual Int_t GetN() const { return 1; }
+
+  Double_t fX;
+
+  ClassDef(ThunkBase,0)
+};
+
+// Inherits X() and overrides GetN()
+class ThunkDerived : public ThunkBase {
+public:
+  explicit ThunkDerived( Double_t x = 0.0 ) : ThunkBase(x) {}
+  virtual Int_t GetN() const { return 2; }
+
+  ClassDef(ThunkDerived,0)
+};
+
+// Hides ThunkBase::X()
+class ThunkHiding : public ThunkBase {
+public:
+  explicit ThunkHiding( Double_t x = 0.0 ) : ThunkBase(x) {}
+  Double_t X() const { return -fX; }
+
+  ClassDef(ThunkHiding,0)
+};
+
+class ThunkMixin {
+public:
+  ThunkMixin() : fTag(7) {}
+  virtual ~ThunkMixin() = default;
+  Int_t Tag() const { return fTag; }
+
+  Int_t fTag;
+
+  ClassDef(ThunkMixin,0)
+};
+
+// ThunkMixin is a base class at a non-zero offset
+class ThunkMulti : public ThunkDerived, public ThunkMixin {
+public:
+  explicit ThunkMulti( Double_t x = 0.0 ) : ThunkDerived(x) {}
+
+  ClassDef(ThunkMulti,0)
+};
+
+} // namespace Podd::Tests
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif
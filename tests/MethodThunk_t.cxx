@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// MethodThunk_t                                                             //
+//                                                                           //
+// Test lookup of Podd::MethodThunk through base classes                     //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CATCH3
+# include <catch2/catch_test_macros.hpp>
+#else
+# include <catch2/catch.hpp>
+#endif
+
+#include "MethodThunk.h"
+#include "MethodThunkObj.h"
+
+using namespace std;
+using Podd::MethodThunk;
+using namespace Podd::Tests;
+
+TEST_CASE("MethodThunk", "[MethodThunk]")
+{
+  REQUIRE( MethodThunk::Register<&ThunkBase::X>("X") );
+  REQUIRE( MethodThunk::Register<&ThunkBase::GetN>("GetN") );
+  REQUIRE( MethodThunk::Register<&ThunkMixin::Tag>("Tag") );
+
+  SECTION("Class itself") {
+    auto thunk = MethodThunk::Find(ThunkBase::Class(), "X");
+    REQUIRE( thunk );
+    CHECK( thunk.GetType() == kDouble );
+    ThunkBase obj(1.5);
+    Double_t x = 0;
+    thunk.Call(&obj, &x);
+    CHECK( x == 1.5 );
+    CHECK_FALSE( MethodThunk::Find(ThunkBase::Class(), "Y") );
+  }
+
+  SECTION("Inherited non-virtual function") {
+    auto thunk = MethodThunk::Find(ThunkDerived::Class(), "X");
+    REQUIRE( thunk );
+    ThunkDerived obj(2.5);
+    Double_t x = 0;
+    thunk.Call(&obj, &x);
+    CHECK( x == 2.5 );
+  }
+
+  SECTION("Overridden virtual function") {
+    auto thunk = MethodThunk::Find(ThunkDerived::Class(), "GetN");
+    REQUIRE( thunk );
+    CHECK( thunk.GetType() == kInt );
+    ThunkDerived obj;
+    Int_t n = 0;
+    thunk.Call(&obj, &n);
+    CHECK( n == 2 );
+  }
+
+  SECTION("Hidden function") {
+    CHECK_FALSE( MethodThunk::Find(ThunkHiding::Class(), "X") );
+  }
+
+  SECTION("Base class at non-zero offset") {
+    ThunkMulti obj(3.5);
+    auto thunk = MethodThunk::Find(ThunkMulti::Class(), "Tag");
+    REQUIRE( thunk );
+    Int_t tag = 0;
+    thunk.Call(&obj, &tag);
+    CHECK( tag == 7 );
+
+    thunk = MethodThunk::Find(ThunkMulti::Class(), "X");
+    REQUIRE( thunk );
+    Double_t x = 0;
+    thunk.Call(&obj, &x);
+    CHECK( x == 3.5 );
+  }
+}
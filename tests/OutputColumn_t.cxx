@@ -0,0 +1,123 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// OutputColumn_t                                                            //
+//                                                                           //
+// Test THaOcolumn, which copies global variables into tree branch buffers   //
+// of their native type                                                      //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CATCH3
+# include <catch2/catch_test_macros.hpp>
+#else
+# include <catch2/catch.hpp>
+#endif
+
+#include "THaOutput.h"
+#include "THaVarList.h"
+#include "THaVar.h"
+#include "THaGlobals.h"   // gHaVars
+#include "DataType.h"     // kBig
+#include <vector>
+#include <cstring>
+
+using namespace std;
+
+namespace {
+
+//_____________________________________________________________________________
+template<typename T>
+vector<T> Contents( const THaOcolumn& col )
+{
+  vector<T> v(col.GetNdata());
+  memcpy(v.data(), col.GetData(), v.size() * sizeof(T));
+  return v;
+}
+
+} // namespace
+
+TEST_CASE("THaOcolumn leaf types", "[Output]")
+{
+  CHECK( THaOcolumn::LeafType(kDouble)  == 'D' );
+  CHECK( THaOcolumn::LeafType(kFloatP)  == 'F' );
+  CHECK( THaOcolumn::LeafType(kInt2P)   == 'I' );
+  CHECK( THaOcolumn::LeafType(kUIntV)   == 'i' );
+  CHECK( THaOcolumn::LeafType(kShort)   == 'S' );
+  CHECK( THaOcolumn::LeafType(kUShortP) == 's' );
+  CHECK( THaOcolumn::LeafType(kChar)    == 'B' );
+  CHECK( THaOcolumn::LeafType(kUChar)   == 'b' );
+  CHECK( THaOcolumn::LeafType(kFloatV)  == 'F' );
+  CHECK( THaOcolumn::LeafType(kObject)  == 'D' );
+  CHECK( THaOcolumn::LeafType(kTString) == 'D' );
+}
+
+TEST_CASE("THaOcolumn copies native data", "[Output]")
+{
+  REQUIRE( gHaVars );
+  Int_t n = 3;
+  Int_t arr[8] = { 1, -2, 3, kMinInt, 5, 6, 7, 8 };
+  vector<Float_t> vec{ 1.5F, 2.5F };
+  Short_t sval = -7;
+  const auto* varr = gHaVars->Define("test.arr", arr[0], &n);
+  const auto* vvec = gHaVars->Define("test.vec", vec);
+  const auto* vsca = gHaVars->Define("test.short", sval);
+  REQUIRE( varr );
+  REQUIRE( vvec );
+  REQUIRE( vsca );
+
+  SECTION("Variable-size array") {
+    THaOcolumn col("test.arr", true, THaOcolumn::LeafType(varr->GetType()));
+    CHECK( col.GetLeafType() == 'I' );
+    col.Attach(varr);
+    CHECK( col.Fill() == 1 );
+    CHECK( Contents<Int_t>(col) == vector<Int_t>{ 1, -2, 3 } );
+    n = 8;
+    CHECK( col.Fill() == 1 );
+    CHECK( Contents<Int_t>(col) == vector<Int_t>(arr, arr + 8) );
+    n = 0;
+    CHECK( col.Fill() == 1 );
+    CHECK( col.GetNdata() == 0 );
+  }
+
+  SECTION("Vector") {
+    THaOcolumn col("test.vec", true, THaOcolumn::LeafType(vvec->GetType()));
+    CHECK( col.GetLeafType() == 'F' );
+    col.Attach(vvec);
+    CHECK( col.Fill() == 1 );
+    CHECK( Contents<Float_t>(col) == vec );
+    vec.assign(100, 0.25F);
+    CHECK( col.Fill() == 1 );
+    CHECK( Contents<Float_t>(col) == vec );
+  }
+
+  SECTION("Scalar") {
+    THaOcolumn col("test.short", false, THaOcolumn::LeafType(vsca->GetType()));
+    CHECK( col.GetLeafType() == 'S' );
+    col.Attach(vsca);
+    CHECK( col.Fill() == 1 );
+    CHECK( Contents<Short_t>(col) == vector<Short_t>{ -7 } );
+  }
+
+  SECTION("Conversion to Double_t") {
+    THaOcolumn col("test.arr", true, 'D');
+    col.Attach(varr);
+    n = 4;
+    CHECK( col.Fill() == 1 );
+    CHECK( Contents<Double_t>(col) == vector<Double_t>{ 1, -2, 3, kBig } );
+  }
+
+  SECTION("No-data marker in Double_t data copied directly") {
+    Double_t darr[3] = { 1.5, kMinInt, -2 };
+    const auto* vd = gHaVars->Define("test.darr[3]", darr[0]);
+    REQUIRE( vd );
+    THaOcolumn col("test.darr", true, THaOcolumn::LeafType(vd->GetType()));
+    col.Attach(vd);
+    CHECK( col.Fill() == 1 );
+    CHECK( Contents<Double_t>(col) == vector<Double_t>{ 1.5, kBig, -2 } );
+    gHaVars->RemoveName("test.darr");
+  }
+
+  gHaVars->RemoveName("test.arr");
+  gHaVars->RemoveName("test.vec");
+  gHaVars->RemoveName("test.short");
+}
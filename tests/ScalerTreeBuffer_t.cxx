@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// ScalerTreeBuffer_t                                                        //
+//                                                                           //
+// Test Podd::ScalerTreeBuffer, the typed scaler tree branch written by the  //
+// scaler event handlers if enabled                                          //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CATCH3
+# include <catch2/catch_test_macros.hpp>
+#else
+# include <catch2/catch.hpp>
+#endif
+
+#include "ScalerTreeBuffer.h"
+#include "TTree.h"
+#include "TLeaf.h"
+#include <memory>
+#include <string>
+
+using namespace std;
+using Podd::ScalerTreeBuffer;
+
+TEST_CASE("ScalerTreeBuffer", "[Scaler]")
+{
+  CHECK_FALSE( ScalerTreeBuffer::TypedBranchesEnabled() );
+
+  auto tree = make_unique<TTree>("TStest", "Scaler tree test");
+  tree->SetDirectory(nullptr);
+
+  ScalerTreeBuffer buf;
+  // Mixed order of 4- and 8-byte leaves
+  REQUIRE( buf.Add("evcount", ScalerTreeBuffer::kULong64) == 0 );
+  REQUIRE( buf.Add("bcm",     ScalerTreeBuffer::kUInt)    == 1 );
+  REQUIRE( buf.Add("bcmr",    ScalerTreeBuffer::kDouble)  == 2 );
+  REQUIRE( buf.Add("clk",     ScalerTreeBuffer::kUInt)    == 3 );
+  REQUIRE( buf.Add("clkr",    ScalerTreeBuffer::kDouble)  == 4 );
+  CHECK( buf.GetSize() == 5 );
+  CHECK_FALSE( buf.HasBranch() );
+
+  REQUIRE( buf.Branch(tree.get(), "scalers", 32000) );
+  CHECK( buf.HasBranch() );
+  CHECK( buf.Add("late", ScalerTreeBuffer::kDouble) == -1 );
+  CHECK( tree->GetListOfBranches()->GetEntries() == 1 );
+
+  struct Leaf_t { const char* name; const char* type; };
+  for( const auto& l : { Leaf_t{"evcount", "ULong64_t"}, {"bcm", "UInt_t"},
+                         {"bcmr", "Double_t"}, {"clk", "UInt_t"},
+                         {"clkr", "Double_t"} } ) {
+    INFO("leaf " << l.name);
+    TLeaf* leaf = tree->GetLeaf(l.name);
+    REQUIRE( leaf );
+    CHECK( string(leaf->GetTypeName()) == l.type );
+  }
+
+  const ULong64_t big = (1ULL << 40) + 3;
+  for( int i = 0; i < 3; ++i ) {
+    buf.Set(0, big + i);
+    buf.Set(1, 4000000000.0 + i);   // UInt_t range, exceeds Int_t
+    buf.Set(2, 1.25 * i);
+    buf.Set(3, 1024.0 * i);
+    buf.Set(4, 0.5 + i);
+    tree->Fill();
+  }
+  REQUIRE( tree->GetEntries() == 3 );
+
+  for( int i = 0; i < 3; ++i ) {
+    INFO("entry " << i);
+    tree->GetEntry(i);
+    auto* evc = tree->GetLeaf("evcount");
+    CHECK( *static_cast<ULong64_t*>(evc->GetValuePointer()) == big + i );
+    CHECK( *static_cast<UInt_t*>(tree->GetLeaf("bcm")->GetValuePointer())
+           == 4000000000U + i );
+    CHECK( tree->GetLeaf("bcmr")->GetValue() == 1.25 * i );
+    CHECK( tree->GetLeaf("clk")->GetValue() == 1024.0 * i );
+    CHECK( tree->GetLeaf("clkr")->GetValue() == 0.5 + i );
+  }
+
+  buf.Clear();
+  CHECK_FALSE( buf.HasBranch() );
+  CHECK( buf.GetSize() == 0 );
+}
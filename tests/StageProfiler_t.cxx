@@ -0,0 +1,130 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// StageProfiler_t                                                           //
+//                                                                           //
+// Test Podd::StageProfiler registration, per-thread recording, aggregation, //
+// percentile estimates and machine-readable output                          //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CATCH3
+# include <catch2/catch_test_macros.hpp>
+#else
+# include <catch2/catch.hpp>
+#endif
+
+#include "StageProfiler.h"
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using Podd::StageProfiler;
+
+TEST_CASE("StageProfiler", "[Profiler]")
+{
+  auto& prof = StageProfiler::Instance();
+  prof.Reset();
+
+  SECTION("Registration") {
+    auto id = prof.Register("Test/Register");
+    CHECK( id != StageProfiler::kNoStage );
+    CHECK( prof.Register("Test/Register") == id );
+    CHECK( prof.Find("Test/Register") == id );
+    CHECK( prof.GetName(id) == "Test/Register" );
+    CHECK( prof.Find("Test/NoSuchStage") == StageProfiler::kNoStage );
+  }
+
+  SECTION("Disabled timers record nothing") {
+    auto id = prof.Register("Test/Disabled");
+    prof.Enable(false);
+    {
+      StageProfiler::Scope timer(id);
+    }
+    CHECK( prof.GetStats("Test/Disabled").empty() );
+  }
+
+  SECTION("Aggregation over threads") {
+    auto id = prof.Register("Test/Threads");
+    const int nthreads = 4, nrec = 1000;
+    vector<thread> threads;
+    for( int t = 0; t < nthreads; ++t ) {
+      threads.emplace_back([&prof, id, t] {
+        for( int i = 1; i <= nrec; ++i )
+          prof.RecordNs(id, uint64_t(i) + 1000 * t);
+      });
+    }
+    for( auto& th: threads )
+      th.join();
+
+    auto stats = prof.GetStats("Test/Threads");
+    REQUIRE( stats.size() == 1 );
+    const auto& st = stats[0];
+    CHECK( st.count == nthreads * nrec );
+    CHECK( st.min == 1 );
+    CHECK( st.max == nrec + 1000 * (nthreads - 1) );
+    uint64_t sum = 0, nhist = 0;
+    for( int t = 0; t < nthreads; ++t )
+      sum += uint64_t(nrec) * (nrec + 1) / 2 + uint64_t(1000 * t) * nrec;
+    for( auto h: st.hist )
+      nhist += h;
+    CHECK( st.total == sum );
+    CHECK( nhist == st.count );
+    CHECK( st.Quantile(0) == st.min );
+    CHECK( st.Quantile(1) == st.max );
+    // Percentiles are estimated within power-of-two bins
+    auto p50 = st.Quantile(0.5);
+    CHECK( p50 >= 1024 );
+    CHECK( p50 <= 2048 );
+    CHECK( st.Quantile(0.99) >= p50 );
+  }
+
+  SECTION("Scope timing") {
+    auto id = prof.Register("Test/Scope");
+    prof.Enable();
+    {
+      StageProfiler::Scope timer(id);
+      this_thread::sleep_for(chrono::milliseconds(2));
+    }
+    StageProfiler::Scope timer;
+    timer.Start(id);
+    timer.Stop();
+    timer.Stop();   // no effect
+    prof.Enable(false);
+
+    auto stats = prof.GetStats("Test/Scope");
+    REQUIRE( stats.size() == 1 );
+    CHECK( stats[0].count == 2 );
+    CHECK( stats[0].max >= 1000000 );
+  }
+
+  SECTION("Output") {
+    auto id = prof.Register("Test/Output");
+    prof.RecordNs(id, 100, 2);
+    prof.RecordNs(id, 300, 1);
+
+    ostringstream csv;
+    prof.WriteCSV(csv, "Test/Output");
+    string line;
+    istringstream is(csv.str());
+    getline(is, line);
+    CHECK( line.rfind("stage,count,total_ns,mean_ns,min_ns,p50_ns,p90_ns,"
+                      "p99_ns,max_ns,allocs,", 0) == 0 );
+    getline(is, line);
+    CHECK( line.rfind("Test/Output,2,400,200,100,", 0) == 0 );
+    CHECK( line.find(",300,3,") != string::npos );
+    CHECK( !getline(is, line) );
+
+    ostringstream json;
+    prof.WriteJSON(json, "Test/Output");
+    auto s = json.str();
+    CHECK( s.find("\"name\": \"Test/Output\"") != string::npos );
+    CHECK( s.find("\"count\": 2") != string::npos );
+    CHECK( s.find("\"allocs\": 3") != string::npos );
+    CHECK( s.find("[64, 128, 1]") != string::npos );
+    CHECK( s.find("[256, 512, 1]") != string::npos );
+  }
+
+  prof.Reset();
+}
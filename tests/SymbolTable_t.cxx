@@ -0,0 +1,124 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// SymbolTable_t                                                             //
+//                                                                           //
+// Test Podd::SymbolTable and lookup of global variables and cuts by name ID //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CATCH3
+# include <catch2/catch_test_macros.hpp>
+#else
+# include <catch2/catch.hpp>
+#endif
+
+#include "SymbolTable.h"
+#include "THaVarList.h"
+#include "THaCutList.h"
+#include <memory>
+#include <string>
+
+using namespace std;
+using Podd::SymbolTable;
+
+TEST_CASE("SymbolTable", "[SymbolTable]")
+{
+  SymbolTable tab;
+  CHECK( tab.Find("x") == SymbolTable::kNoID );
+
+  const int N = 3000;
+  for( int i = 0; i < N; ++i )
+    REQUIRE( tab.Intern("L.tr.v" + to_string(i)) == i );
+  CHECK( tab.Intern("L.tr.v42") == 42 );
+  CHECK( tab.GetSize() == N );
+  CHECK( tab.GetName(42) == "L.tr.v42" );
+
+  tab.Freeze();
+  CHECK( tab.IsFrozen() );
+  bool all_found = true;
+  for( int i = 0; i < N; ++i )
+    all_found = all_found && tab.Find("L.tr.v" + to_string(i)) == i;
+  CHECK( all_found );
+  CHECK( tab.Find("L.tr.v") == SymbolTable::kNoID );
+
+  CHECK( tab.Intern("new") == N );
+  CHECK_FALSE( tab.IsFrozen() );
+  CHECK( tab.Find("new") == N );
+
+  tab.Clear();
+  CHECK( tab.Find("new") == SymbolTable::kNoID );
+  CHECK( tab.Intern("a") == 0 );
+}
+
+TEST_CASE("Lookup by name ID", "[SymbolTable]")
+{
+  auto vars = make_unique<THaVarList>();
+  Double_t x = 1, y[4] = { 1, 2, 3, 4 };
+  REQUIRE( vars->Define("x", x) );
+  REQUIRE( vars->Define("y[4]", y[0]) );
+  vars->Freeze();
+
+  Int_t idx = vars->GetID("x"), idy = vars->GetID("y[2]");
+  CHECK( idx != idy );
+  CHECK( vars->FindByID(idx) == vars->Find("x") );
+  CHECK( vars->FindByID(idy) == vars->Find("y") );
+  CHECK( vars->GetID("z") == SymbolTable::kNoID );
+  CHECK( vars->FindByID(SymbolTable::kNoID) == nullptr );
+
+  // IDs survive redefinition
+  CHECK( vars->RemoveName("x") == 1 );
+  CHECK( vars->Find("x") == nullptr );
+  CHECK( vars->FindByID(idx) == nullptr );
+  const auto* newx = vars->Define("x", y[1]);
+  REQUIRE( newx );
+  CHECK( vars->GetID("x") == idx );
+  CHECK( vars->FindByID(idx) == newx );
+
+  // Insertion at any position updates the index
+  auto* vy = vars->Find("y");
+  Int_t idy0 = vars->GetID("y");
+  REQUIRE( vars->Remove(vy) == vy );
+  CHECK( vars->FindByID(idy0) == nullptr );
+  UInt_t nchg = vars->GetChangeCount();
+  vars->AddAt(vy, 1);
+  CHECK( vars->FindByID(idy0) == vy );
+  CHECK( vars->GetChangeCount() != nchg );
+  vars->Remove(vy);
+  vars->AddBefore(newx, vy);
+  CHECK( vars->FindByID(idy0) == vy );
+  vars->Remove(vy);
+  vars->AddAfter(newx, vy);
+  CHECK( vars->FindByID(idy0) == vy );
+  CHECK( vars->Find("y") == vy );
+
+  vars->Clear();
+  CHECK( vars->Find("y") == nullptr );
+
+  THaCutList cuts(vars.get());
+  REQUIRE( vars->Define("x", x) );
+  REQUIRE( cuts.Define("c1", "x>0", "Test") == 0 );
+  Int_t idc = cuts.GetCutID("c1");
+  CHECK( cuts.FindCutByID(idc) == cuts.FindCut("c1") );
+  CHECK( cuts.Remove("c1") == 1 );
+  CHECK( cuts.FindCut("c1") == nullptr );
+  REQUIRE( cuts.Define("c1", "x<0", "Test") == 0 );
+  CHECK( cuts.GetCutID("c1") == idc );
+  CHECK( cuts.FindCutByID(idc) == cuts.FindCut("c1") );
+
+  // A copy has its own cuts, which are found by name and ID
+  REQUIRE( cuts.Define("c2", "c1&&x>-1", "Test2") == 0 );
+  {
+    THaCutList copy(cuts);
+    REQUIRE( copy.FindCut("c1") );
+    CHECK( copy.FindCut("c1") != cuts.FindCut("c1") );
+    CHECK( copy.FindCutByID(copy.GetCutID("c2")) == copy.FindCut("c2") );
+    CHECK( copy.GetNblocks() == 2 );
+    x = -0.5;
+    copy.Eval();
+    CHECK( copy.Result("c1") == 1 );
+    CHECK( copy.Result("c2") == 1 );
+    CHECK( copy.Remove("c2") == 1 );
+    CHECK( copy.FindCut("c2") == nullptr );
+  }
+  CHECK( cuts.FindCut("c2") );
+}
@@ -6,5 +6,10 @@
 
 #pragma link C++ class Podd::Tests::UnitTest+;
 #pragma link C++ class Podd::Tests::ArrayRTTI+;
+#pragma link C++ class Podd::Tests::ThunkBase+;
+#pragma link C++ class Podd::Tests::ThunkDerived+;
+#pragma link C++ class Podd::Tests::ThunkHiding+;
+#pragma link C++ class Podd::Tests::ThunkMixin+;
+#pragma link C++ class Podd::Tests::ThunkMulti+;
 
 #endif
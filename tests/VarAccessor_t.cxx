@@ -0,0 +1,110 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// VarAccessor_t                                                             //
+//                                                                           //
+// Test Podd::VarAccessor, the typed read access to global variables         //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CATCH3
+# include <catch2/catch_test_macros.hpp>
+#else
+# include <catch2/catch.hpp>
+#endif
+
+#include "VarAccessor.h"
+#include "THaVarList.h"
+#include "THaVar.h"
+#include <memory>
+#include <vector>
+
+using namespace std;
+using Podd::VarAccessor;
+
+TEST_CASE("VarAccessor", "[VarAccessor]") // NOLINT(*-function-cognitive-complexity)
+{
+  auto vars = make_unique<THaVarList>();
+  Short_t s = -3;
+  Float_t fa[4] = { 0.5F, 1.5F, 2.5F, 3.5F };
+  Int_t n = 2;
+  Double_t da[5] = { 1, 2, 3, 4, 5 };
+  auto* ai = new Int_t[3]{ 7, 8, 9 };
+  vector<UInt_t> vu{ 10, 20 };
+
+  const auto* vs  = vars->Define("s", s);
+  const auto* vfa = vars->Define("fa[4]", fa[0]);
+  const auto* vda = vars->Define("da", da[0], &n);
+  const auto* vai = vars->DefineByType("ai[3]", "Heap array", &ai, kIntP, nullptr);
+  const auto* vvu = vars->Define("vu", "vector<UInt_t>", vu);
+  REQUIRE( vs );
+  REQUIRE( vfa );
+  REQUIRE( vda );
+  REQUIRE( vai );
+  REQUIRE( vvu );
+
+  SECTION("Scalar") {
+    auto acc = vs->GetAccessor();
+    CHECK( acc.GetLayout() == VarAccessor::kDirect );
+    CHECK( acc.GetElemType() == kShort );
+    CHECK( acc.IsFixed() );
+    CHECK( acc.GetLen() == 1 );
+    CHECK( acc.Get(0) == -3 );
+    CHECK( acc.GetElement(0) == &s );
+  }
+
+  SECTION("Fixed array") {
+    auto acc = vfa->GetAccessor();
+    CHECK( acc.GetLayout() == VarAccessor::kDirect );
+    CHECK( acc.GetStride() == sizeof(Float_t) );
+    CHECK_FALSE( acc.IsVarArray() );
+    Double_t d[4];
+    CHECK( acc.Gather(d, 0, 4) == 4 );
+    CHECK( vector<Double_t>(d, d + 4) == vector<Double_t>{ 0.5, 1.5, 2.5, 3.5 } );
+    CHECK( acc.Get(3) == vfa->GetValue(3) );
+  }
+
+  SECTION("Variable-size array") {
+    auto acc = vda->GetAccessor();
+    CHECK( acc.IsVarArray() );
+    CHECK( acc.GetLen() == 2 );
+    n = 5;
+    CHECK( acc.GetLen() == 5 );
+    CHECK( acc.Get(4) == 5 );
+    CHECK( acc.GetBase() == da );
+  }
+
+  SECTION("Pointer to array") {
+    auto acc = vai->GetAccessor();
+    CHECK( acc.GetLayout() == VarAccessor::kIndirect );
+    CHECK( acc.GetElemType() == kInt );
+    CHECK_FALSE( acc.IsFixed() );
+    CHECK( acc.Get(2) == 9 );
+    // The array may move
+    Int_t moved[3] = { -1, -2, -3 };
+    Int_t* old = ai;
+    ai = moved;
+    CHECK( acc.Get(2) == -3 );
+    CHECK( acc.GetElement(1) == &moved[1] );
+    ai = old;
+  }
+
+  SECTION("Vector") {
+    auto acc = vvu->GetAccessor();
+    CHECK( acc.GetLayout() == VarAccessor::kVector );
+    CHECK( acc.GetElemType() == kUInt );
+    CHECK( acc.GetLen() == 2 );
+    vu.assign(100, 3);
+    CHECK( acc.GetLen() == 100 );
+    CHECK( acc.Get(99) == 3 );
+    CHECK( acc.GetBase() == vu.data() );
+  }
+
+  SECTION("No variable") {
+    VarAccessor acc;
+    CHECK( acc.GetLayout() == VarAccessor::kNoData );
+    CHECK( acc.GetLen() == 0 );
+    CHECK( acc.Get(0) == THaVar::kInvalid );
+  }
+
+  delete [] ai;
+}
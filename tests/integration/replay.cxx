@@ -25,7 +25,8 @@ struct IgnoreMessages {
   Int_t orig_level_;
 };
 
-int replay( const char* run_file, const char* out_file = nullptr, int nev = -1 )
+int replay( const char* run_file, const char* out_file = nullptr, int nev = -1,
+            int nworkers = 0 )
 {
   static const char* const here = "replay.cxx";
   static const char* const run_description = "Podd integration test data";
@@ -99,6 +100,8 @@ int replay( const char* run_file, const char* out_file = nullptr, int nev = -1 )
   analyzer->EnableSlowControl(false);
   analyzer->EnableHelicity(false);
   analyzer->SetSummaryFile(summaryfile);
+  if( nworkers > 1 )
+    analyzer->SetNumWorkers(nworkers);
 
   analyzer->Process(run);
 
@@ -12,6 +12,12 @@ set -e
 
 # Scratch directory. Need about 1 GB of space.
 WORK="$1"
+# Optional number of worker processes for an additional event-parallel replay
+NWORKERS="$2"
+if [ -n "$NWORKERS" ] && ! [ "$NWORKERS" -ge 0 ] 2>/dev/null; then
+  echo ">>>> Invalid number of workers: $NWORKERS"
+  exit 22
+fi
 [ -z "$WORK" ] && WORK="/var/tmp"
 if [ -e "$WORK" ]; then
   WORK="$(realpath "$WORK")"
@@ -102,31 +108,51 @@ fi
 echo "File checksum OK"
 popd >/dev/null
 
+# Compare the run summary in log file $1 and the ROOT file $2 with the
+# references. Sets err on failure. $3 describes the replay.
+check_results() {
+  grep -Ev '^(====|Reading)' "$1" > "$WORK/tmp.log"
+  if ! diff -q "$WORK/tmp.log" "${REF_ROOTFILE//.root/.log}" ; then
+    echo ">>>> Run summary differs$3"
+    err=11
+  else
+    echo "Run summary compares OK$3"
+  fi
+  rm "$WORK/tmp.log"
+
+  if ! analyzer -l -b -q verify.cxx\(\""$2"\",\""$REF_ROOTFILE"\"\) >/dev/null; then
+    echo ">>>> Error testing ROOT file$3"
+    err=12
+  else
+    echo "ROOT file tests OK$3"
+  fi
+}
+
 pushd "$THIS" >/dev/null
 # Replay the raw data
 # echo "Replaying $EVIOF. This will take a few minutes"
+START=$SECONDS
 if ! analyzer -l -b -q replay.cxx\(\""$EVIOF"\",\""$DSTF"\"\) >/dev/null; then
   echo ">>>> Error running replay.cxx"
   exit 10
 fi
+SERIAL_TIME=$((SECONDS - START))
 
 err=0
-# Compare run summary with reference
-grep -Ev '^(====|Reading)' "$LOGF" > "$WORK/tmp.log"
-if ! diff -q "$WORK/tmp.log" "${REF_ROOTFILE//.root/.log}" ; then
-  echo ">>>> Run summary differs"
-  err=11
-else
-  echo "Run summary compares OK"
-fi
-rm "$WORK/tmp.log"
+check_results "$LOGF" "$DSTF"
 
-# Verify ROOT file data, comparing with reference
-if ! analyzer -l -b -q verify.cxx\(\""$DSTF"\",\""$REF_ROOTFILE"\"\) >/dev/null; then
-  echo ">>>> Error testing ROOT file"
-  err=12
-else
-  echo "ROOT file tests OK"
+# Replay again with worker processes. The results must be identical.
+if [ -n "$NWORKERS" ] && [ "$NWORKERS" -gt 1 ]; then
+  PDSTF="${DSTF//.root/_workers.root}"
+  PLOGF="${PDSTF//.root/.log}"
+  START=$SECONDS
+  if ! analyzer -l -b -q replay.cxx\(\""$EVIOF"\",\""$PDSTF"\",-1,"$NWORKERS"\) >/dev/null; then
+    echo ">>>> Error running replay.cxx with $NWORKERS workers"
+    exit 13
+  fi
+  PARALLEL_TIME=$((SECONDS - START))
+  check_results "$PLOGF" "$PDSTF" " ($NWORKERS workers)"
+  echo "Replay time: ${SERIAL_TIME}s serial, ${PARALLEL_TIME}s with $NWORKERS workers"
 fi
 
 popd >/dev/null